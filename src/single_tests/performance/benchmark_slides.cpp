@@ -0,0 +1,19 @@
+#include "benchmarkslides.hpp"
+#include <iostream>
+
+// Generates the synthetic slides of the performance suite. Called by the build.
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        std::cerr << "Usage: benchmark_slides <output directory>" << std::endl;
+        return 1;
+    }
+    try {
+        generateSyntheticSlides(argv[1]);
+    }
+    catch (const std::exception& ex) {
+        std::cerr << "Cannot generate benchmark slides: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "benchmarkslides.hpp"
+#include "slideio/base/exceptions.hpp"
+#include "slideio/converter/converter.hpp"
+#include "slideio/converter/converterparameters.hpp"
+#include "slideio/slideio/slideio.hpp"
+#include "slideio/slideio/scene.hpp"
+#include "tests/testlib/testtools.hpp"
+#include <filesystem>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+using namespace slideio;
+using namespace slideio::converter;
+
+namespace
+{
+    const int SYNTHETIC_SIZE = 4096;
+    const char* SOURCE_NAME = "synthetic.png";
+    const char* SVS_NAME = "synthetic.svs";
+    const char* OMETIFF_NAME = "synthetic.ome.tiff";
+
+    // Tissue-like content: smooth background, blobs of stained cells and sensor noise,
+    // so that the JPEG tiles have realistic sizes and decode times.
+    cv::Mat createSyntheticImage(int size) {
+        cv::Mat image(size, size, CV_8UC3, cv::Scalar(235, 230, 240));
+        cv::RNG rng(20240501);
+        const int numCells = size * size / 2000;
+        for (int cell = 0; cell < numCells; ++cell) {
+            const cv::Point center(rng.uniform(0, size), rng.uniform(0, size));
+            const int radius = rng.uniform(3, 14);
+            const cv::Scalar color(rng.uniform(120, 200), rng.uniform(40, 120), rng.uniform(110, 190));
+            cv::circle(image, center, radius, color, cv::FILLED, cv::LINE_AA);
+        }
+        cv::Mat noise(size, size, CV_8UC3);
+        rng.fill(noise, cv::RNG::NORMAL, cv::Scalar::all(0), cv::Scalar::all(6));
+        cv::add(image, noise, image);
+        return image;
+    }
+
+    void convertSource(const std::string& sourcePath, ConverterParameters& parameters,
+        const std::string& outputPath) {
+        if (std::filesystem::exists(outputPath)) {
+            return;
+        }
+        SlidePtr slide = openSlide(sourcePath, "GDAL");
+        ScenePtr scene = slide->getScene(0);
+        convertScene(scene, parameters, outputPath, 1);
+    }
+
+    void addTestImage(std::vector<BenchmarkSlide>& slides, const std::string& format, const std::string& driver,
+        const std::string& subfolder, const std::string& image, bool full = false) {
+        try {
+            const std::string path = full ? TestTools::getFullTestImagePath(subfolder, image)
+                : TestTools::getTestImagePath(subfolder, image);
+            if (std::filesystem::exists(path)) {
+                slides.push_back({ format, driver, path });
+            }
+        }
+        catch (const std::exception&) {
+            // the test image folder is not configured
+        }
+    }
+}
+
+void generateSyntheticSlides(const std::string& directory) {
+    std::filesystem::create_directories(directory);
+    const std::filesystem::path root(directory);
+    const std::string sourcePath = (root / SOURCE_NAME).string();
+    if (!std::filesystem::exists(sourcePath)) {
+        TestTools::writePNG(createSyntheticImage(SYNTHETIC_SIZE), sourcePath);
+    }
+    SVSJpegConverterParameters svsParameters;
+    svsParameters.setQuality(90);
+    svsParameters.setNumZoomLevels(4);
+    convertSource(sourcePath, svsParameters, (root / SVS_NAME).string());
+    OMETIFFJpegConverterParameters omeParameters;
+    omeParameters.setQuality(90);
+    omeParameters.setNumZoomLevels(4);
+    convertSource(sourcePath, omeParameters, (root / OMETIFF_NAME).string());
+}
+
+std::vector<BenchmarkSlide> collectBenchmarkSlides(const std::string& syntheticDirectory) {
+    std::vector<BenchmarkSlide> slides;
+    const std::filesystem::path root(syntheticDirectory);
+    const std::pair<const char*, const char*> synthetic[] = {
+        { "SVS", SVS_NAME }, { "OMETIFF", OMETIFF_NAME }, { "GDAL", SOURCE_NAME }
+    };
+    for (const auto& [driver, name] : synthetic) {
+        const std::string path = (root / name).string();
+        if (!std::filesystem::exists(path)) {
+            RAISE_RUNTIME_ERROR << "Synthetic slide " << path << " is missing. Build the benchmark_slides target.";
+        }
+        slides.push_back({ driver, driver, path });
+    }
+    addTestImage(slides, "NDPI", "NDPI", "ndpi", "test3-DAPI-2-(387).ndpi");
+    addTestImage(slides, "CZI", "CZI", "czi", "pJP31mCherry.czi");
+    addTestImage(slides, "VSI", "VSI", "vsi", "vsi-multifile/vsi-ets-test-jpg2k.vsi", true);
+    addTestImage(slides, "SCN", "SCN", "scn", "Leica-Fluorescence-1.scn");
+    addTestImage(slides, "PKE", "QPTIFF", "pke", "openmicroscopy/PKI_scans/HandEcompressed_Scan1.qptiff", true);
+    addTestImage(slides, "DCM", "DCM", "dcm", "benigns_01/patient0186/0186.LEFT_MLO.dcm");
+    addTestImage(slides, "ZVI", "ZVI", "zvi", "Zeiss-1-Merged.zvi");
+    return slides;
+}
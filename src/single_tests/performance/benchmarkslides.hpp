@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// A slide the performance suite runs against.
+struct BenchmarkSlide
+{
+    std::string format;     // Benchmark name prefix, e.g. "SVS"
+    std::string driver;     // slideio driver id
+    std::string path;
+};
+
+// Writes the synthetic slides into a directory: a PNG source read by the GDAL driver,
+// and the SVS and OME-TIFF pyramids converted from it. Existing files are kept.
+void generateSyntheticSlides(const std::string& directory);
+
+// Synthetic slides of the directory plus the public test images of the drivers
+// that cannot be written by slideio, where the test image folder provides them.
+std::vector<BenchmarkSlide> collectBenchmarkSlides(const std::string& syntheticDirectory);
@@ -1,36 +1,224 @@
+#include <benchmark/benchmark.h>
+#include "benchmarkslides.hpp"
+#include "slideio/base/exceptions.hpp"
+#include "slideio/converter/converter.hpp"
+#include "slideio/converter/converterparameters.hpp"
+#include "slideio/core/levelinfo.hpp"
+#include "slideio/core/tools/tempfile.hpp"
+#include "slideio/slideio/slideio.hpp"
+#include "slideio/slideio/scene.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
-#include "slideio/drivers/dcm/dcmimagedriver.hpp"
-#include "tests/testlib/testtools.hpp"
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
 using namespace slideio;
+using namespace slideio::converter;
+
+// Usage: performance [--slides=<directory>] [google benchmark options]
+// Per driver it measures slide opening, random tile reads of every level, thumbnail reads,
+// multi-threaded tile throughput and conversion speed. Use
+// --benchmark_out=<file> --benchmark_out_format=json to keep results for trend tracking.
 
-void test()
+namespace
 {
-    DCMImageDriver driver;
-    const std::string filePath = TestTools::getFullTestImagePath("dcm", "private/H01EBB49P-24900");
-    auto slide = driver.openFile(filePath.c_str());
-    auto scene = slide->getScene(0);
-    auto rect = scene->getRect();
-    cv::Mat mat;
-    //scene->readBlock(rect, mat);
-    // cv::Rect blockRect[] = {
-    //     {1000,1000,256,256},
-    //     {2000,2000,256,256},
-    //     {3000,3000,256,256},
-    //     {4000,4000,256,256},
-    //     {5000,5000,256,256},
-    //     {6000,6000,256,256},
-    //     {7000,7000,256,256},
-    // };
-    // for(auto rc:blockRect) {
-    //     cv::Mat mat;
-    //     scene->readBlock(rc, mat);
-    // }
-    std::cout << "Done" << std::endl;
+    const int TILE_SIZES[] = { 256, 512, 1024 };
+    const int NUM_RANDOM_TILES = 64;
+    const int THUMBNAIL_SIZE = 512;
+    const int CONVERSION_SIZE = 2048;
+    const int CONVERSION_TILE_SIZE = 256;
+
+    using BlockRect = std::tuple<int, int, int, int>;
+
+    // Opened once per slide and shared by all benchmarks and their threads, so the
+    // read benchmarks do not include the open time and exercise concurrent reads.
+    ScenePtr getSharedScene(const BenchmarkSlide& slide) {
+        static std::mutex mutex;
+        static std::map<std::string, std::pair<SlidePtr, ScenePtr>> scenes;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = scenes.find(slide.path);
+        if (it == scenes.end()) {
+            SlidePtr opened = openSlide(slide.path, slide.driver);
+            it = scenes.emplace(slide.path, std::make_pair(opened, opened->getScene(0))).first;
+        }
+        return it->second.second;
+    }
+
+    size_t getBufferSize(const ScenePtr& scene, int width, int height) {
+        return static_cast<size_t>(scene->getBlockSize({ width, height }, 0, scene->getNumChannels(), 1, 1));
+    }
+
+    // The same seed gives the same tiles in every run, so the runs stay comparable.
+    std::vector<BlockRect> createRandomTiles(const Size& levelSize, int width, int height, unsigned seed) {
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<int> xDistribution(0, levelSize.width - width);
+        std::uniform_int_distribution<int> yDistribution(0, levelSize.height - height);
+        std::vector<BlockRect> tiles;
+        for (int index = 0; index < NUM_RANDOM_TILES; ++index) {
+            tiles.emplace_back(xDistribution(generator), yDistribution(generator), width, height);
+        }
+        return tiles;
+    }
+
+    void readRandomTiles(benchmark::State& state, const BenchmarkSlide& slide, int level, int tileSize) {
+        try {
+            ScenePtr scene = getSharedScene(slide);
+            const Size levelSize = scene->getLevelInfo(level)->getSize();
+            const int width = std::min(tileSize, levelSize.width);
+            const int height = std::min(tileSize, levelSize.height);
+            const std::vector<BlockRect> tiles = createRandomTiles(levelSize, width, height,
+                static_cast<unsigned>(level * 1000 + tileSize + state.thread_index()));
+            std::vector<uint8_t> buffer(getBufferSize(scene, width, height));
+            size_t index = 0;
+            for (auto _ : state) {
+                const BlockRect& tile = tiles[index++ % tiles.size()];
+                scene->readResampledLevelBlockChannels(level, tile, { width, height }, {}, buffer.data(), buffer.size());
+                benchmark::ClobberMemory();
+            }
+            state.SetItemsProcessed(state.iterations());
+            state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(buffer.size()));
+        }
+        catch (const std::exception& ex) {
+            state.SkipWithError(ex.what());
+        }
+    }
+
+    void openSlideBenchmark(benchmark::State& state, const BenchmarkSlide& slide) {
+        try {
+            for (auto _ : state) {
+                SlidePtr opened = openSlide(slide.path, slide.driver);
+                benchmark::DoNotOptimize(opened->getScene(0));
+            }
+        }
+        catch (const std::exception& ex) {
+            state.SkipWithError(ex.what());
+        }
+    }
+
+    void readThumbnail(benchmark::State& state, const BenchmarkSlide& slide) {
+        try {
+            ScenePtr scene = getSharedScene(slide);
+            const BlockRect rect = scene->getRect();
+            const int sceneWidth = std::get<2>(rect);
+            const int sceneHeight = std::get<3>(rect);
+            const double scale = static_cast<double>(THUMBNAIL_SIZE) / std::max(sceneWidth, sceneHeight);
+            const int width = std::max(1, static_cast<int>(sceneWidth * scale));
+            const int height = std::max(1, static_cast<int>(sceneHeight * scale));
+            std::vector<uint8_t> buffer(getBufferSize(scene, width, height));
+            for (auto _ : state) {
+                scene->readResampledBlock(rect, { width, height }, buffer.data(), buffer.size());
+                benchmark::ClobberMemory();
+            }
+        }
+        catch (const std::exception& ex) {
+            state.SkipWithError(ex.what());
+        }
+    }
+
+    bool canConvertToSVS(const ScenePtr& scene) {
+        const int numChannels = scene->getNumChannels();
+        return (numChannels == 1 || numChannels == 3) && scene->getChannelDataType(0) == DataType::DT_Byte;
+    }
+
+    // Converts a central region of the scene; "tiles" is the number of written level 0 tiles per second.
+    void convertRegion(benchmark::State& state, const BenchmarkSlide& slide) {
+        try {
+            SlidePtr opened = openSlide(slide.path, slide.driver);
+            ScenePtr scene = opened->getScene(0);
+            const BlockRect rect = scene->getRect();
+            const int width = std::min(CONVERSION_SIZE, std::get<2>(rect));
+            const int height = std::min(CONVERSION_SIZE, std::get<3>(rect));
+            const int x = (std::get<2>(rect) - width) / 2;
+            const int y = (std::get<3>(rect) - height) / 2;
+            const int tiles = ((width + CONVERSION_TILE_SIZE - 1) / CONVERSION_TILE_SIZE)
+                * ((height + CONVERSION_TILE_SIZE - 1) / CONVERSION_TILE_SIZE);
+            TempFile output("svs");
+            for (auto _ : state) {
+                state.PauseTiming();
+                std::filesystem::remove(output.getPath());
+                SVSJpegConverterParameters parameters;
+                parameters.setRect(Rect(x, y, width, height));
+                parameters.setTileWidth(CONVERSION_TILE_SIZE);
+                parameters.setTileHeight(CONVERSION_TILE_SIZE);
+                parameters.setNumZoomLevels(1);
+                state.ResumeTiming();
+                convertScene(scene, parameters, output.getPath().string(), 1);
+            }
+            state.counters["tiles"] = benchmark::Counter(tiles, benchmark::Counter::kIsIterationInvariantRate);
+        }
+        catch (const std::exception& ex) {
+            state.SkipWithError(ex.what());
+        }
+    }
+
+    void registerBenchmarks(const std::vector<BenchmarkSlide>& slides) {
+        const int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        for (const BenchmarkSlide& slide : slides) {
+            ScenePtr scene;
+            try {
+                scene = getSharedScene(slide);
+            }
+            catch (const std::exception& ex) {
+                std::cerr << "Skipping " << slide.path << ": " << ex.what() << std::endl;
+                continue;
+            }
+            const std::string prefix = slide.format + "/";
+            benchmark::RegisterBenchmark((prefix + "Open").c_str(), [slide](benchmark::State& state) {
+                openSlideBenchmark(state, slide);
+            })->Unit(benchmark::kMillisecond);
+            for (int level = 0; level < scene->getNumZoomLevels(); ++level) {
+                for (const int tileSize : TILE_SIZES) {
+                    const std::string name = prefix + "ReadTile/L" + std::to_string(level) + "/" + std::to_string(tileSize);
+                    benchmark::RegisterBenchmark(name.c_str(), [slide, level, tileSize](benchmark::State& state) {
+                        readRandomTiles(state, slide, level, tileSize);
+                    })->Unit(benchmark::kMicrosecond);
+                }
+            }
+            benchmark::RegisterBenchmark((prefix + "Thumbnail").c_str(), [slide](benchmark::State& state) {
+                readThumbnail(state, slide);
+            })->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark((prefix + "ReadTileMT/L0/512").c_str(), [slide](benchmark::State& state) {
+                readRandomTiles(state, slide, 0, 512);
+            })->ThreadRange(1, maxThreads)->UseRealTime()->Unit(benchmark::kMicrosecond);
+            if (canConvertToSVS(scene)) {
+                benchmark::RegisterBenchmark((prefix + "ConvertSVS").c_str(), [slide](benchmark::State& state) {
+                    convertRegion(state, slide);
+                })->Unit(benchmark::kMillisecond)->Iterations(3);
+            }
+        }
+    }
 }
 
-int main()
+int main(int argc, char** argv)
 {
-    test();
+    std::string slidesDirectory = SLIDEIO_BENCHMARK_SLIDES_DIR;
+    const char* slidesOption = "--slides=";
+    int numArgs = 0;
+    for (int index = 0; index < argc; ++index) {
+        if (strncmp(argv[index], slidesOption, strlen(slidesOption)) == 0) {
+            slidesDirectory = argv[index] + strlen(slidesOption);
+        }
+        else {
+            argv[numArgs++] = argv[index];
+        }
+    }
+    argc = numArgs;
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    try {
+        registerBenchmarks(collectBenchmarkSlides(slidesDirectory));
+    }
+    catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
     return 0;
-    
 }
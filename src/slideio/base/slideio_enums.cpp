@@ -37,6 +37,7 @@ std::string slideio::compressionToString(slideio::Compression compression) {
     case Compression::GIF: return "GIF";
     case Compression::BIGGIF: return "BIGGIF";
     case Compression::RLE: return "RLE";
+    case Compression::Zstd: return "Zstd";
     }
     return "Unknown";
 }
@@ -74,4 +75,11 @@ std::ostream& slideio::operator << (std::ostream& os, const slideio::MetadataFor
 	return os;
 }
 
-
+std::ostream& slideio::operator << (std::ostream& os, slideio::ResamplingPolicy policy) {
+    switch (policy) {
+    case slideio::ResamplingPolicy::Fast: os << "Fast"; break;
+    case slideio::ResamplingPolicy::Balanced: os << "Balanced"; break;
+    case slideio::ResamplingPolicy::Exact: os << "Exact"; break;
+    }
+    return os;
+}
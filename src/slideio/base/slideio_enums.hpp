@@ -58,6 +58,8 @@ namespace slideio
         BMP,
         JpegLossless,
         VP8,
+        /**@brief Zstandard lossless data compression*/
+        Zstd,
     };
 
     enum class DataType
@@ -87,8 +89,27 @@ namespace slideio
 		XML
 	};
 
+    /**@brief trade-off between speed and quality of resampled reads.
+     *
+     * The policy selects both the zoom level a resampled block is read from and the
+     * interpolation the block is resized with.
+     */
+    enum class ResamplingPolicy
+    {
+        /**@brief the level closest to the requested zoom, coarser levels included, resized
+         * with nearest neighbor interpolation.*/
+        Fast,
+        /**@brief the coarsest level not below the requested zoom, resized with bilinear
+         * interpolation. The default.*/
+        Balanced,
+        /**@brief a level of at least twice the requested zoom where one exists, reduced with
+         * area interpolation and enlarged with Lanczos interpolation.*/
+        Exact
+    };
+
     std::string SLIDEIO_BASE_EXPORTS compressionToString(Compression compression);
     SLIDEIO_BASE_EXPORTS std::ostream& operator << (std::ostream& os, Compression compression);
     SLIDEIO_BASE_EXPORTS std::ostream& operator << (std::ostream& os, const DataType& dt);
 	SLIDEIO_BASE_EXPORTS std::ostream& operator << (std::ostream& os, const MetadataFormat& mt);
+    SLIDEIO_BASE_EXPORTS std::ostream& operator << (std::ostream& os, ResamplingPolicy policy);
 }
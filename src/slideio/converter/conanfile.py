@@ -14,3 +14,4 @@ class ConverterConan(ConanFile):
         self.requires("libtiff/4.6.0")
         self.requires("xz_utils/5.4.5")
         self.requires("libwebp/1.3.2")
+        self.requires("nlohmann_json/3.11.3")
@@ -0,0 +1,151 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "conversionjournal.hpp"
+#include "slideio/base/exceptions.hpp"
+#include "slideio/base/log.hpp"
+#include <cinttypes>
+#include <filesystem>
+#include <sstream>
+
+using namespace slideio;
+using namespace slideio::converter;
+
+namespace
+{
+    const char* JOURNAL_SIGNATURE = "slideio-conversion-journal 1";
+
+    std::filesystem::path toPath(const std::string& path) {
+#if defined(WIN32)
+        return std::filesystem::path(Tools::toWstring(path));
+#else
+        return std::filesystem::path(path);
+#endif
+    }
+}
+
+ConversionJournal::ConversionJournal(const std::string& path) : m_path(path) {
+}
+
+std::string ConversionJournal::getJournalPath(const std::string& outputPath) {
+    return outputPath + ".journal";
+}
+
+bool ConversionJournal::load(const std::string& layout) {
+    m_records.clear();
+    m_metadataSize = 0;
+    std::unique_ptr<FILE, Tools::FileDeleter> file(Tools::openFile(m_path, "rb"));
+    if (!file) {
+        return false;
+    }
+    std::string content;
+    char buffer[4096];
+    size_t bytes = 0;
+    while ((bytes = fread(buffer, 1, sizeof(buffer), file.get())) > 0) {
+        content.append(buffer, bytes);
+    }
+    // only lines terminated by a newline are complete
+    const size_t end = content.rfind('\n');
+    if (end == std::string::npos) {
+        return false;
+    }
+    std::istringstream stream(content.substr(0, end + 1));
+    std::string line;
+    if (!std::getline(stream, line) || line != JOURNAL_SIGNATURE) {
+        return false;
+    }
+    if (!std::getline(stream, line) || line != "layout " + layout) {
+        return false;
+    }
+    if (!std::getline(stream, line) || sscanf(line.c_str(), "metadata %" SCNu64, &m_metadataSize) != 1) {
+        return false;
+    }
+    while (std::getline(stream, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        Record record;
+        if (sscanf(line.c_str(), "tile %d %d %d %" SCNu64 " %" SCNu64, &record.directoryIndex,
+            &record.x, &record.y, &record.offset, &record.size) != 5) {
+            SLIDEIO_LOG(WARNING) << "ConversionJournal: skipping malformed record in " << m_path << ": " << line;
+            continue;
+        }
+        m_records.push_back(record);
+    }
+    return true;
+}
+
+void ConversionJournal::start(const std::string& layout, uint64_t metadataSize) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_records.clear();
+    m_metadataSize = metadataSize;
+    m_file.reset(Tools::openFile(m_path, "wb"));
+    if (!m_file) {
+        RAISE_RUNTIME_ERROR << "ConversionJournal: cannot create journal " << m_path;
+    }
+    m_pending.clear();
+    fprintf(m_file.get(), "%s\nlayout %s\nmetadata %" PRIu64 "\n", JOURNAL_SIGNATURE, layout.c_str(), metadataSize);
+    if (!Tools::syncFile(m_file.get())) {
+        RAISE_RUNTIME_ERROR << "ConversionJournal: error by writing journal " << m_path;
+    }
+}
+
+void ConversionJournal::resume() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_file.reset(Tools::openFile(m_path, "ab"));
+    if (!m_file) {
+        RAISE_RUNTIME_ERROR << "ConversionJournal: cannot open journal " << m_path;
+    }
+    m_pending.clear();
+    // a torn record of the interrupted session is terminated, so it stays a single bad line
+    fputc('\n', m_file.get());
+}
+
+void ConversionJournal::setDataSync(std::function<void()> dataSync) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dataSync = std::move(dataSync);
+}
+
+void ConversionJournal::append(const Record& record) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file) {
+        RAISE_RUNTIME_ERROR << "ConversionJournal: journal " << m_path << " is not open";
+    }
+    m_pending.push_back(record);
+    if (m_pending.size() >= RECORDS_PER_SYNC) {
+        writePendingRecords();
+    }
+}
+
+void ConversionJournal::flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file) {
+        writePendingRecords();
+    }
+}
+
+void ConversionJournal::writePendingRecords() {
+    if (m_pending.empty()) {
+        return;
+    }
+    // the tiles reach the disk before the records that describe them
+    if (m_dataSync) {
+        m_dataSync();
+    }
+    for (const Record& record : m_pending) {
+        fprintf(m_file.get(), "tile %d %d %d %" PRIu64 " %" PRIu64 "\n", record.directoryIndex, record.x, record.y,
+            record.offset, record.size);
+    }
+    m_pending.clear();
+    if (!Tools::syncFile(m_file.get())) {
+        RAISE_RUNTIME_ERROR << "ConversionJournal: error by writing journal " << m_path;
+    }
+}
+
+void ConversionJournal::remove() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.clear();
+    m_file.reset();
+    std::error_code ec;
+    std::filesystem::remove(toPath(m_path), ec);
+}
@@ -0,0 +1,90 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+#include "slideio/converter/converter_def.hpp"
+#include "slideio/core/tools/tools.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#pragma warning( push )
+#pragma warning(disable: 4251)
+#endif
+
+namespace slideio
+{
+    namespace converter
+    {
+        // Append-only text journal of the tiles a resumable conversion has written. Records
+        // are kept in memory and written in batches: the data sync makes the tiles of a batch
+        // durable in the output file before the batch is written and synced to the journal,
+        // so every complete record describes valid data even after a power loss. A crash
+        // loses at most the records of the last batch; their tiles are converted again.
+        // A torn last line left by a crash is ignored on load.
+        // The layout string identifies the file structure the records belong to; a journal
+        // with a different layout is not resumed.
+        class SLIDEIO_CONVERTER_EXPORTS ConversionJournal
+        {
+        public:
+            // Records written to the journal per sync of the output file.
+            static constexpr size_t RECORDS_PER_SYNC = 64;
+            struct Record {
+                int directoryIndex = 0;
+                int x = 0;              // Pixel position of the tile in the directory
+                int y = 0;
+                uint64_t offset = 0;    // File offset of the encoded tile
+                uint64_t size = 0;      // Encoded size in bytes
+            };
+        public:
+            explicit ConversionJournal(const std::string& path);
+            ConversionJournal(const ConversionJournal&) = delete;
+            ConversionJournal& operator=(const ConversionJournal&) = delete;
+            // Journal file of an output file.
+            static std::string getJournalPath(const std::string& outputPath);
+            // Reads an existing journal. Returns false when there is none or when it was
+            // written for another layout.
+            bool load(const std::string& layout);
+            // Starts a new journal, dropping an existing one.
+            void start(const std::string& layout, uint64_t metadataSize);
+            // Continues a loaded journal: new records are appended to it.
+            void resume();
+            // Called before a batch of records is written; makes their tiles durable.
+            void setDataSync(std::function<void()> dataSync);
+            // Thread-safe.
+            void append(const Record& record);
+            // Writes the pending records, e.g. when an interrupted conversion stops.
+            void flush();
+            // Closes and deletes the journal after the output file is complete.
+            void remove();
+            uint64_t getMetadataSize() const {
+                return m_metadataSize;
+            }
+            const std::vector<Record>& getRecords() const {
+                return m_records;
+            }
+            const std::string& getPath() const {
+                return m_path;
+            }
+        private:
+            void writePendingRecords();
+        private:
+            std::string m_path;
+            std::unique_ptr<FILE, Tools::FileDeleter> m_file;
+            std::mutex m_mutex;
+            uint64_t m_metadataSize = 0;
+            std::vector<Record> m_records;
+            std::vector<Record> m_pending;
+            std::function<void()> m_dataSync;
+        };
+    }
+}
+
+#if defined(_MSC_VER)
+#pragma warning( pop )
+#endif
@@ -7,6 +7,8 @@
 #include "slideio/converter/converterparameters.hpp"
 #include "slideio/base/log.hpp"
 #include "tiffconverter.hpp"
+#include "zarrconverter.hpp"
+#include "conversionjournal.hpp"
 
 #include <filesystem>
 
@@ -18,22 +20,52 @@ void converter::convertScene(std::shared_ptr<Scene> scene, ConverterParameters&
     if(scene == nullptr) {
         RAISE_RUNTIME_ERROR << "Converter: invalid input scene!";
     }
-    if (parameters.getFormat() != ImageFormat::SVS && parameters.getFormat() != ImageFormat::OME_TIFF) {
+    const ImageFormat format = parameters.getFormat();
+    if (format != ImageFormat::SVS && format != ImageFormat::OME_TIFF && format != ImageFormat::OME_ZARR) {
         RAISE_RUNTIME_ERROR << "Converter: output format '" << (int)parameters.getFormat() << "' is not supported!";
     }
-    if(parameters.getEncoding() != Compression::Jpeg
-        && parameters.getEncoding() != Compression::Jpeg2000) {
+    if (format == ImageFormat::OME_ZARR) {
+        if (parameters.getEncoding() != Compression::Zstd && parameters.getEncoding() != Compression::Zlib) {
+            RAISE_RUNTIME_ERROR << "Converter: OME-Zarr output supports Zstd and Zlib compression only. Received: "
+                << parameters.getEncoding();
+        }
+    }
+    else if(parameters.getEncoding() != Compression::Jpeg
+        && parameters.getEncoding() != Compression::Jpeg2000
+        && !LosslessEncodeParameters::isLosslessCompression(parameters.getEncoding())) {
         RAISE_RUNTIME_ERROR << "Unsupported compression type: " << parameters.getEncoding();
     }
-    if(std::filesystem::exists(outputPath)) {
+    bool resumable = false;
+    if (parameters.getContainerType() == Container::TIFF_CONTAINER) {
+        resumable = std::static_pointer_cast<const TIFFContainerParameters>(
+            parameters.getContainerParameters())->getResumable();
+    }
+    // a partial output with a journal is continued by a resumable conversion
+    if(std::filesystem::exists(outputPath)
+        && !(resumable && std::filesystem::exists(ConversionJournal::getJournalPath(outputPath)))) {
         RAISE_RUNTIME_ERROR << "Converter: output file \"" << outputPath << "\" already exists.";
     }
     std::string sceneName = scene->getName();
     std::string filePath = scene->getFilePath();
     SLIDEIO_LOG(INFO) << "Convert a scene " << sceneName << " from file "
         << filePath << " to format: '" << (int)parameters.getFormat() << "'.";
-    if (parameters.getFormat() != ImageFormat::SVS && parameters.getFormat() != ImageFormat::OME_TIFF) {
-        RAISE_RUNTIME_ERROR << "Incorrect parameter type for the output file";
+    if (format == ImageFormat::OME_ZARR) {
+        // the output path is the root directory of the zarr store
+        try {
+            ZarrConverter zarr;
+            zarr.createLayout(scene->getCVScene(), parameters);
+            zarr.createZarr(outputPath, cb);
+        }
+        catch (std::exception&) {
+            std::error_code ec;
+#if defined(WIN32)
+            std::filesystem::remove_all(Tools::toWstring(outputPath), ec);
+#else
+            std::filesystem::remove_all(outputPath, ec);
+#endif
+            throw;
+        }
+        return;
     }
     try {
         TiffConverter structure;
@@ -41,11 +73,13 @@ void converter::convertScene(std::shared_ptr<Scene> scene, ConverterParameters&
 		structure.createTiff(outputPath, cb, tileBatchSize);
     }
     catch (std::exception&) {
+        if (!resumable) {
 #if defined(WIN32)
-        std::filesystem::remove(Tools::toWstring(outputPath));
+            std::filesystem::remove(Tools::toWstring(outputPath));
 #else
-        std::filesystem::remove(outputPath);
+            std::filesystem::remove(outputPath);
 #endif
+        }
         throw;
     }
 }
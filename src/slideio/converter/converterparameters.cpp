@@ -16,6 +16,8 @@ ConverterParameters::ConverterParameters(ImageFormat format, Container container
     m_format = format;
     if (containerType == TIFF_CONTAINER) {
         m_containerParameters = std::make_shared<TIFFContainerParameters>();
+	} else if (containerType == ZARR_CONTAINER) {
+        m_containerParameters = std::make_shared<ZarrContainerParameters>();
 	} else {
 		RAISE_RUNTIME_ERROR << "ConverterParameters: Unsupported container type " << static_cast<int>(containerType);
 	}
@@ -24,6 +26,12 @@ ConverterParameters::ConverterParameters(ImageFormat format, Container container
 
     } else if (compression == Compression::Jpeg2000) {
         m_encodeParameters =  std::make_shared<JP2KEncodeParameters>();
+    } else if (compression == Compression::Zstd) {
+        m_encodeParameters = std::make_shared<ZstdEncodeParameters>();
+    } else if (compression == Compression::Zlib) {
+        m_encodeParameters = std::make_shared<DeflateEncodeParameters>();
+    } else if (compression == Compression::LZW) {
+        m_encodeParameters = std::make_shared<LZWEncodeParameters>();
     }
     else {
         RAISE_RUNTIME_ERROR << "ConverterParameters: Unsupported compression type " << static_cast<int>(compression);
@@ -63,6 +71,21 @@ void ConverterParameters::copyFrom(const ConverterParameters& other) {
             );
             newParams->setSubSamplingDx(jp2kParams->getSubSamplingDx());
             newParams->setSubSamplingDy(jp2kParams->getSubSamplingDy());
+            newParams->setHighThroughput(jp2kParams->getHighThroughput());
+            newParams->setQuantizationStep(jp2kParams->getQuantizationStep());
+            m_encodeParameters = newParams;
+        } else if (LosslessEncodeParameters::isLosslessCompression(compression)) {
+            auto losslessParams = std::static_pointer_cast<LosslessEncodeParameters>(other.m_encodeParameters);
+            std::shared_ptr<LosslessEncodeParameters> newParams;
+            if (compression == Compression::Zstd) {
+                newParams = std::make_shared<ZstdEncodeParameters>();
+            } else if (compression == Compression::Zlib) {
+                newParams = std::make_shared<DeflateEncodeParameters>();
+            } else {
+                newParams = std::make_shared<LZWEncodeParameters>();
+            }
+            newParams->setLevel(losslessParams->getLevel());
+            newParams->setPredictor(losslessParams->getPredictor());
             m_encodeParameters = newParams;
         } else {
             m_encodeParameters = nullptr;
@@ -82,6 +105,19 @@ void ConverterParameters::copyFrom(const ConverterParameters& other) {
             newParams->setNumZoomLevels(tiffParams->getNumZoomLevels());
             newParams->setNumReadingThreads(tiffParams->getNumReadingThreads());
             newParams->setNumEncodingThreads(tiffParams->getNumEncodingThreads());
+            newParams->setParallelWriting(tiffParams->getParallelWriting());
+            newParams->setBackgroundDetection(tiffParams->getBackgroundDetection());
+            newParams->setBackgroundTolerance(tiffParams->getBackgroundTolerance());
+            newParams->setResumable(tiffParams->getResumable());
+            m_containerParameters = newParams;
+        } else if (containerType == ZARR_CONTAINER) {
+            auto zarrParams = std::static_pointer_cast<ZarrContainerParameters>(other.m_containerParameters);
+            auto newParams = std::make_shared<ZarrContainerParameters>();
+            newParams->setChunkWidth(zarrParams->getChunkWidth());
+            newParams->setChunkHeight(zarrParams->getChunkHeight());
+            newParams->setNumZoomLevels(zarrParams->getNumZoomLevels());
+            newParams->setNumReadingThreads(zarrParams->getNumReadingThreads());
+            newParams->setNumEncodingThreads(zarrParams->getNumEncodingThreads());
             m_containerParameters = newParams;
         } else {
             m_containerParameters = nullptr;
@@ -102,7 +138,7 @@ void ConverterParameters::updateNotDefinedParameters(const std::shared_ptr<CVSce
     if (m_sliceRange.size() <= 0) {
         if (m_format == ImageFormat::SVS) {
 			m_sliceRange = Range(0, 1);
-        } else if (m_format == ImageFormat::OME_TIFF) {
+        } else if (m_format == ImageFormat::OME_TIFF || m_format == ImageFormat::OME_ZARR) {
 			m_sliceRange = Range(0, scene->getNumZSlices());
         }
     }
@@ -110,7 +146,7 @@ void ConverterParameters::updateNotDefinedParameters(const std::shared_ptr<CVSce
         if (m_format == ImageFormat::SVS) {
             m_frameRange = Range(0, 1);
         }
-        else if (m_format == ImageFormat::OME_TIFF) {
+        else if (m_format == ImageFormat::OME_TIFF || m_format == ImageFormat::OME_ZARR) {
             m_frameRange = Range(0, scene->getNumTFrames());
         }
     }
@@ -122,6 +158,13 @@ void ConverterParameters::updateNotDefinedParameters(const std::shared_ptr<CVSce
                 tiffParams->setNumZoomLevels(numZoomLevels);
             }
 		}
+        else if (m_containerParameters->getContainerType() == ZARR_CONTAINER) {
+            auto zarrParams = std::static_pointer_cast<ZarrContainerParameters>(m_containerParameters);
+            if (zarrParams->getNumZoomLevels() < 1) {
+                int numZoomLevels = ConverterTools::computeNumZoomLevels(m_rect.width, m_rect.height);
+                zarrParams->setNumZoomLevels(numZoomLevels);
+            }
+        }
     }
 }
 
@@ -26,7 +26,8 @@ namespace slideio
         {
             Unknown,
             SVS,
-            OME_TIFF
+            OME_TIFF,
+            OME_ZARR
         };
 
         enum Encoding
@@ -39,7 +40,8 @@ namespace slideio
         enum Container
         {
             UNKNOWN_CONTAINER,
-            TIFF_CONTAINER
+            TIFF_CONTAINER,
+            ZARR_CONTAINER
         };
 
         class ContainerParameters
@@ -66,7 +68,11 @@ namespace slideio
                                         m_tileHeight(256),
                                         m_numZoomLevels(-1),
                                         m_numReadingThreads(0),
-                                        m_numEncodingThreads(0) {
+                                        m_numEncodingThreads(0),
+                                        m_parallelWriting(false),
+                                        m_backgroundDetection(false),
+                                        m_backgroundTolerance(2.0),
+                                        m_resumable(false) {
             }
 
             ~TIFFContainerParameters() override = default;
@@ -111,12 +117,122 @@ namespace slideio
                 m_numEncodingThreads = numEncodingThreads;
             }
 
+            bool getParallelWriting() const {
+                return m_parallelWriting;
+            }
+
+            // Encoder threads write tiles straight into a BigTIFF file at preallocated
+            // offsets instead of handing them to a single ordered libtiff writer.
+            void setParallelWriting(bool parallelWriting) {
+                m_parallelWriting = parallelWriting;
+            }
+
+            bool getBackgroundDetection() const {
+                return m_backgroundDetection;
+            }
+
+            // Tiles whose pixel values are near-uniform (glass background) are replaced by
+            // a uniform tile of their mean value. Such tiles are encoded once per directory
+            // and value; with parallel writing all of them reference a single copy in the file.
+            void setBackgroundDetection(bool backgroundDetection) {
+                m_backgroundDetection = backgroundDetection;
+            }
+
+            double getBackgroundTolerance() const {
+                return m_backgroundTolerance;
+            }
+
+            // Maximal standard deviation of a channel for a tile to count as background.
+            // 0 accepts only exactly uniform tiles, which keeps the conversion lossless.
+            void setBackgroundTolerance(double backgroundTolerance) {
+                m_backgroundTolerance = backgroundTolerance;
+            }
+
+            bool getResumable() const {
+                return m_resumable;
+            }
+
+            // Written tiles are recorded in a journal next to the output file. A conversion
+            // interrupted by a crash or preemption continues from the journal when it is
+            // started again with the same parameters. Implies parallel writing.
+            void setResumable(bool resumable) {
+                m_resumable = resumable;
+            }
+
         protected:
             int m_tileWidth;
             int m_tileHeight;
             int m_numZoomLevels;
             int m_numReadingThreads;
             int m_numEncodingThreads;
+            bool m_parallelWriting;
+            bool m_backgroundDetection;
+            double m_backgroundTolerance;
+            bool m_resumable;
+        };
+
+        // OME-Zarr (NGFF 0.4) directory store. Every chunk holds one plane of one channel
+        // (t, c, z = 1) and chunkHeight x chunkWidth pixels.
+        class ZarrContainerParameters : public ContainerParameters
+        {
+        public:
+            ZarrContainerParameters() : ContainerParameters(ZARR_CONTAINER),
+                                        m_chunkWidth(512),
+                                        m_chunkHeight(512),
+                                        m_numZoomLevels(-1),
+                                        m_numReadingThreads(0),
+                                        m_numEncodingThreads(0) {
+            }
+
+            ~ZarrContainerParameters() override = default;
+
+            int getChunkWidth() const {
+                return m_chunkWidth;
+            }
+
+            void setChunkWidth(int chunkWidth) {
+                m_chunkWidth = chunkWidth;
+            }
+
+            int getChunkHeight() const {
+                return m_chunkHeight;
+            }
+
+            void setChunkHeight(int chunkHeight) {
+                m_chunkHeight = chunkHeight;
+            }
+
+            int getNumZoomLevels() const {
+                return m_numZoomLevels;
+            }
+
+            void setNumZoomLevels(int numZoomLevels) {
+                m_numZoomLevels = numZoomLevels;
+            }
+
+            int getNumReadingThreads() const {
+                return m_numReadingThreads;
+            }
+
+            void setNumReadingThreads(int numReadingThreads) {
+                m_numReadingThreads = numReadingThreads;
+            }
+
+            int getNumEncodingThreads() const {
+                return m_numEncodingThreads;
+            }
+
+            // Encoder threads compress chunks and write each one to its own file.
+            void setNumEncodingThreads(int numEncodingThreads) {
+                m_numEncodingThreads = numEncodingThreads;
+            }
+
+        protected:
+            int m_chunkWidth;
+            int m_chunkHeight;
+            int m_numZoomLevels;
+            int m_numReadingThreads;
+            int m_numEncodingThreads;
         };
 
         class SLIDEIO_CONVERTER_EXPORTS ConverterParameters
@@ -182,11 +298,11 @@ namespace slideio
             }
 
             std::shared_ptr<ContainerParameters> getContainerParameters() {
-                return std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters);
+                return m_containerParameters;
             }
 
             std::shared_ptr<const ContainerParameters> getContainerParameters() const {
-                return std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters);
+                return m_containerParameters;
             }
 
             bool isValid() const {
@@ -266,6 +382,38 @@ namespace slideio
             void setNumEncodingThreads(int numEncodingThreads) {
                 std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->setNumEncodingThreads(numEncodingThreads);
             }
+
+            bool getParallelWriting() const {
+                return std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->getParallelWriting();
+            }
+
+            void setParallelWriting(bool parallelWriting) {
+                std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->setParallelWriting(parallelWriting);
+            }
+
+            bool getBackgroundDetection() const {
+                return std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->getBackgroundDetection();
+            }
+
+            void setBackgroundDetection(bool backgroundDetection) {
+                std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->setBackgroundDetection(backgroundDetection);
+            }
+
+            double getBackgroundTolerance() const {
+                return std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->getBackgroundTolerance();
+            }
+
+            void setBackgroundTolerance(double backgroundTolerance) {
+                std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->setBackgroundTolerance(backgroundTolerance);
+            }
+
+            bool getResumable() const {
+                return std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->getResumable();
+            }
+
+            void setResumable(bool resumable) {
+                std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->setResumable(resumable);
+            }
         };
 
         class SLIDEIO_CONVERTER_EXPORTS SVSJpegConverterParameters : public SVSConverterParameters
@@ -304,6 +452,22 @@ namespace slideio
             float getCompressionRate() const {
                 return std::static_pointer_cast<slideio::JP2KEncodeParameters>(m_encodeParameters)->getCompressionRate();
             }
+
+            void setHighThroughput(bool highThroughput) {
+                std::static_pointer_cast<slideio::JP2KEncodeParameters>(m_encodeParameters)->setHighThroughput(highThroughput);
+            }
+
+            bool getHighThroughput() const {
+                return std::static_pointer_cast<slideio::JP2KEncodeParameters>(m_encodeParameters)->getHighThroughput();
+            }
+
+            void setQuantizationStep(float step) {
+                std::static_pointer_cast<slideio::JP2KEncodeParameters>(m_encodeParameters)->setQuantizationStep(step);
+            }
+
+            float getQuantizationStep() const {
+                return std::static_pointer_cast<slideio::JP2KEncodeParameters>(m_encodeParameters)->getQuantizationStep();
+            }
         };
 
         class SLIDEIO_CONVERTER_EXPORTS OMETIFFConverterParameters : public ConverterParameters
@@ -354,6 +518,38 @@ namespace slideio
             void setNumEncodingThreads(int numEncodingThreads) {
                 std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->setNumEncodingThreads(numEncodingThreads);
             }
+
+            bool getParallelWriting() const {
+                return std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->getParallelWriting();
+            }
+
+            void setParallelWriting(bool parallelWriting) {
+                std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->setParallelWriting(parallelWriting);
+            }
+
+            bool getBackgroundDetection() const {
+                return std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->getBackgroundDetection();
+            }
+
+            void setBackgroundDetection(bool backgroundDetection) {
+                std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->setBackgroundDetection(backgroundDetection);
+            }
+
+            double getBackgroundTolerance() const {
+                return std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->getBackgroundTolerance();
+            }
+
+            void setBackgroundTolerance(double backgroundTolerance) {
+                std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->setBackgroundTolerance(backgroundTolerance);
+            }
+
+            bool getResumable() const {
+                return std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->getResumable();
+            }
+
+            void setResumable(bool resumable) {
+                std::static_pointer_cast<TIFFContainerParameters>(m_containerParameters)->setResumable(resumable);
+            }
         };
 
         class SLIDEIO_CONVERTER_EXPORTS OMETIFFJpegConverterParameters : public OMETIFFConverterParameters
@@ -375,6 +571,33 @@ namespace slideio
         };
 
 
+        class SLIDEIO_CONVERTER_EXPORTS OMETIFFLosslessConverterParameters : public OMETIFFConverterParameters
+        {
+        public:
+            // compression: Zstd, Zlib (Deflate) or LZW
+            OMETIFFLosslessConverterParameters(Compression compression = Compression::Zstd)
+                : OMETIFFConverterParameters(compression) {
+            }
+
+            ~OMETIFFLosslessConverterParameters() override = default;
+
+            void setLevel(int level) {
+                std::static_pointer_cast<slideio::LosslessEncodeParameters>(m_encodeParameters)->setLevel(level);
+            }
+
+            int getLevel() const {
+                return std::static_pointer_cast<slideio::LosslessEncodeParameters>(m_encodeParameters)->getLevel();
+            }
+
+            void setPredictor(TiffPredictor predictor) {
+                std::static_pointer_cast<slideio::LosslessEncodeParameters>(m_encodeParameters)->setPredictor(predictor);
+            }
+
+            TiffPredictor getPredictor() const {
+                return std::static_pointer_cast<slideio::LosslessEncodeParameters>(m_encodeParameters)->getPredictor();
+            }
+        };
+
         class SLIDEIO_CONVERTER_EXPORTS OMETIFFJp2KConverterParameters : public OMETIFFConverterParameters
         {
         public:
@@ -391,6 +614,82 @@ namespace slideio
             float getCompressionRate() const {
                 return std::static_pointer_cast<slideio::JP2KEncodeParameters>(m_encodeParameters)->getCompressionRate();
             }
+
+            void setHighThroughput(bool highThroughput) {
+                std::static_pointer_cast<slideio::JP2KEncodeParameters>(m_encodeParameters)->setHighThroughput(highThroughput);
+            }
+
+            bool getHighThroughput() const {
+                return std::static_pointer_cast<slideio::JP2KEncodeParameters>(m_encodeParameters)->getHighThroughput();
+            }
+
+            void setQuantizationStep(float step) {
+                std::static_pointer_cast<slideio::JP2KEncodeParameters>(m_encodeParameters)->setQuantizationStep(step);
+            }
+
+            float getQuantizationStep() const {
+                return std::static_pointer_cast<slideio::JP2KEncodeParameters>(m_encodeParameters)->getQuantizationStep();
+            }
+        };
+
+        // Chunks are compressed with Zstd or Deflate (zlib) - the codecs that OME-Zarr
+        // readers know as numcodecs "zstd" and "zlib".
+        class SLIDEIO_CONVERTER_EXPORTS OMEZarrConverterParameters : public ConverterParameters
+        {
+        public:
+            OMEZarrConverterParameters(Compression compression = Compression::Zstd)
+                : ConverterParameters(ImageFormat::OME_ZARR, Container::ZARR_CONTAINER, compression) {
+            }
+
+            ~OMEZarrConverterParameters() override = default;
+
+            int getChunkWidth() const {
+                return std::static_pointer_cast<ZarrContainerParameters>(m_containerParameters)->getChunkWidth();
+            }
+
+            void setChunkWidth(int chunkWidth) {
+                std::static_pointer_cast<ZarrContainerParameters>(m_containerParameters)->setChunkWidth(chunkWidth);
+            }
+
+            int getChunkHeight() const {
+                return std::static_pointer_cast<ZarrContainerParameters>(m_containerParameters)->getChunkHeight();
+            }
+
+            void setChunkHeight(int chunkHeight) {
+                std::static_pointer_cast<ZarrContainerParameters>(m_containerParameters)->setChunkHeight(chunkHeight);
+            }
+
+            int getNumZoomLevels() const {
+                return std::static_pointer_cast<ZarrContainerParameters>(m_containerParameters)->getNumZoomLevels();
+            }
+
+            void setNumZoomLevels(int numZoomLevels) {
+                std::static_pointer_cast<ZarrContainerParameters>(m_containerParameters)->setNumZoomLevels(numZoomLevels);
+            }
+
+            int getNumReadingThreads() const {
+                return std::static_pointer_cast<ZarrContainerParameters>(m_containerParameters)->getNumReadingThreads();
+            }
+
+            void setNumReadingThreads(int numReadingThreads) {
+                std::static_pointer_cast<ZarrContainerParameters>(m_containerParameters)->setNumReadingThreads(numReadingThreads);
+            }
+
+            int getNumEncodingThreads() const {
+                return std::static_pointer_cast<ZarrContainerParameters>(m_containerParameters)->getNumEncodingThreads();
+            }
+
+            void setNumEncodingThreads(int numEncodingThreads) {
+                std::static_pointer_cast<ZarrContainerParameters>(m_containerParameters)->setNumEncodingThreads(numEncodingThreads);
+            }
+
+            int getLevel() const {
+                return std::static_pointer_cast<LosslessEncodeParameters>(m_encodeParameters)->getLevel();
+            }
+
+            void setLevel(int level) {
+                std::static_pointer_cast<LosslessEncodeParameters>(m_encodeParameters)->setLevel(level);
+            }
         };
     }
 }
@@ -6,6 +6,7 @@
 #include "slideio/base/exceptions.hpp"
 #include "slideio/core/tools/cvtools.hpp"
 #include "slideio/converter/converterparameters.hpp"
+#include <opencv2/imgproc.hpp>
 
 using namespace slideio;
 using namespace slideio::converter;
@@ -100,3 +101,41 @@ Rect ConverterTools::computeZoomLevelRect(const Rect& sceneRect,
     levelRect.height = ((levelRect.height - 1) / tileSize.height + 1) * tileSize.height;
     return levelRect;
 }
+
+bool ConverterTools::isBackgroundTile(const cv::Mat& tile, double tolerance, cv::Scalar& value) {
+    const int numChannels = tile.channels();
+    if (tile.empty() || numChannels > 4 || tolerance < 0) {
+        return false;
+    }
+    // a probe of at most 32x32 pixels rejects tissue tiles cheaply
+    const int step = std::max(1, std::min(tile.cols, tile.rows) / 32);
+    cv::Mat probe;
+    if (step > 1) {
+        cv::resize(tile, probe, cv::Size(tile.cols / step, tile.rows / step), 0, 0, cv::INTER_NEAREST);
+    }
+    else {
+        probe = tile;
+    }
+    cv::Scalar mean, stdDev;
+    cv::meanStdDev(probe, mean, stdDev);
+    for (int channel = 0; channel < numChannels; ++channel) {
+        if (stdDev[channel] > tolerance) {
+            return false;
+        }
+    }
+    const bool integerData = tile.depth() != CV_32F && tile.depth() != CV_64F && tile.depth() != CV_16F;
+    for (int channel = 0; channel < numChannels; ++channel) {
+        value[channel] = integerData ? std::round(mean[channel]) : mean[channel];
+    }
+    // the probe may miss small objects: the whole tile has to stay close to the value.
+    // Rows are compared with one reference row, no deviation image is allocated, and
+    // the first row off the value stops the check.
+    const cv::Mat reference(1, tile.cols, tile.type(), value);
+    const double maxDeviation = 3 * tolerance;
+    for (int row = 0; row < tile.rows; ++row) {
+        if (cv::norm(tile.row(row), reference, cv::NORM_INF) > maxDeviation) {
+            return false;
+        }
+    }
+    return true;
+}
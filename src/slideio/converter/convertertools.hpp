@@ -25,6 +25,10 @@ namespace slideio
             static void readTile(const std::shared_ptr <CVScene>& scene, const std::vector<int> channels, int zoomLevel, const cv::Rect& sceneBlockRect,
                 int slice, int frame, cv::OutputArray tile);
             static Rect computeZoomLevelRect(const Rect& sceneRect, const Size& tileSize, int zoomLevel);
+            // Checks whether a tile is near-uniform (glass background): the standard deviation of a
+            // sparse probe must not exceed the tolerance and no pixel may deviate from the mean by
+            // more than three tolerances. Returns the rounded mean in value.
+            static bool isBackgroundTile(const cv::Mat& tile, double tolerance, cv::Scalar& value);
 			static int computeNumTiles(const Size& imageSize, const Size& tileSize) {
                 const int numTilesX = (imageSize.width + tileSize.width - 1) / tileSize.width;
                 const int numTilesY = (imageSize.height + tileSize.height - 1) / tileSize.height;
@@ -6,6 +6,7 @@
 #include "convertertools.hpp"
 #include "slideio/core/cvscene.hpp"
 #include "slideio/core/tools/tools.hpp"
+#include "slideio/core/tools/tracing.hpp"
 #include "slideio/imagetools/tiffkeeper.hpp"
 #include "slideio/imagetools/tiffmessagehandler.hpp"
 #include "slideio/imagetools/libtiff.hpp"
@@ -20,6 +21,9 @@
 #include <condition_variable>
 #include <atomic>
 #include <unordered_map>
+#include <set>
+#include <sstream>
+#include <tuple>
 
 #include "slideio/base/log.hpp"
 #include "slideio/core/tools/boundedqueue.hpp"
@@ -72,7 +76,7 @@ int TiffConverter::computeChannelChunk(int firstChannel, const std::shared_ptr<C
             RAISE_RUNTIME_ERROR << "Converter: JPEG compression supports only 8-bit channels.";
         }
     }
-    else if (compression == Compression::Jpeg2000) {
+    else if (compression == Compression::Jpeg2000 || LosslessEncodeParameters::isLosslessCompression(compression)) {
         if (canGroupChannelsBy3) {
             channelChunkSize = 3;
         }
@@ -102,6 +106,9 @@ std::string TiffConverter::createSVSImageDescription() const {
     else if (m_parameters.getEncoding() == Compression::Jpeg2000) {
         buff << "J2K";
     }
+    else {
+        buff << m_parameters.getEncoding();
+    }
     buff << "\n";
     double magn = m_scene->getMagnification();
     Resolution resolution = m_scene->getResolution();
@@ -404,6 +411,12 @@ TiffDirectory TiffConverter::setUpDirectory(const TiffDirectoryStructure& page)
     if (m_parameters.getEncoding() == Compression::Jpeg || m_parameters.getEncoding() == Compression::Jpeg2000) {
         dir.slideioCompression = m_parameters.getEncoding();
     }
+    else if (LosslessEncodeParameters::isLosslessCompression(m_parameters.getEncoding())) {
+        dir.slideioCompression = m_parameters.getEncoding();
+        std::shared_ptr<const LosslessEncodeParameters> losslessParams =
+            std::static_pointer_cast<const LosslessEncodeParameters>(m_parameters.getEncodeParameters());
+        dir.predictor = static_cast<int>(losslessParams->resolvePredictor(dir.dataType));
+    }
     else {
         RAISE_RUNTIME_ERROR << "Converter: Unexpected compression type: " << (int)m_parameters.getEncoding();
     }
@@ -424,21 +437,6 @@ TiffDirectory TiffConverter::setUpDirectory(const TiffDirectoryStructure& page)
     return dir;
 }
 
-void TiffConverter::writeDirectoryData(TiffDirectory& dir, const TiffDirectoryStructure& page, const std::function<void(int)>& cb, int param) {
-    if (page.getZoomLevelRange().size() != 1) {
-        RAISE_RUNTIME_ERROR << "Converter: Invalid zoom level range in page! Expected: 1, received: " << page.
-            getZoomLevelRange().size();
-    }
-    if (m_parameters.getEncodeParameters()->getCompression() == Compression::Jpeg2000
-        || m_parameters.getEncodeParameters()->getCompression() == Compression::Jpeg
-        || param != 1) {
-        writeDirectoryDataMT(dir, page, cb, param);
-    }
-    else {
-        writeDirectoryDataST(dir, page, cb, param);
-    }
-}
-
 void TiffConverter::writeDirectoryDataST(TiffDirectory& dir, const TiffDirectoryStructure& page, const std::function<void(int)>& cb, int tileBatchSize) {
     if (page.getZoomLevelRange().size() != 1) {
         RAISE_RUNTIME_ERROR << "Converter: Invalid zoom level range in page! Expected: 1, received: " << page.getZoomLevelRange().size();
@@ -470,7 +468,10 @@ void TiffConverter::writeDirectoryDataST(TiffDirectory& dir, const TiffDirectory
             numTiles = std::max(1, numTiles);
             const int blockWidth = numTiles * sceneTileSize.width;
             cv::Rect blockRect(x, y, blockWidth, sceneTileSize.height);
-            ConverterTools::readTile(m_scene, channels, zoomLevel, blockRect, slice, frame, block);
+            {
+                TraceScope trace("read", "convert");
+                ConverterTools::readTile(m_scene, channels, zoomLevel, blockRect, slice, frame, block);
+            }
             if (block.rows != tileSize.height || block.cols != tileSize.width * numTiles) {
                 RAISE_RUNTIME_ERROR << "Converter: Unexpected tile size ("
                     << block.cols << ","
@@ -486,21 +487,18 @@ void TiffConverter::writeDirectoryDataST(TiffDirectory& dir, const TiffDirectory
                 cv::Mat tile;
                 block(tileRect).copyTo(tile);
                 const int tileWritePosX = zoomLevelRect.x + blockTile * tileSize.width;
-                m_file->writeTile(tileWritePosX, zoomLevelRect.y, dir.slideioCompression, *encoding, tile, buffer.data(), (int)buffer.size());
-                m_currentTile++;
-                if (cb) {
-                    double proc = 100. * (double)m_currentTile / (double)m_totalTiles;
-                    if (const int lproc = std::lround(proc); lproc != m_lastProgress) {
-                        cb(lproc);
-                        m_lastProgress = lproc;
-                    }
+                {
+                    TraceScope trace("encode and write", "convert");
+                    m_file->writeTile(tileWritePosX, zoomLevelRect.y, dir.slideioCompression, *encoding, tile, buffer.data(), (int)buffer.size());
                 }
+                updateProgress(cb);
             }
         }
     }
 }
 
-void TiffConverter::createTileQueue(const TiffDirectory& dir, const TiffDirectoryStructure& page, int tileBatchSize, std::queue<Block>& queue)
+size_t TiffConverter::createTileQueue(const TiffDirectory& dir, const TiffDirectoryStructure& page, int tileBatchSize,
+    std::queue<Block>& queue, size_t firstTileSequenceId, int directoryIndex)
 {
     const int zoomLevel = page.getZoomLevelRange().start;
     const cv::Size tileSize = cv::Size(dir.tileWidth, dir.tileHeight);
@@ -510,7 +508,7 @@ void TiffConverter::createTileQueue(const TiffDirectory& dir, const TiffDirector
     const int numTileCols = 1 + (m_cropRect.width - 1) / sceneTileSize.width;
     const int safeTileBatchSize = std::max(1, tileBatchSize);
     const int batchWidth = safeTileBatchSize * sceneTileSize.width;
-	size_t iTile = 0;
+	size_t iTile = firstTileSequenceId;
     for (int y = m_cropRect.y; y < yEnd; y += sceneTileSize.height) {
         for (int x = m_cropRect.x; x < xEnd; x += batchWidth) {
             int numTiles = 1 + (xEnd - x - 1) / sceneTileSize.width;
@@ -521,10 +519,12 @@ void TiffConverter::createTileQueue(const TiffDirectory& dir, const TiffDirector
             Block block;
             block.rect = blockRect;
             block.firstTileSequenceId = iTile;
+            block.directoryIndex = directoryIndex;
             queue.emplace(block);
 			iTile += numTiles;
         }
     }
+    return iTile;
 }
 
 std::pair<std::shared_ptr<Slide>, std::shared_ptr<Scene>> TiffConverter::cloneScene() const {
@@ -536,26 +536,23 @@ std::pair<std::shared_ptr<Slide>, std::shared_ptr<Scene>> TiffConverter::cloneSc
 	return { slide, scene };
 }
 
-void TiffConverter::readTiles(const TiffDirectory& dir, const TiffDirectoryStructure& page, BoundedQueue<Tile>& inputQueue,
+void TiffConverter::readTiles(const std::vector<DirectoryTask>& tasks, BoundedQueue<Tile>& inputQueue,
 							  std::queue<Block>& blockQueue, std::mutex& blockQueueMutex, std::atomic<size_t>& activeReaders,
 							  std::exception_ptr& readerException, std::mutex& exceptionMutex) {
-	int zoomLevel = page.getZoomLevelRange().start;
-	cv::Size tileSize = cv::Size(dir.tileWidth, dir.tileHeight);
-	cv::Size sceneTileSize = ConverterTools::scaleSize(tileSize, zoomLevel, false);
-	const int slice = page.getZSliceRange().start;
-	const int frame = page.getTFrameRange().start;
-	std::vector<int> channels;
-	channels.reserve(dir.channels);
-	for (int channel = 0; channel < dir.channels; ++channel) {
-		channels.push_back(page.getChannelRange().start + channel);
-	}
+	// the scene is cloned once per reader and serves every directory of the file
 	auto clone = cloneScene();
 	auto slide = clone.first;
 	auto scene = clone.second;
 	int64_t localIdleNs = 0;
+	std::shared_ptr<const TIFFContainerParameters> tiffParams =
+		std::static_pointer_cast<const TIFFContainerParameters>(m_parameters.getContainerParameters());
+	const bool backgroundDetection = tiffParams->getBackgroundDetection();
+	const double backgroundTolerance = tiffParams->getBackgroundTolerance();
+	Tracer::setThreadName("converter reader");
 
 	try {
 		cv::Mat block;
+		std::vector<int> channels;
 		while (true) {
 			Block currentBlock;
 			{
@@ -566,9 +563,24 @@ void TiffConverter::readTiles(const TiffDirectory& dir, const TiffDirectoryStruc
 				currentBlock = blockQueue.front();
 				blockQueue.pop();
 			}
+			const DirectoryTask& task = tasks[currentBlock.directoryIndex];
+			const TiffDirectory& dir = task.dir;
+			const TiffDirectoryStructure& page = *task.structure;
+			const int zoomLevel = page.getZoomLevelRange().start;
+			const cv::Size tileSize = cv::Size(dir.tileWidth, dir.tileHeight);
+			const cv::Size sceneTileSize = ConverterTools::scaleSize(tileSize, zoomLevel, false);
+			const int slice = page.getZSliceRange().start;
+			const int frame = page.getTFrameRange().start;
+			channels.clear();
+			for (int channel = 0; channel < dir.channels; ++channel) {
+				channels.push_back(page.getChannelRange().start + channel);
+			}
 			const cv::Rect& blockRect = currentBlock.rect;
 			const int numTiles = blockRect.width / sceneTileSize.width;
-			ConverterTools::readTile(scene->getCVScene(), channels, zoomLevel, blockRect, slice, frame, block);
+			{
+				TraceScope trace("read", "convert");
+				ConverterTools::readTile(scene->getCVScene(), channels, zoomLevel, blockRect, slice, frame, block);
+			}
 			if (block.rows != tileSize.height || block.cols != tileSize.width * numTiles) {
 				RAISE_RUNTIME_ERROR << "Converter: Unexpected tile size ("
 					<< block.cols << ","
@@ -588,13 +600,20 @@ void TiffConverter::readTiles(const TiffDirectory& dir, const TiffDirectoryStruc
 				block(tileRect).copyTo(tileInfo.raster);
 				const int tileWritePosX = zoomLevelRect.x + blockTile * tileSize.width;
 				tileInfo.location = cv::Point2i(tileWritePosX, zoomLevelRect.y);
+				tileInfo.directoryIndex = currentBlock.directoryIndex;
+				if (backgroundDetection) {
+					tileInfo.background = ConverterTools::isBackgroundTile(tileInfo.raster, backgroundTolerance,
+						tileInfo.backgroundValue);
+				}
 				auto pushStart = std::chrono::steady_clock::now();
-				if (!inputQueue.push(std::move(tileInfo))) {
-					localIdleNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - pushStart).count();
+				const bool pushed = inputQueue.push(std::move(tileInfo));
+				auto pushEnd = std::chrono::steady_clock::now();
+				localIdleNs += std::chrono::duration_cast<std::chrono::nanoseconds>(pushEnd - pushStart).count();
+				Tracer::addEvent("queue wait", "convert", pushStart, pushEnd);
+				if (!pushed) {
 					done = true;
 					break;
 				}
-				localIdleNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - pushStart).count();
 			}
 			if (done) {
 				break;
@@ -649,32 +668,132 @@ std::vector<uint8_t> TiffConverter::encodeTile(const cv::Mat& tileRaster) {
         ImageTools::encodeJpegAbbreviated(tileRaster, buff, *jpegParams);
         return buff;
     }
+    else if (LosslessEncodeParameters::isLosslessCompression(compression)) {
+        // The predictor is applied by the encoder; the directory carries the matching
+        // TIFFTAG_PREDICTOR, so the result is written verbatim by writeRawTile.
+        std::vector<uint8_t> buff;
+        std::shared_ptr<const LosslessEncodeParameters> losslessParams =
+            std::static_pointer_cast<const LosslessEncodeParameters>(m_parameters.getEncodeParameters());
+        ImageTools::encodeLossless(tileRaster, buff, *losslessParams);
+        return buff;
+    }
     else {
         RAISE_RUNTIME_ERROR << "Unsupported compression type for multi-threaded encoding.";
     }
 }
 
+std::vector<uint8_t> TiffConverter::encodeBackgroundTile(const Tile& tile) {
+    const int numChannels = tile.raster.channels();
+    std::pair<int, std::vector<double>> key(tile.directoryIndex,
+        std::vector<double>(tile.backgroundValue.val, tile.backgroundValue.val + numChannels));
+    // the lock guards the map only: the first encoder of a value encodes and writes
+    // the blank tile, background tiles of other encoders wait for its future
+    std::promise<BackgroundTile> promise;
+    std::shared_future<BackgroundTile> future;
+    bool owner = false;
+    {
+        std::lock_guard<std::mutex> lock(m_backgroundMutex);
+        auto it = m_backgroundTiles.find(key);
+        if (it == m_backgroundTiles.end()) {
+            future = promise.get_future().share();
+            m_backgroundTiles.emplace(std::move(key), future);
+            owner = true;
+        }
+        else {
+            future = it->second;
+        }
+    }
+    if (owner) {
+        try {
+            const cv::Mat blank(tile.raster.size(), tile.raster.type(), tile.backgroundValue);
+            BackgroundTile background;
+            background.encodedData = encodeTile(blank);
+            if (m_parallelWriter) {
+                const std::vector<uint8_t>& data = background.encodedData;
+                background.offset = m_parallelWriter->writeTile(tile.directoryIndex, tile.location.x, tile.location.y,
+                    data.data(), data.size());
+                journalTile(tile.directoryIndex, tile.location, background.offset, data.size());
+            }
+            promise.set_value(std::move(background));
+        }
+        catch (...) {
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+    const BackgroundTile& background = future.get();
+    if (m_parallelWriter) {
+        if (!owner) {
+            m_parallelWriter->writeTileReference(tile.directoryIndex, tile.location.x, tile.location.y,
+                background.offset, background.encodedData.size());
+            journalTile(tile.directoryIndex, tile.location, background.offset, background.encodedData.size());
+        }
+        // the tile is already in the file
+        return {};
+    }
+    return background.encodedData;
+}
+
+void TiffConverter::updateProgress(const std::function<void(int)>& cb) {
+    m_currentTile++;
+    if (cb) {
+        double proc = 100. * (double)m_currentTile / (double)m_totalTiles;
+        if (const int lproc = std::lround(proc); lproc != m_lastProgress) {
+            cb(lproc);
+            m_lastProgress = lproc;
+        }
+    }
+}
+
 void TiffConverter::encodeTiles(BoundedQueue<Tile>& inputQueue, BoundedQueue<EncodedTile>& outputQueue,
-                                std::atomic<size_t>& activeEncoders, std::exception_ptr& encoderException, std::mutex& encoderExMutex) {
+                                const std::function<void(int)>& cb, std::atomic<size_t>& activeEncoders,
+                                std::exception_ptr& encoderException, std::mutex& encoderExMutex) {
     int64_t localIdleNs = 0;
+    Tracer::setThreadName("converter encoder");
     try {
         while (true) {
             auto popStart = std::chrono::steady_clock::now();
             std::optional<Tile> tile = inputQueue.pop();
-            localIdleNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - popStart).count();
+            auto popEnd = std::chrono::steady_clock::now();
+            localIdleNs += std::chrono::duration_cast<std::chrono::nanoseconds>(popEnd - popStart).count();
+            Tracer::addEvent("queue wait", "convert", popStart, popEnd);
             if (!tile) {
                 break;
             }
             EncodedTile encoded;
             encoded.sequenceId = tile->sequenceId;
             encoded.location = tile->location;
-            encoded.encodedData = encodeTile(tile->raster);
+            encoded.background = tile->background;
+            if (tile->background) {
+                ++m_numBackgroundTiles;
+                TraceScope trace("encode background", "convert");
+                encoded.encodedData = encodeBackgroundTile(*tile);
+            }
+            else {
+                TraceScope trace("encode", "convert");
+                encoded.encodedData = encodeTile(tile->raster);
+            }
+            if (m_parallelWriter) {
+                // tiles land at preallocated offsets in any order: no writer thread, no reordering
+                if (!tile->background) {
+                    TraceScope trace("write", "convert");
+                    const std::vector<uint8_t>& data = encoded.encodedData;
+                    const uint64_t offset = m_parallelWriter->writeTile(tile->directoryIndex,
+                        encoded.location.x, encoded.location.y, data.data(), data.size());
+                    journalTile(tile->directoryIndex, encoded.location, offset, data.size());
+                }
+                std::lock_guard<std::mutex> lock(m_progressMutex);
+                updateProgress(cb);
+                continue;
+            }
             auto pushStart = std::chrono::steady_clock::now();
-            if (!outputQueue.push(std::move(encoded))) {
-                localIdleNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - pushStart).count();
+            const bool pushed = outputQueue.push(std::move(encoded));
+            auto pushEnd = std::chrono::steady_clock::now();
+            localIdleNs += std::chrono::duration_cast<std::chrono::nanoseconds>(pushEnd - pushStart).count();
+            Tracer::addEvent("queue wait", "convert", pushStart, pushEnd);
+            if (!pushed) {
                 break;
             }
-            localIdleNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - pushStart).count();
         }
     }
     catch (const std::exception& e) {
@@ -701,22 +820,43 @@ void TiffConverter::encodeTiles(BoundedQueue<Tile>& inputQueue, BoundedQueue<Enc
 }
 
 void TiffConverter::writeTile(const EncodedTile& tile)  {
+    TraceScope trace("write", "convert");
     const cv::Point2i& loc = tile.location;
     const std::vector<uint8_t>& buffer = tile.encodedData;
+    if (tile.background) {
+        // a blank tile of a value is written once per directory, the other tiles of
+        // the value share its offset and byte count
+        auto it = m_writtenBackgroundTiles.find(buffer);
+        if (it != m_writtenBackgroundTiles.end()) {
+            m_file->writeRawTileReference(loc.x, loc.y, it->second.x, it->second.y);
+            return;
+        }
+        m_file->writeRawTile(loc.x, loc.y, buffer.data(), static_cast<int>(buffer.size()));
+        m_writtenBackgroundTiles.emplace(buffer, loc);
+        return;
+    }
     m_file->writeRawTile(loc.x, loc.y, buffer.data(), static_cast<int>(buffer.size()));
 }
 
-void TiffConverter::writeTiles(BoundedQueue<Tile>& inputQueue, BoundedQueue<EncodedTile>& outputQueue, const std::function<void(int)>& cb,
+void TiffConverter::writeTiles(const std::vector<DirectoryTask>& tasks, BoundedQueue<Tile>& inputQueue,
+    BoundedQueue<EncodedTile>& outputQueue, const std::function<void(int)>& cb,
     std::exception_ptr& writerException, std::mutex& exceptionMutex) {
     std::unordered_map<size_t, EncodedTile> reorderBuffer; // Holds out-of-order tiles
     size_t nextExpected = 0;
+    size_t currentDirectory = 0;
     int64_t localIdleNs = 0;
+    Tracer::setThreadName("converter writer");
 
     try {
+        if (!tasks.empty()) {
+            startDirectory(tasks.front());
+        }
         while (true) {
             auto popStart = std::chrono::steady_clock::now();
             auto encoded = outputQueue.pop();
-            localIdleNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - popStart).count();
+            auto popEnd = std::chrono::steady_clock::now();
+            localIdleNs += std::chrono::duration_cast<std::chrono::nanoseconds>(popEnd - popStart).count();
+            Tracer::addEvent("queue wait", "convert", popStart, popEnd);
             if (!encoded) {
                 break;
             }
@@ -729,15 +869,18 @@ void TiffConverter::writeTiles(BoundedQueue<Tile>& inputQueue, BoundedQueue<Enco
                 }
                 writeTile(it->second);  // Fast I/O
                 reorderBuffer.erase(it);
-                m_currentTile++;
-                if (cb) {
-                    double proc = 100. * (double)m_currentTile / (double)m_totalTiles;
-                    if (const int lproc = std::lround(proc); lproc != m_lastProgress) {
-                        cb(lproc);
-                        m_lastProgress = lproc;
+                updateProgress(cb);
+                ++nextExpected;
+                // directories are written in file order: the last tile of a directory closes it
+                // while tiles of the following directories are already being read and encoded
+                while (currentDirectory < tasks.size() && nextExpected == tasks[currentDirectory].endTileSequenceId) {
+                    TraceScope trace("write directory", "convert");
+                    m_file->writeDirectory();
+                    ++currentDirectory;
+                    if (currentDirectory < tasks.size()) {
+                        startDirectory(tasks[currentDirectory]);
                     }
                 }
-                ++nextExpected;
             }
         }
     }
@@ -764,8 +907,8 @@ void TiffConverter::writeTiles(BoundedQueue<Tile>& inputQueue, BoundedQueue<Enco
     m_writerIdleTimeNs.fetch_add(localIdleNs, std::memory_order_relaxed);
 }
 
-void TiffConverter::writeDirectoryDataMT(TiffDirectory& dir, const TiffDirectoryStructure& page,
-                                         const std::function<void(int)>& cb, int tileBatchSize) {
+void TiffConverter::writeDirectoriesMT(const std::vector<DirectoryTask>& tasks, std::queue<Block>& blockQueue,
+                                       const std::function<void(int)>& cb) {
     m_readersIdleTimeNs.store(0, std::memory_order_relaxed);
     m_encodersIdleTimeNs.store(0, std::memory_order_relaxed);
     m_writerIdleTimeNs.store(0, std::memory_order_relaxed);
@@ -784,16 +927,14 @@ void TiffConverter::writeDirectoryDataMT(TiffDirectory& dir, const TiffDirectory
     numReadingThreads = std::max(1, numReadingThreads);
     m_numReaderThreads = numReadingThreads;
     m_numEncoderThreads = numEncoderThreads;
-    const int safeTileBatchSize = std::max(1, tileBatchSize);
+    m_numWriterThreads = m_parallelWriter ? numEncoderThreads : 1;
     const size_t QUEUE_DEPTH = std::max(static_cast<size_t>(2), static_cast<size_t>(numEncoderThreads) * 2); // Bound memory usage
 
     BoundedQueue<Tile> inputQueue(QUEUE_DEPTH);
     BoundedQueue<EncodedTile> outputQueue(QUEUE_DEPTH);
 
-    // Create block queue for readers
-    std::queue<Block> blockQueue;
+    // Block queue for readers holds the blocks of all directories in file order
     std::mutex blockQueueMutex;
-    createTileQueue(dir, page, safeTileBatchSize, blockQueue);
 
     // Shared exception handling
     std::exception_ptr readerException;
@@ -806,7 +947,7 @@ void TiffConverter::writeDirectoryDataMT(TiffDirectory& dir, const TiffDirectory
     readers.reserve(numReadingThreads);
     std::atomic<size_t> activeReaders{ static_cast<size_t>(numReadingThreads) };
     for (int reader = 0; reader < numReadingThreads; ++reader) {
-        readers.emplace_back(&TiffConverter::readTiles, this, std::cref(dir), std::cref(page), std::ref(inputQueue),
+        readers.emplace_back(&TiffConverter::readTiles, this, std::cref(tasks), std::ref(inputQueue),
             std::ref(blockQueue), std::ref(blockQueueMutex), std::ref(activeReaders), std::ref(readerException), std::ref(exceptionMutex));
     }
 
@@ -816,12 +957,16 @@ void TiffConverter::writeDirectoryDataMT(TiffDirectory& dir, const TiffDirectory
 
     for (int i = 0; i < numEncoderThreads; ++i) {
         encoders.emplace_back(&TiffConverter::encodeTiles, this, std::ref(inputQueue), std::ref(outputQueue),
-            std::ref(activeEncoders), std::ref(encoderException), std::ref(exceptionMutex));
+            std::cref(cb), std::ref(activeEncoders), std::ref(encoderException), std::ref(exceptionMutex));
     }
 
-    // --- Stage 3: Writer (single thread, ordered) ---
-    std::thread writer(&TiffConverter::writeTiles, this, std::ref(inputQueue), std::ref(outputQueue), std::ref(cb),
-        std::ref(writerException), std::ref(exceptionMutex));
+    // --- Stage 3: Writer (single thread, ordered, owns the libtiff handle) ---
+    // With the parallel writer the encoders write their tiles themselves.
+    std::thread writer;
+    if (!m_parallelWriter) {
+        writer = std::thread(&TiffConverter::writeTiles, this, std::cref(tasks), std::ref(inputQueue), std::ref(outputQueue),
+            std::ref(cb), std::ref(writerException), std::ref(exceptionMutex));
+    }
 
     auto joinAll = [&]() {
         for (auto& r : readers) {
@@ -855,38 +1000,238 @@ void TiffConverter::writeDirectoryDataMT(TiffDirectory& dir, const TiffDirectory
 }
 
 
+std::vector<TiffConverter::DirectoryTask> TiffConverter::createDirectoryTasks() {
+    std::vector<DirectoryTask> tasks;
+    for (int pageIndex = 0; pageIndex < getNumTiffPages(); ++pageIndex) {
+        const TiffPageStructure& page = getTiffPage(pageIndex);
+        DirectoryTask& pageTask = tasks.emplace_back();
+        pageTask.dir = setUpDirectory(page);
+        pageTask.structure = &page;
+        pageTask.numSubDirectories = page.getNumSubDirectories();
+        const int pageTaskIndex = static_cast<int>(tasks.size()) - 1;
+        for (int subDirIndex = 0; subDirIndex < page.getNumSubDirectories(); ++subDirIndex) {
+            const TiffDirectoryStructure& dirSpec = page.getSubDirectory(subDirIndex);
+            DirectoryTask& subDirTask = tasks.emplace_back();
+            subDirTask.parentIndex = pageTaskIndex;
+            subDirTask.dir = setUpDirectory(dirSpec);
+            subDirTask.dir.subFileType = FILETYPE_REDUCEDIMAGE;
+            subDirTask.structure = &dirSpec;
+        }
+    }
+    for (const auto& task : tasks) {
+        if (task.structure->getZoomLevelRange().size() != 1) {
+            RAISE_RUNTIME_ERROR << "Converter: Invalid zoom level range in page! Expected: 1, received: "
+                << task.structure->getZoomLevelRange().size();
+        }
+    }
+    return tasks;
+}
+
+void TiffConverter::startDirectory(const DirectoryTask& task) {
+    m_writtenBackgroundTiles.clear();
+    m_file->setTags(task.dir);
+    if (task.numSubDirectories > 0) {
+        m_file->initSubDirs(task.numSubDirectories);
+    }
+}
+
 void TiffConverter::createTiff(const std::string& filePath, const std::function<void(int)>& cb, int tileBatchSize) {
     TIFFMessageHandler mh;
+    TraceScope trace("convert", "convert");
     m_currentTile = 0;
-    m_file.reset(new TIFFKeeper(filePath, false));
+    m_numBackgroundTiles = 0;
+    m_backgroundTiles.clear();
+    m_writtenBackgroundTiles.clear();
+    std::shared_ptr<const TIFFContainerParameters> tiffParams =
+        std::static_pointer_cast<const TIFFContainerParameters>(m_parameters.getContainerParameters());
+    const bool resumable = tiffParams->getResumable();
+    // only the parallel writer can continue a partial file: libtiff keeps its
+    // directory state in memory until the file is closed
+    const bool parallelWriting = tiffParams->getParallelWriting() || resumable;
+    m_numResumedTiles = 0;
+    m_file.reset();
+    m_parallelWriter.reset();
+    m_journal.reset();
+    if (!parallelWriting) {
+        m_file.reset(new TIFFKeeper(filePath, false));
+    }
     m_filePath = filePath;
     std::string description = createImageDescriptionTag();
     if (!m_pages.empty()) {
         m_pages.front().setDescription(description);
     }
-    for (int pageIndex = 0; pageIndex < getNumTiffPages(); ++pageIndex) {
-        const TiffPageStructure& page = getTiffPage(pageIndex);
-        TiffDirectory dir = setUpDirectory(page);
-        m_file->setTags(dir);
-        const int numSubDirs = page.getNumSubDirectories();
-        if (numSubDirs > 0) {
-            m_file->initSubDirs(numSubDirs);
-        }
-        writeDirectoryData(dir, page, cb, tileBatchSize);
-        m_file->writeDirectory();
-        const int numSubdirs = page.getNumSubDirectories();
-        for (int subDirIndex = 0; subDirIndex < numSubdirs; ++subDirIndex) {
-            const TiffDirectoryStructure& dirSpec = page.getSubDirectory(subDirIndex);
-            TiffDirectory subDir = setUpDirectory(dirSpec);
-            subDir.subFileType = FILETYPE_REDUCEDIMAGE;
-            m_file->setTags(subDir);
-            writeDirectoryData(subDir, dirSpec, cb, tileBatchSize);
+    std::vector<DirectoryTask> tasks = createDirectoryTasks();
+    const Compression compression = m_parameters.getEncodeParameters()->getCompression();
+    if (parallelWriting || compression == Compression::Jpeg2000 || compression == Compression::Jpeg
+        || LosslessEncodeParameters::isLosslessCompression(compression) || tileBatchSize != 1) {
+        // One pipeline serves the whole file: blocks of every directory are queued up front,
+        // so reading and encoding of later directories overlaps writing of earlier ones.
+        std::queue<Block> blockQueue;
+        const int safeTileBatchSize = std::max(1, tileBatchSize);
+        size_t sequenceId = 0;
+        for (int taskIndex = 0; taskIndex < static_cast<int>(tasks.size()); ++taskIndex) {
+            DirectoryTask& task = tasks[taskIndex];
+            task.firstTileSequenceId = sequenceId;
+            sequenceId = createTileQueue(task.dir, *task.structure, safeTileBatchSize, blockQueue, sequenceId, taskIndex);
+            task.endTileSequenceId = sequenceId;
+        }
+        if (parallelWriting) {
+            try {
+                openParallelWriter(filePath, tasks, resumable);
+                skipWrittenBlocks(tasks, blockQueue);
+                writeDirectoriesMT(tasks, blockQueue, cb);
+                m_parallelWriter->finalize();
+            }
+            catch (...) {
+                // the journal stays on disk, so the conversion can be resumed
+                if (m_journal) {
+                    try {
+                        m_journal->flush();
+                    }
+                    catch (const std::exception& e) {
+                        SLIDEIO_LOG(WARNING) << "Converter: cannot write the journal of " << filePath << ": " << e.what();
+                    }
+                }
+                m_parallelWriter.reset();
+                m_journal.reset();
+                throw;
+            }
+            m_parallelWriter.reset();
+            if (m_journal) {
+                m_journal->remove();
+                m_journal.reset();
+            }
+        }
+        else {
+            writeDirectoriesMT(tasks, blockQueue, cb);
+        }
+    }
+    else {
+        for (auto& task : tasks) {
+            startDirectory(task);
+            writeDirectoryDataST(task.dir, *task.structure, cb, tileBatchSize);
             m_file->writeDirectory();
         }
     }
 }
 
 
+std::string TiffConverter::createLayoutSignature(const std::vector<DirectoryTask>& tasks) const {
+    // Everything that decides where tiles go and how they are encoded. A journal written
+    // for another signature describes a different file and is not resumed.
+    std::ostringstream signature;
+    signature << m_scene->getFilePath() << "|" << m_scene->getSceneIndex()
+        << "|" << m_cropRect.x << "," << m_cropRect.y << "," << m_cropRect.width << "," << m_cropRect.height;
+    std::shared_ptr<const EncodeParameters> encodeParams = m_parameters.getEncodeParameters();
+    const Compression compression = encodeParams->getCompression();
+    signature << "|" << static_cast<int>(compression);
+    if (compression == Compression::Jpeg2000) {
+        auto jp2kParams = std::static_pointer_cast<const JP2KEncodeParameters>(encodeParams);
+        signature << "," << jp2kParams->getCompressionRate() << "," << jp2kParams->getHighThroughput()
+            << "," << jp2kParams->getQuantizationStep();
+    }
+    else if (LosslessEncodeParameters::isLosslessCompression(compression)) {
+        signature << "," << std::static_pointer_cast<const LosslessEncodeParameters>(encodeParams)->getLevel();
+    }
+    for (const auto& task : tasks) {
+        const TiffDirectory& dir = task.dir;
+        signature << "|" << task.parentIndex << ":" << dir.width << "x" << dir.height
+            << ":" << dir.tileWidth << "x" << dir.tileHeight << ":" << dir.channels
+            << ":" << static_cast<int>(dir.dataType) << ":" << dir.compressionQuality << ":" << dir.predictor;
+    }
+    return signature.str();
+}
+
+void TiffConverter::openParallelWriter(const std::string& filePath, const std::vector<DirectoryTask>& tasks,
+                                       bool resumable) {
+    auto createWriter = [this, &filePath, &tasks](bool resume) {
+        m_parallelWriter = std::make_shared<TiffParallelWriter>(filePath, resume);
+        for (const auto& task : tasks) {
+            m_parallelWriter->addDirectory(task.dir, task.parentIndex);
+        }
+        m_parallelWriter->beginWriting();
+    };
+    if (!resumable) {
+        createWriter(false);
+        return;
+    }
+    const std::string layout = createLayoutSignature(tasks);
+    m_journal = std::make_shared<ConversionJournal>(ConversionJournal::getJournalPath(filePath));
+    bool resume = std::filesystem::exists(filePath) && m_journal->load(layout);
+    createWriter(resume);
+    if (resume && m_journal->getMetadataSize() != m_parallelWriter->getMetadataSize()) {
+        // the directory region changed size (e.g. a longer description): the old tiles may overlap it
+        SLIDEIO_LOG(WARNING) << "Converter: journal " << m_journal->getPath()
+            << " does not match the file layout. Conversion starts from the beginning.";
+        resume = false;
+        m_parallelWriter.reset();
+        createWriter(false);
+    }
+    // the writer is final here: a batch of records is journaled once its tiles are synced
+    m_journal->setDataSync([this]() { m_parallelWriter->sync(); });
+    if (!resume) {
+        m_journal->start(layout, m_parallelWriter->getMetadataSize());
+        return;
+    }
+    for (const auto& record : m_journal->getRecords()) {
+        m_parallelWriter->restoreTile(record.directoryIndex, record.x, record.y, record.offset, record.size);
+    }
+    m_journal->resume();
+    SLIDEIO_LOG(INFO) << "Converter: resuming conversion of " << filePath << " with "
+        << m_journal->getRecords().size() << " journaled tiles";
+}
+
+void TiffConverter::skipWrittenBlocks(const std::vector<DirectoryTask>& tasks, std::queue<Block>& blockQueue) {
+    if (!m_journal || m_journal->getRecords().empty()) {
+        return;
+    }
+    std::set<std::tuple<int, int, int>> writtenTiles;
+    for (const auto& record : m_journal->getRecords()) {
+        writtenTiles.emplace(record.directoryIndex, record.x, record.y);
+    }
+    // A block is skipped when all its tiles are in the journal. Partially written blocks
+    // are converted again; their new tiles replace the journaled ones.
+    std::queue<Block> pendingBlocks;
+    while (!blockQueue.empty()) {
+        const Block block = blockQueue.front();
+        blockQueue.pop();
+        const DirectoryTask& task = tasks[block.directoryIndex];
+        const int zoomLevel = task.structure->getZoomLevelRange().start;
+        const cv::Size tileSize(task.dir.tileWidth, task.dir.tileHeight);
+        const cv::Size sceneTileSize = ConverterTools::scaleSize(tileSize, zoomLevel, false);
+        const int numTiles = block.rect.width / sceneTileSize.width;
+        cv::Rect adjustedRect = block.rect;
+        adjustedRect.x -= m_cropRect.x;
+        adjustedRect.y -= m_cropRect.y;
+        const cv::Rect zoomLevelRect = ConverterTools::scaleRect(adjustedRect, zoomLevel, true);
+        bool written = true;
+        for (int blockTile = 0; blockTile < numTiles && written; ++blockTile) {
+            written = writtenTiles.count({ block.directoryIndex, zoomLevelRect.x + blockTile * tileSize.width,
+                zoomLevelRect.y }) > 0;
+        }
+        if (written) {
+            m_numResumedTiles += numTiles;
+        }
+        else {
+            pendingBlocks.push(block);
+        }
+    }
+    blockQueue.swap(pendingBlocks);
+    m_currentTile = m_numResumedTiles;
+}
+
+void TiffConverter::journalTile(int directoryIndex, const cv::Point2i& location, uint64_t offset, size_t size) {
+    if (m_journal) {
+        ConversionJournal::Record record;
+        record.directoryIndex = directoryIndex;
+        record.x = location.x;
+        record.y = location.y;
+        record.offset = offset;
+        record.size = size;
+        m_journal->append(record);
+    }
+}
+
 void TiffConverter::makeSureValid() const {
     if (m_scene == nullptr || m_parameters.getFormat() == ImageFormat::Unknown || !m_parameters.isValid()) {
         RAISE_RUNTIME_ERROR << "Converter: TiffStructure is not initialized";
@@ -4,10 +4,14 @@
 #pragma once
 #include "slideio/converter/converter_def.hpp"
 #include "slideio/imagetools/tiffkeeper.hpp"
+#include "slideio/imagetools/tiffparallelwriter.hpp"
 #include "slideio/converter/converterparameters.hpp"
 #include "slideio/converter/tiffstructure.hpp"
+#include "slideio/converter/conversionjournal.hpp"
 #include "slideio/core/tools/boundedqueue.hpp"
+#include <map>
 #include <mutex>
+#include <future>
 #include <chrono>
 #include <atomic>
 
@@ -40,8 +44,11 @@ namespace slideio
 				, m_readersIdleTimeNs(other.m_readersIdleTimeNs.load())
 				, m_encodersIdleTimeNs(other.m_encodersIdleTimeNs.load())
 				, m_writerIdleTimeNs(other.m_writerIdleTimeNs.load())
+				, m_numBackgroundTiles(other.m_numBackgroundTiles.load())
+				, m_numResumedTiles(other.m_numResumedTiles)
 				, m_numReaderThreads(other.m_numReaderThreads)
-				, m_numEncoderThreads(other.m_numEncoderThreads) {}
+				, m_numEncoderThreads(other.m_numEncoderThreads)
+				, m_numWriterThreads(other.m_numWriterThreads) {}
 			TiffConverter& operator=(const TiffConverter& other) {
 				if (this != &other) {
 					m_pages = other.m_pages;
@@ -56,8 +63,11 @@ namespace slideio
 					m_readersIdleTimeNs.store(other.m_readersIdleTimeNs.load());
 					m_encodersIdleTimeNs.store(other.m_encodersIdleTimeNs.load());
 					m_writerIdleTimeNs.store(other.m_writerIdleTimeNs.load());
+					m_numBackgroundTiles.store(other.m_numBackgroundTiles.load());
+					m_numResumedTiles = other.m_numResumedTiles;
 					m_numReaderThreads = other.m_numReaderThreads;
 					m_numEncoderThreads = other.m_numEncoderThreads;
+					m_numWriterThreads = other.m_numWriterThreads;
 				}
 				return *this;
 			}
@@ -67,16 +77,29 @@ namespace slideio
 			struct Block {
 				cv::Rect rect;              // Block rectangle in the source image
 				size_t firstTileSequenceId; // Preserves original read order
+				int directoryIndex = 0;     // Directory the block belongs to, in file order
 			};
 			struct Tile {
 				size_t sequenceId;      // Preserves original read order
 				cv::Mat raster;         // Tile pixel data 
 				cv::Point2i location;   // Location of the tile in the target image
+				int directoryIndex = 0; // Directory the tile belongs to, in file order
+				bool background = false; // Near-uniform tile, replaced by backgroundValue
+				cv::Scalar backgroundValue;
 			};
 			struct EncodedTile {
 				size_t sequenceId;                  // Preserves original read order
 				std::vector<uint8_t> encodedData;   // Encoded tile data
 				cv::Point2i location;               // Location of the tile in the target image
+				bool background = false;            // encodedData is the shared blank tile of its value
+			};
+			struct DirectoryTask {
+				TiffDirectory dir;                          // Tags of the directory
+				const TiffDirectoryStructure* structure = nullptr; // Page or sub-directory specification
+				int numSubDirectories = 0;                  // SubIFDs reserved for a page
+				size_t firstTileSequenceId = 0;             // First tile of the directory in the write order
+				size_t endTileSequenceId = 0;               // One past the last tile of the directory
+				int parentIndex = -1;                       // Page task of a sub-directory
 			};
 		public:
             void createFileLayout(const std::shared_ptr<CVScene>& scene, const ConverterParameters& parameters);
@@ -113,9 +136,20 @@ namespace slideio
 				return m_numEncoderThreads;
 			}
 			int getNumWriterThreads() const {
-				return 1;
+				return m_numWriterThreads;
+			}
+			// Number of tiles detected as background during the last conversion.
+			int getNumBackgroundTiles() const {
+				return m_numBackgroundTiles.load();
+			}
+			// Number of tiles taken over from an interrupted conversion by the last createTiff.
+			int getNumResumedTiles() const {
+				return m_numResumedTiles;
 			}
-            void createTileQueue(const TiffDirectory& dir, const TiffDirectoryStructure& page, int tileBatchSize, std::queue<Block>& queue);
+            // Appends blocks of a directory to the queue. Tile sequence ids start at firstTileSequenceId;
+            // returns the sequence id following the last tile of the directory.
+            size_t createTileQueue(const TiffDirectory& dir, const TiffDirectoryStructure& page, int tileBatchSize,
+                std::queue<Block>& queue, size_t firstTileSequenceId = 0, int directoryIndex = 0);
 			virtual std::pair<std::shared_ptr<Slide>, std::shared_ptr<Scene>> cloneScene() const;
 		protected:
             std::shared_ptr<CVScene> getScene() const {
@@ -131,12 +165,12 @@ namespace slideio
             std::string createImageDescriptionTag() const;
             std::string createOMETiffDescription() const;
             TiffDirectory setUpDirectory(const TiffDirectoryStructure& page);
-            void writeDirectoryData(TiffDirectory& dir, const TiffDirectoryStructure& page,
-                const std::function<void(int)>& cb, int param);
+            std::vector<DirectoryTask> createDirectoryTasks();
+            void startDirectory(const DirectoryTask& task);
             void writeDirectoryDataST(TiffDirectory& dir, const TiffDirectoryStructure& page,
                 const std::function<void(int)>& cb, int tileBatchSize);
-            void writeDirectoryDataMT(TiffDirectory& dir, const TiffDirectoryStructure& page,
-                                      const std::function<void(int)>& cb, int tileBatchSize);
+            void writeDirectoriesMT(const std::vector<DirectoryTask>& tasks, std::queue<Block>& blockQueue,
+                                    const std::function<void(int)>& cb);
             void computeCropRect();
             void makeSureValid() const;
             static std::string SVSDateString();
@@ -147,18 +181,43 @@ namespace slideio
             void checkContainerRequirements() const;
             void updateNotDefinedParameters();
 			// --- Multithreaded conversion helpers ---
-			void readTiles(const TiffDirectory& dir, const TiffDirectoryStructure& page, BoundedQueue<Tile>& inputQueue,
+			void readTiles(const std::vector<DirectoryTask>& tasks, BoundedQueue<Tile>& inputQueue,
 				std::queue<Block>& blockQueue, std::mutex& blockQueueMutex, std::atomic<size_t>& activeReaders,
 				std::exception_ptr& readerException, std::mutex& exceptionMutex);
 			void encodeTiles(BoundedQueue<Tile>& inputQueue, BoundedQueue<EncodedTile>& outputQueue,
-				std::atomic<size_t>& activeEncoders, std::exception_ptr& encoderException, std::mutex& exceptionMutex);
+				const std::function<void(int)>& cb, std::atomic<size_t>& activeEncoders,
+				std::exception_ptr& encoderException, std::mutex& exceptionMutex);
 			void writeTile(const EncodedTile& tile);
-			void writeTiles(BoundedQueue<Tile>& inputQueue, BoundedQueue<EncodedTile>& outputQueue, const std::function<void(int)>& cb,
+			void writeTiles(const std::vector<DirectoryTask>& tasks, BoundedQueue<Tile>& inputQueue,
+				BoundedQueue<EncodedTile>& outputQueue, const std::function<void(int)>& cb,
 				std::exception_ptr& writerException, std::mutex& exceptionMutex);
 			std::vector<uint8_t> encodeTile(const cv::Mat& tile);
+			std::vector<uint8_t> encodeBackgroundTile(const Tile& tile);
+			void updateProgress(const std::function<void(int)>& cb);
+			// --- Resumable conversion ---
+			std::string createLayoutSignature(const std::vector<DirectoryTask>& tasks) const;
+			void openParallelWriter(const std::string& filePath, const std::vector<DirectoryTask>& tasks, bool resumable);
+			void skipWrittenBlocks(const std::vector<DirectoryTask>& tasks, std::queue<Block>& blockQueue);
+			void journalTile(int directoryIndex, const cv::Point2i& location, uint64_t offset, size_t size);
         private:
             std::vector<TiffPageStructure> m_pages;
             TIFFKeeperPtr m_file;
+            std::shared_ptr<TiffParallelWriter> m_parallelWriter;
+            std::shared_ptr<ConversionJournal> m_journal;
+            std::mutex m_progressMutex;
+            // Uniform tiles encoded once per directory and value. offset is the file
+            // position of the shared copy when tiles go through the parallel writer.
+            // The first encoder of a value fulfils the future; the others wait for it
+            // outside m_backgroundMutex, which guards the map only.
+            struct BackgroundTile {
+                std::vector<uint8_t> encodedData;
+                uint64_t offset = 0;
+            };
+            std::map<std::pair<int, std::vector<double>>, std::shared_future<BackgroundTile>> m_backgroundTiles;
+            std::mutex m_backgroundMutex;
+            // Writer thread of the libtiff path: location of the first written copy of each
+            // blank tile of the current directory. Later copies reference its bytes.
+            std::map<std::vector<uint8_t>, cv::Point2i> m_writtenBackgroundTiles;
             std::shared_ptr<CVScene> m_scene;
             ConverterParameters m_parameters;
             Rect m_cropRect;
@@ -169,8 +228,11 @@ namespace slideio
 			std::atomic<int64_t> m_readersIdleTimeNs{0};
 			std::atomic<int64_t> m_encodersIdleTimeNs{0};
 			std::atomic<int64_t> m_writerIdleTimeNs{0};
+			std::atomic<int> m_numBackgroundTiles{0};
+			int m_numResumedTiles = 0;
 			int m_numReaderThreads = 0;
 			int m_numEncoderThreads = 0;
+			int m_numWriterThreads = 1;
 		};
     }
 }
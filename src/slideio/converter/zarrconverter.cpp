@@ -0,0 +1,497 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "zarrconverter.hpp"
+#include "convertertools.hpp"
+#include "slideio/core/cvscene.hpp"
+#include "slideio/core/tools/tools.hpp"
+#include "slideio/imagetools/imagetools.hpp"
+#include "slideio/base/exceptions.hpp"
+#include "slideio/base/log.hpp"
+#include "slideio/slideio/slideio.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+using namespace slideio;
+using namespace slideio::converter;
+using json = nlohmann::json;
+
+namespace
+{
+    void writeJsonFile(const std::filesystem::path& path, const json& content) {
+        std::ofstream stream(path, std::ios::out | std::ios::trunc);
+        if (!stream) {
+            RAISE_RUNTIME_ERROR << "Converter: cannot create file " << path.string();
+        }
+        stream << content.dump(2);
+        if (!stream) {
+            RAISE_RUNTIME_ERROR << "Converter: error writing file " << path.string();
+        }
+    }
+
+    // Display range of the omero channel metadata.
+    std::pair<double, double> dataTypeRange(DataType dt) {
+        switch (dt) {
+        case DataType::DT_Byte:
+            return { 0., 255. };
+        case DataType::DT_Int8:
+            return { -128., 127. };
+        case DataType::DT_UInt16:
+            return { 0., 65535. };
+        case DataType::DT_Int16:
+            return { -32768., 32767. };
+        case DataType::DT_UInt32:
+            return { 0., static_cast<double>(std::numeric_limits<uint32_t>::max()) };
+        case DataType::DT_Int32:
+            return { static_cast<double>(std::numeric_limits<int32_t>::min()),
+                static_cast<double>(std::numeric_limits<int32_t>::max()) };
+        default:
+            return { 0., 1. };
+        }
+    }
+}
+
+std::string ZarrConverter::zarrDataType(DataType dt) {
+    switch (dt) {
+    case DataType::DT_Byte:
+        return "|u1";
+    case DataType::DT_Int8:
+        return "|i1";
+    case DataType::DT_UInt16:
+        return "<u2";
+    case DataType::DT_Int16:
+        return "<i2";
+    case DataType::DT_UInt32:
+        return "<u4";
+    case DataType::DT_Int32:
+        return "<i4";
+    case DataType::DT_Float16:
+        return "<f2";
+    case DataType::DT_Float32:
+        return "<f4";
+    case DataType::DT_Float64:
+        return "<f8";
+    default:
+        RAISE_RUNTIME_ERROR << "Converter: data type " << static_cast<int>(dt) << " is not supported by OME-Zarr converter";
+    }
+}
+
+std::string ZarrConverter::chunkPath(int level, int frame, int channel, int slice, int chunkX, int chunkY) {
+    std::stringstream path;
+    path << level << "/" << frame << "/" << channel << "/" << slice << "/" << chunkY << "/" << chunkX;
+    return path.str();
+}
+
+cv::Size ZarrConverter::getLevelSize(int level) const {
+    if (level < 0 || level >= getNumZoomLevels()) {
+        RAISE_RUNTIME_ERROR << "Converter: zoom level " << level << " is out of range";
+    }
+    return m_levelSizes[level];
+}
+
+void ZarrConverter::createLayout(const std::shared_ptr<CVScene>& scene, const ConverterParameters& parameters) {
+    if (!scene) {
+        RAISE_RUNTIME_ERROR << "Converter: invalid scene provided";
+    }
+    if (!parameters.isValid()) {
+        RAISE_RUNTIME_ERROR << "Converter: invalid converter parameters";
+    }
+    if (parameters.getContainerType() != Container::ZARR_CONTAINER) {
+        RAISE_RUNTIME_ERROR << "Converter: Zarr store can be created only for Zarr container parameters!";
+    }
+    if (parameters.getFormat() != ImageFormat::OME_ZARR) {
+        RAISE_RUNTIME_ERROR << "Converter: Unrecognized target image format: " << static_cast<int>(parameters.getFormat());
+    }
+    const Compression compression = parameters.getEncoding();
+    if (compression != Compression::Zstd && compression != Compression::Zlib) {
+        RAISE_RUNTIME_ERROR << "Converter: OME-Zarr supports only Zstd and Zlib compression. Received: "
+            << static_cast<int>(compression);
+    }
+    m_scene = scene;
+    m_parameters = parameters;
+    m_parameters.updateNotDefinedParameters(scene);
+    m_levelSizes.clear();
+    m_totalChunks = 0;
+    m_currentChunk = 0;
+    m_lastProgress = 0;
+
+    if (!m_parameters.getRect().valid()) {
+        RAISE_RUNTIME_ERROR << "Converter: Invalid rectangle for the scene converter!";
+    }
+    const cv::Rect sceneRect = m_scene->getRect();
+    const auto& block = m_parameters.getRect();
+    if (block.x + block.width > sceneRect.width || block.y + block.height > sceneRect.height) {
+        RAISE_RUNTIME_ERROR << "Converter: Crop rectangle exceeds scene size!";
+    }
+    m_cropRect = cv::Rect(block.x, block.y, block.width, block.height);
+
+    const Range channelRange = m_parameters.getChannelRange();
+    m_dataType = scene->getChannelDataType(channelRange.start);
+    for (int channel = channelRange.start + 1; channel < channelRange.end; ++channel) {
+        if (scene->getChannelDataType(channel) != m_dataType) {
+            RAISE_RUNTIME_ERROR << "Converter: OME-Zarr requires the same data type for all channels!";
+        }
+    }
+    zarrDataType(m_dataType);
+
+    std::shared_ptr<const ZarrContainerParameters> zarrParams =
+        std::static_pointer_cast<const ZarrContainerParameters>(m_parameters.getContainerParameters());
+    m_chunkSize = cv::Size(zarrParams->getChunkWidth(), zarrParams->getChunkHeight());
+    if (m_chunkSize.width <= 0 || m_chunkSize.height <= 0) {
+        RAISE_RUNTIME_ERROR << "Converter: Invalid chunk size (" << m_chunkSize.width << "," << m_chunkSize.height << ")";
+    }
+    const int numPlanes = channelRange.size() * m_parameters.getSliceRange().size() * m_parameters.getTFrameRange().size();
+    const int numZoomLevels = std::max(1, zarrParams->getNumZoomLevels());
+    for (int level = 0; level < numZoomLevels; ++level) {
+        const cv::Size levelSize = ConverterTools::scaleSize(m_cropRect.size(), level);
+        if (levelSize.width <= 0 || levelSize.height <= 0) {
+            break;
+        }
+        m_levelSizes.push_back(levelSize);
+        m_totalChunks += ConverterTools::computeNumTiles(levelSize, m_chunkSize) * numPlanes;
+    }
+}
+
+void ZarrConverter::writeMetadata() const {
+    const std::filesystem::path root(m_directoryPath);
+    writeJsonFile(root / ".zgroup", json{ {"zarr_format", 2} });
+
+    const Resolution res = m_scene->getResolution();
+    const double resX = res.x > 0 ? res.x * 1.e6 : 1.;
+    const double resY = res.y > 0 ? res.y * 1.e6 : 1.;
+    const double resZ = m_scene->getZSliceResolution() > 0 ? m_scene->getZSliceResolution() * 1.e6 : 1.;
+    const double resT = m_scene->getTFrameResolution() > 0 ? m_scene->getTFrameResolution() : 1.;
+
+    json datasets = json::array();
+    for (int level = 0; level < getNumZoomLevels(); ++level) {
+        const double scale = static_cast<double>(1 << level);
+        datasets.push_back({
+            {"path", std::to_string(level)},
+            {"coordinateTransformations", json::array({
+                {{"type", "scale"}, {"scale", {resT, 1., resZ, resY * scale, resX * scale}}}
+            })}
+        });
+    }
+    json axes = json::array({
+        {{"name", "t"}, {"type", "time"}, {"unit", "second"}},
+        {{"name", "c"}, {"type", "channel"}},
+        {{"name", "z"}, {"type", "space"}, {"unit", "micrometer"}},
+        {{"name", "y"}, {"type", "space"}, {"unit", "micrometer"}},
+        {{"name", "x"}, {"type", "space"}, {"unit", "micrometer"}}
+    });
+    json multiscale = {
+        {"version", "0.4"},
+        {"name", m_scene->getName()},
+        {"axes", axes},
+        {"datasets", datasets}
+    };
+
+    const Range channelRange = m_parameters.getChannelRange();
+    const auto range = dataTypeRange(m_dataType);
+    json channels = json::array();
+    for (int channel = channelRange.start; channel < channelRange.end; ++channel) {
+        std::string label = m_scene->getChannelName(channel);
+        if (label.empty()) {
+            label = "Channel " + std::to_string(channel);
+        }
+        channels.push_back({
+            {"label", label},
+            {"active", true},
+            {"color", "FFFFFF"},
+            {"window", {{"min", range.first}, {"max", range.second}, {"start", range.first}, {"end", range.second}}}
+        });
+    }
+    json attributes = {
+        {"multiscales", json::array({multiscale})},
+        {"omero", {{"version", "0.4"}, {"channels", channels}}}
+    };
+    writeJsonFile(root / ".zattrs", attributes);
+
+    const Compression compression = m_parameters.getEncoding();
+    std::shared_ptr<const LosslessEncodeParameters> encodeParams =
+        std::static_pointer_cast<const LosslessEncodeParameters>(m_parameters.getEncodeParameters());
+    const json compressor = {
+        {"id", compression == Compression::Zstd ? "zstd" : "zlib"},
+        {"level", encodeParams->getLevel()}
+    };
+    const std::string dtype = zarrDataType(m_dataType);
+    const int numFrames = m_parameters.getTFrameRange().size();
+    const int numSlices = m_parameters.getSliceRange().size();
+    for (int level = 0; level < getNumZoomLevels(); ++level) {
+        const cv::Size& levelSize = m_levelSizes[level];
+        const json array = {
+            {"zarr_format", 2},
+            {"shape", {numFrames, channelRange.size(), numSlices, levelSize.height, levelSize.width}},
+            {"chunks", {1, 1, 1, m_chunkSize.height, m_chunkSize.width}},
+            {"dtype", dtype},
+            {"compressor", compressor},
+            {"fill_value", 0},
+            {"order", "C"},
+            {"filters", nullptr},
+            {"dimension_separator", "/"}
+        };
+        const std::filesystem::path levelPath = root / std::to_string(level);
+        std::filesystem::create_directories(levelPath);
+        writeJsonFile(levelPath / ".zarray", array);
+    }
+}
+
+void ZarrConverter::createChunkDirectories() const {
+    // Directories are created up front, so the encoder threads only create files.
+    const std::filesystem::path root(m_directoryPath);
+    const int numFrames = m_parameters.getTFrameRange().size();
+    const int numChannels = m_parameters.getChannelRange().size();
+    const int numSlices = m_parameters.getSliceRange().size();
+    for (int level = 0; level < getNumZoomLevels(); ++level) {
+        const int rows = (m_levelSizes[level].height + m_chunkSize.height - 1) / m_chunkSize.height;
+        for (int frame = 0; frame < numFrames; ++frame) {
+            for (int channel = 0; channel < numChannels; ++channel) {
+                for (int slice = 0; slice < numSlices; ++slice) {
+                    for (int row = 0; row < rows; ++row) {
+                        const std::filesystem::path dir = root / std::to_string(level) / std::to_string(frame)
+                            / std::to_string(channel) / std::to_string(slice) / std::to_string(row);
+                        std::filesystem::create_directories(dir);
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::pair<std::shared_ptr<Slide>, std::shared_ptr<Scene>> ZarrConverter::cloneScene() const {
+    std::string filePath = m_scene->getFilePath();
+    int sceneIndex = m_scene->getSceneIndex();
+    std::string driverId = m_scene->getDriverId();
+    std::shared_ptr<Slide> slide = openSlide(filePath, driverId);
+    std::shared_ptr<Scene> scene = slide->getScene(sceneIndex);
+    return { slide, scene };
+}
+
+void ZarrConverter::updateProgress(const std::function<void(int)>& cb) {
+    m_currentChunk++;
+    if (cb) {
+        double proc = 100. * (double)m_currentChunk / (double)m_totalChunks;
+        if (const int lproc = std::lround(proc); lproc != m_lastProgress) {
+            cb(lproc);
+            m_lastProgress = lproc;
+        }
+    }
+}
+
+void ZarrConverter::readChunks(std::queue<Block>& blockQueue, std::mutex& blockQueueMutex,
+                               BoundedQueue<Chunk>& chunkQueue, std::atomic<size_t>& activeReaders,
+                               std::exception_ptr& readerException, std::mutex& exceptionMutex) {
+    auto clone = cloneScene();
+    auto slide = clone.first;
+    auto scene = clone.second;
+    const Range channelRange = m_parameters.getChannelRange();
+    const Range frameRange = m_parameters.getTFrameRange();
+    const Range sliceRange = m_parameters.getSliceRange();
+    std::vector<int> channels;
+    for (int channel = channelRange.start; channel < channelRange.end; ++channel) {
+        channels.push_back(channel);
+    }
+    try {
+        cv::Mat block;
+        std::vector<cv::Mat> planes;
+        bool done = false;
+        while (!done) {
+            Block currentBlock;
+            {
+                std::unique_lock lock(blockQueueMutex);
+                if (blockQueue.empty()) {
+                    break;
+                }
+                currentBlock = blockQueue.front();
+                blockQueue.pop();
+            }
+            const int level = currentBlock.level;
+            const cv::Size sceneChunkSize = ConverterTools::scaleSize(m_chunkSize, level, false);
+            const cv::Rect blockRect(m_cropRect.x + currentBlock.chunk.x * sceneChunkSize.width,
+                m_cropRect.y + currentBlock.chunk.y * sceneChunkSize.height,
+                sceneChunkSize.width, sceneChunkSize.height);
+            ConverterTools::readTile(scene->getCVScene(), channels, level, blockRect,
+                sliceRange.start + currentBlock.slice, frameRange.start + currentBlock.frame, block);
+            if (block.rows != m_chunkSize.height || block.cols != m_chunkSize.width) {
+                RAISE_RUNTIME_ERROR << "Converter: Unexpected chunk size ("
+                    << block.cols << "," << block.rows << "). Expected chunk size: ("
+                    << m_chunkSize.width << "," << m_chunkSize.height << ").";
+            }
+            cv::split(block, planes);
+            for (int channel = 0; channel < static_cast<int>(planes.size()); ++channel) {
+                Chunk chunk;
+                chunk.level = level;
+                chunk.frame = currentBlock.frame;
+                chunk.channel = channel;
+                chunk.slice = currentBlock.slice;
+                chunk.chunk = currentBlock.chunk;
+                chunk.raster = std::move(planes[channel]);
+                if (!chunkQueue.push(std::move(chunk))) {
+                    done = true;
+                    break;
+                }
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        {
+            std::unique_lock lock(exceptionMutex);
+            if (!readerException)
+                readerException = std::current_exception();
+        }
+        chunkQueue.setDone();
+        SLIDEIO_LOG(ERROR) << "Converter: Exception in chunk reader thread: " << e.what();
+    }
+    catch (...) {
+        {
+            std::unique_lock lock(exceptionMutex);
+            if (!readerException)
+                readerException = std::current_exception();
+        }
+        chunkQueue.setDone();
+        SLIDEIO_LOG(ERROR) << "Converter: Unknown exception in chunk reader thread.";
+    }
+    if (--activeReaders == 0)
+        chunkQueue.setDone();
+}
+
+void ZarrConverter::writeChunk(const Chunk& chunk, const std::vector<uint8_t>& data) const {
+    const std::filesystem::path path = std::filesystem::path(m_directoryPath)
+        / chunkPath(chunk.level, chunk.frame, chunk.channel, chunk.slice, chunk.chunk.x, chunk.chunk.y);
+    std::unique_ptr<FILE, Tools::FileDeleter> file(Tools::openFile(path.string(), "wb"));
+    if (!file) {
+        RAISE_RUNTIME_ERROR << "Converter: cannot create chunk file " << path.string();
+    }
+    if (!data.empty() && fwrite(data.data(), 1, data.size(), file.get()) != data.size()) {
+        RAISE_RUNTIME_ERROR << "Converter: error writing chunk file " << path.string();
+    }
+}
+
+void ZarrConverter::encodeChunks(BoundedQueue<Chunk>& chunkQueue, const std::function<void(int)>& cb,
+                                 std::exception_ptr& encoderException, std::mutex& exceptionMutex) {
+    std::shared_ptr<const LosslessEncodeParameters> params =
+        std::static_pointer_cast<const LosslessEncodeParameters>(m_parameters.getEncodeParameters());
+    // zarr arrays carry no TIFF predictor: the codec sees the raw samples
+    std::unique_ptr<LosslessEncodeParameters> encodeParams;
+    if (params->getCompression() == Compression::Zstd) {
+        encodeParams = std::make_unique<ZstdEncodeParameters>(params->getLevel(), TiffPredictor::None);
+    }
+    else {
+        encodeParams = std::make_unique<DeflateEncodeParameters>(params->getLevel(), TiffPredictor::None);
+    }
+    try {
+        std::vector<uint8_t> encoded;
+        while (true) {
+            std::optional<Chunk> chunk = chunkQueue.pop();
+            if (!chunk) {
+                break;
+            }
+            ImageTools::encodeLossless(chunk->raster, encoded, *encodeParams);
+            writeChunk(*chunk, encoded);
+            std::lock_guard<std::mutex> lock(m_progressMutex);
+            updateProgress(cb);
+        }
+    }
+    catch (const std::exception& e) {
+        {
+            std::unique_lock lock(exceptionMutex);
+            if (!encoderException)
+                encoderException = std::current_exception();
+        }
+        chunkQueue.setDone();
+        SLIDEIO_LOG(ERROR) << "Converter: Exception in chunk encoder thread: " << e.what();
+    }
+    catch (...) {
+        {
+            std::unique_lock lock(exceptionMutex);
+            if (!encoderException)
+                encoderException = std::current_exception();
+        }
+        chunkQueue.setDone();
+        SLIDEIO_LOG(ERROR) << "Converter: Unknown exception in chunk encoder thread.";
+    }
+}
+
+void ZarrConverter::createZarr(const std::string& directoryPath, const std::function<void(int)>& cb) {
+    if (!m_scene || m_levelSizes.empty()) {
+        RAISE_RUNTIME_ERROR << "Converter: Zarr layout is not initialized";
+    }
+    m_directoryPath = directoryPath;
+    m_currentChunk = 0;
+    m_lastProgress = 0;
+    std::filesystem::create_directories(m_directoryPath);
+    writeMetadata();
+    createChunkDirectories();
+
+    std::queue<Block> blockQueue;
+    const int numFrames = m_parameters.getTFrameRange().size();
+    const int numSlices = m_parameters.getSliceRange().size();
+    for (int level = 0; level < getNumZoomLevels(); ++level) {
+        const cv::Size& levelSize = m_levelSizes[level];
+        const int columns = (levelSize.width + m_chunkSize.width - 1) / m_chunkSize.width;
+        const int rows = (levelSize.height + m_chunkSize.height - 1) / m_chunkSize.height;
+        for (int frame = 0; frame < numFrames; ++frame) {
+            for (int slice = 0; slice < numSlices; ++slice) {
+                for (int row = 0; row < rows; ++row) {
+                    for (int column = 0; column < columns; ++column) {
+                        Block block;
+                        block.level = level;
+                        block.frame = frame;
+                        block.slice = slice;
+                        block.chunk = cv::Point2i(column, row);
+                        blockQueue.push(block);
+                    }
+                }
+            }
+        }
+    }
+
+    std::shared_ptr<const ZarrContainerParameters> zarrParams =
+        std::static_pointer_cast<const ZarrContainerParameters>(m_parameters.getContainerParameters());
+    int numReadingThreads = zarrParams->getNumReadingThreads();
+    int numEncoderThreads = zarrParams->getNumEncodingThreads();
+    const int halfCores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2);
+    if (numEncoderThreads <= 0) {
+        numEncoderThreads = halfCores;
+    }
+    if (numReadingThreads <= 0) {
+        numReadingThreads = halfCores;
+    }
+    const size_t QUEUE_DEPTH = std::max(static_cast<size_t>(2), static_cast<size_t>(numEncoderThreads) * 2);
+    BoundedQueue<Chunk> chunkQueue(QUEUE_DEPTH);
+    std::mutex blockQueueMutex;
+    std::exception_ptr readerException;
+    std::exception_ptr encoderException;
+    std::mutex exceptionMutex;
+
+    std::vector<std::thread> readers;
+    std::atomic<size_t> activeReaders{ static_cast<size_t>(numReadingThreads) };
+    for (int reader = 0; reader < numReadingThreads; ++reader) {
+        readers.emplace_back(&ZarrConverter::readChunks, this, std::ref(blockQueue), std::ref(blockQueueMutex),
+            std::ref(chunkQueue), std::ref(activeReaders), std::ref(readerException), std::ref(exceptionMutex));
+    }
+    std::vector<std::thread> encoders;
+    for (int encoder = 0; encoder < numEncoderThreads; ++encoder) {
+        encoders.emplace_back(&ZarrConverter::encodeChunks, this, std::ref(chunkQueue), std::cref(cb),
+            std::ref(encoderException), std::ref(exceptionMutex));
+    }
+    for (auto& reader : readers) {
+        if (reader.joinable()) reader.join();
+    }
+    for (auto& encoder : encoders) {
+        if (encoder.joinable()) encoder.join();
+    }
+    if (readerException) {
+        std::rethrow_exception(readerException);
+    }
+    if (encoderException) {
+        std::rethrow_exception(encoderException);
+    }
+}
@@ -0,0 +1,105 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+#include "slideio/converter/converter_def.hpp"
+#include "slideio/converter/converterparameters.hpp"
+#include "slideio/core/tools/boundedqueue.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <opencv2/core.hpp>
+
+#if defined(_MSC_VER)
+#pragma warning( push )
+#pragma warning(disable: 4251)
+#endif
+
+namespace slideio
+{
+    class Slide;
+    class Scene;
+    class CVScene;
+
+    namespace converter
+    {
+        // Writes a scene as an OME-Zarr (NGFF 0.4) directory store: a multiscale pyramid of
+        // zarr v2 arrays with t, c, z, y, x axes. Chunks do not depend on each other, so the
+        // encoder threads compress them and write every chunk to its own file in any order;
+        // there is no writer thread.
+        class SLIDEIO_CONVERTER_EXPORTS ZarrConverter
+        {
+        public:
+            struct Block {
+                int level = 0;          // Pyramid level
+                int frame = 0;          // Index of the time frame in the output
+                int slice = 0;          // Index of the z slice in the output
+                cv::Point2i chunk;      // Chunk column and row in the level
+            };
+            struct Chunk {
+                int level = 0;
+                int frame = 0;
+                int channel = 0;        // Index of the channel in the output
+                int slice = 0;
+                cv::Point2i chunk;
+                cv::Mat raster;         // Single channel chunk raster
+            };
+        public:
+            ZarrConverter() = default;
+            virtual ~ZarrConverter() = default;
+            void createLayout(const std::shared_ptr<CVScene>& scene, const ConverterParameters& parameters);
+            void createZarr(const std::string& directoryPath, const std::function<void(int)>& cb);
+            int getNumZoomLevels() const {
+                return static_cast<int>(m_levelSizes.size());
+            }
+            cv::Size getLevelSize(int level) const;
+            cv::Size getChunkSize() const {
+                return m_chunkSize;
+            }
+            int getTotalChunks() const {
+                return m_totalChunks;
+            }
+            const ConverterParameters& getParameters() const {
+                return m_parameters;
+            }
+            // Relative path of a chunk file in the store ("/" dimension separator).
+            static std::string chunkPath(int level, int frame, int channel, int slice, int chunkX, int chunkY);
+            // zarr v2 dtype string ("|u1", "<u2", ...) of a slideio data type.
+            static std::string zarrDataType(DataType dt);
+            virtual std::pair<std::shared_ptr<Slide>, std::shared_ptr<Scene>> cloneScene() const;
+        protected:
+            std::shared_ptr<CVScene> getScene() const {
+                return m_scene;
+            }
+        private:
+            void writeMetadata() const;
+            void createChunkDirectories() const;
+            void readChunks(std::queue<Block>& blockQueue, std::mutex& blockQueueMutex,
+                BoundedQueue<Chunk>& chunkQueue, std::atomic<size_t>& activeReaders,
+                std::exception_ptr& readerException, std::mutex& exceptionMutex);
+            void encodeChunks(BoundedQueue<Chunk>& chunkQueue, const std::function<void(int)>& cb,
+                std::exception_ptr& encoderException, std::mutex& exceptionMutex);
+            void writeChunk(const Chunk& chunk, const std::vector<uint8_t>& data) const;
+            void updateProgress(const std::function<void(int)>& cb);
+        private:
+            std::shared_ptr<CVScene> m_scene;
+            ConverterParameters m_parameters;
+            cv::Rect m_cropRect;
+            cv::Size m_chunkSize;
+            std::vector<cv::Size> m_levelSizes;
+            DataType m_dataType = DataType::DT_Unknown;
+            std::string m_directoryPath;
+            std::mutex m_progressMutex;
+            int m_totalChunks = 0;
+            int m_currentChunk = 0;
+            int m_lastProgress = 0;
+        };
+    }
+}
+
+#if defined(_MSC_VER)
+#pragma warning( pop )
+#endif
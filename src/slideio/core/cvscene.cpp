@@ -10,6 +10,7 @@
 #include "slideio/core/metadata_internal.hpp"
 #include "cvscene.hpp"
 #include "slideio/core/tools/tools.hpp"
+#include "slideio/core/tools/resampling.hpp"
 #include <cmath>
 
 
@@ -34,17 +35,22 @@ void CVScene::readBlockChannels(const cv::Rect& blockRect, const std::vector<int
     readResampledBlockChannels(blockRect, blockRect.size(), channelIndices, output);
 }
 
-void CVScene::readResampledBlock(const cv::Rect& blockRect, const cv::Size& blockSize, cv::OutputArray output)
+void CVScene::readResampledBlock(const cv::Rect& blockRect, const cv::Size& blockSize, cv::OutputArray output,
+    ResamplingPolicy policy)
 {
     RefCounterGuard guard(this);
     const std::vector<int> channelIndices;
-    readResampledBlockChannels(blockRect, blockSize, channelIndices, output);
+    readResampledBlockChannels(blockRect, blockSize, channelIndices, output, policy);
 }
 
 void CVScene::readResampledBlockChannels(const cv::Rect& blockRect,
     const cv::Size& blockSize, const std::vector<int>& channelIndices,
-    cv::OutputArray output) {
+    cv::OutputArray output, ResamplingPolicy policy) {
     RefCounterGuard guard(this);
+    ResamplingScope resampling(policy);
+    ReadStatisticsScope statistics;
+    startReadStatistics(statistics);
+    ReadStageTimer timer(ReadStage::Total);
     std::lock_guard<std::mutex> lock(m_readBlockMutex);
     readResampledBlockChannelsEx(blockRect, blockSize, channelIndices, 0, 0, output);
 }
@@ -65,11 +71,11 @@ void CVScene::read4DBlockChannels(const cv::Rect& blockRect, const std::vector<i
 }
 
 void CVScene::readResampled4DBlock(const cv::Rect& blockRect, const cv::Size& blockSize, const cv::Range& zSliceRange,
-    const cv::Range& timeFrameRange, cv::OutputArray output)
+    const cv::Range& timeFrameRange, cv::OutputArray output, ResamplingPolicy policy)
 {
     RefCounterGuard guard(this);
     const std::vector<int> channelIndices;
-    readResampled4DBlockChannels(blockRect, blockSize, channelIndices, zSliceRange, timeFrameRange, output);
+    readResampled4DBlockChannels(blockRect, blockSize, channelIndices, zSliceRange, timeFrameRange, output, policy);
 }
 
 void CVScene::assemble4DBlock(const cv::Size& blockSize, const std::vector<int>& channelIndicesIn,
@@ -162,9 +168,13 @@ void CVScene::assemble4DBlock(const cv::Size& blockSize, const std::vector<int>&
 void CVScene::readResampled4DBlockChannels(const cv::Rect& blockRect, const cv::Size& blockSize,
     const std::vector<int>& channelIndicesIn, const cv::Range& zSliceRange,
     const cv::Range& timeFrameRange,
-    cv::OutputArray output)
+    cv::OutputArray output, ResamplingPolicy policy)
 {
     RefCounterGuard guard(this);
+    ResamplingScope resampling(policy);
+    ReadStatisticsScope statistics;
+    startReadStatistics(statistics);
+    ReadStageTimer timer(ReadStage::Total);
     std::vector<int> channelIndices(channelIndicesIn);
     if (channelIndices.empty()) {
         const int sceneNumChannels = getNumChannels();
@@ -183,6 +193,9 @@ void CVScene::readResampledLevel4DBlockChannels(int level, const cv::Rect& level
     const cv::Range& zSliceRange, const cv::Range& timeFrameRange, cv::OutputArray output)
 {
     RefCounterGuard guard(this);
+    ReadStatisticsScope statistics;
+    startReadStatistics(statistics);
+    ReadStageTimer timer(ReadStage::Total);
     validateLevel(level);
     std::vector<int> channelIndices(channelIndicesIn);
     if (channelIndices.empty()) {
@@ -282,6 +295,9 @@ void CVScene::readResampledLevelBlockChannels(int level, const cv::Rect& levelRe
     const cv::Size& blockSize, const std::vector<int>& channelIndices, cv::OutputArray output)
 {
     RefCounterGuard guard(this);
+    ReadStatisticsScope statistics;
+    startReadStatistics(statistics);
+    ReadStageTimer timer(ReadStage::Total);
     std::lock_guard<std::mutex> lock(m_readBlockMutex);
     readResampledLevelBlockChannelsEx(level, levelRect, blockSize, channelIndices, 0, 0, output);
 }
@@ -397,6 +413,43 @@ const Metadata& CVScene::getMetadata() const
     return m_metadata;
 }
 
+void CVScene::startReadStatistics(ReadStatisticsScope& scope)
+{
+    if (ReadStatistics::isEnabled()) {
+        scope.activate(m_readStatistics, getDriverId(), getCompression());
+    }
+}
+
+bool CVScene::releaseFileHandles()
+{
+    // reads hold a reference for their whole duration: the handles are closed only
+    // between reads, and a read starting meanwhile waits for the close
+    bool closed = false;
+    runIfUnused([this, &closed]() {
+        closed = closeFileHandles();
+    });
+    return closed;
+}
+
+void CVScene::notifyNextReopen(const std::weak_ptr<FileReopenListener>& listener)
+{
+    std::lock_guard<std::mutex> lock(m_reopenMutex);
+    m_reopenListener = listener;
+}
+
+void CVScene::initializeCounter()
+{
+    std::shared_ptr<FileReopenListener> listener;
+    {
+        std::lock_guard<std::mutex> lock(m_reopenMutex);
+        listener = m_reopenListener.lock();
+        m_reopenListener.reset();
+    }
+    if (listener) {
+        listener->onFilesReopened();
+    }
+}
+
 const Metadata& CVScene::getChannelAttributes() const
 {
     std::call_once(m_channelAttrsOnce, [this]
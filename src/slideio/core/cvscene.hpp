@@ -7,10 +7,12 @@
 #include "slideio/base/resolution.hpp"
 #include "slideio/base/slideio_enums.hpp"
 #include "slideio/core/metadata.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
 #include <opencv2/core.hpp>
 #include <vector>
 #include <string>
 #include <list>
+#include <memory>
 #include "refcounter.hpp"
 #include <mutex>
 #include <functional>
@@ -25,6 +27,16 @@
 namespace slideio
 {
     class CVSlide;
+    /**@brief receives the reads that reopen the files closed by releaseFileHandles. */
+    class SLIDEIO_CORE_EXPORTS FileReopenListener
+    {
+    public:
+        virtual ~FileReopenListener() = default;
+        /**@brief called by the first read of a scene after its files were closed,
+         * before the read reopens them.
+         */
+        virtual void onFilesReopened() = 0;
+    };
     /**@brief class CVScene represents a base class for opencv based representations of
      * raster images contained in a medical slide.
      *
@@ -114,8 +126,11 @@ namespace slideio
          * allocate memory for the object if it is not yet allocated or allocated not enough memory.
          * All channels have to be of the same type. The method will throw an error by attempt to put read several channels
          * of different types in one block.
+         * @param policy : trade-off between speed and quality of the resampling. It selects
+         * the zoom level the block is read from and the interpolation, see ResamplingPolicy.
          */
-        virtual void readResampledBlock(const cv::Rect& blockRect, const cv::Size& blockSize, cv::OutputArray output);
+        virtual void readResampledBlock(const cv::Rect& blockRect, const cv::Size& blockSize, cv::OutputArray output,
+            ResamplingPolicy policy = ResamplingPolicy::Balanced);
         /**@brief reads selected channels raster rectangle of a plane image with resizing.
          *
          * @param blockRect : rectangle of the block to be read. The rectangle is represented by cv::Rect structure
@@ -126,8 +141,11 @@ namespace slideio
          * allocate memory for the object if it is not yet allocated or allocated not enough memory.
          * All channels have to be of the same type. The method will throw an error by attempt to put read several channels
          * of different types in one block.
+         * @param policy : trade-off between speed and quality of the resampling. It selects
+         * the zoom level the block is read from and the interpolation, see ResamplingPolicy.
          */
-        virtual void readResampledBlockChannels(const cv::Rect& blockRect, const cv::Size& blockSize, const std::vector<int>& channelIndices, cv::OutputArray output);
+        virtual void readResampledBlockChannels(const cv::Rect& blockRect, const cv::Size& blockSize, const std::vector<int>& channelIndices, cv::OutputArray output,
+            ResamplingPolicy policy = ResamplingPolicy::Balanced);
         /**@brief reads multi-dimensional raster block.
          *
          * @param blockRect : rectangle of the block to be read. The rectangle is represented by cv::Rect structure
@@ -164,8 +182,11 @@ namespace slideio
          * allocate memory for the object if it is not yet allocated or allocated not enough memory.
          * All channels have to be of the same type. The method will throw an error by attempt to put read several channels
          * of different types in one block.
+         * @param policy : trade-off between speed and quality of the resampling. It selects
+         * the zoom level the block is read from and the interpolation, see ResamplingPolicy.
          */
-        virtual void readResampled4DBlock(const cv::Rect& blockRect, const cv::Size& blockSize, const cv::Range& zSliceRange, const cv::Range& timeFrameRange, cv::OutputArray output);
+        virtual void readResampled4DBlock(const cv::Rect& blockRect, const cv::Size& blockSize, const cv::Range& zSliceRange, const cv::Range& timeFrameRange, cv::OutputArray output,
+            ResamplingPolicy policy = ResamplingPolicy::Balanced);
         /**@brief reads selected channels of multi-dimensional raster block.
          *
          * @param blockRect : rectangle of the block to be read. The rectangle is represented by cv::Rect structure
@@ -178,8 +199,11 @@ namespace slideio
          * allocate memory for the object if it is not yet allocated or allocated not enough memory.
          * All channels have to be of the same type. The method will throw an error by attempt to put read several channels
          * of different types in one block.
+         * @param policy : trade-off between speed and quality of the resampling. It selects
+         * the zoom level the block is read from and the interpolation, see ResamplingPolicy.
          */
-        virtual void readResampled4DBlockChannels(const cv::Rect& blockRect, const cv::Size& blockSize, const std::vector<int>& channelIndices, const cv::Range& zSliceRange, const cv::Range& timeFrameRange, cv::OutputArray output);
+        virtual void readResampled4DBlockChannels(const cv::Rect& blockRect, const cv::Size& blockSize, const std::vector<int>& channelIndices, const cv::Range& zSliceRange, const cv::Range& timeFrameRange, cv::OutputArray output,
+            ResamplingPolicy policy = ResamplingPolicy::Balanced);
         /**@brief returns list of auxiliary image names.*/
         virtual const std::list<std::string>& getAuxImageNames() const {
             return m_auxNames;
@@ -193,7 +217,7 @@ namespace slideio
          */
         virtual std::shared_ptr<CVScene> getAuxImage(const std::string& imageName) const;
         /**@brief returns string of serialized metadata. Content of the string depends on image format.*/
-        virtual std::string getRawMetadata() const { return m_rawMetadata; }
+        virtual const std::string& getRawMetadata() const { return m_rawMetadata; }
         /**@brief returns metadata as a navigable tree. Built lazily on first call. */
         const Metadata& getMetadata() const;
         virtual void readResampledBlockChannelsEx(const cv::Rect& blockRect, const cv::Size& blockSize,
@@ -259,6 +283,23 @@ namespace slideio
          * count nor the attribute values must change after the first read.
          */
         const Metadata& getChannelAttributes() const;
+        /**@brief returns counters and latency histograms of the reads of the scene.
+         *
+         * Collected while ReadStatistics::setEnabled(true) is in effect.
+         */
+        const ReadStatistics& getReadStatistics() const { return m_readStatistics; }
+        void resetReadStatistics() { m_readStatistics.reset(); }
+        /**@brief closes the files the scene keeps open. The parsed structure is kept
+         * and the next read reopens the files transparently.
+         *
+         * @return false if a read of the scene is running or the driver cannot close
+         * the files of the scene; the files stay open then.
+         */
+        bool releaseFileHandles();
+        /**@brief makes the next read of the scene notify the listener: set when the files
+         * of the scene are closed, to report that the read reopens them.
+         */
+        void notifyNextReopen(const std::weak_ptr<FileReopenListener>& listener);
     protected:
         /**@brief adds a new attribute to channels */
         virtual void setChannelAttribute(int channelIndex, const std::string& attributeName, const std::string& attributeValue);
@@ -283,6 +324,19 @@ namespace slideio
          * slideio::detail::builderFromJson from "slideio/core/metadata_internal.hpp".
          */
         virtual MetadataBuilder buildMetadataTree() const;
+        /**@brief attributes the reads of the calling thread to the scene until the scope
+         * ends. Does nothing if collection of read statistics is off.
+         */
+        void startReadStatistics(ReadStatisticsScope& scope);
+        /**@brief Driver hook: closes the file handles of the scene. Called while no
+         * read of the scene runs.
+         *
+         * @return false if the scene cannot close its files; they stay open then.
+         * Drivers that do not implement the hook keep their files open.
+         */
+        virtual bool closeFileHandles() { return false; }
+        /**@brief notifies the reopen listener on the first reference of a read. */
+        void initializeCounter() override;
 
     protected:
         std::list<std::string> m_auxNames;
@@ -306,6 +360,9 @@ namespace slideio
         mutable Metadata       m_metadata;
         mutable std::once_flag m_channelAttrsOnce;
         mutable Metadata       m_channelAttributesMeta;
+        ReadStatistics         m_readStatistics;
+        std::mutex             m_reopenMutex;
+        std::weak_ptr<FileReopenListener> m_reopenListener;
     };
 }
 
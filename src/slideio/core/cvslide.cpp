@@ -21,6 +21,36 @@ std::shared_ptr<CVScene> CVSlide::getAuxImage(const std::string& sceneName) cons
     throw std::runtime_error("The slide does not have any auxiliary image");
 }
 
+bool CVSlide::releaseFileHandles()
+{
+    bool released = true;
+    for (int i = 0; i < getNumScenes(); ++i) {
+        released = getScene(i)->releaseFileHandles() && released;
+    }
+    return released;
+}
+
+static bool runIfUnusedFrom(const std::vector<std::shared_ptr<CVScene>>& scenes, size_t first,
+                            const std::function<void()>& action)
+{
+    if (first == scenes.size()) {
+        action();
+        return true;
+    }
+    // every scene stays exclusive until the action of the last one returns
+    bool done = false;
+    scenes[first]->runIfUnused([&]() {
+        done = runIfUnusedFrom(scenes, first + 1, action);
+    });
+    return done;
+}
+
+bool CVSlide::runIfScenesUnused(const std::vector<std::shared_ptr<CVScene>>& scenes,
+                                const std::function<void()>& action)
+{
+    return runIfUnusedFrom(scenes, 0, action);
+}
+
 static std::string trimStart(const std::string& s) {
     auto it = std::find_if_not(s.begin(), s.end(), [](unsigned char ch) { return std::isspace(ch); });
     return std::string(it, s.end());
@@ -71,7 +101,7 @@ std::string CVSlide::toString() const {
 	for (const auto& name : getAuxImageNames()) {
 		os << "  " << name << "\n";
 	}
-	std::string metadata = getRawMetadata();
+	const std::string& metadata = getRawMetadata();
 	if (!metadata.empty()) {
 		os << "Metadata: " << "\n";
 		if (metadata.size() > 100) {
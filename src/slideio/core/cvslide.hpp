@@ -8,6 +8,7 @@
 #include "slideio/core/metadata.hpp"
 #include <string>
 #include <mutex>
+#include <functional>
 
 #if defined(_MSC_VER)
 #pragma warning( push )
@@ -78,8 +79,22 @@ namespace slideio
          static MetadataFormat recognizeMetadataFormat(const std::string& metadata);
 		 /**@brief The method returns a string containing serialized metadata of the slide. */
          std::string toString() const;
+        /**@brief closes the files kept open by the slide and its scenes. The parsed
+         * structure is kept and the next read reopens the files transparently.
+         *
+         * @return false if a read is running or the driver cannot close its files;
+         * the files stay open then.
+         */
+        virtual bool releaseFileHandles();
     protected:
         virtual MetadataBuilder buildMetadataTree() const;
+        /**@brief runs the action while none of the scenes is read: for slides whose
+         * scenes share the file handles of the slide. Reads starting meanwhile wait.
+         *
+         * @return false if a read of a scene is running; the action is not run then.
+         */
+        static bool runIfScenesUnused(const std::vector<std::shared_ptr<CVScene>>& scenes,
+            const std::function<void()>& action);
 
     protected:
         std::string m_rawMetadata;
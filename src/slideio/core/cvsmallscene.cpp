@@ -5,6 +5,7 @@
 #include <opencv2/imgproc.hpp>
 
 #include "slideio/base/exceptions.hpp"
+#include "slideio/core/tools/tools.hpp"
 
 using namespace slideio;
 
@@ -15,8 +16,9 @@ void CVSmallScene::readResampledBlockChannelsEx(const cv::Rect& blockRect, const
 	if (zSliceIndex != 0 || tFrameIndex != 0) {
 		RAISE_RUNTIME_ERROR << "CVSmallScene: 3D and 4D images are not supported";
 	}
-    cv::Mat image;
-    readImage(image);
+    const cv::Mat image = m_imageCache.get("image", [this](cv::OutputArray raster) {
+        readImage(raster);
+    });
     cv::Rect imageRect = { 0, 0, image.size().width, image.size().height };
     cv::Rect intersection = blockRect & imageRect;
     cv::Mat imageBlock = image(intersection);
@@ -33,7 +35,7 @@ void CVSmallScene::readResampledBlockChannelsEx(const cv::Rect& blockRect, const
         block = imageBlock;
     }
     cv::Mat resizedBlock;
-    cv::resize(block, resizedBlock, blockSize);
+    Tools::resize(block, resizedBlock, blockSize);
     if(output.empty()) {
         output.assign(resizedBlock);
     }
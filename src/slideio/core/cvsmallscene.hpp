@@ -5,6 +5,7 @@
 
 #include "slideio/core/slideio_core_def.hpp"
 #include "slideio/core/cvscene.hpp"
+#include "slideio/core/tools/rastercache.hpp"
 
 #if defined(_MSC_VER)
 #pragma warning( push )
@@ -47,6 +48,7 @@ namespace slideio
             const std::vector<int>& channelIndices, int zSliceIndex, int tFrameIndex, cv::OutputArray output) override;
         virtual bool init() { return false; }
     protected:
+        // Decodes the whole image; the result is cached for the next blocks.
         virtual void readImage(cv::OutputArray output) = 0;
     protected:
         std::string m_filePath;
@@ -57,5 +59,6 @@ namespace slideio
         double m_magnification{ 0. };
         Compression m_compression{ Compression::Unknown };
         DataType m_channelDataType;
+        RasterCache m_imageCache;
     };
 };
@@ -13,6 +13,8 @@ namespace slideio
     {
         std::shared_ptr<const nlohmann::json> root;
         const nlohmann::json*                 view = nullptr;
+        // Set instead of root/view for a node of a lazily materialised tree.
+        std::shared_ptr<const detail::LazyMetadataNode> lazy;
     };
 
     namespace
@@ -30,6 +32,90 @@ namespace slideio
             impl->view = &child;
             return Metadata::fromImpl(impl);
         }
+        Metadata makeLazyNode(std::shared_ptr<const detail::LazyMetadataNode> node)
+        {
+            if (!node) return Metadata();
+            auto impl = std::make_shared<Metadata::Impl>();
+            impl->lazy = std::move(node);
+            return Metadata::fromImpl(impl);
+        }
+        const detail::LazyMetadataNode* lazy(const std::shared_ptr<const Metadata::Impl>& p)
+        {
+            return p ? p->lazy.get() : nullptr;
+        }
+        // Scalar value of a node for the conversions. Lazy scalars are strings;
+        // other lazy nodes are converted to fail or dump like json ones.
+        nlohmann::json lazyValue(const detail::LazyMetadataNode& node)
+        {
+            if (node.type() == Metadata::Type::String) return nlohmann::json(node.text());
+            return node.toJson();
+        }
+        // Splits a json pointer ("/a/0/b") into unescaped reference tokens.
+        bool splitPointer(const std::string& pointer, std::vector<std::string>& tokens)
+        {
+            if (pointer.empty()) return true;
+            if (pointer[0] != '/') return false;
+            size_t start = 1;
+            while (true)
+            {
+                const size_t end = pointer.find('/', start);
+                std::string token = pointer.substr(start, end == std::string::npos ? std::string::npos : end - start);
+                std::string unescaped;
+                for (size_t i = 0; i < token.size(); ++i)
+                {
+                    if (token[i] != '~') { unescaped += token[i]; continue; }
+                    if (i + 1 >= token.size()) return false;
+                    const char next = token[++i];
+                    if (next == '0') unescaped += '~';
+                    else if (next == '1') unescaped += '/';
+                    else return false;
+                }
+                tokens.push_back(std::move(unescaped));
+                if (end == std::string::npos) break;
+                start = end + 1;
+            }
+            return true;
+        }
+        bool parseIndex(const std::string& token, size_t& index)
+        {
+            if (token.empty() || (token.size() > 1 && token[0] == '0')) return false;
+            index = 0;
+            for (char c : token)
+            {
+                if (c < '0' || c > '9') return false;
+                index = index * 10 + static_cast<size_t>(c - '0');
+            }
+            return true;
+        }
+        bool boolOf(const nlohmann::json& n)
+        {
+            if (n.is_boolean()) return n.get<bool>();
+            if (n.is_number())  return n.get<double>() != 0.0;
+            if (n.is_string())  { auto s = n.get<std::string>(); return s == "true" || s == "1"; }
+            throw std::runtime_error("Metadata: not convertible to bool");
+        }
+        int64_t intOf(const nlohmann::json& n)
+        {
+            if (n.is_number_integer())  return n.get<int64_t>();
+            if (n.is_number_unsigned()) return static_cast<int64_t>(n.get<uint64_t>());
+            if (n.is_number_float())    return static_cast<int64_t>(n.get<double>());
+            if (n.is_boolean())         return n.get<bool>() ? 1 : 0;
+            if (n.is_string())          return std::stoll(n.get<std::string>());
+            throw std::runtime_error("Metadata: not convertible to int");
+        }
+        double doubleOf(const nlohmann::json& n)
+        {
+            if (n.is_number())  return n.get<double>();
+            if (n.is_boolean()) return n.get<bool>() ? 1.0 : 0.0;
+            if (n.is_string())  return std::stod(n.get<std::string>());
+            throw std::runtime_error("Metadata: not convertible to double");
+        }
+        std::string stringOf(const nlohmann::json& n)
+        {
+            if (n.is_string()) return n.get<std::string>();
+            if (n.is_null())   return {};
+            return n.dump();
+        }
     }
 
     Metadata::Metadata() = default;
@@ -47,6 +133,7 @@ namespace slideio
     Metadata::Type Metadata::type() const
     {
         using J = nlohmann::json;
+        if (const auto* node = lazy(m_impl)) return node->type();
         switch (view(m_impl).type())
         {
         case J::value_t::null:            return Type::Null;
@@ -63,56 +150,47 @@ namespace slideio
 
     bool Metadata::asBool() const
     {
-        const auto& n = view(m_impl);
-        if (n.is_boolean()) return n.get<bool>();
-        if (n.is_number())  return n.get<double>() != 0.0;
-        if (n.is_string())  { auto s = n.get<std::string>(); return s == "true" || s == "1"; }
-        throw std::runtime_error("Metadata: not convertible to bool");
+        if (const auto* node = lazy(m_impl)) return boolOf(lazyValue(*node));
+        return boolOf(view(m_impl));
     }
     int64_t Metadata::asInt() const
     {
-        const auto& n = view(m_impl);
-        if (n.is_number_integer())  return n.get<int64_t>();
-        if (n.is_number_unsigned()) return static_cast<int64_t>(n.get<uint64_t>());
-        if (n.is_number_float())    return static_cast<int64_t>(n.get<double>());
-        if (n.is_boolean())         return n.get<bool>() ? 1 : 0;
-        if (n.is_string())          return std::stoll(n.get<std::string>());
-        throw std::runtime_error("Metadata: not convertible to int");
+        if (const auto* node = lazy(m_impl)) return intOf(lazyValue(*node));
+        return intOf(view(m_impl));
     }
     double Metadata::asDouble() const
     {
-        const auto& n = view(m_impl);
-        if (n.is_number())  return n.get<double>();
-        if (n.is_boolean()) return n.get<bool>() ? 1.0 : 0.0;
-        if (n.is_string())  return std::stod(n.get<std::string>());
-        throw std::runtime_error("Metadata: not convertible to double");
+        if (const auto* node = lazy(m_impl)) return doubleOf(lazyValue(*node));
+        return doubleOf(view(m_impl));
     }
     std::string Metadata::asString() const
     {
-        const auto& n = view(m_impl);
-        if (n.is_string()) return n.get<std::string>();
-        if (n.is_null())   return {};
-        return n.dump();
+        if (const auto* node = lazy(m_impl)) return stringOf(lazyValue(*node));
+        return stringOf(view(m_impl));
     }
 
     size_t Metadata::size() const
     {
+        if (const auto* node = lazy(m_impl)) return node->size();
         const auto& n = view(m_impl);
         return (n.is_object() || n.is_array()) ? n.size() : 0;
     }
     bool Metadata::contains(const std::string& key) const
     {
+        if (const auto* node = lazy(m_impl)) return node->contains(key);
         const auto& n = view(m_impl);
         return n.is_object() && n.contains(key);
     }
     Metadata Metadata::operator[](const std::string& key) const
     {
+        if (const auto* node = lazy(m_impl)) return makeLazyNode(node->child(key));
         const auto& n = view(m_impl);
         if (!m_impl || !n.is_object() || !n.contains(key)) return Metadata();
         return makeChild(m_impl, n.at(key));
     }
     Metadata Metadata::operator[](size_t i) const
     {
+        if (const auto* node = lazy(m_impl)) return makeLazyNode(node->child(i));
         const auto& n = view(m_impl);
         if (!m_impl || !n.is_array() || i >= n.size()) return Metadata();
         return makeChild(m_impl, n.at(i));
@@ -120,6 +198,22 @@ namespace slideio
     Metadata Metadata::find(const std::string& pointer) const
     {
         if (!m_impl) return Metadata();
+        if (m_impl->lazy)
+        {
+            std::vector<std::string> tokens;
+            if (!splitPointer(pointer, tokens)) return Metadata();
+            std::shared_ptr<const detail::LazyMetadataNode> node = m_impl->lazy;
+            for (const auto& token : tokens)
+            {
+                size_t index = 0;
+                if (node->type() == Type::Array)
+                    node = parseIndex(token, index) ? node->child(index) : nullptr;
+                else
+                    node = node->child(token);
+                if (!node) return Metadata();
+            }
+            return makeLazyNode(std::move(node));
+        }
         try
         {
             nlohmann::json::json_pointer ptr(pointer);
@@ -130,6 +224,7 @@ namespace slideio
     }
     std::vector<std::string> Metadata::keys() const
     {
+        if (const auto* node = lazy(m_impl)) return node->keys();
         const auto& n = view(m_impl);
         std::vector<std::string> out;
         if (n.is_object())
@@ -139,7 +234,11 @@ namespace slideio
         }
         return out;
     }
-    std::string Metadata::toJson(int indent) const { return view(m_impl).dump(indent); }
+    std::string Metadata::toJson(int indent) const
+    {
+        if (const auto* node = lazy(m_impl)) return node->toJson().dump(indent);
+        return view(m_impl).dump(indent);
+    }
 
     namespace detail {
         Metadata makeMetadataFromJson(nlohmann::json root)
@@ -151,12 +250,28 @@ namespace slideio
             return Metadata::fromImpl(impl);
         }
 
+        Metadata makeLazyMetadata(std::shared_ptr<const LazyMetadataNode> root)
+        {
+            return makeLazyNode(std::move(root));
+        }
     }
 
     struct MetadataBuilder::Impl
     {
         std::shared_ptr<nlohmann::json> root;   // shared owner of the tree
         nlohmann::json*                 view = nullptr;   // points into *root
+        // Unmodified lazy tree of a root builder; converted into *root on the
+        // first access that needs json.
+        std::shared_ptr<const detail::LazyMetadataNode> lazy;
+
+        nlohmann::json& node()
+        {
+            if (lazy) {
+                *root = lazy->toJson();
+                lazy.reset();
+            }
+            return *view;
+        }
     };
 
     MetadataBuilder::MetadataBuilder()
@@ -169,8 +284,10 @@ namespace slideio
     MetadataBuilder::MetadataBuilder(const MetadataBuilder& other)
         : m_impl(std::make_shared<Impl>())
     {
-        // Deep copy the visible subtree into a fresh root.
-        m_impl->root = std::make_shared<nlohmann::json>(*other.m_impl->view);
+        // Deep copy the visible subtree into a fresh root; a lazy tree is immutable and shared.
+        m_impl->lazy = other.m_impl->lazy;
+        m_impl->root = m_impl->lazy ? std::make_shared<nlohmann::json>()
+                                    : std::make_shared<nlohmann::json>(*other.m_impl->view);
         m_impl->view = m_impl->root.get();
     }
 
@@ -180,7 +297,9 @@ namespace slideio
     {
         if (this != &other) {
             auto fresh = std::make_shared<Impl>();
-            fresh->root = std::make_shared<nlohmann::json>(*other.m_impl->view);
+            fresh->lazy = other.m_impl->lazy;
+            fresh->root = fresh->lazy ? std::make_shared<nlohmann::json>()
+                                      : std::make_shared<nlohmann::json>(*other.m_impl->view);
             fresh->view = fresh->root.get();
             m_impl = std::move(fresh);
         }
@@ -203,6 +322,15 @@ namespace slideio
             return MetadataBuilder::fromImpl(std::move(impl));
         }
 
+        MetadataBuilder builderFromLazy(std::shared_ptr<const LazyMetadataNode> root)
+        {
+            auto impl = std::make_shared<MetadataBuilder::Impl>();
+            impl->root = std::make_shared<nlohmann::json>();
+            impl->view = impl->root.get();
+            impl->lazy = std::move(root);
+            return MetadataBuilder::fromImpl(std::move(impl));
+        }
+
         MetadataBuilder makeDefaultMetadataBuilder(
             const std::string& rawMetadata, MetadataFormat fmt)
         {
@@ -217,8 +345,16 @@ namespace slideio
                 }
                 break;
             case MetadataFormat::XML:
-                root = xmlStringToJson(rawMetadata);
+            {
+                // Large xml documents (czi, ome-tiff) are indexed, not converted.
+                std::string error;
+                auto lazyRoot = xmlStringToLazyNode(rawMetadata, error);
+                if (lazyRoot) {
+                    return builderFromLazy(std::move(lazyRoot));
+                }
+                root = json{{"#error", error}};
                 break;
+            }
             case MetadataFormat::Text:
                 root = json{{"text", rawMetadata}};
                 break;
@@ -233,18 +369,22 @@ namespace slideio
 
     void MetadataBuilder::set(const std::string& value)
     {
+        m_impl->lazy.reset();
         *m_impl->view = value;
     }
     void MetadataBuilder::set(bool value)
     {
+        m_impl->lazy.reset();
         *m_impl->view = value;
     }
     void MetadataBuilder::set(int64_t value)
     {
+        m_impl->lazy.reset();
         *m_impl->view = value;
     }
     void MetadataBuilder::set(double value)
     {
+        m_impl->lazy.reset();
         *m_impl->view = value;
     }
     void MetadataBuilder::set(const char* value)
@@ -252,12 +392,13 @@ namespace slideio
         if (value == nullptr) {
             RAISE_RUNTIME_ERROR << "MetadataBuilder::set: const char* value must not be null";
         }
+        m_impl->lazy.reset();
         *m_impl->view = std::string(value);
     }
 
     MetadataBuilder MetadataBuilder::operator[](const std::string& key)
     {
-        if (m_impl->view->is_null()) {
+        if (m_impl->node().is_null()) {
             *m_impl->view = nlohmann::json::object();
         }
         if (!m_impl->view->is_object()) {
@@ -272,14 +413,14 @@ namespace slideio
 
     void MetadataBuilder::makeObject()
     {
-        if (!m_impl->view->is_object()) {
+        if (!m_impl->node().is_object()) {
             *m_impl->view = nlohmann::json::object();
         }
     }
 
     MetadataBuilder MetadataBuilder::operator[](size_t index)
     {
-        if (m_impl->view->is_null()) {
+        if (m_impl->node().is_null()) {
             *m_impl->view = nlohmann::json::array();
         }
         if (!m_impl->view->is_array()) {
@@ -297,34 +438,39 @@ namespace slideio
 
     void MetadataBuilder::makeArray()
     {
-        if (!m_impl->view->is_array()) {
+        if (!m_impl->node().is_array()) {
             *m_impl->view = nlohmann::json::array();
         }
     }
 
     bool MetadataBuilder::isNull() const
     {
+        if (m_impl->lazy) return m_impl->lazy->type() == Metadata::Type::Null;
         return m_impl->view->is_null();
     }
 
     bool MetadataBuilder::isObject() const
     {
+        if (m_impl->lazy) return m_impl->lazy->type() == Metadata::Type::Object;
         return m_impl->view->is_object();
     }
 
     bool MetadataBuilder::isArray() const
     {
+        if (m_impl->lazy) return m_impl->lazy->type() == Metadata::Type::Array;
         return m_impl->view->is_array();
     }
 
     size_t MetadataBuilder::size() const
     {
+        if (m_impl->lazy) return m_impl->lazy->size();
         const auto& v = *m_impl->view;
         return (v.is_object() || v.is_array()) ? v.size() : 0u;
     }
 
     Metadata MetadataBuilder::freeze() const
     {
+        if (m_impl->lazy) return detail::makeLazyMetadata(m_impl->lazy);
         return detail::makeMetadataFromJson(nlohmann::json(*m_impl->view));
     }
 }
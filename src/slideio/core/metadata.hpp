@@ -20,7 +20,8 @@ namespace slideio
      *
      * Built lazily by CVScene / CVSlide on first call to getMetadata(). Children
      * returned by operator[] / find() are lightweight views into the same root
-     * tree and share its lifetime.
+     * tree and share its lifetime. XML metadata is indexed instead of being
+     * converted: a node is created only when it is queried.
      */
     class SLIDEIO_CORE_EXPORTS Metadata
     {
@@ -9,9 +9,38 @@
 
 namespace slideio { namespace detail {
 
+    // Node of a metadata tree that is materialised on demand. Implementations
+    // index their source (e.g. a parsed XML document) and create child nodes
+    // only when they are queried. Nodes are immutable and may be shared
+    // between threads.
+    class LazyMetadataNode
+    {
+    public:
+        virtual ~LazyMetadataNode() = default;
+        virtual Metadata::Type type() const = 0;
+        // Value of a String node.
+        virtual std::string text() const = 0;
+        virtual size_t size() const = 0;
+        virtual bool contains(const std::string& key) const = 0;
+        // Returns nullptr if there is no such child.
+        virtual std::shared_ptr<const LazyMetadataNode> child(const std::string& key) const = 0;
+        virtual std::shared_ptr<const LazyMetadataNode> child(size_t index) const = 0;
+        virtual std::vector<std::string> keys() const = 0;
+        // Materialises the subtree of the node.
+        virtual nlohmann::json toJson() const = 0;
+    };
+
     SLIDEIO_CORE_EXPORTS Metadata    makeMetadataFromJson(nlohmann::json root);
     SLIDEIO_CORE_EXPORTS nlohmann::json xmlStringToJson(const std::string& xml);
     SLIDEIO_CORE_EXPORTS MetadataBuilder builderFromJson(nlohmann::json root);
+    SLIDEIO_CORE_EXPORTS Metadata    makeLazyMetadata(std::shared_ptr<const LazyMetadataNode> root);
+    // Builder over a lazy tree. The tree is materialised only when the builder is
+    // modified; freeze() of an unmodified builder returns the lazy tree itself.
+    SLIDEIO_CORE_EXPORTS MetadataBuilder builderFromLazy(std::shared_ptr<const LazyMetadataNode> root);
+    // Indexes an xml document without converting it. Returns nullptr and sets
+    // error if the document cannot be parsed.
+    SLIDEIO_CORE_EXPORTS std::shared_ptr<const LazyMetadataNode> xmlStringToLazyNode(
+        const std::string& xml, std::string& error);
     SLIDEIO_CORE_EXPORTS MetadataBuilder makeDefaultMetadataBuilder(
         const std::string& rawMetadata, MetadataFormat fmt);
 
@@ -4,6 +4,7 @@
 #include "slideio/core/metadata_internal.hpp"
 #include <nlohmann/json.hpp>
 #include <tinyxml2.h>
+#include <set>
 #include <string>
 
 namespace slideio { namespace detail {
@@ -61,6 +62,175 @@ namespace
         }
         return node;
     }
+
+    // The lazy nodes below mirror the mapping of elementToJson over the
+    // tinyxml2 DOM: the document is parsed once and json is never built
+    // for nodes that are not converted explicitly.
+    using Document = std::shared_ptr<const tinyxml2::XMLDocument>;
+
+    class XmlValueNode : public LazyMetadataNode
+    {
+    public:
+        XmlValueNode(Document doc, const char* value) : m_doc(std::move(doc)), m_value(value) {}
+        Metadata::Type type() const override { return Metadata::Type::String; }
+        std::string text() const override { return m_value; }
+        size_t size() const override { return 0; }
+        bool contains(const std::string&) const override { return false; }
+        std::shared_ptr<const LazyMetadataNode> child(const std::string&) const override { return nullptr; }
+        std::shared_ptr<const LazyMetadataNode> child(size_t) const override { return nullptr; }
+        std::vector<std::string> keys() const override { return {}; }
+        json toJson() const override { return json(m_value); }
+    private:
+        Document m_doc;
+        const char* m_value;
+    };
+
+    class XmlElementNode : public LazyMetadataNode
+    {
+    public:
+        XmlElementNode(Document doc, const XMLElement* el) : m_doc(std::move(doc)), m_element(el) {
+            const char* txt = el->GetText();
+            m_text = (txt && *txt) ? txt : nullptr;
+            m_leaf = m_text && !el->FirstAttribute() && !el->FirstChildElement();
+        }
+        Metadata::Type type() const override {
+            return m_leaf ? Metadata::Type::String : Metadata::Type::Object;
+        }
+        std::string text() const override { return m_text ? m_text : ""; }
+        size_t size() const override { return m_leaf ? 0 : keys().size(); }
+        bool contains(const std::string& key) const override {
+            return !m_leaf && child(key) != nullptr;
+        }
+        std::shared_ptr<const LazyMetadataNode> child(const std::string& key) const override;
+        std::shared_ptr<const LazyMetadataNode> child(size_t) const override { return nullptr; }
+        std::vector<std::string> keys() const override {
+            std::vector<std::string> out;
+            if (m_leaf) return out;
+            // same order as the keys of a json object
+            std::set<std::string> names;
+            for (const auto* a = m_element->FirstAttribute(); a; a = a->Next()) {
+                names.insert(std::string("@") + a->Name());
+            }
+            for (const XMLElement* c = m_element->FirstChildElement(); c; c = c->NextSiblingElement()) {
+                names.insert(c->Name());
+            }
+            if (m_text) names.insert("#text");
+            out.assign(names.begin(), names.end());
+            return out;
+        }
+        json toJson() const override { return elementToJson(m_element); }
+    private:
+        Document m_doc;
+        const XMLElement* m_element;
+        const char* m_text;
+        bool m_leaf;
+    };
+
+    // Repeated sibling elements of the same name.
+    class XmlArrayNode : public LazyMetadataNode
+    {
+    public:
+        XmlArrayNode(Document doc, std::vector<const XMLElement*> items)
+            : m_doc(std::move(doc)), m_items(std::move(items)) {}
+        Metadata::Type type() const override { return Metadata::Type::Array; }
+        std::string text() const override { return {}; }
+        size_t size() const override { return m_items.size(); }
+        bool contains(const std::string&) const override { return false; }
+        std::shared_ptr<const LazyMetadataNode> child(const std::string&) const override { return nullptr; }
+        std::shared_ptr<const LazyMetadataNode> child(size_t index) const override {
+            if (index >= m_items.size()) return nullptr;
+            return std::make_shared<XmlElementNode>(m_doc, m_items[index]);
+        }
+        std::vector<std::string> keys() const override { return {}; }
+        json toJson() const override {
+            json out = json::array();
+            for (const XMLElement* item : m_items) out.push_back(elementToJson(item));
+            return out;
+        }
+    private:
+        Document m_doc;
+        std::vector<const XMLElement*> m_items;
+    };
+
+    std::shared_ptr<const LazyMetadataNode> XmlElementNode::child(const std::string& key) const
+    {
+        if (m_leaf) return nullptr;
+        if (!key.empty() && key[0] == '@') {
+            const char* value = m_element->Attribute(key.c_str() + 1);
+            return value ? std::make_shared<XmlValueNode>(m_doc, value) : nullptr;
+        }
+        if (key == "#text") {
+            return m_text ? std::make_shared<XmlValueNode>(m_doc, m_text) : nullptr;
+        }
+        std::vector<const XMLElement*> items;
+        for (const XMLElement* c = m_element->FirstChildElement(key.c_str()); c;
+             c = c->NextSiblingElement(key.c_str())) {
+            items.push_back(c);
+        }
+        if (items.empty()) return nullptr;
+        if (items.size() == 1) return std::make_shared<XmlElementNode>(m_doc, items.front());
+        return std::make_shared<XmlArrayNode>(m_doc, std::move(items));
+    }
+
+    // tinyxml2 resolves entities of names and values in place on their first
+    // access. Doing it for the whole document up front keeps the shared
+    // document read-only afterwards; no memory is allocated by that.
+    void resolveStrings(const tinyxml2::XMLDocument& doc)
+    {
+        const tinyxml2::XMLNode* node = doc.FirstChild();
+        while (node)
+        {
+            node->Value();
+            if (const XMLElement* el = node->ToElement())
+            {
+                for (const auto* a = el->FirstAttribute(); a; a = a->Next())
+                {
+                    a->Name();
+                    a->Value();
+                }
+            }
+            if (node->FirstChild())
+            {
+                node = node->FirstChild();
+                continue;
+            }
+            while (node && !node->NextSibling())
+            {
+                node = node->Parent();
+            }
+            if (node) node = node->NextSibling();
+        }
+    }
+
+    // {rootName: root} like the result of xmlStringToJson.
+    class XmlDocumentNode : public LazyMetadataNode
+    {
+    public:
+        explicit XmlDocumentNode(Document doc) : m_doc(std::move(doc)), m_root(m_doc->RootElement()) {}
+        Metadata::Type type() const override { return Metadata::Type::Object; }
+        std::string text() const override { return {}; }
+        size_t size() const override { return m_root ? 1 : 0; }
+        bool contains(const std::string& key) const override {
+            return m_root && key == m_root->Name();
+        }
+        std::shared_ptr<const LazyMetadataNode> child(const std::string& key) const override {
+            if (!contains(key)) return nullptr;
+            return std::make_shared<XmlElementNode>(m_doc, m_root);
+        }
+        std::shared_ptr<const LazyMetadataNode> child(size_t) const override { return nullptr; }
+        std::vector<std::string> keys() const override {
+            if (!m_root) return {};
+            return { m_root->Name() };
+        }
+        json toJson() const override {
+            json out = json::object();
+            if (m_root) out[m_root->Name()] = elementToJson(m_root);
+            return out;
+        }
+    private:
+        Document m_doc;
+        const XMLElement* m_root;
+    };
 }
 
 json xmlStringToJson(const std::string& xml)
@@ -78,4 +248,17 @@ json xmlStringToJson(const std::string& xml)
     return out;
 }
 
+std::shared_ptr<const LazyMetadataNode> xmlStringToLazyNode(const std::string& xml, std::string& error)
+{
+    auto doc = std::make_shared<tinyxml2::XMLDocument>();
+    if (doc->Parse(xml.c_str(), xml.size()) != tinyxml2::XML_SUCCESS)
+    {
+        const char* err = doc->ErrorStr();
+        error = err ? err : "xml parse error";
+        return nullptr;
+    }
+    resolveStrings(*doc);
+    return std::make_shared<XmlDocumentNode>(std::move(doc));
+}
+
 }}
@@ -4,24 +4,58 @@
 #pragma once
 #include "slideio/core/slideio_core_def.hpp"
 #include <atomic>
+#include <functional>
+#include <mutex>
 namespace slideio
 {
     class SLIDEIO_CORE_EXPORTS RefCounter
     {
     public:
         void increaseCounter() {
-            if (m_counter.fetch_add(1, std::memory_order_acq_rel) == 0)
+            int value = m_counter.load(std::memory_order_acquire);
+            while (true) {
+                if (value == EXCLUSIVE) {
+                    // runIfUnused holds the mutex while the counter is exclusive
+                    std::lock_guard<std::mutex> lock(m_exclusiveMutex);
+                    value = m_counter.load(std::memory_order_acquire);
+                    continue;
+                }
+                if (m_counter.compare_exchange_weak(value, value + 1, std::memory_order_acq_rel)) {
+                    break;
+                }
+            }
+            if (value == 0)
                 initializeCounter();
         }
         void decreaseCounter() {
             if (m_counter.fetch_sub(1, std::memory_order_acq_rel) == 1)
                 cleanCounter();
         }
+        // Runs the action if no reference is held. References taken meanwhile wait
+        // until it returns. Returns false if the action was not run.
+        bool runIfUnused(const std::function<void()>& action) {
+            std::lock_guard<std::mutex> lock(m_exclusiveMutex);
+            int expected = 0;
+            if (!m_counter.compare_exchange_strong(expected, EXCLUSIVE, std::memory_order_acq_rel)) {
+                return false;
+            }
+            try {
+                action();
+            }
+            catch (...) {
+                m_counter.store(0, std::memory_order_release);
+                throw;
+            }
+            m_counter.store(0, std::memory_order_release);
+            return true;
+        }
     protected:
         virtual void initializeCounter(){};
         virtual void cleanCounter(){};
     private:
+        static constexpr int EXCLUSIVE = -1;
         std::atomic<int> m_counter{0};
+        std::mutex m_exclusiveMutex;
     };
 
     class SLIDEIO_CORE_EXPORTS RefCounterGuard
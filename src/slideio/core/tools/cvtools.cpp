@@ -171,6 +171,7 @@ std::string CVTools::compressionToString(Compression compression) {
     case slideio::Compression::GIF: name = "GIF"; break;
     case slideio::Compression::BIGGIF: name = "BIGGIF"; break;
     case slideio::Compression::RLE: name = "RLE"; break;
+    case slideio::Compression::Zstd: name = "Zstd"; break;
     default: name = std::to_string((int)compression);
     }
     return name;
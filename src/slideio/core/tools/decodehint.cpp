@@ -0,0 +1,23 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "slideio/core/tools/decodehint.hpp"
+
+using namespace slideio;
+
+namespace
+{
+    thread_local DecodeHint threadHint = DecodeHint::None;
+}
+
+DecodeHint DecodeHints::get() {
+    return threadHint;
+}
+
+DecodeHintScope::DecodeHintScope(DecodeHint hint) : m_previous(threadHint) {
+    threadHint = hint;
+}
+
+DecodeHintScope::~DecodeHintScope() {
+    threadHint = m_previous;
+}
@@ -0,0 +1,40 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+
+#include "slideio/core/slideio_core_def.hpp"
+
+namespace slideio
+{
+    enum class DecodeHint
+    {
+        None,
+        // The reader converts the block to grayscale (RGB to GRAY weights). Decoders of
+        // 3-channel 8-bit color data may put the luminance into every channel of the
+        // block instead of the colors: the conversion gives the luminance either way,
+        // and the decoder skips the chroma.
+        Luminance
+    };
+
+    // Decode hint of the read running on the calling thread. Decoders are free to ignore
+    // it; a decoder that follows it must not cache what it decodes under the hint.
+    class SLIDEIO_CORE_EXPORTS DecodeHints
+    {
+    public:
+        // Hint of the calling thread; None outside of a DecodeHintScope.
+        static DecodeHint get();
+    };
+
+    // Sets the decode hint of the calling thread until the scope ends. Scopes nest.
+    class SLIDEIO_CORE_EXPORTS DecodeHintScope
+    {
+    public:
+        explicit DecodeHintScope(DecodeHint hint);
+        DecodeHintScope(const DecodeHintScope&) = delete;
+        DecodeHintScope& operator=(const DecodeHintScope&) = delete;
+        ~DecodeHintScope();
+    private:
+        DecodeHint m_previous;
+    };
+}
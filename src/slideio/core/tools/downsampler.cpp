@@ -0,0 +1,202 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "slideio/core/tools/downsampler.hpp"
+#include "slideio/base/exceptions.hpp"
+#include <opencv2/imgproc.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+using namespace slideio;
+
+namespace
+{
+    // Accumulators of one pass: rows are summed in chunks that fit the buffer
+    constexpr int BUFFER_SIZE = 4096;
+
+    // Sums of up to 8x8 values: 8-bit values fit 16 bits, 16-bit values 32 bits.
+    template <typename T> struct Accumulator { using type = int32_t; };
+    template <> struct Accumulator<uint8_t> { using type = uint16_t; };
+    template <> struct Accumulator<int8_t> { using type = int16_t; };
+    template <> struct Accumulator<uint16_t> { using type = uint32_t; };
+    template <> struct Accumulator<int32_t> { using type = int64_t; };
+    template <> struct Accumulator<float> { using type = double; };
+
+    template <typename T, typename A>
+    void addRow(const T* src, A* sums, int count) {
+        for (int index = 0; index < count; ++index) {
+            sums[index] += src[index];
+        }
+    }
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    void addRow(const uint8_t* src, uint16_t* sums, int count) {
+        const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+        const int half = lanes / 2;
+        int index = 0;
+        for (; index <= count - lanes; index += lanes) {
+            cv::v_uint16 low, high;
+            cv::v_expand(cv::vx_load(src + index), low, high);
+            cv::v_store(sums + index, cv::v_add(cv::vx_load(sums + index), low));
+            cv::v_store(sums + index + half, cv::v_add(cv::vx_load(sums + index + half), high));
+        }
+        for (; index < count; ++index) {
+            sums[index] += src[index];
+        }
+    }
+
+    void addRow(const uint16_t* src, uint32_t* sums, int count) {
+        const int lanes = cv::VTraits<cv::v_uint16>::vlanes();
+        const int half = lanes / 2;
+        int index = 0;
+        for (; index <= count - lanes; index += lanes) {
+            cv::v_uint32 low, high;
+            cv::v_expand(cv::vx_load(src + index), low, high);
+            cv::v_store(sums + index, cv::v_add(cv::vx_load(sums + index), low));
+            cv::v_store(sums + index + half, cv::v_add(cv::vx_load(sums + index + half), high));
+        }
+        for (; index < count; ++index) {
+            sums[index] += src[index];
+        }
+    }
+#endif
+
+    template <typename T, typename A>
+    T average(A sum, int shift) {
+        if constexpr (std::is_floating_point<T>::value) {
+            return static_cast<T>(sum / static_cast<A>(1 << shift));
+        }
+        else {
+            // the shift floors negative sums as well: ties are rounded up
+            return static_cast<T>((sum + (static_cast<A>(1) << (shift - 1))) >> shift);
+        }
+    }
+
+    // Sums the factor pixels of every output pixel of a row. The channel count is a
+    // template parameter for the common rasters, so the inner loops unroll.
+    template <typename T, typename A, int CN>
+    void reduceRow(const A* sums, T* dst, int width, int factor, int shift) {
+        for (int x = 0; x < width; ++x) {
+            const A* block = sums + x * factor * CN;
+            for (int channel = 0; channel < CN; ++channel) {
+                A sum = 0;
+                for (int pixel = 0; pixel < factor; ++pixel) {
+                    sum += block[pixel * CN + channel];
+                }
+                dst[x * CN + channel] = average<T>(sum, shift);
+            }
+        }
+    }
+
+    template <typename T, typename A>
+    void reduceRow(const A* sums, T* dst, int width, int factor, int shift, int channels) {
+        switch (channels) {
+        case 1: reduceRow<T, A, 1>(sums, dst, width, factor, shift); return;
+        case 3: reduceRow<T, A, 3>(sums, dst, width, factor, shift); return;
+        case 4: reduceRow<T, A, 4>(sums, dst, width, factor, shift); return;
+        default: break;
+        }
+        for (int x = 0; x < width; ++x) {
+            const A* block = sums + x * factor * channels;
+            for (int channel = 0; channel < channels; ++channel) {
+                A sum = 0;
+                for (int pixel = 0; pixel < factor; ++pixel) {
+                    sum += block[pixel * channels + channel];
+                }
+                dst[x * channels + channel] = average<T>(sum, shift);
+            }
+        }
+    }
+
+    template <typename T>
+    void downsampleRaster(const cv::Mat& src, cv::Mat& dst, int factor) {
+        using A = typename Accumulator<T>::type;
+        const int channels = src.channels();
+        const int shift = factor == 2 ? 2 : (factor == 4 ? 4 : 6);
+        // source values of one output pixel in a row
+        const int group = factor * channels;
+        const int chunkWidth = BUFFER_SIZE / group;
+        A sums[BUFFER_SIZE];
+        for (int y = 0; y < dst.rows; ++y) {
+            T* dstRow = dst.ptr<T>(y);
+            for (int x = 0; x < dst.cols; x += chunkWidth) {
+                const int width = std::min(chunkWidth, dst.cols - x);
+                const int count = width * group;
+                std::fill(sums, sums + count, static_cast<A>(0));
+                for (int row = 0; row < factor; ++row) {
+                    addRow(src.ptr<T>(y * factor + row) + x * group, sums, count);
+                }
+                reduceRow(sums, dstRow + x * channels, width, factor, shift, channels);
+            }
+        }
+    }
+}
+
+int Downsampler::getFactor(const cv::Size& srcSize, const cv::Size& dstSize) {
+    if (dstSize.width <= 0 || dstSize.height <= 0) {
+        return 0;
+    }
+    for (int factor = 2; factor <= MAX_FACTOR; factor *= 2) {
+        if (dstSize.width * factor == srcSize.width && dstSize.height * factor == srcSize.height) {
+            return factor;
+        }
+    }
+    return 0;
+}
+
+bool Downsampler::isSupported(int type) {
+    switch (CV_MAT_DEPTH(type)) {
+    case CV_8U:
+    case CV_8S:
+    case CV_16U:
+    case CV_16S:
+    case CV_32S:
+    case CV_32F:
+        // the row chunk holds the channels of at least one output pixel
+        return CV_MAT_CN(type) * MAX_FACTOR <= BUFFER_SIZE;
+    default:
+        return false;
+    }
+}
+
+int Downsampler::selectFactor(const cv::Size& srcSize, const cv::Size& dstSize, int type, int interpolation) {
+    if (interpolation != cv::INTER_AREA && interpolation != cv::INTER_LINEAR) {
+        return 0;
+    }
+    const int factor = getFactor(srcSize, dstSize);
+    if (factor == 0 || !isSupported(type)) {
+        return 0;
+    }
+    if (interpolation == cv::INTER_LINEAR && factor != 2) {
+        return 0;
+    }
+    return factor;
+}
+
+void Downsampler::downsample(const cv::Mat& src, cv::Mat& dst, int factor) {
+    if (factor != 2 && factor != 4 && factor != 8) {
+        RAISE_RUNTIME_ERROR << "Downsampler: unsupported factor " << factor;
+    }
+    if (src.cols % factor != 0 || src.rows % factor != 0) {
+        RAISE_RUNTIME_ERROR << "Downsampler: raster size (" << src.cols << "," << src.rows
+            << ") is not a multiple of " << factor;
+    }
+    if (!isSupported(src.type())) {
+        RAISE_RUNTIME_ERROR << "Downsampler: unsupported raster type " << src.type();
+    }
+    const cv::Size dstSize(src.cols / factor, src.rows / factor);
+    if (dst.size() != dstSize || dst.type() != src.type()) {
+        dst.create(dstSize, src.type());
+    }
+    switch (src.depth()) {
+    case CV_8U: downsampleRaster<uint8_t>(src, dst, factor); break;
+    case CV_8S: downsampleRaster<int8_t>(src, dst, factor); break;
+    case CV_16U: downsampleRaster<uint16_t>(src, dst, factor); break;
+    case CV_16S: downsampleRaster<int16_t>(src, dst, factor); break;
+    case CV_32S: downsampleRaster<int32_t>(src, dst, factor); break;
+    case CV_32F: downsampleRaster<float>(src, dst, factor); break;
+    default: break;
+    }
+}
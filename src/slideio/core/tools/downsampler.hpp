@@ -0,0 +1,33 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+
+#include "slideio/core/slideio_core_def.hpp"
+#include <opencv2/core.hpp>
+
+namespace slideio
+{
+    // Reduction of rasters by 2, 4 or 8 in both directions by averaging factor x factor
+    // blocks (box / area filter). Rows are summed with SIMD (OpenCV universal intrinsics,
+    // scalar where the build has none) into a fixed stack buffer, so a reduction
+    // allocates nothing when the destination exists. Integer results are rounded half up.
+    class SLIDEIO_CORE_EXPORTS Downsampler
+    {
+    public:
+        static constexpr int MAX_FACTOR = 8;
+    public:
+        // Factor (2, 4 or 8) that reduces srcSize exactly to dstSize, 0 if there is none.
+        static int getFactor(const cv::Size& srcSize, const cv::Size& dstSize);
+        // 8U, 8S, 16U, 16S, 32S and 32F rasters with any number of channels.
+        static bool isSupported(int type);
+        // Factor to reduce a raster of the type from srcSize to dstSize with, if the box
+        // filter gives the result of the interpolation: any factor for cv::INTER_AREA,
+        // 2 for cv::INTER_LINEAR (which averages 2x2 blocks at half size). 0 otherwise.
+        static int selectFactor(const cv::Size& srcSize, const cv::Size& dstSize, int type, int interpolation);
+        // Averages factor x factor blocks of src into dst. src and dst may be ROIs of
+        // larger rasters. dst is created unless it has the type of src and the size of
+        // src divided by factor; src sizes must be multiples of factor.
+        static void downsample(const cv::Mat& src, cv::Mat& dst, int factor);
+    };
+}
@@ -0,0 +1,101 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "slideio/core/tools/rastercache.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
+#include <algorithm>
+
+using namespace slideio;
+
+cv::Mat RasterCache::get(const std::string& key, const Loader& loader) {
+    std::promise<cv::Mat> promise;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = std::find_if(m_entries.begin(), m_entries.end(),
+            [&key](const Entry& entry) { return entry.key == key; });
+        if (it != m_entries.end()) {
+            m_entries.splice(m_entries.begin(), m_entries, it);
+            ReadStatistics::countCacheHit();
+            return it->raster;
+        }
+        auto loading = m_loading.find(key);
+        if (loading != m_loading.end()) {
+            // another thread decodes the raster
+            std::shared_future<cv::Mat> future = loading->second;
+            lock.unlock();
+            ReadStatistics::countCacheHit();
+            return future.get();
+        }
+        m_loading.emplace(key, promise.get_future().share());
+    }
+    ReadStatistics::countCacheMiss();
+    cv::Mat raster;
+    try {
+        loader(raster);
+    }
+    catch (...) {
+        promise.set_exception(std::current_exception());
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_loading.erase(key);
+        throw;
+    }
+    raster = put(key, raster);
+    promise.set_value(raster);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_loading.erase(key);
+    return raster;
+}
+
+bool RasterCache::find(const std::string& key, cv::Mat& raster) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::find_if(m_entries.begin(), m_entries.end(),
+            [&key](const Entry& entry) { return entry.key == key; });
+        if (it != m_entries.end()) {
+            m_entries.splice(m_entries.begin(), m_entries, it);
+            ReadStatistics::countCacheHit();
+            raster = it->raster;
+            return true;
+        }
+    }
+    ReadStatistics::countCacheMiss();
+    return false;
+}
+
+cv::Mat RasterCache::put(const std::string& key, const cv::Mat& raster) {
+    const size_t bytes = rasterBytes(raster);
+    if (bytes > m_maxBytes) {
+        return raster;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // another thread may have decoded the same raster meanwhile
+    auto it = std::find_if(m_entries.begin(), m_entries.end(),
+        [&key](const Entry& entry) { return entry.key == key; });
+    if (it != m_entries.end()) {
+        m_entries.splice(m_entries.begin(), m_entries, it);
+        return it->raster;
+    }
+    m_entries.push_front({ key, raster });
+    m_size += bytes;
+    while (m_size > m_maxBytes && m_entries.size() > 1) {
+        m_size -= rasterBytes(m_entries.back().raster);
+        m_entries.pop_back();
+    }
+    return raster;
+}
+
+void RasterCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_size = 0;
+}
+
+size_t RasterCache::getSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size;
+}
+
+int RasterCache::getCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_entries.size());
+}
@@ -0,0 +1,71 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+
+#include "slideio/core/slideio_core_def.hpp"
+#include <opencv2/core.hpp>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+#if defined(_MSC_VER)
+#pragma warning( push )
+#pragma warning(disable: 4251)
+#endif
+
+namespace slideio
+{
+    // Small thread-safe LRU cache of decoded rasters, for images that can only be decoded
+    // as a whole (single-strip directories, thumbnails). The least recently used rasters
+    // are dropped when the total size exceeds the budget. Returned rasters share the
+    // cached data and must not be modified.
+    class SLIDEIO_CORE_EXPORTS RasterCache
+    {
+    public:
+        static constexpr size_t DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+        using Loader = std::function<void(cv::OutputArray)>;
+    public:
+        explicit RasterCache(size_t maxBytes = DEFAULT_MAX_BYTES) : m_maxBytes(maxBytes) {}
+        RasterCache(const RasterCache&) = delete;
+        RasterCache& operator=(const RasterCache&) = delete;
+        // Returns the cached raster of the key or decodes it with the loader. The loader
+        // runs without the lock; threads that miss the key while it is decoded wait for
+        // that decode instead of starting their own. A raster larger than the budget is
+        // returned but not kept.
+        cv::Mat get(const std::string& key, const Loader& loader);
+        // Lookup and insertion for callers that decode several missing rasters at once.
+        bool find(const std::string& key, cv::Mat& raster);
+        // Keeps the raster unless it exceeds the budget. Returns the raster kept for the
+        // key: the one of another thread if it was inserted meanwhile.
+        cv::Mat put(const std::string& key, const cv::Mat& raster);
+        void clear();
+        size_t getSize() const;
+        int getCount() const;
+        size_t getMaxBytes() const {
+            return m_maxBytes;
+        }
+    private:
+        struct Entry
+        {
+            std::string key;
+            cv::Mat raster;
+        };
+        static size_t rasterBytes(const cv::Mat& raster) {
+            return raster.total() * raster.elemSize();
+        }
+    private:
+        size_t m_maxBytes;
+        size_t m_size = 0;
+        std::list<Entry> m_entries;     // The most recently used first
+        std::map<std::string, std::shared_future<cv::Mat>> m_loading;
+        mutable std::mutex m_mutex;
+    };
+}
+
+#if defined(_MSC_VER)
+#pragma warning( pop )
+#endif
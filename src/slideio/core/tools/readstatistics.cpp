@@ -0,0 +1,473 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "slideio/core/tools/readstatistics.hpp"
+#include "slideio/core/tools/tracing.hpp"
+#include "slideio/base/exceptions.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+
+using namespace slideio;
+
+std::atomic<bool> ReadStatistics::s_enabled(false);
+
+namespace
+{
+    struct ThreadState
+    {
+        ReadStatisticsTargets targets;
+        ReadStageTimer* timer = nullptr;
+    };
+    thread_local ThreadState threadState;
+
+    // Aggregates are never removed: references handed out stay valid.
+    struct Aggregates
+    {
+        std::mutex mutex;
+        std::map<std::string, std::unique_ptr<ReadStatistics>> drivers;
+        std::map<Compression, std::unique_ptr<ReadStatistics>> compressions;
+    };
+
+    Aggregates& aggregates() {
+        static Aggregates instance;
+        return instance;
+    }
+
+    int highestBit(uint64_t value) {
+        int bit = 0;
+        for (int shift = 32; shift > 0; shift >>= 1) {
+            if (value >> shift) {
+                value >>= shift;
+                bit += shift;
+            }
+        }
+        return bit;
+    }
+
+    void atomicMin(std::atomic<uint64_t>& target, uint64_t value) {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void atomicMax(std::atomic<uint64_t>& target, uint64_t value) {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    nlohmann::json histogramToJson(const LatencyHistogram& histogram) {
+        nlohmann::json node = nlohmann::json::object();
+        node["count"] = histogram.getCount();
+        node["mean"] = histogram.getMean();
+        node["min"] = histogram.getMin();
+        node["max"] = histogram.getMax();
+        node["p50"] = histogram.getPercentile(50.);
+        node["p90"] = histogram.getPercentile(90.);
+        node["p99"] = histogram.getPercentile(99.);
+        return node;
+    }
+
+    nlohmann::json statisticsToJson(const ReadStatistics& statistics) {
+        nlohmann::json root = nlohmann::json::object();
+        root["tilesDecoded"] = statistics.getTilesDecoded();
+        root["bytesRead"] = statistics.getBytesRead();
+        root["cacheHits"] = statistics.getCacheHits();
+        root["cacheMisses"] = statistics.getCacheMisses();
+        nlohmann::json& latency = root["latency"];
+        latency = nlohmann::json::object();
+        for (int stage = 0; stage < READ_STAGE_COUNT; ++stage) {
+            const ReadStage readStage = static_cast<ReadStage>(stage);
+            latency[readStageToString(readStage)] = histogramToJson(statistics.getLatency(readStage));
+        }
+        return root;
+    }
+
+    const char* traceEventName(ReadStage stage) {
+        switch (stage) {
+        case ReadStage::Total: return "read block";
+        case ReadStage::IO: return "file read";
+        case ReadStage::Decode: return "decode";
+        case ReadStage::Resize: return "resize";
+        case ReadStage::Copy: return "copy";
+        }
+        return "unknown";
+    }
+}
+
+const char* slideio::readStageToString(ReadStage stage) {
+    switch (stage) {
+    case ReadStage::Total: return "total";
+    case ReadStage::IO: return "io";
+    case ReadStage::Decode: return "decode";
+    case ReadStage::Resize: return "resize";
+    case ReadStage::Copy: return "copy";
+    }
+    return "unknown";
+}
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+LatencyHistogram::LatencyHistogram(const LatencyHistogram& other) {
+    reset();
+    add(other);
+}
+
+LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram& other) {
+    if (this != &other) {
+        reset();
+        add(other);
+    }
+    return *this;
+}
+
+int LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<int>(value);
+    }
+    const int bit = highestBit(value);
+    if (bit >= MAX_VALUE_BITS) {
+        return BUCKET_COUNT - 1;
+    }
+    const int shift = bit - SUB_BUCKET_BITS;
+    const int subBucket = static_cast<int>(value >> shift) - SUB_BUCKET_COUNT;
+    return (shift + 1) * SUB_BUCKET_COUNT + subBucket;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return static_cast<uint64_t>(index);
+    }
+    if (index >= BUCKET_COUNT - 1) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    const int shift = index / SUB_BUCKET_COUNT - 1;
+    const uint64_t subBucket = static_cast<uint64_t>(index % SUB_BUCKET_COUNT);
+    return ((SUB_BUCKET_COUNT + subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    m_buckets[bucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_total.fetch_add(nanoseconds, std::memory_order_relaxed);
+    atomicMin(m_min, nanoseconds);
+    atomicMax(m_max, nanoseconds);
+}
+
+void LatencyHistogram::add(const LatencyHistogram& other) {
+    for (int index = 0; index < BUCKET_COUNT; ++index) {
+        const uint64_t count = other.m_buckets[index].load(std::memory_order_relaxed);
+        if (count) {
+            m_buckets[index].fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+    m_count.fetch_add(other.m_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_total.fetch_add(other.m_total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    atomicMin(m_min, other.m_min.load(std::memory_order_relaxed));
+    atomicMax(m_max, other.m_max.load(std::memory_order_relaxed));
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_total.store(0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    return m_count.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getTotal() const {
+    return m_total.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getMin() const {
+    return getCount() ? m_min.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t LatencyHistogram::getMax() const {
+    return m_max.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::getMean() const {
+    const uint64_t count = getCount();
+    return count ? static_cast<double>(getTotal()) / static_cast<double>(count) : 0.;
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+    uint64_t total = 0;
+    for (const auto& bucket : m_buckets) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+    const double clamped = std::min(100., std::max(0., percentile));
+    uint64_t rank = static_cast<uint64_t>(clamped / 100. * static_cast<double>(total) + 0.5);
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (int index = 0; index < BUCKET_COUNT; ++index) {
+        seen += m_buckets[index].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // the bucket bound never exceeds the largest recorded value
+            return std::min(bucketUpperBound(index), getMax());
+        }
+    }
+    return getMax();
+}
+
+ReadStatistics::ReadStatistics() : m_tilesDecoded(0), m_bytesRead(0), m_cacheHits(0), m_cacheMisses(0),
+    m_histograms(nullptr) {
+}
+
+ReadStatistics::~ReadStatistics() {
+    delete[] m_histograms.load();
+}
+
+LatencyHistogram* ReadStatistics::histograms() const {
+    LatencyHistogram* histograms = m_histograms.load(std::memory_order_acquire);
+    if (histograms) {
+        return histograms;
+    }
+    LatencyHistogram* created = new LatencyHistogram[READ_STAGE_COUNT];
+    if (!m_histograms.compare_exchange_strong(histograms, created, std::memory_order_acq_rel)) {
+        delete[] created;
+        return histograms;
+    }
+    return created;
+}
+
+const LatencyHistogram& ReadStatistics::getLatency(ReadStage stage) const {
+    const int index = static_cast<int>(stage);
+    if (index < 0 || index >= READ_STAGE_COUNT) {
+        RAISE_RUNTIME_ERROR << "ReadStatistics: invalid read stage " << index;
+    }
+    return histograms()[index];
+}
+
+void ReadStatistics::recordLatency(ReadStage stage, uint64_t nanoseconds) {
+    histograms()[static_cast<int>(stage)].record(nanoseconds);
+}
+
+void ReadStatistics::reset() {
+    m_tilesDecoded.store(0, std::memory_order_relaxed);
+    m_bytesRead.store(0, std::memory_order_relaxed);
+    m_cacheHits.store(0, std::memory_order_relaxed);
+    m_cacheMisses.store(0, std::memory_order_relaxed);
+    if (LatencyHistogram* histograms = m_histograms.load(std::memory_order_acquire)) {
+        for (int stage = 0; stage < READ_STAGE_COUNT; ++stage) {
+            histograms[stage].reset();
+        }
+    }
+}
+
+std::string ReadStatistics::toJson(int indent) const {
+    return statisticsToJson(*this).dump(indent);
+}
+
+std::string ReadStatistics::aggregatesToJson(int indent) {
+    nlohmann::json root = nlohmann::json::object();
+    nlohmann::json& drivers = root["drivers"];
+    drivers = nlohmann::json::object();
+    for (const auto& driverId : getDriverIds()) {
+        drivers[driverId] = statisticsToJson(forDriver(driverId));
+    }
+    nlohmann::json& compressions = root["compressions"];
+    compressions = nlohmann::json::object();
+    for (const auto compression : getCompressions()) {
+        compressions[compressionToString(compression)] = statisticsToJson(forCompression(compression));
+    }
+    return root.dump(indent);
+}
+
+void ReadStatistics::setEnabled(bool enabled) {
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+ReadStatistics& ReadStatistics::forDriver(const std::string& driverId) {
+    Aggregates& all = aggregates();
+    std::lock_guard<std::mutex> lock(all.mutex);
+    auto& statistics = all.drivers[driverId];
+    if (!statistics) {
+        statistics.reset(new ReadStatistics);
+    }
+    return *statistics;
+}
+
+ReadStatistics& ReadStatistics::forCompression(Compression compression) {
+    Aggregates& all = aggregates();
+    std::lock_guard<std::mutex> lock(all.mutex);
+    auto& statistics = all.compressions[compression];
+    if (!statistics) {
+        statistics.reset(new ReadStatistics);
+    }
+    return *statistics;
+}
+
+std::vector<std::string> ReadStatistics::getDriverIds() {
+    Aggregates& all = aggregates();
+    std::lock_guard<std::mutex> lock(all.mutex);
+    std::vector<std::string> ids;
+    for (const auto& item : all.drivers) {
+        ids.push_back(item.first);
+    }
+    return ids;
+}
+
+std::vector<Compression> ReadStatistics::getCompressions() {
+    Aggregates& all = aggregates();
+    std::lock_guard<std::mutex> lock(all.mutex);
+    std::vector<Compression> compressions;
+    for (const auto& item : all.compressions) {
+        compressions.push_back(item.first);
+    }
+    return compressions;
+}
+
+void ReadStatistics::resetAggregates() {
+    Aggregates& all = aggregates();
+    std::lock_guard<std::mutex> lock(all.mutex);
+    for (auto& item : all.drivers) {
+        item.second->reset();
+    }
+    for (auto& item : all.compressions) {
+        item.second->reset();
+    }
+}
+
+void ReadStatistics::countTiles(uint64_t count) {
+    if (!isEnabled()) {
+        return;
+    }
+    for (ReadStatistics* statistics : threadState.targets.items) {
+        if (statistics) {
+            statistics->addTilesDecoded(count);
+        }
+    }
+}
+
+void ReadStatistics::countBytesRead(uint64_t bytes) {
+    if (!isEnabled()) {
+        return;
+    }
+    for (ReadStatistics* statistics : threadState.targets.items) {
+        if (statistics) {
+            statistics->addBytesRead(bytes);
+        }
+    }
+}
+
+void ReadStatistics::countCacheHit() {
+    if (!isEnabled()) {
+        return;
+    }
+    for (ReadStatistics* statistics : threadState.targets.items) {
+        if (statistics) {
+            statistics->addCacheHits(1);
+        }
+    }
+}
+
+void ReadStatistics::countCacheMiss() {
+    if (!isEnabled()) {
+        return;
+    }
+    for (ReadStatistics* statistics : threadState.targets.items) {
+        if (statistics) {
+            statistics->addCacheMisses(1);
+        }
+    }
+}
+
+void ReadStatisticsScope::activate(ReadStatistics& scene, const std::string& driverId, Compression compression) {
+    if (m_active) {
+        RAISE_RUNTIME_ERROR << "ReadStatisticsScope: the scope is already active";
+    }
+    ReadStatisticsTargets targets;
+    targets.items[0] = &scene;
+    targets.items[1] = &ReadStatistics::forDriver(driverId);
+    targets.items[2] = &ReadStatistics::forCompression(compression);
+    m_previous = threadState.targets;
+    m_previousTimer = threadState.timer;
+    threadState.targets = targets;
+    threadState.timer = nullptr;
+    m_active = true;
+}
+
+void ReadStatisticsScope::activate(const ReadStatisticsTargets& targets) {
+    if (m_active) {
+        RAISE_RUNTIME_ERROR << "ReadStatisticsScope: the scope is already active";
+    }
+    if (targets.empty() || targets == threadState.targets) {
+        return;
+    }
+    m_previous = threadState.targets;
+    m_previousTimer = threadState.timer;
+    threadState.targets = targets;
+    threadState.timer = nullptr;
+    m_active = true;
+}
+
+ReadStatisticsTargets ReadStatisticsScope::current() {
+    return threadState.targets;
+}
+
+ReadStatisticsScope::~ReadStatisticsScope() {
+    if (m_active) {
+        threadState.targets = m_previous;
+        threadState.timer = m_previousTimer;
+    }
+}
+
+ReadStageTimer::ReadStageTimer(ReadStage stage) : m_stage(stage) {
+    const bool statistics = ReadStatistics::isEnabled() && !threadState.targets.empty();
+    const bool tracing = Tracer::isEnabled();
+    if (!statistics && !tracing) {
+        return;
+    }
+    for (const ReadStageTimer* timer = threadState.timer; timer; timer = timer->m_parent) {
+        if (timer->m_stage == stage) {
+            return;
+        }
+    }
+    m_active = true;
+    m_tracing = tracing;
+    if (statistics) {
+        m_targets = threadState.targets;
+    }
+    m_parent = threadState.timer;
+    threadState.timer = this;
+    m_start = std::chrono::steady_clock::now();
+}
+
+ReadStageTimer::~ReadStageTimer() {
+    if (!m_active) {
+        return;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const auto elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        end - m_start).count());
+    if (m_tracing) {
+        Tracer::addEvent(traceEventName(m_stage), "read", m_start, end);
+    }
+    threadState.timer = m_parent;
+    if (m_parent) {
+        m_parent->m_childTime += elapsed;
+    }
+    const uint64_t exclusive = m_stage == ReadStage::Total ? elapsed : elapsed - std::min(m_childTime, elapsed);
+    for (ReadStatistics* statistics : m_targets.items) {
+        if (statistics) {
+            statistics->recordLatency(m_stage, exclusive);
+        }
+    }
+}
@@ -0,0 +1,196 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+
+#include "slideio/core/slideio_core_def.hpp"
+#include "slideio/base/slideio_enums.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#pragma warning( push )
+#pragma warning(disable: 4251)
+#endif
+
+namespace slideio
+{
+    // Stages of a block read. Stage times are exclusive: the time of a stage running
+    // inside another one (e.g. file I/O inside a decoder) is not counted for the outer
+    // stage. Total is the inclusive time of the whole read request. Where a codec
+    // library reads and decodes in one call (libtiff), the I/O is part of Decode.
+    enum class ReadStage
+    {
+        Total,
+        IO,
+        Decode,
+        Resize,
+        Copy
+    };
+    constexpr int READ_STAGE_COUNT = 5;
+    SLIDEIO_CORE_EXPORTS const char* readStageToString(ReadStage stage);
+
+    // Log-linear (HDR-style) histogram of latencies in nanoseconds. Every power of two
+    // is split into 16 buckets, so a recorded value is reported with a relative error
+    // below 1/16. Recording is lock-free.
+    class SLIDEIO_CORE_EXPORTS LatencyHistogram
+    {
+    public:
+        static constexpr int SUB_BUCKET_BITS = 4;
+        static constexpr int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+        // Values from 2^40 ns (about 18 minutes) on share the last bucket
+        static constexpr int MAX_VALUE_BITS = 40;
+        static constexpr int BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+    public:
+        LatencyHistogram();
+        LatencyHistogram(const LatencyHistogram& other);
+        LatencyHistogram& operator=(const LatencyHistogram& other);
+        void record(uint64_t nanoseconds);
+        void add(const LatencyHistogram& other);
+        void reset();
+        uint64_t getCount() const;
+        uint64_t getTotal() const;
+        uint64_t getMin() const;
+        uint64_t getMax() const;
+        double getMean() const;
+        // Upper bound of the bucket of the requested percentile (0-100).
+        uint64_t getPercentile(double percentile) const;
+        static int bucketIndex(uint64_t value);
+        static uint64_t bucketUpperBound(int index);
+    private:
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets;
+        std::atomic<uint64_t> m_count;
+        std::atomic<uint64_t> m_total;
+        std::atomic<uint64_t> m_min;
+        std::atomic<uint64_t> m_max;
+    };
+
+    // Counters and per-stage latency histograms of block reads. A scene keeps one for its
+    // own reads; ReadStatistics::forDriver and forCompression aggregate the reads of all
+    // scenes. Collection is off by default and switched globally with setEnabled; while it
+    // is off the instrumented code costs a relaxed atomic load per measured call.
+    class SLIDEIO_CORE_EXPORTS ReadStatistics
+    {
+    public:
+        ReadStatistics();
+        ~ReadStatistics();
+        ReadStatistics(const ReadStatistics&) = delete;
+        ReadStatistics& operator=(const ReadStatistics&) = delete;
+        uint64_t getTilesDecoded() const { return m_tilesDecoded.load(std::memory_order_relaxed); }
+        uint64_t getBytesRead() const { return m_bytesRead.load(std::memory_order_relaxed); }
+        uint64_t getCacheHits() const { return m_cacheHits.load(std::memory_order_relaxed); }
+        uint64_t getCacheMisses() const { return m_cacheMisses.load(std::memory_order_relaxed); }
+        // Number of read requests is getLatency(ReadStage::Total).getCount().
+        const LatencyHistogram& getLatency(ReadStage stage) const;
+        void reset();
+        // Counters and histogram summaries (count, mean, min, max, p50, p90, p99 in ns).
+        std::string toJson(int indent = -1) const;
+
+        void addTilesDecoded(uint64_t count) { m_tilesDecoded.fetch_add(count, std::memory_order_relaxed); }
+        void addBytesRead(uint64_t bytes) { m_bytesRead.fetch_add(bytes, std::memory_order_relaxed); }
+        void addCacheHits(uint64_t count) { m_cacheHits.fetch_add(count, std::memory_order_relaxed); }
+        void addCacheMisses(uint64_t count) { m_cacheMisses.fetch_add(count, std::memory_order_relaxed); }
+        void recordLatency(ReadStage stage, uint64_t nanoseconds);
+
+        static void setEnabled(bool enabled);
+        static bool isEnabled() {
+            return s_enabled.load(std::memory_order_relaxed);
+        }
+        // Aggregated statistics of all scenes of a driver / with a compression.
+        static ReadStatistics& forDriver(const std::string& driverId);
+        static ReadStatistics& forCompression(Compression compression);
+        static std::vector<std::string> getDriverIds();
+        static std::vector<Compression> getCompressions();
+        // Resets the aggregated statistics.
+        static void resetAggregates();
+        // All aggregated statistics: {"drivers": {id: ...}, "compressions": {name: ...}}.
+        static std::string aggregatesToJson(int indent = -1);
+
+        // Record into the statistics of the read running on the calling thread, if any.
+        static void countTiles(uint64_t count);
+        static void countBytesRead(uint64_t bytes);
+        static void countCacheHit();
+        static void countCacheMiss();
+    private:
+        // Histograms are allocated by the first recorded latency: scenes that are never
+        // read with collection on do not pay for them.
+        LatencyHistogram* histograms() const;
+    private:
+        std::atomic<uint64_t> m_tilesDecoded;
+        std::atomic<uint64_t> m_bytesRead;
+        std::atomic<uint64_t> m_cacheHits;
+        std::atomic<uint64_t> m_cacheMisses;
+        mutable std::atomic<LatencyHistogram*> m_histograms;
+        static std::atomic<bool> s_enabled;
+    };
+
+    class ReadStageTimer;
+
+    // Statistics a read is recorded into: its scene, driver and compression.
+    struct ReadStatisticsTargets
+    {
+        static constexpr int SIZE = 3;
+        ReadStatistics* items[SIZE] = {};
+        bool empty() const {
+            return items[0] == nullptr;
+        }
+        bool operator==(const ReadStatisticsTargets& other) const {
+            return std::equal(std::begin(items), std::end(items), std::begin(other.items));
+        }
+    };
+
+    // Attributes the reads of the calling thread to a scene, its driver and its
+    // compression until the scope ends. Scopes nest; an inactive scope changes nothing.
+    // The scope is thread-local: a read that hands work to other threads (cv::parallel_for_)
+    // captures current() and activates a scope with it in the workers.
+    class SLIDEIO_CORE_EXPORTS ReadStatisticsScope
+    {
+    public:
+        ReadStatisticsScope() = default;
+        ReadStatisticsScope(const ReadStatisticsScope&) = delete;
+        ReadStatisticsScope& operator=(const ReadStatisticsScope&) = delete;
+        ~ReadStatisticsScope();
+        void activate(ReadStatistics& scene, const std::string& driverId, Compression compression);
+        // Attributes the reads of a worker to the read that started it. Does nothing if
+        // the targets are empty or already those of the calling thread (a worker body run
+        // by the thread of the read).
+        void activate(const ReadStatisticsTargets& targets);
+        // Targets of the read running on the calling thread; empty if there is none.
+        static ReadStatisticsTargets current();
+    private:
+        bool m_active = false;
+        ReadStatisticsTargets m_previous;
+        ReadStageTimer* m_previousTimer = nullptr;
+    };
+
+    // Measures a stage of the read running on the calling thread and adds it to the
+    // trace if tracing is on. Does nothing if neither a statistics scope is active nor
+    // tracing is on, or if a timer of the same stage already runs in the scope. Stages
+    // of worker threads are exclusive within their worker: they overlap the stage of
+    // the thread that waits for them.
+    class SLIDEIO_CORE_EXPORTS ReadStageTimer
+    {
+    public:
+        explicit ReadStageTimer(ReadStage stage);
+        ReadStageTimer(const ReadStageTimer&) = delete;
+        ReadStageTimer& operator=(const ReadStageTimer&) = delete;
+        ~ReadStageTimer();
+    private:
+        ReadStage m_stage;
+        bool m_active = false;
+        bool m_tracing = false;
+        ReadStatisticsTargets m_targets;
+        ReadStageTimer* m_parent = nullptr;
+        uint64_t m_childTime = 0;
+        std::chrono::steady_clock::time_point m_start;
+    };
+}
+
+#if defined(_MSC_VER)
+#pragma warning( pop )
+#endif
@@ -0,0 +1,40 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "slideio/core/tools/resampling.hpp"
+#include <opencv2/imgproc.hpp>
+
+using namespace slideio;
+
+namespace
+{
+    thread_local ResamplingPolicy threadPolicy = ResamplingPolicy::Balanced;
+}
+
+ResamplingPolicy Resampling::getPolicy() {
+    return threadPolicy;
+}
+
+int Resampling::getInterpolation(ResamplingPolicy policy, const cv::Size& srcSize, const cv::Size& dstSize) {
+    switch (policy) {
+    case ResamplingPolicy::Fast:
+        return cv::INTER_NEAREST;
+    case ResamplingPolicy::Exact:
+        // area averaging does not alias by reduction; it is bilinear-like by enlargement
+        if (dstSize.width <= srcSize.width && dstSize.height <= srcSize.height) {
+            return cv::INTER_AREA;
+        }
+        return cv::INTER_LANCZOS4;
+    case ResamplingPolicy::Balanced:
+    default:
+        return cv::INTER_LINEAR;
+    }
+}
+
+ResamplingScope::ResamplingScope(ResamplingPolicy policy) : m_previous(threadPolicy) {
+    threadPolicy = policy;
+}
+
+ResamplingScope::~ResamplingScope() {
+    threadPolicy = m_previous;
+}
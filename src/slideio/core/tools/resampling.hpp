@@ -0,0 +1,38 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+
+#include "slideio/core/slideio_core_def.hpp"
+#include "slideio/base/slideio_enums.hpp"
+#include <opencv2/core.hpp>
+
+namespace slideio
+{
+    // Resampling policy of the read running on the calling thread. Zoom level selection
+    // (Tools::findZoomLevel) and resizing (Tools::resize) of the drivers follow it, so
+    // the policy needs no parameter down the driver read paths.
+    class SLIDEIO_CORE_EXPORTS Resampling
+    {
+    public:
+        // Policy of the calling thread; Balanced outside of a ResamplingScope.
+        static ResamplingPolicy getPolicy();
+        // Interpolation (cv::InterpolationFlags) to resize a raster from srcSize to dstSize with.
+        static int getInterpolation(ResamplingPolicy policy, const cv::Size& srcSize, const cv::Size& dstSize);
+        static int getInterpolation(const cv::Size& srcSize, const cv::Size& dstSize) {
+            return getInterpolation(getPolicy(), srcSize, dstSize);
+        }
+    };
+
+    // Sets the resampling policy of the calling thread until the scope ends. Scopes nest.
+    class SLIDEIO_CORE_EXPORTS ResamplingScope
+    {
+    public:
+        explicit ResamplingScope(ResamplingPolicy policy);
+        ResamplingScope(const ResamplingScope&) = delete;
+        ResamplingScope& operator=(const ResamplingScope&) = delete;
+        ~ResamplingScope();
+    private:
+        ResamplingPolicy m_previous;
+    };
+}
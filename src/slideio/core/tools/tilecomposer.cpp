@@ -4,6 +4,10 @@
 
 #include "slideio/core/tools/tilecomposer.hpp"
 #include "slideio/core/tools/tools.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
+#include "slideio/core/tools/tracing.hpp"
+#include "slideio/core/tools/downsampler.hpp"
+#include "slideio/core/tools/resampling.hpp"
 #include <opencv2/imgproc.hpp>
 
 
@@ -40,7 +44,12 @@ void slideio::TileComposer::composeRect(slideio::Tiler* tiler,
             }
             else
             {
-                if(!tiler->readTile(tileIndex, channelIndices, tileRaster, userData))
+                TraceScope trace("tile read", "read");
+                if(tiler->readTile(tileIndex, channelIndices, tileRaster, userData))
+                {
+                    ReadStatistics::countTiles(1);
+                }
+                else
                 {
                     // fill tile with background color if the tile is not available
                     tiler->initializeBlock(tileRect.size(), channelIndices, tileRaster);
@@ -50,12 +59,34 @@ void slideio::TileComposer::composeRect(slideio::Tiler* tiler,
             {
                 cv::Rect scaledTileRect;
                 Tools::scaleRect(tileRect, scaleX, scaleY, scaledTileRect);
+                const int interpolation = Resampling::getInterpolation(tileRaster.size(), scaledTileRect.size());
+                const int factor = Downsampler::selectFactor(tileRaster.size(), scaledTileRect.size(),
+                                                             tileRaster.type(), interpolation);
+                if(factor > 0 && tileRaster.type() == scaledBlockRaster.type())
+                {
+                    // reduce the visible part of the tile straight into the block
+                    const cv::Rect scaledIntersectionRect = scaledBlockRect & scaledTileRect;
+                    if(!scaledIntersectionRect.empty()) {
+                        ReadStageTimer timer(ReadStage::Resize);
+                        const cv::Rect blockPart = scaledIntersectionRect - scaledBlockRect.tl();
+                        const cv::Rect tilePart = scaledIntersectionRect - scaledTileRect.tl();
+                        const cv::Rect sourcePart(tilePart.x * factor, tilePart.y * factor,
+                                                  tilePart.width * factor, tilePart.height * factor);
+                        cv::Mat blockPartRaster(scaledBlockRaster, blockPart);
+                        Downsampler::downsample(cv::Mat(tileRaster, sourcePart), blockPartRaster, factor);
+                    }
+                    continue;
+                }
                 // scale tile raster
                 cv::Mat scaledTileRaster;
-                Tools::resize(tileRaster, scaledTileRaster, scaledTileRect.size());
+                {
+                    ReadStageTimer timer(ReadStage::Resize);
+                    Tools::resize(tileRaster, scaledTileRaster, scaledTileRect.size(), interpolation);
+                }
                 // compute intersection of scaled tile rectangle and scaled block rectangle
                 cv::Rect scaledIntersectionRect = scaledBlockRect & scaledTileRect;
                 if(!scaledIntersectionRect.empty()) {
+                    ReadStageTimer timer(ReadStage::Copy);
                     const cv::Rect blockPart = scaledIntersectionRect - scaledBlockRect.tl();
                     const cv::Rect tilePart = scaledIntersectionRect - scaledTileRect.tl();
                     cv::Mat blockPartRaster(scaledBlockRaster, blockPart);
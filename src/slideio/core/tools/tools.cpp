@@ -3,16 +3,22 @@
 // of this distribution and at http://slideio.com/license.html.
 //
 #include "slideio/core/tools/tools.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
+#include "slideio/core/tools/downsampler.hpp"
 
 #include <codecvt>
 #include <numeric>
 #include "slideio/base/exceptions.hpp"
 #include <filesystem>
 #include <random>
+#include <cerrno>
 #if defined(WIN32)
+#include <windows.h>
 #include <Shlwapi.h>
+#include <io.h>
 #else
 #include <fnmatch.h>
+#include <unistd.h>
 #endif
 #include <string>
 #include <stdexcept>
@@ -62,6 +68,19 @@ std::string Tools::randomUUID() {
 }
 
 void Tools::resize(cv::InputArray src, cv::OutputArray dst, cv::Size dsize, int interpolation) {
+    if (interpolation == INTER_POLICY) {
+        interpolation = Resampling::getInterpolation(src.size(), dsize);
+    }
+    // Power-of-two reductions the box filter reproduces exactly: no promotion of
+    // CV_8S/CV_32S rasters and no reallocation of an existing destination.
+    const int factor = Downsampler::selectFactor(src.size(), dsize, src.type(), interpolation);
+    if (factor > 0) {
+        const cv::Mat srcMat = src.getMat();
+        dst.create(dsize, srcMat.type());
+        cv::Mat dstMat = dst.getMat();
+        Downsampler::downsample(srcMat, dstMat, factor);
+        return;
+    }
     // cv::resize does not support the CV_8S (signed 8-bit) depth, so handle it here.
     if (src.depth() == CV_8S) {
         const cv::Mat srcMat = src.getMat();
@@ -324,6 +343,95 @@ uint64_t Tools::getFileSize(FILE* file)
     return size;
 }
 
+size_t Tools::readFileAt(FILE* file, uint64_t pos, void* buffer, size_t size)
+{
+    ReadStageTimer timer(ReadStage::IO);
+    uint8_t* dest = static_cast<uint8_t*>(buffer);
+    size_t total = 0;
+#if defined(WIN32)
+    HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));
+    while (total < size) {
+        const uint64_t offset = pos + total;
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        const size_t left = size - total;
+        const DWORD chunk = static_cast<DWORD>(left < 0x40000000 ? left : 0x40000000);
+        DWORD read = 0;
+        if (!ReadFile(handle, dest + total, chunk, &read, &overlapped) || read == 0) {
+            break;
+        }
+        total += read;
+    }
+#else
+    const int fd = fileno(file);
+    while (total < size) {
+        const ssize_t read = pread(fd, dest + total, size - total, static_cast<off_t>(pos + total));
+        if (read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (read <= 0) {
+            break;
+        }
+        total += static_cast<size_t>(read);
+    }
+#endif
+    ReadStatistics::countBytesRead(total);
+    return total;
+}
+
+size_t Tools::writeFileAt(FILE* file, uint64_t pos, const void* buffer, size_t size)
+{
+    const uint8_t* src = static_cast<const uint8_t*>(buffer);
+    size_t total = 0;
+#if defined(WIN32)
+    HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));
+    while (total < size) {
+        const uint64_t offset = pos + total;
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        const size_t left = size - total;
+        const DWORD chunk = static_cast<DWORD>(left < 0x40000000 ? left : 0x40000000);
+        DWORD written = 0;
+        if (!WriteFile(handle, src + total, chunk, &written, &overlapped) || written == 0) {
+            break;
+        }
+        total += written;
+    }
+#else
+    const int fd = fileno(file);
+    while (total < size) {
+        const ssize_t written = pwrite(fd, src + total, size - total, static_cast<off_t>(pos + total));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            break;
+        }
+        total += static_cast<size_t>(written);
+    }
+#endif
+    return total;
+}
+
+bool Tools::syncFile(FILE* file)
+{
+    if (fflush(file) != 0) {
+        return false;
+    }
+#if defined(WIN32)
+    HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));
+    return FlushFileBuffers(handle) != 0;
+#else
+    int result = 0;
+    do {
+        result = fsync(fileno(file));
+    } while (result != 0 && errno == EINTR);
+    return result == 0;
+#endif
+}
+
 int Tools::dataTypeSize(slideio::DataType dt)
 {
     switch (dt)
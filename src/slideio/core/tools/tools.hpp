@@ -19,6 +19,7 @@
 #include <opencv2/imgproc.hpp>
 #include "slideio/base/slideio_enums.hpp"
 #include "slideio/base/slideio_structs.hpp"
+#include "slideio/core/tools/resampling.hpp"
 
 namespace slideio
 {
@@ -47,6 +48,10 @@ namespace slideio
             }
             return channelList;
         }
+        // Index of the level to read a block of the zoom from, selected by the resampling
+        // policy of the calling thread (see Resampling). Balanced: the coarsest level not
+        // below the zoom. Fast: the neighbour level closest to the zoom, coarser levels
+        // included. Exact: the next finer level unless the zoom matches a level.
         template <typename Functor>
         static int findZoomLevel(double zoom, int numLevels, Functor zoomFunction)
         {
@@ -59,6 +64,7 @@ namespace slideio
                 return 0;
             }
             int goodLevelIndex = -1;
+            bool exactMatch = false;
             double lastZoom = baseZoom;
             for (int levelIndex = 1; levelIndex < numLevels; levelIndex++)
             {
@@ -68,6 +74,7 @@ namespace slideio
                 if (relDif < 0.01)
                 {
                     goodLevelIndex = levelIndex;
+                    exactMatch = true;
                     break;
                 }
                 if (zoom <= lastZoom && zoom > currentZoom)
@@ -81,6 +88,21 @@ namespace slideio
             {
                 goodLevelIndex = numLevels - 1;
             }
+            if (exactMatch) {
+                return goodLevelIndex;
+            }
+            const ResamplingPolicy policy = Resampling::getPolicy();
+            if (policy == ResamplingPolicy::Fast && goodLevelIndex + 1 < numLevels) {
+                // upscaling from the coarser level if it is closer on the logarithmic scale
+                const double coarserZoom = zoomFunction(goodLevelIndex + 1);
+                if (coarserZoom > 0 && zoom / coarserZoom < zoomFunction(goodLevelIndex) / zoom) {
+                    return goodLevelIndex + 1;
+                }
+            }
+            else if (policy == ResamplingPolicy::Exact && goodLevelIndex > 0
+                     && zoomFunction(goodLevelIndex) < 2. * zoom) {
+                return goodLevelIndex - 1;
+            }
             return  goodLevelIndex;
         }
         static void convert12BitsTo16Bits(const uint8_t* source, uint16_t* target, int targetLen);
@@ -114,6 +136,14 @@ namespace slideio
         static uint64_t getFilePos(FILE* file);
         static int setFilePos(FILE* file, uint64_t pos, int origin);
         static uint64_t getFileSize(FILE* file);
+        // Positional read: does not use or move the stream position, so several
+        // threads may read from the same handle. Returns the number of bytes read.
+        static size_t readFileAt(FILE* file, uint64_t pos, void* buffer, size_t size);
+        // Positional write, the counterpart of readFileAt. Returns the number of bytes written.
+        static size_t writeFileAt(FILE* file, uint64_t pos, const void* buffer, size_t size);
+        // Flushes the stream and waits until the data of the file is on the storage device.
+        // Returns false on failure.
+        static bool syncFile(FILE* file);
         static int dataTypeSize(slideio::DataType dt);
         static Size cvSizeToSize(const cv::Size& cvSize) {
             return {cvSize.width, cvSize.height};
@@ -124,7 +154,10 @@ namespace slideio
         static void replaceAll(std::string& str, const std::string& from, const std::string& to);
         static std::vector<std::string> split(const std::string& value, char delimiter);
         static std::string randomUUID();
+        // Interpolation argument of resize: selected by the resampling policy of the
+        // calling thread (see Resampling::getInterpolation).
+        static constexpr int INTER_POLICY = -1;
         static void resize( cv::InputArray src, cv::OutputArray dst, cv::Size dsize,
-                            int interpolation = cv::INTER_LINEAR);
+                            int interpolation = INTER_POLICY);
     };
 }
@@ -0,0 +1,197 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "slideio/core/tools/tracing.hpp"
+#include "slideio/core/tools/tools.hpp"
+#include "slideio/base/exceptions.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace slideio;
+
+std::atomic<bool> Tracer::s_enabled(false);
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* name;
+        const char* category;
+        int64_t start;      // ns from the start of the trace
+        int64_t duration;   // ns
+    };
+
+    // Events of a thread. Only the owning thread appends; the writer locks the
+    // buffer while it takes the events.
+    struct ThreadBuffer
+    {
+        std::mutex mutex;
+        std::vector<TraceEvent> events;
+        std::string name;
+        int id = 0;
+    };
+
+    struct TraceState
+    {
+        std::mutex mutex;
+        std::string filePath;
+        // Start of the trace in steady clock nanoseconds
+        std::atomic<int64_t> origin{0};
+        std::vector<std::shared_ptr<ThreadBuffer>> threads;
+        std::atomic<size_t> eventCount{0};
+        std::atomic<uint64_t> droppedEvents{0};
+        int nextThreadId = 1;
+    };
+
+    // Never destroyed: the trace may be written by an atexit handler after the
+    // static objects of the library are gone.
+    TraceState& traceState() {
+        static TraceState* state = new TraceState;
+        return *state;
+    }
+
+    thread_local std::shared_ptr<ThreadBuffer> threadBuffer;
+
+    ThreadBuffer& getThreadBuffer() {
+        if (!threadBuffer) {
+            auto buffer = std::make_shared<ThreadBuffer>();
+            TraceState& state = traceState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            buffer->id = state.nextThreadId++;
+            state.threads.push_back(buffer);
+            threadBuffer = buffer;
+        }
+        return *threadBuffer;
+    }
+
+    std::string quoted(const std::string& text) {
+        return nlohmann::json(text).dump();
+    }
+
+    void writeTrace(const std::string& filePath, std::vector<std::shared_ptr<ThreadBuffer>>& threads,
+                    uint64_t droppedEvents) {
+        std::unique_ptr<FILE, Tools::FileDeleter> file(Tools::openFile(filePath, "w"));
+        if (!file) {
+            RAISE_RUNTIME_ERROR << "Tracer: cannot create trace file " << filePath;
+        }
+        FILE* out = file.get();
+        fprintf(out, "{\"traceEvents\":[\n");
+        fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"slideio\"}}");
+        for (const auto& thread : threads) {
+            std::lock_guard<std::mutex> lock(thread->mutex);
+            if (!thread->name.empty()) {
+                fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":%s}}",
+                        thread->id, quoted(thread->name).c_str());
+            }
+            for (const TraceEvent& event : thread->events) {
+                fprintf(out, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                        "\"pid\":1,\"tid\":%d}", event.name, event.category,
+                        static_cast<double>(event.start) / 1000., static_cast<double>(event.duration) / 1000.,
+                        thread->id);
+            }
+            thread->events.clear();
+            thread->events.shrink_to_fit();
+        }
+        fprintf(out, "\n],\n\"displayTimeUnit\":\"ms\",\n\"otherData\":{\"droppedEvents\":%" PRIu64 "}}\n",
+                droppedEvents);
+        if (fflush(out) != 0 || ferror(out)) {
+            RAISE_RUNTIME_ERROR << "Tracer: error by writing trace file " << filePath;
+        }
+    }
+
+    void stopAtExit() {
+        try {
+            Tracer::stop();
+        }
+        catch (const std::exception& ex) {
+            fprintf(stderr, "slideio: %s\n", ex.what());
+        }
+    }
+
+    bool startFromEnvironment() {
+        const char* filePath = std::getenv(Tracer::ENVIRONMENT_VARIABLE);
+        if (filePath == nullptr || *filePath == 0) {
+            return false;
+        }
+        Tracer::start(filePath);
+        std::atexit(stopAtExit);
+        return true;
+    }
+
+    const bool startedFromEnvironment = startFromEnvironment();
+}
+
+void Tracer::start(const std::string& filePath) {
+    if (filePath.empty()) {
+        RAISE_RUNTIME_ERROR << "Tracer: trace file path is empty";
+    }
+    stop();
+    TraceState& state = traceState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (const auto& thread : state.threads) {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        thread->events.clear();
+    }
+    state.filePath = filePath;
+    state.eventCount = 0;
+    state.droppedEvents = 0;
+    state.origin = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop() {
+    TraceState& state = traceState();
+    std::vector<std::shared_ptr<ThreadBuffer>> threads;
+    std::string filePath;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!s_enabled.exchange(false)) {
+            return;
+        }
+        threads = state.threads;
+        filePath = state.filePath;
+        // buffers of finished threads are referenced only by the list and its copy
+        state.threads.erase(std::remove_if(state.threads.begin(), state.threads.end(),
+            [](const std::shared_ptr<ThreadBuffer>& thread) { return thread.use_count() == 2; }),
+            state.threads.end());
+    }
+    writeTrace(filePath, threads, state.droppedEvents.load());
+}
+
+void Tracer::setThreadName(const std::string& name) {
+    if (!isEnabled()) {
+        return;
+    }
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.name = name;
+}
+
+void Tracer::addEvent(const char* name, const char* category,
+                      std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point end) {
+    if (!isEnabled()) {
+        return;
+    }
+    TraceState& state = traceState();
+    if (state.eventCount.fetch_add(1, std::memory_order_relaxed) >= MAX_EVENTS) {
+        state.droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count()
+        - state.origin.load(std::memory_order_relaxed);
+    event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back(event);
+}
@@ -0,0 +1,77 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+
+#include "slideio/core/slideio_core_def.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(_MSC_VER)
+#pragma warning( push )
+#pragma warning(disable: 4251)
+#endif
+
+namespace slideio
+{
+    // Records scoped events of the read and conversion pipelines and writes them as a
+    // Chrome trace (JSON trace event format), which chrome://tracing and the Perfetto UI
+    // open directly. Tracing is started by Tracer::start or by setting the environment
+    // variable SLIDEIO_TRACE_FILE to the output path; in the latter case the trace is
+    // written when the process exits. While tracing is off an instrumented scope costs
+    // a relaxed atomic load.
+    class SLIDEIO_CORE_EXPORTS Tracer
+    {
+    public:
+        static constexpr const char* ENVIRONMENT_VARIABLE = "SLIDEIO_TRACE_FILE";
+        // Events recorded beyond this number are dropped (and counted in the trace).
+        static constexpr size_t MAX_EVENTS = 4 * 1024 * 1024;
+    public:
+        // Starts recording into a new trace that is written to filePath by stop.
+        // A running trace is written first.
+        static void start(const std::string& filePath);
+        // Stops recording and writes the trace file. Does nothing if tracing is off.
+        static void stop();
+        static bool isEnabled() {
+            return s_enabled.load(std::memory_order_relaxed);
+        }
+        // Name of the calling thread in the trace, e.g. "converter encoder".
+        static void setThreadName(const std::string& name);
+        // Adds a complete event. name and category must be string literals.
+        static void addEvent(const char* name, const char* category,
+                             std::chrono::steady_clock::time_point start,
+                             std::chrono::steady_clock::time_point end);
+    private:
+        static std::atomic<bool> s_enabled;
+    };
+
+    // Adds a trace event covering its lifetime. name and category must be string literals.
+    class SLIDEIO_CORE_EXPORTS TraceScope
+    {
+    public:
+        TraceScope(const char* name, const char* category) {
+            if (Tracer::isEnabled()) {
+                m_name = name;
+                m_category = category;
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+        ~TraceScope() {
+            if (m_name) {
+                Tracer::addEvent(m_name, m_category, m_start, std::chrono::steady_clock::now());
+            }
+        }
+    private:
+        const char* m_name = nullptr;
+        const char* m_category = nullptr;
+        std::chrono::steady_clock::time_point m_start;
+    };
+}
+
+#if defined(_MSC_VER)
+#pragma warning( pop )
+#endif
@@ -66,6 +66,10 @@ std::shared_ptr<CVScene> CZISlide::getScene(int index) const
 
 void CZISlide::readBlock(uint64_t pos, uint64_t size, std::vector<unsigned char>& data)
 {
+    std::lock_guard<std::mutex> lock(m_fileStreamMutex);
+    if (!m_fileStream.is_open()) {
+        openFileStream();
+    }
     try
     {
         data.resize(size);
@@ -79,6 +83,16 @@ void CZISlide::readBlock(uint64_t pos, uint64_t size, std::vector<unsigned char>
     }
 }
 
+bool CZISlide::releaseFileHandles()
+{
+    // the stream is shared by all scenes and used only under the lock
+    std::lock_guard<std::mutex> lock(m_fileStreamMutex);
+    if (m_fileStream.is_open()) {
+        m_fileStream.close();
+    }
+    return true;
+}
+
 std::shared_ptr<CVScene> CZISlide::getAuxImage(const std::string& sceneName) const {
     auto it = m_auxImages.find(sceneName);
     if(it==m_auxImages.end()) {
@@ -142,10 +156,8 @@ void CZISlide::readAttachments()
     }
 }
 
-void CZISlide::init()
+void CZISlide::openFileStream()
 {
-    SLIDEIO_LOG(INFO) << "Slide initialization. File path: " << getFilePath();
-    // read file header
     m_fileStream.exceptions(std::ios::failbit | std::ios::badbit);
     auto flags = std::ifstream::in | std::ifstream::binary;
 #if defined(WIN32)
@@ -154,6 +166,13 @@ void CZISlide::init()
 #else
     m_fileStream.open(m_filePath.c_str(), flags);
 #endif
+}
+
+void CZISlide::init()
+{
+    SLIDEIO_LOG(INFO) << "Slide initialization. File path: " << getFilePath();
+    openFileStream();
+    // read file header
     readFileHeader();
     readMetadata();
     readDirectory();
@@ -39,12 +39,15 @@ namespace slideio
         double getTFrameResolution() const {return m_resT;}
         const CZIChannelInfos& getChannelInfo() const { return m_channels; }
         const std::string& getTitle() const { return m_title; }
-        void readBlock(uint64_t pos, uint64_t size, std::vector<unsigned char>& data);;
+        // Thread-safe. Reopens the file if it was closed by releaseFileHandles.
+        void readBlock(uint64_t pos, uint64_t size, std::vector<unsigned char>& data);
         std::shared_ptr<CVScene> getAuxImage(const std::string& sceneName) const override;
+        bool releaseFileHandles() override;
         void readFileHeader(FileHeader& fileHeader);
         void readSubBlocks(uint64_t pos, uint64_t originPos, std::vector<CZISubBlocks>& sceneBlocks, std::vector<uint64_t>& sceneIds);
         std::shared_ptr<CZIScene> constructScene(int sceneIndex, uint64_t sceneId, const CZISubBlocks& blocks, bool mainScene = true);
     private:
+        void openFileStream();
         void readAttachments();
         void init();
         void readMetadata();
@@ -77,6 +80,7 @@ namespace slideio
         std::vector<std::shared_ptr<CZIScene>> m_scenes;
         std::string m_filePath;
         std::ifstream m_fileStream;
+        std::mutex m_fileStreamMutex;
         uint64_t m_directoryPosition{};
         uint64_t m_metadataPosition{};
         uint64_t m_attachmentDirectoryPosition;
@@ -297,6 +297,9 @@ void DCMFile::defineCompression()
     case EXS_JPEG2000:
     case EXS_JPEG2000MulticomponentLosslessOnly:
     case EXS_JPEG2000Multicomponent:
+    case EXS_HighThroughputJPEG2000LosslessOnly:
+    case EXS_HighThroughputJPEG2000withRPCLOptionsLosslessOnly:
+    case EXS_HighThroughputJPEG2000:
         m_compression = Compression::Jpeg2000;
         break;
     default: ;
@@ -697,10 +700,25 @@ bool DCMFile::isDicomDirFile(const std::string& filePath)
     return isDicomDir;
 }
 
+bool DCMFile::loadHeader(const std::string& filePath, DcmFileFormat& file)
+{
+    // Parsing stops in front of the pixel data element. Neither the pixel data nor
+    // the fragment table of encapsulated frames is touched.
+#if defined(WIN32)
+    std::wstring filePathW = Tools::toWstring(filePath);
+    OFFilename filename(filePathW.c_str());
+#else
+    OFFilename filename(filePath.c_str());
+#endif
+    const OFCondition status = file.loadFileUntilTag(filename, EXS_Unknown, EGL_noChange, DCM_MaxReadLength,
+        ERM_autoDetect, DCM_PixelData);
+    return status.good();
+}
+
 bool DCMFile::isWSIFile(const std::string& filePath) {
     bool isWSI = false;
     DcmFileFormat file;
-    if (file.loadFile(filePath.c_str()).good())
+    if (loadHeader(filePath, file))
     {
         DcmDataset* dataset = file.getDataset();
         if (dataset)
@@ -144,6 +144,7 @@ namespace slideio
             return m_imageType != "VOLUME";
         }
     private:
+        static bool loadHeader(const std::string& filePath, DcmFileFormat& file);
         void readFrames(std::vector<cv::Mat>& frames, int startFrame, int numFrames);
         void extractPixelsWholeFileDecompression(std::vector<cv::Mat>& mats, int startFrame, int numFrames);
         std::shared_ptr<DicomImage> createImage(int firstSlice = 0, int numSlices = 1);
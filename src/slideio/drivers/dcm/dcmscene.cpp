@@ -205,7 +205,7 @@ void DCMScene::extractSliceRaster(const cv::Mat& frame,
 {
     cv::Mat block = frame(blockRect);
     cv::Mat resizedBlock;
-    cv::resize(block, resizedBlock, blockSize);
+    Tools::resize(block, resizedBlock, blockSize);
     if (componentIndices.empty() || (componentIndices.size() == getNumChannels()
         && getNumChannels() == 1))
     {
@@ -6,6 +6,9 @@
 #include "slideio/base/base.hpp"
 #include <filesystem>
 #include <algorithm>
+#include <thread>
+#include <atomic>
+#include <set>
 #include <dcmdata/dcdeftag.h>
 #include <dcmdata/dcmetinf.h>
 #include <dcmtk/dcmdata/dcdicdir.h>
@@ -154,30 +157,68 @@ void DCMSlide::processSeries(std::vector<std::shared_ptr<DCMFile>>& files, bool
     SLIDEIO_LOG(INFO) << "DCMSlide::processSeries-end: initialize DCMSlide from file: " << m_srcPath;
 }
 
+void DCMSlide::initFiles(std::vector<std::shared_ptr<DCMFile>>& files) const {
+    // Files are independent of each other: metadata extraction is spread over
+    // the available cores. Files that cannot be initialized are dropped from the list.
+    const int numFiles = static_cast<int>(files.size());
+    std::vector<char> valid(numFiles, 0);
+    std::atomic<int> nextFile{0};
+    auto worker = [&]() {
+        for (int index = nextFile++; index < numFiles; index = nextFile++) {
+            try {
+                files[index]->init();
+                valid[index] = 1;
+            }
+            catch (std::exception& ex) {
+                SLIDEIO_LOG(WARNING) << "DCMSlide::initFiles: cannot initialize DICOM file: "
+                    << files[index]->getFilePath() << ". Error: " << ex.what();
+            }
+        }
+    };
+    const int numThreads = std::min(numFiles, std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+    if (numThreads <= 1) {
+        worker();
+    }
+    else {
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads);
+        for (int thread = 0; thread < numThreads; ++thread) {
+            threads.emplace_back(worker);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    int validCount = 0;
+    for (int index = 0; index < numFiles; ++index) {
+        if (valid[index]) {
+            files[validCount++] = files[index];
+        }
+    }
+    files.resize(validCount);
+}
+
 void DCMSlide::initFromDir() {
     SLIDEIO_LOG(INFO) << "DCMSlide::initFromDir-begin: initialize DCMSlide from directory: " << m_srcPath;
     fs::recursive_directory_iterator dir(m_srcPath), end;
-    std::map<std::string, std::shared_ptr<Series>> seriesMap;
+    std::vector<std::shared_ptr<DCMFile>> files;
     for (; dir != end; ++dir) {
         if (fs::is_regular_file(dir->path())) {
-            try {
-                std::shared_ptr<DCMFile> file(new DCMFile(dir->path().string()));
-                file->init();
-                const std::string& seriesUID = file->getSeriesUID();
-                auto itScene = seriesMap.find(seriesUID);
-                if (itScene == seriesMap.end()) {
-                    std::shared_ptr<Series> series(new Series);
-                    series->files.push_back(file);
-                    seriesMap[seriesUID] = series;
-                }
-                else {
-                    itScene->second->files.push_back(file);
-                }
-            }
-            catch (std::exception& ex) {
-                SLIDEIO_LOG(ERROR) << "DCMSlide::initFromDir: No valid DICOM files found in the directory: " <<
-                    m_srcPath << ". Error: " << ex.what();
-            }
+            files.push_back(std::make_shared<DCMFile>(dir->path().string()));
+        }
+    }
+    initFiles(files);
+    std::map<std::string, std::shared_ptr<Series>> seriesMap;
+    for (auto&& file : files) {
+        const std::string& seriesUID = file->getSeriesUID();
+        auto itScene = seriesMap.find(seriesUID);
+        if (itScene == seriesMap.end()) {
+            std::shared_ptr<Series> series(new Series);
+            series->files.push_back(file);
+            seriesMap[seriesUID] = series;
+        }
+        else {
+            itScene->second->files.push_back(file);
         }
     }
     for (auto&& itSeries : seriesMap) {
@@ -197,9 +238,10 @@ void DCMSlide::initFromDicomDirFile() {
     DcmDicomDir dicomdir(m_srcPath.c_str());
     DcmDirectoryRecord& rec = dicomdir.getRootRecord();
     DcmDirectoryRecord* patientRecord = nullptr;
-    int patientIndex = 0;
     fs::path filePath(m_srcPath);
     fs::path directoryPath = filePath.parent_path();
+    // collect referenced files of all series first, so that they can be initialized in one parallel pass
+    std::vector<std::vector<std::shared_ptr<DCMFile>>> seriesList;
     for (int patientIndex = 0; (patientRecord = rec.getSub(patientIndex)) != nullptr; ++patientIndex) {
         DcmDirectoryRecord* studyRecord = nullptr;
         for (int studyIndex = 0; (studyRecord = patientRecord->getSub(studyIndex)) != nullptr; ++studyIndex) {
@@ -210,28 +252,33 @@ void DCMSlide::initFromDicomDirFile() {
                 for (int imageIndex = 0; (imageRecord = seriesRecord->getSub(imageIndex)) != nullptr; ++imageIndex) {
                     OFString fileId;
                     if (imageRecord->findAndGetOFStringArray(DCM_ReferencedFileID, fileId, true).good()) {
-                        try {
-                            std::string fileName = fileId.c_str();
-                            Tools::replaceAll(fileName, "\\", "/");
-                            filePath = directoryPath / fileName;
-                            std::string str = filePath.string();
-                            std::shared_ptr<DCMFile> dcm(new DCMFile(str));
-                            dcm->init();
-                            series.push_back(dcm);
-                        }
-                        catch (std::exception& ex) {
-                            SLIDEIO_LOG(WARNING) << "DCMImageDriver: Error by processing DICOMDIR for file:" << ex.
-                                what();
-                        }
+                        std::string fileName = fileId.c_str();
+                        Tools::replaceAll(fileName, "\\", "/");
+                        filePath = directoryPath / fileName;
+                        series.push_back(std::make_shared<DCMFile>(filePath.string()));
                     }
                 }
                 if (!series.empty()) {
-                    processSeries(series, true);
-                    ok = true;
+                    seriesList.push_back(std::move(series));
                 }
             }
         }
     }
+    std::vector<std::shared_ptr<DCMFile>> allFiles;
+    for (auto&& series : seriesList) {
+        allFiles.insert(allFiles.end(), series.begin(), series.end());
+    }
+    initFiles(allFiles);
+    const std::set<std::shared_ptr<DCMFile>> validFiles(allFiles.begin(), allFiles.end());
+    for (auto&& series : seriesList) {
+        series.erase(std::remove_if(series.begin(), series.end(), [&validFiles](const std::shared_ptr<DCMFile>& file) {
+            return validFiles.find(file) == validFiles.end();
+        }), series.end());
+        if (!series.empty()) {
+            processSeries(series, true);
+            ok = true;
+        }
+    }
     if (ok) {
         SLIDEIO_LOG(INFO) << "DCMSlide::initFromDicomDirFile: initialization is successful.";
     }
@@ -30,6 +30,7 @@ namespace slideio
     private:
         void processWSISeries(std::vector<std::shared_ptr<DCMFile>>& dcmFiles);
         void processSeries(std::vector<std::shared_ptr<DCMFile>>& files, bool keepOrder=false);
+        void initFiles(std::vector<std::shared_ptr<DCMFile>>& files) const;
         void initFromDir();
         void initFromDicomDirFile();
         void init();
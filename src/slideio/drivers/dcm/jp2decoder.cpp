@@ -71,7 +71,11 @@ OFBool Jp2Decoder::canChangeCoding(const E_TransferSyntax oldRepType, const E_Tr
     E_TransferSyntax myXfer = EXS_JPEG2000;
     DcmXfer newRep(newRepType);
     OFBool ret(OFFalse);
-    if (newRep.isNotEncapsulated() && (oldRepType == EXS_JPEG2000 || oldRepType == EXS_JPEG2000LosslessOnly))
+    // HTJ2K codestreams are decoded by the same OpenJPEG path
+    const bool jp2kRep = oldRepType == EXS_JPEG2000 || oldRepType == EXS_JPEG2000LosslessOnly
+        || oldRepType == EXS_HighThroughputJPEG2000 || oldRepType == EXS_HighThroughputJPEG2000LosslessOnly
+        || oldRepType == EXS_HighThroughputJPEG2000withRPCLOptionsLosslessOnly;
+    if (newRep.isNotEncapsulated() && jp2kRep)
         ret = OFTrue; // decompress requested
     // we don't support re-coding for now.
     return ret;
@@ -5,6 +5,7 @@
 #include "slideio/drivers/gdal/gdalscene.hpp"
 
 #include <opencv2/imgproc.hpp>
+#include <algorithm>
 
 #include "slideio/slideio/slideio.hpp"
 #include "slideio/base/resolution.hpp"
@@ -16,7 +17,8 @@
 slideio::GDALScene::GDALScene(SmallImagePage* page, const std::string& path, const std::string& driverId) :
     m_imagePage(page),
     m_filePath(path),
-	m_driverId(driverId)
+	m_driverId(driverId),
+    m_pageCache(pageCacheBytes(page))
 {
     m_filePath = path;
     // A gdal image has no pyramid, but a scene with no level cannot be addressed by level
@@ -83,6 +85,39 @@ cv::Rect slideio::GDALScene::getRect() const
     return { {}, m_imagePage->getSize() };
 }
 
+size_t slideio::GDALScene::pageCacheBytes(const SmallImagePage* page)
+{
+    if (page == nullptr || page->canReadRegion()) {
+        return RasterCache::DEFAULT_MAX_BYTES;
+    }
+    const Size size = page->getSize();
+    const size_t pageBytes = static_cast<size_t>(size.width) * size.height * page->getNumChannels()
+        * Tools::dataTypeSize(page->getDataType());
+    return std::max(pageBytes, RasterCache::DEFAULT_MAX_BYTES);
+}
+
+void slideio::GDALScene::readPageRegion(const cv::Rect& blockRect, const cv::Size& blockSize, cv::OutputArray output)
+{
+    cv::Mat blockRaster;
+    if (m_imagePage->canReadRegion()) {
+        std::lock_guard<std::mutex> lock(m_readMutex);
+        m_imagePage->readRasterRegionUnscaled(blockRect, blockSize, blockRaster);
+    }
+    else {
+        const cv::Mat pageRaster = m_pageCache.get("page", [this](cv::OutputArray raster) {
+            std::lock_guard<std::mutex> lock(m_readMutex);
+            m_imagePage->readRaster(raster);
+        });
+        blockRaster = pageRaster(blockRect);
+    }
+    if (blockRaster.size() != blockSize) {
+        Tools::resize(blockRaster, output, blockSize);
+    }
+    else {
+        blockRaster.copyTo(output);
+    }
+}
+
 void slideio::GDALScene::readResampledBlockChannelsEx(const cv::Rect& blockRect, const cv::Size& blockSize,
     const std::vector<int>& componentIndices, int zSliceIndex, int tFrameIndex, cv::OutputArray output)
 {
@@ -94,24 +129,13 @@ void slideio::GDALScene::readResampledBlockChannelsEx(const cv::Rect& blockRect,
     }
     const int numChannels = m_imagePage->getNumChannels();
     auto channelIndices = Tools::completeChannelList(componentIndices, numChannels);
-    cv::Mat sceneRaster;
     if (Tools::isConsecutiveFromZero(channelIndices, numChannels)) {
-        m_imagePage->readRaster(sceneRaster);
+        readPageRegion(blockRect, blockSize, output);
     } else {
-        cv::Mat raster;
-        m_imagePage->readRaster(raster);
-        std::vector<cv::Mat> channels(channelIndices.size());
-        int channelNum = 0;
-        for (const auto& channelIndex : channelIndices) {
-            cv::extractChannel(raster, channels[channelNum++], channelIndex);
-        }
-        cv::merge(channels, sceneRaster);
-    }
-    cv::Mat blockRaster = sceneRaster(blockRect);
-    if ((blockSize.width != blockRect.width) || (blockSize.height != blockRect.height)) {
-        cv::resize(blockRaster, blockRaster, blockSize, 0, 0, cv::INTER_LINEAR);
+        cv::Mat blockRaster;
+        readPageRegion(blockRect, blockSize, blockRaster);
+        Tools::extractChannels(blockRaster, channelIndices, output);
     }
-    blockRaster.copyTo(output);
 }
 
 slideio::Compression slideio::GDALScene::getCompression() const {
@@ -125,6 +149,6 @@ slideio::MetadataFormat slideio::GDALScene::getMetadataFormat() const {
     return MetadataFormat::JSON;
 }
 
-std::string slideio::GDALScene::getRawMetadata() const {
+const std::string& slideio::GDALScene::getRawMetadata() const {
     return m_imagePage->getMetadata();
 }
@@ -5,8 +5,10 @@
 
 #include "slideio/drivers/gdal/gdal_api_def.hpp"
 #include "slideio/core/cvscene.hpp"
+#include "slideio/core/tools/rastercache.hpp"
 #include "slideio/base/slideio_enums.hpp"
 #include <opencv2/core.hpp>
+#include <mutex>
 
 #if defined(_MSC_VER)
 #pragma warning( push )
@@ -37,11 +39,20 @@ namespace slideio
             const std::vector<int>& componentIndices, int zSliceIndex, int tFrameIndex, cv::OutputArray output) override;
         Compression getCompression() const override;
         MetadataFormat getMetadataFormat() const override;
-        std::string getRawMetadata() const override;
+        const std::string& getRawMetadata() const override;
+    private:
+        void readPageRegion(const cv::Rect& blockRect, const cv::Size& blockSize, cv::OutputArray output);
+        // Budget of the page cache: the decoded page, and at least the default budget.
+        static size_t pageCacheBytes(const SmallImagePage* page);
     private:
         SmallImagePage* m_imagePage;
         std::string m_filePath;
         std::string m_driverId;
+        // decoded page for formats that cannot decode a region: the blocks of a page are
+        // cut from one decode
+        RasterCache m_pageCache;
+        // guards the page handle shared by the readers of the scene
+        std::mutex m_readMutex;
     };
 }
 
@@ -30,13 +30,46 @@ void slideio::NDPIFile::init(const std::string& filePath)
     }
     SLIDEIO_LOG(INFO) << "File " << filePath << " is successfully opened";
     m_filePath = filePath;
+    m_file.reset(Tools::openFile(filePath, "rb"));
+    if (!m_file) {
+        RAISE_RUNTIME_ERROR << "NDPIImageDriver: Cannot open file:" << filePath;
+    }
     scanFile();
     for(auto& dir : m_directories) {
         NDPITiffTools::readDirectoryJpegHeaders(this, dir);
     }
+    m_indexed.reset(new std::once_flag[m_directories.size()]);
     SLIDEIO_LOG(INFO) << "File " << filePath << " initialization is complete";
 }
 
+void slideio::NDPIFile::makeSureFileIsOpened()
+{
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    if (!m_tiff.isValid()) {
+        m_tiff = NDPITiffTools::openTiffFile(m_filePath);
+        if (!m_tiff.isValid()) {
+            RAISE_RUNTIME_ERROR << "NDPIImageDriver: Cannot open file:" << m_filePath;
+        }
+    }
+    if (!m_file) {
+        m_file.reset(Tools::openFile(m_filePath, "rb"));
+        if (!m_file) {
+            RAISE_RUNTIME_ERROR << "NDPIImageDriver: Cannot open file:" << m_filePath;
+        }
+    }
+}
+
+void slideio::NDPIFile::closeFileHandles()
+{
+    // the handles are reopened by the next getTiffHandle or getFileHandle
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    if (m_tiff) {
+        NDPITiffTools::closeTiffFile(m_tiff);
+        m_tiff = nullptr;
+    }
+    m_file.reset();
+}
+
 void slideio::NDPIFile::scanFile()
 {
     SLIDEIO_LOG(INFO) << "NDPITiffTools::scanFile-begin";
@@ -61,3 +94,39 @@ const slideio::NDPITiffDirectory& slideio::NDPIFile::findZoomDirectory(double zo
     });
     return m_directories[index + dirBegin];
 }
+
+const slideio::NDPITiffDirectory& slideio::NDPIFile::getIndexedDirectory(int dirIndex)
+{
+    if (dirIndex < 0 || dirIndex >= static_cast<int>(m_directories.size())) {
+        RAISE_RUNTIME_ERROR << "NDPIImageDriver: Invalid directory index: " << dirIndex << ". File:" << m_filePath;
+    }
+    NDPITiffDirectory& dir = m_directories[dirIndex];
+    std::call_once(m_indexed[dirIndex], [this, &dir]() {
+        indexRestartMarkers(dir);
+    });
+    return dir;
+}
+
+void slideio::NDPIFile::indexRestartMarkers(NDPITiffDirectory& dir)
+{
+    if (dir.tiled || !dir.mcuStarts.empty() || dir.tileWidth <= 0 || dir.tileHeight <= 0
+        || dir.slideioCompression != Compression::Jpeg || dir.rowsPerStrip != dir.height) {
+        return;
+    }
+    const int dirIndex = dir.dirIndex;
+    SLIDEIO_LOG(INFO) << "NDPIFile::indexRestartMarkers: scanning directory " << dirIndex;
+    std::vector<uint64_t> starts;
+    NDPITiffTools::scanRestartMarkers(getFileHandle(), dir.jpegHeaderOffset + dir.jpegHeaderSize,
+        dir.jpegHeaderOffset + dir.rawStripSize, starts);
+    const int tilesX = (dir.width - 1) / dir.tileWidth + 1;
+    const int tilesY = (dir.height - 1) / dir.tileHeight + 1;
+    if (starts.size() != static_cast<size_t>(tilesX) * tilesY) {
+        SLIDEIO_LOG(WARNING) << "NDPIFile::indexRestartMarkers: directory " << dirIndex << " has "
+            << starts.size() << " restart intervals, expected " << tilesX * tilesY
+            << ". The directory is decoded as a single strip.";
+        dir.tileWidth = 0;
+        dir.tileHeight = 0;
+        return;
+    }
+    dir.mcuStarts = std::move(starts);
+}
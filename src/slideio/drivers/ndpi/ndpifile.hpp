@@ -9,8 +9,11 @@
 #pragma warning(disable: 4251)
 #endif
 #include <string>
+#include <memory>
+#include <mutex>
 
 #include "ndpitifftools.hpp"
+#include "slideio/core/tools/tools.hpp"
 
 namespace libtiff
 {
@@ -33,17 +36,40 @@ namespace slideio
         const std::string getFilePath() const  {
             return m_filePath;
         }
+        // The handles are reopened if they were closed by closeFileHandles.
         libtiff::TIFF* getTiffHandle()
         {
+            makeSureFileIsOpened();
             return m_tiff;
         }
+        // Handle for positional reads (Tools::readFileAt) of raw jpeg data. It may be
+        // shared by several threads.
+        FILE* getFileHandle()
+        {
+            makeSureFileIsOpened();
+            return m_file.get();
+        }
+        // Closes the handles. Called by the slide while none of its scenes is read.
+        void closeFileHandles();
         const NDPITiffDirectory& findZoomDirectory(double zoom, int sceneWidth, int dirBegin, int dirEnd);
+        // Directory for reading its pixels. A single strip jpeg directory that has no NDPI
+        // restart marker tag is indexed by the first call: its restart intervals and tile
+        // size are set once, and every caller returns after they are.
+        const NDPITiffDirectory& getIndexedDirectory(int dirIndex);
     private:
+        void makeSureFileIsOpened();
         void scanFile();
+        // Builds the restart interval index of a single strip jpeg directory that has no
+        // NDPI restart marker tag.
+        void indexRestartMarkers(NDPITiffDirectory& dir);
     private:
         std::string m_filePath;
         NDPITIFFKeeper m_tiff;
+        std::unique_ptr<FILE, Tools::FileDeleter> m_file;
+        std::mutex m_fileMutex;
         std::vector<NDPITiffDirectory> m_directories;
+        // one flag per directory for indexRestartMarkers
+        std::unique_ptr<std::once_flag[]> m_indexed;
     };
 }
 
@@ -77,25 +77,9 @@ namespace
 class NDPIUserData
 {
 public:
-    NDPIUserData(const NDPITiffDirectory* dir, const std::string& filePath) : m_dir(dir),
-                                                                              m_file(nullptr),
-                                                                              m_filePath(filePath)
+    // the file handle belongs to NDPIFile and is shared by all reads of the slide
+    NDPIUserData(const NDPITiffDirectory* dir, FILE* file) : m_dir(dir), m_file(file)
     {
-        if ((!dir->tiled) && (dir->rowsPerStrip == dir->height) 
-            && (dir->slideioCompression==Compression::Jpeg
-            || dir->slideioCompression==Compression::Uncompressed)) {
-            m_file = Tools::openFile(filePath, "rb");
-            if (!m_file) {
-                RAISE_RUNTIME_ERROR << "NDPI Image Driver: Cannot open file " << filePath;
-            }
-        }
-    }
-
-    ~NDPIUserData()
-    {
-        if (m_file) {
-            fclose(m_file);
-        }
     }
 
     const NDPITiffDirectory* dir() const
@@ -108,15 +92,9 @@ public:
         return m_file;
     }
 
-    const std::string& filePath() const
-    {
-        return m_filePath;
-    }
-
 private:
     const NDPITiffDirectory* m_dir;
     FILE* m_file;
-    std::string m_filePath;
 };
 
 NDPIScene::NDPIScene() : m_pfile(nullptr), m_startDir(-1), m_endDir(-1), m_rect(0, 0, 0, 0), m_sceneIndex(-1)
@@ -239,8 +217,6 @@ Compression NDPIScene::getCompression() const
 
 const NDPITiffDirectory& NDPIScene::findZoomDirectory(const cv::Rect& imageBlockRect, const cv::Size& requiredBlockSize) const
 {
-    auto directories = m_pfile->directories();
-
     const double zoomImageToBlockX = static_cast<double>(requiredBlockSize.width) / static_cast<double>(imageBlockRect.width);
     const double zoomImageToBlockY = static_cast<double>(requiredBlockSize.height) / static_cast<double>(imageBlockRect.height);
 
@@ -282,24 +258,21 @@ void NDPIScene::readResampledLevelBlockChannelsEx(int level, const cv::Rect& lev
         RAISE_RUNTIME_ERROR << "NDPIScene: 3D and 4D images are not supported";
     }
     validateLevel(level);
-    const auto& directories = m_pfile->directories();
-    const slideio::NDPITiffDirectory& dir = directories[m_startDir + level];
+    const slideio::NDPITiffDirectory& dir = m_pfile->getIndexedDirectory(m_startDir + level);
 
     NDPITiffTools::setCurrentDirectory(m_pfile->getTiffHandle(), dir);
-    NDPIUserData data(&dir, getFilePath());
     const auto dirType = dir.getType();
     if (dirType == NDPITiffDirectory::Type::Tiled
-        || dirType == NDPITiffDirectory::Type::SingleStripeMCU
         || dirType == NDPITiffDirectory::Type::Striped) {
+        NDPIUserData data(&dir, m_pfile->getFileHandle());
         // TileComposer intersects every tile with the block, so an overhanging block simply
         // finds no tile there and keeps the background.
         TileComposer::composeRect(this, channelIndices, levelRect, blockSize, output, (void*)&data);
-    } else if (dirType == NDPITiffDirectory::Type::SingleStripe) {
-        cv::Mat raster;
-        NDPITiffTools::readStripedDir(m_pfile->getTiffHandle(), dir, raster);
+    } else if (dirType == NDPITiffDirectory::Type::SingleStripe
+        || dirType == NDPITiffDirectory::Type::SingleStripeMCU) {
         // cv::Mat(raster, rect) throws unless the rect is contained, and an edge tile of a
         // level is not: clamp, read the part that exists, and leave the rest background.
-        const cv::Rect valid = levelRect & cv::Rect(0, 0, raster.cols, raster.rows);
+        const cv::Rect valid = levelRect & cv::Rect(0, 0, dir.width, dir.height);
         initializeSceneBlock(blockSize, channelIndices, output);
         if (valid.empty()) {
             return;
@@ -314,13 +287,19 @@ void NDPIScene::readResampledLevelBlockChannelsEx(int level, const cv::Rect& lev
         if (target.width <= 0 || target.height <= 0) {
             return;
         }
-        cv::Mat block(raster, valid);
+        cv::Mat block;
+        if (dirType == NDPITiffDirectory::Type::SingleStripeMCU) {
+            // only the restart intervals covering the block are decoded
+            NDPITiffTools::readMCURegion(m_pfile->getFileHandle(), dir, valid, channelIndices, block);
+        }
+        else {
+            const cv::Mat raster = readSingleStripeDir(dir);
+            Tools::extractChannels(cv::Mat(raster, valid), channelIndices, block);
+        }
         cv::Mat blockResized;
-        cv::resize(block, blockResized, target.size());
-        cv::Mat extracted;
-        Tools::extractChannels(blockResized, channelIndices, extracted);
+        Tools::resize(block, blockResized, target.size());
         cv::Mat out = output.getMat();
-        extracted.copyTo(out(target));
+        blockResized.copyTo(out(target));
     } else {
         RAISE_RUNTIME_ERROR << "NDPIScene::readResampledLevelBlockChannelsEx: Unexpected directory type: "
             << dir.getType();
@@ -412,6 +391,12 @@ void NDPIScene::makeSureValidDirectoryType(NDPITiffDirectory::Type directoryType
     }
 }
 
+cv::Mat NDPIScene::readSingleStripeDir(const NDPITiffDirectory& dir) {
+    return m_rasterCache.get(std::to_string(dir.dirIndex), [this, &dir](cv::OutputArray raster) {
+        NDPITiffTools::readStripedDir(m_pfile->getTiffHandle(), dir, raster);
+    });
+}
+
 bool NDPIScene::readTile(int tileIndex, const std::vector<int>& channelIndices, cv::OutputArray tileRaster,
                          void* userData)
 {
@@ -444,8 +429,7 @@ bool NDPIScene::readTile(int tileIndex, const std::vector<int>& channelIndices,
             break;
         }
         case NDPITiffDirectory::Type::SingleStripe: {
-            cv::Mat raster;
-            NDPITiffTools::readStripedDir(m_pfile->getTiffHandle(), *dir, raster);
+            const cv::Mat raster = readSingleStripeDir(*dir);
             cv::Rect tileRect;
             if(getTileRect(tileIndex,tileRect, userData)) {
                 cv::Mat blockRaster(raster, tileRect);
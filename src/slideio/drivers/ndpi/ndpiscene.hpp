@@ -7,6 +7,7 @@
 #include "slideio/drivers/ndpi/ndpi_api_def.hpp"
 #include "slideio/core/cvscene.hpp"
 #include "slideio/core/tools/tilecomposer.hpp"
+#include "slideio/core/tools/rastercache.hpp"
 
 #if defined(_MSC_VER)
 #pragma warning( push )
@@ -61,6 +62,8 @@ namespace slideio
         void initializeBlock(const cv::Size& blockSize, const std::vector<int>& channelIndices, cv::OutputArray output) override;
     private:
         void makeSureValidDirectoryType(NDPITiffDirectory::Type directoryType);
+        // Single-stripe directories can only be decoded as a whole: the rasters are cached.
+        cv::Mat readSingleStripeDir(const NDPITiffDirectory& dir);
     protected:
         NDPIFile* m_pfile;
         int m_startDir;
@@ -69,6 +72,7 @@ namespace slideio
         cv::Rect m_rect;
         int m_sceneIndex;
 		std::string m_driverId;
+        RasterCache m_rasterCache;
     };
 
 }
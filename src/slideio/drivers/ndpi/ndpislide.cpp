@@ -109,6 +109,18 @@ std::shared_ptr<CVScene> NDPISlide::getScene(int index) const
     return m_Scenes[index];
 }
 
+bool NDPISlide::releaseFileHandles()
+{
+    // the scenes and auxiliary images read through the handles of the file
+    std::vector<std::shared_ptr<CVScene>> scenes(m_Scenes);
+    for (const auto& auxImage : m_auxImages) {
+        scenes.push_back(auxImage.second);
+    }
+    return runIfScenesUnused(scenes, [this]() {
+        m_pfile->closeFileHandles();
+    });
+}
+
 std::shared_ptr<CVScene> NDPISlide::getAuxImage(const std::string& sceneName) const
 {
     auto it = m_auxImages.find(sceneName);
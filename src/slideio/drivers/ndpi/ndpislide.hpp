@@ -36,6 +36,7 @@ namespace slideio
         std::string getFilePath() const override;
         std::shared_ptr<slideio::CVScene> getScene(int index) const override;
         std::shared_ptr<CVScene> getAuxImage(const std::string& sceneName) const override;
+        bool releaseFileHandles() override;
     private:
         void log();
     private:
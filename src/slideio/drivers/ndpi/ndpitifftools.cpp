@@ -12,10 +12,12 @@
 #include "ndpifile.hpp"
 #include "slideio/core/tools/blocktiler.hpp"
 #include "slideio/core/tools/endian.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
 
 
 #include <codecvt>
 #include <opencv2/imgproc.hpp>
+#include <opencv2/core/utility.hpp>
 #include <setjmp.h>
 #include <opencv2/core.hpp>
 #include <jxrcodec/jxrcodec.hpp>
@@ -748,6 +750,69 @@ void ErrorExit(j_common_ptr cinfo)
     longjmp(myerr->setjmp_buffer, 1);
 }
 
+namespace
+{
+    // libjpeg source that reads the stream with positional reads from an offset of the
+    // file: the decoder neither uses nor moves the stream position, so the handle may be
+    // shared by several readers.
+    struct PositionalSource
+    {
+        jpeg_source_mgr pub;
+        FILE* file;
+        uint64_t position;
+        JOCTET buffer[64 * 1024];
+    };
+
+    void initPositionalSource(j_decompress_ptr) {
+    }
+
+    boolean fillPositionalSource(j_decompress_ptr cinfo) {
+        PositionalSource* source = reinterpret_cast<PositionalSource*>(cinfo->src);
+        size_t count = Tools::readFileAt(source->file, source->position, source->buffer, sizeof(source->buffer));
+        source->position += count;
+        if (count == 0) {
+            // a truncated stream ends with a fake end of image marker, as in jpeg_stdio_src
+            source->buffer[0] = 0xFF;
+            source->buffer[1] = JPEG_EOI;
+            count = 2;
+        }
+        source->pub.next_input_byte = source->buffer;
+        source->pub.bytes_in_buffer = count;
+        return TRUE;
+    }
+
+    void skipPositionalSource(j_decompress_ptr cinfo, long numBytes) {
+        if (numBytes <= 0) {
+            return;
+        }
+        PositionalSource* source = reinterpret_cast<PositionalSource*>(cinfo->src);
+        const size_t skip = static_cast<size_t>(numBytes);
+        if (skip <= source->pub.bytes_in_buffer) {
+            source->pub.next_input_byte += skip;
+            source->pub.bytes_in_buffer -= skip;
+            return;
+        }
+        source->position += skip - source->pub.bytes_in_buffer;
+        source->pub.bytes_in_buffer = 0;
+    }
+
+    void termPositionalSource(j_decompress_ptr) {
+    }
+
+    void setPositionalSource(j_decompress_ptr cinfo, PositionalSource& source, FILE* file, uint64_t offset) {
+        source.file = file;
+        source.position = offset;
+        source.pub.init_source = initPositionalSource;
+        source.pub.fill_input_buffer = fillPositionalSource;
+        source.pub.skip_input_data = skipPositionalSource;
+        source.pub.resync_to_restart = jpeg_resync_to_restart;
+        source.pub.term_source = termPositionalSource;
+        source.pub.next_input_byte = nullptr;
+        source.pub.bytes_in_buffer = 0;
+        cinfo->src = &source.pub;
+    }
+}
+
 void NDPITiffTools::readJpegScanlines(libtiff::TIFF* tiff, FILE* file, const NDPITiffDirectory& dir, int firstScanline,
                                   int numberScanlines, const std::vector<int>& channelIndices, cv::_OutputArray output)
 {
@@ -764,9 +829,9 @@ void NDPITiffTools::readJpegScanlines(libtiff::TIFF* tiff, FILE* file, const NDP
     setCurrentDirectory(tiff, dir);
 
     uint64_t stripeOffset = libtiff::TIFFGetStrileOffset(tiff, 0);
-    int ret = Tools::setFilePos(file, stripeOffset, SEEK_SET);
     jpeg_decompress_struct cinfo;
     ErrorManager jerr;
+    PositionalSource source;
 
     cinfo.err = jpeg_std_error(&jerr.pub);
     jerr.pub.error_exit = ErrorExit;
@@ -779,7 +844,7 @@ void NDPITiffTools::readJpegScanlines(libtiff::TIFF* tiff, FILE* file, const NDP
     }
 
     jpeg_create_decompress(&cinfo);
-    jpeg_stdio_src(&cinfo, file);
+    setPositionalSource(&cinfo, source, file, stripeOffset);
     cinfo.image_width = dir.width;
     cinfo.image_height = dir.height;
     jpeg_read_header(&cinfo, TRUE);
@@ -815,7 +880,7 @@ void NDPITiffTools::readJpegScanlines(libtiff::TIFF* tiff, FILE* file, const NDP
 }
 
 
-void NDPITiffTools::readJpegDirectoryRegion(libtiff::TIFF* tiff, const std::string& filePath, const cv::Rect& region,
+void NDPITiffTools::readJpegDirectoryRegion(libtiff::TIFF* tiff, FILE* file, const cv::Rect& region,
                                             const NDPITiffDirectory& dir, const std::vector<int>& channelIndices,
                                             cv::_OutputArray output)
 {
@@ -830,13 +895,15 @@ void NDPITiffTools::readJpegDirectoryRegion(libtiff::TIFF* tiff, const std::stri
         RAISE_RUNTIME_ERROR << "One strip directory is expected. Rows per strip: " << dir.rowsPerStrip << ". Height:" <<
             dir.height;
     }
-    setCurrentDirectory(tiff, dir);
-
-    std::unique_ptr<FILE, Tools::FileDeleter> sfile(Tools::openFile(filePath.c_str(), "rb"));
-    FILE* file = sfile.get();
-    if (!file) {
-        RAISE_RUNTIME_ERROR << "NDPI Image Driver: Cannot open file " << filePath;
+    if (file == nullptr) {
+        RAISE_RUNTIME_ERROR << "NDPITiffTools::readJpegDirectoryRegion: file pointer is not set";
     }
+    if (dir.getType() == NDPITiffDirectory::Type::SingleStripeMCU) {
+        // restart intervals are indexed: decode only the ones covering the region
+        readMCURegion(file, dir, region, channelIndices, output);
+        return;
+    }
+    setCurrentDirectory(tiff, dir);
 
     const bool allChannels = Tools::isCompleteChannelList(channelIndices, dir.channels);
 
@@ -851,9 +918,9 @@ void NDPITiffTools::readJpegDirectoryRegion(libtiff::TIFF* tiff, const std::stri
     const int numberScanlines = region.height;
 
     uint64_t stripeOffset = libtiff::TIFFGetStrileOffset(tiff, 0);
-    int ret = Tools::setFilePos(file, stripeOffset, SEEK_SET);
     jpeg_decompress_struct cinfo{};
     ErrorManager jErr{};
+    PositionalSource source;
 
     cinfo.err = jpeg_std_error(&jErr.pub);
     jErr.pub.error_exit = ErrorExit;
@@ -866,7 +933,7 @@ void NDPITiffTools::readJpegDirectoryRegion(libtiff::TIFF* tiff, const std::stri
     }
 
     jpeg_create_decompress(&cinfo);
-    jpeg_stdio_src(&cinfo, file);
+    setPositionalSource(&cinfo, source, file, stripeOffset);
     cinfo.image_width = dir.width;
     cinfo.image_height = dir.height;
     jpeg_read_header(&cinfo, TRUE);
@@ -941,16 +1008,19 @@ void NDPITiffTools::readJpegDirectoryRegion(libtiff::TIFF* tiff, const std::stri
 
 void NDPITiffTools::readDirectoryJpegHeaders(NDPIFile* ndpi, NDPITiffDirectory& dir)
 {
-    if (dir.height == dir.rowsPerStrip && !dir.mcuStarts.empty()) {
+    // Single strip jpeg directories are decoded by restart intervals whenever the stream has them.
+    // Offsets of the intervals come from the NDPI restart marker tag; if the tag is missing they
+    // are collected by NDPIFile::indexRestartMarkers on the first read of the directory.
+    if (!dir.tiled && dir.height == dir.rowsPerStrip && dir.slideioCompression == Compression::Jpeg
+        && dir.rawStripSize > 0) {
         const auto dirIndex = dir.dirIndex;
 
         libtiff::TIFF* tiff = ndpi->getTiffHandle();
         setCurrentDirectory(tiff, dir);
 
-        std::unique_ptr<FILE, Tools::FileDeleter> sfile(Tools::openFile(ndpi->getFilePath(), "rb"));
-        FILE* file = sfile.get();
+        FILE* file = ndpi->getFileHandle();
         if (!file) {
-            RAISE_RUNTIME_ERROR << "NDPI Image Driver: Cannot open file " << ndpi->getFilePath();
+            RAISE_RUNTIME_ERROR << "NDPI Image Driver: File " << ndpi->getFilePath() << " is not open";
         }
 
         const auto stripeOffset = libtiff::TIFFGetStrileOffset(tiff, 0);
@@ -961,6 +1031,9 @@ void NDPITiffTools::readDirectoryJpegHeaders(NDPIFile* ndpi, NDPITiffDirectory&
                 << stripeOffset << ". For directory " << dirIndex << ". Code: " << ret;
         }
         cv::Size tileSize = NDPITiffTools::computeMCUTileSize(file, cv::Size(dir.width, dir.height));
+        if (tileSize.width <= 0 || tileSize.height <= 0) {
+            return;
+        }
 
         ret = Tools::setFilePos(file, stripeOffset, SEEK_SET);
         if (ret) {
@@ -974,6 +1047,13 @@ void NDPITiffTools::readDirectoryJpegHeaders(NDPIFile* ndpi, NDPITiffDirectory&
         dir.jpegHeaderSize = static_cast<uint32_t>(headerInfo.second - stripeOffset);
         dir.jpegSOFMarker = headerInfo.first;
 
+        dir.jpegHeader.resize(dir.jpegHeaderSize);
+        const size_t count = Tools::readFileAt(file, dir.jpegHeaderOffset, dir.jpegHeader.data(), dir.jpegHeaderSize);
+        if (count != dir.jpegHeaderSize) {
+            RAISE_RUNTIME_ERROR << "NDPITiffTools: error by reading jpeg header of directory " << dirIndex
+                << ". Expected:" << dir.jpegHeaderSize << ". Read:" << count;
+        }
+        fixJpegHeader(dir, dir.jpegHeader.data());
     }
 }
 
@@ -1228,6 +1308,11 @@ cv::Size NDPITiffTools::computeMCUTileSize(FILE* file, const cv::Size& dirSize)
     ErrorManager jerr = {};
     cinfo.err = jpeg_std_error(&jerr.pub);
     jerr.pub.error_exit = ErrorExit;
+    if (setjmp(jerr.setjmp_buffer)) {
+        // the stream cannot be split into restart intervals
+        jpeg_destroy_decompress(&cinfo);
+        return {0, 0};
+    }
     jpeg_create_decompress(&cinfo);
     jpeg_stdio_src(&cinfo, file);
     cinfo.image_width = dirSize.width;
@@ -1244,6 +1329,11 @@ cv::Size NDPITiffTools::computeMCUTileSize(FILE* file, const cv::Size& dirSize)
             tileHeight = mcuHeight;
         }
     }
+    else if (cinfo.restart_interval > 0 && (cinfo.restart_interval % mcuPerRow) == 0) {
+        // an interval spans several complete MCU rows
+        tileWidth = mcuWidth * mcuPerRow;
+        tileHeight = mcuHeight * (cinfo.restart_interval / mcuPerRow);
+    }
     cinfo.output_scanline = cinfo.output_height; // otherwise libjpeg crashes
     jpeg_finish_decompress(&cinfo);
     jpeg_destroy_decompress(&cinfo);
@@ -1320,8 +1410,6 @@ void NDPITiffTools::readMCUTile(FILE* file, const NDPITiffDirectory& dir, int ti
     if(file ==nullptr) {
         RAISE_RUNTIME_ERROR << "NDPITiffTools: file pointer is not set";
     }
-    // read jpeg header
-    const uint64_t headerOffset = dir.jpegHeaderOffset;
     const uint32_t headerSize = dir.jpegHeaderSize;
     const uint64_t tileOffset = dir.mcuStarts[tile];
 
@@ -1333,16 +1421,22 @@ void NDPITiffTools::readMCUTile(FILE* file, const NDPITiffDirectory& dir, int ti
         uint64_t stripEndOffset = dir.jpegHeaderOffset + dir.rawStripSize;
         tileSize = static_cast<uint32_t>(stripEndOffset - tileOffset);
     }
-    std::vector<uint8_t> tileData(headerSize + tileSize);
+    // the buffer is reused by all tiles decoded on a thread
+    thread_local std::vector<uint8_t> tileData;
+    tileData.resize(headerSize + tileSize);
 
-    Tools::setFilePos(file, headerOffset, SEEK_SET);
-    auto count = fread(tileData.data(), sizeof(uint8_t), headerSize, file);
-    if(count != headerSize) {
-        RAISE_RUNTIME_ERROR << "NDPITiffTools: error by reading jpeg header. Expected:" << headerSize << ". Read:" << count;
+    if (dir.jpegHeader.size() == headerSize) {
+        std::copy(dir.jpegHeader.begin(), dir.jpegHeader.end(), tileData.begin());
+    }
+    else {
+        const size_t count = Tools::readFileAt(file, dir.jpegHeaderOffset, tileData.data(), headerSize);
+        if(count != headerSize) {
+            RAISE_RUNTIME_ERROR << "NDPITiffTools: error by reading jpeg header. Expected:" << headerSize << ". Read:" << count;
+        }
+        fixJpegHeader(dir, tileData.data());
     }
 
-    Tools::setFilePos(file, tileOffset, SEEK_SET);
-    count = fread(tileData.data() + headerSize, sizeof(uint8_t), tileSize, file);
+    const size_t count = Tools::readFileAt(file, tileOffset, tileData.data() + headerSize, tileSize);
     if(count != tileSize) {
         RAISE_RUNTIME_ERROR << "NDPITiffTools: error by reading jpeg tile. Expected:" << tileSize << ". Read:" << count;
     }
@@ -1352,11 +1446,108 @@ void NDPITiffTools::readMCUTile(FILE* file, const NDPITiffDirectory& dir, int ti
 
     tileData[tileData.size() - 1] = JPEG_EOI; // End of image marker
 
-    fixJpegHeader(dir, (uint8_t*)tileData.data());
     jpeglibDecodeTile(tileData.data(), tileData.size(), cv::Size(dir.tileWidth, dir.tileHeight), output);
 
 }
 
+void NDPITiffTools::scanRestartMarkers(FILE* file, uint64_t dataBegin, uint64_t dataEnd, std::vector<uint64_t>& starts)
+{
+    if (file == nullptr) {
+        RAISE_RUNTIME_ERROR << "NDPITiffTools: file pointer is not set";
+    }
+    starts.clear();
+    starts.push_back(dataBegin);
+    const size_t BUFFER_SIZE = 1024 * 1024;
+    std::vector<uint8_t> buffer(BUFFER_SIZE);
+    uint64_t pos = dataBegin;
+    bool markerPrefix = false;
+    while (pos < dataEnd) {
+        const size_t toRead = static_cast<size_t>(std::min<uint64_t>(BUFFER_SIZE, dataEnd - pos));
+        const size_t count = Tools::readFileAt(file, pos, buffer.data(), toRead);
+        if (count != toRead) {
+            RAISE_RUNTIME_ERROR << "NDPITiffTools: error by reading entropy-coded segment. Expected:" << toRead
+                << ". Read:" << count;
+        }
+        for (size_t index = 0; index < count; ++index) {
+            const uint8_t byte = buffer[index];
+            if (markerPrefix) {
+                // 0xFF00 is a stuffed byte, 0xFFFF a fill byte before a marker
+                markerPrefix = (byte == 0xFF);
+                if (byte >= 0xD0 && byte <= 0xD7) {
+                    starts.push_back(pos + index + 1);
+                }
+                else if (byte == 0xD9) {
+                    return; // End of image marker
+                }
+            }
+            else if (byte == 0xFF) {
+                markerPrefix = true;
+            }
+        }
+        pos += count;
+    }
+}
+
+void NDPITiffTools::readMCURegion(FILE* file, const NDPITiffDirectory& dir, const cv::Rect& region,
+                                  const std::vector<int>& channelIndices, cv::OutputArray output)
+{
+    if (dir.getType() != NDPITiffDirectory::Type::SingleStripeMCU) {
+        RAISE_RUNTIME_ERROR << "NDPITiffTools::readMCURegion: directory " << dir.dirIndex
+            << " is not split into restart intervals. Directory type: " << dir.getType();
+    }
+    const cv::Rect dirRect(0, 0, dir.width, dir.height);
+    if ((region & dirRect) != region || region.empty()) {
+        RAISE_RUNTIME_ERROR << "NDPITiffTools::readMCURegion: region (" << region.x << "," << region.y << ","
+            << region.width << "," << region.height << ") is outside of directory " << dir.dirIndex;
+    }
+    const int tilesX = (dir.width - 1) / dir.tileWidth + 1;
+    const int firstTileX = region.x / dir.tileWidth;
+    const int lastTileX = (region.x + region.width - 1) / dir.tileWidth;
+    const int firstTileY = region.y / dir.tileHeight;
+    const int lastTileY = (region.y + region.height - 1) / dir.tileHeight;
+    std::vector<int> tiles;
+    tiles.reserve((lastTileX - firstTileX + 1) * (lastTileY - firstTileY + 1));
+    for (int tileY = firstTileY; tileY <= lastTileY; ++tileY) {
+        for (int tileX = firstTileX; tileX <= lastTileX; ++tileX) {
+            tiles.push_back(tileY * tilesX + tileX);
+        }
+    }
+
+    const bool allChannels = Tools::isCompleteChannelList(channelIndices, dir.channels);
+    const int numChannels = allChannels ? dir.channels : static_cast<int>(channelIndices.size());
+    output.create(region.size(), CV_MAKETYPE(CV_8U, numChannels));
+    cv::Mat outputMat = output.getMat();
+
+    if (file == nullptr) {
+        RAISE_RUNTIME_ERROR << "NDPITiffTools: file pointer is not set";
+    }
+    // intervals are decoded on the shared OpenCV pool: calls from several reader threads
+    // do not multiply the threads, and the per-thread decode buffers are reused
+    const ReadStatisticsTargets statisticsTargets = ReadStatisticsScope::current();
+    cv::parallel_for_(cv::Range(0, static_cast<int>(tiles.size())), [&](const cv::Range& range) {
+        ReadStatisticsScope statisticsScope;
+        statisticsScope.activate(statisticsTargets);
+        cv::Mat tileRaster;
+        cv::Mat channelRaster;
+        for (int index = range.start; index < range.end; ++index) {
+            const int tile = tiles[index];
+            const cv::Rect tileRect((tile % tilesX) * dir.tileWidth, (tile / tilesX) * dir.tileHeight,
+                dir.tileWidth, dir.tileHeight);
+            readMCUTile(file, dir, tile, tileRaster);
+            const cv::Rect intersection = tileRect & region;
+            const cv::Mat tilePart(tileRaster, intersection - tileRect.tl());
+            cv::Mat regionPart(outputMat, intersection - region.tl());
+            if (allChannels) {
+                tilePart.copyTo(regionPart);
+            }
+            else {
+                Tools::extractChannels(tilePart, channelIndices, channelRaster);
+                channelRaster.copyTo(regionPart);
+            }
+        }
+    });
+}
+
 void NDPITiffTools::jpeglibDecodeTile(const uint8_t* jpg_buffer, size_t jpg_size, const cv::Size& tileSize, cv::OutputArray output)
 {
     // code derived from: https://gist.github.com/PhirePhly/3080633
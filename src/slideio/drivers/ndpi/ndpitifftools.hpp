@@ -65,6 +65,9 @@ namespace slideio
         uint64_t jpegHeaderOffset;
         uint64_t jpegSOFMarker;
         uint32_t jpegHeaderSize;
+        // jpeg header of the strip with the SOF dimensions already patched by fixJpegHeader,
+        // prepended to every restart interval decoded by readMCUTile
+        std::vector<uint8_t> jpegHeader;
         uint32_t rawStripSize = 0;
         bool auxImage = false;
 
@@ -121,9 +124,19 @@ namespace slideio
         static cv::Size computeTileCounts(const NDPITiffDirectory& dir);
         static void readJpegScanlines(libtiff::TIFF* tiff, FILE* file, const NDPITiffDirectory& dir, int firstScanline,
             int numberScanlines, const std::vector<int>& channelIndices, cv::_OutputArray output);
-        static void readJpegDirectoryRegion(libtiff::TIFF* tiff, const std::string& filePath, const cv::Rect& region, const NDPITiffDirectory& dir,
+        // The jpeg stream is read with positional reads (Tools::readFileAt): the file handle
+        // may be shared, e.g. NDPIFile::getFileHandle.
+        static void readJpegDirectoryRegion(libtiff::TIFF* tiff, FILE* file, const cv::Rect& region, const NDPITiffDirectory& dir,
             const std::vector<int>& channelIndices, cv::_OutputArray output);
         static void readDirectoryJpegHeaders(NDPIFile* ndpi, NDPITiffDirectory& dir);
+        // Collects the file offsets of the restart intervals of a jpeg entropy-coded segment
+        // [dataBegin, dataEnd): the first interval starts at dataBegin, every following one
+        // right after a RSTn marker.
+        static void scanRestartMarkers(FILE* file, uint64_t dataBegin, uint64_t dataEnd, std::vector<uint64_t>& starts);
+        // Decodes only the restart intervals covering the region of a SingleStripeMCU directory.
+        // Intervals are decoded in parallel; the workers share the file through positional reads.
+        static void readMCURegion(FILE* file, const NDPITiffDirectory& dir, const cv::Rect& region,
+            const std::vector<int>& channelIndices, cv::OutputArray output);
         static void readUncompressedScanlines(libtiff::TIFF* tiff, FILE* file, const NDPITiffDirectory& dir, int firstScanline, int numberScanlines, const std::vector<int>& vector,
                                       cv::_OutputArray tileRaster);
     private:
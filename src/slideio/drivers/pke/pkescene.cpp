@@ -36,6 +36,7 @@ PKEScene::~PKEScene() = default;
 
 void PKEScene::makeSureFileIsOpened()
 {
+    std::lock_guard<std::mutex> lock(m_fileMutex);
     if (!m_tiffKeeper.isValid()) {
         m_tiffKeeper.reset(TiffTools::openTiffFile(m_filePath));
         if(!m_tiffKeeper.isValid()) {
@@ -49,3 +50,11 @@ libtiff::TIFF* PKEScene::getFileHandle()
     makeSureFileIsOpened();
     return m_tiffKeeper.getHandle();
 }
+
+bool PKEScene::closeFileHandles()
+{
+    // the file is reopened by the next getFileHandle
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    m_tiffKeeper.reset();
+    return true;
+}
@@ -56,6 +56,8 @@ namespace slideio
         }
         libtiff::TIFF* getFileHandle();
 
+    protected:
+        bool closeFileHandles() override;
     protected:
         std::string m_filePath;
         std::string m_driverId;
@@ -67,6 +69,7 @@ namespace slideio
 		int m_sceneIndex;
     private:
         TIFFKeeper m_tiffKeeper;
+        std::mutex m_fileMutex;
     };
 }
 
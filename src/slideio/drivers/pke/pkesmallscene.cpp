@@ -5,10 +5,12 @@
 #include "slideio/drivers/pke/pketools.hpp"
 #include "slideio/slideio/slideio.hpp"
 #include "slideio/imagetools/tifftools.hpp"
+#include "slideio/core/tools/tools.hpp"
 #include "slideio/core/levelinfo.hpp"
 
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
+#include <algorithm>
 
 using namespace slideio;
 
@@ -19,7 +21,9 @@ PKESmallScene::PKESmallScene(const std::string& filePath,
     const TiffDirectory& dir,
     bool auxiliary):
         PKEScene(filePath, sceneIndex, driverId, name),
-        m_directory(dir)
+        m_directory(dir),
+        m_rasterCache(std::max(TiffTools::getDecodedBytes(dir), RasterCache::DEFAULT_MAX_BYTES)),
+        m_stripHandles(filePath)
 {
     m_dataType = m_directory.dataType;
 
@@ -85,32 +89,33 @@ void PKESmallScene::readResampledBlockChannelsEx(const cv::Rect& blockRect, cons
         RAISE_RUNTIME_ERROR << "PKEDriver: Invalid file header by raster reading operation";
     }
 
-    cv::Mat wholeDirRaster;
-    if(channelIndices.empty())
+    cv::Mat blockRaster;
+    if (TiffTools::getStripRange(m_directory, blockRect) == TiffTools::getStripRange(m_directory, getRect()))
     {
-        TiffTools::readStripedDir(hFile, m_directory, wholeDirRaster);
+        // the whole directory is decoded anyway: it is kept for the next blocks
+        const cv::Mat dirRaster = m_rasterCache.get("directory", [this, hFile](cv::OutputArray raster) {
+            TiffTools::readStripedDir(hFile, m_directory, raster);
+        });
+        blockRaster = dirRaster(blockRect);
     }
     else
     {
-        cv::Mat dirRaster;
-        TiffTools::readStripedDir(hFile, m_directory, dirRaster);
-        if(channelIndices.size()==1)
-        {
-            cv::extractChannel(dirRaster, wholeDirRaster, channelIndices[0]);
-        }
-        else
-        {
-            std::vector<cv::Mat> channelRasters;
-            channelRasters.reserve(channelIndices.size());
-            for (const auto& channelIndex : channelIndices)
-            {
-                cv::Mat channelRaster;
-                cv::extractChannel(dirRaster, channelRaster, channelIndex);
-                channelRasters.push_back(channelRaster);
-            }
-            cv::merge(channelRasters, wholeDirRaster);
-        }
+        TiffTools::readStripedDirRegion(hFile, m_directory, blockRect, blockRaster, &m_stripHandles);
+    }
+    if (channelIndices.empty())
+    {
+        Tools::resize(blockRaster, output, blockSize);
     }
-    cv::Mat blockRaster = wholeDirRaster(blockRect);
-    cv::resize(blockRaster, output, blockSize);
+    else
+    {
+        cv::Mat channelRaster;
+        Tools::extractChannels(blockRaster, channelIndices, channelRaster);
+        Tools::resize(channelRaster, output, blockSize);
+    }
+}
+
+bool PKESmallScene::closeFileHandles()
+{
+    m_stripHandles.closeHandles();
+    return PKEScene::closeFileHandles();
 }
@@ -6,6 +6,8 @@
 #include "slideio/drivers/pke/pke_api_def.hpp"
 #include "slideio/drivers/pke/pkescene.hpp"
 #include "slideio/imagetools/tifftools.hpp"
+#include "slideio/core/tools/rastercache.hpp"
+#include "slideio/imagetools/tiffhandlepool.hpp"
 
 #if defined(_MSC_VER)
 #pragma warning( push )
@@ -28,8 +30,14 @@ namespace slideio
         int getNumChannels() const override;
         void readResampledBlockChannelsEx(const cv::Rect& blockRect, const cv::Size& blockSize,
             const std::vector<int>& channelIndices, int zSliceIndex, int tFrameIndex, cv::OutputArray output) override;
+    protected:
+        bool closeFileHandles() override;
     private:
         slideio::TiffDirectory m_directory;
+        // whole-directory decode, kept whatever its size
+        RasterCache m_rasterCache;
+        // handles of the threads that decode the strips of a region
+        TIFFHandlePool m_stripHandles;
         LevelInfo m_levelInfo;
     };
 }
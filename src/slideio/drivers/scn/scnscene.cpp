@@ -33,6 +33,26 @@ SCNScene::~SCNScene()
 {
 }
 
+libtiff::TIFF* SCNScene::getFileHandle()
+{
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    if (!m_tiff.isValid()) {
+        m_tiff.reset(TiffTools::openTiffFile(m_filePath.c_str()));
+        if (!m_tiff.isValid()) {
+            RAISE_RUNTIME_ERROR << "SCNImageDriver: Cannot open file:" << m_filePath;
+        }
+    }
+    return m_tiff.getHandle();
+}
+
+bool SCNScene::closeFileHandles()
+{
+    // the file is reopened by the next getFileHandle
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    m_tiff.reset();
+    return true;
+}
+
 cv::Rect SCNScene::getRect() const
 {
     return m_rect;
@@ -9,6 +9,7 @@
 #include "slideio/core/tools/tilecomposer.hpp"
 #include "slideio/drivers/scn/scnstruct.h"
 #include "slideio/imagetools/tiffkeeper.hpp"
+#include <mutex>
 
 namespace tinyxml2
 {
@@ -90,12 +91,13 @@ namespace slideio
         void parseMagnification(const tinyxml2::XMLElement* xmlImage);
         void defineChannelDataType();
         void setupChannels(const tinyxml2::XMLElement* xmlPixels);
-        libtiff::TIFF* getFileHandle() {
-            return m_tiff.getHandle();
-        }
+        // Reopens the file if it was closed by closeFileHandles.
+        libtiff::TIFF* getFileHandle();
+        bool closeFileHandles() override;
         void createEmptyChannelTile(int tileIndex, int channel, cv::OutputArray output, void* userData);
     protected:
         TIFFKeeper m_tiff;
+        std::mutex m_fileMutex;
         std::string m_filePath;
         std::string m_driverId;
         std::string m_name;
@@ -29,6 +29,8 @@ void SCNSlide::init()
     TiffTools::scanFile(m_tiff.getHandle(), directories);
     m_rawMetadata = directories[0].description;
     constructScenes();
+    // the scenes read through handles of their own
+    m_tiff.reset();
 }
 
 void SCNSlide::constructScenes()
@@ -117,6 +119,16 @@ std::shared_ptr<CVScene> SCNSlide::getScene(int index) const
     return m_Scenes[index];
 }
 
+bool SCNSlide::releaseFileHandles()
+{
+    // every scene and auxiliary image keeps its own tiff handle
+    bool released = CVSlide::releaseFileHandles();
+    for (const auto& auxImage : m_auxImages) {
+        released = auxImage.second->releaseFileHandles() && released;
+    }
+    return released;
+}
+
 std::shared_ptr<CVScene> SCNSlide::getAuxImage(const std::string& sceneName) const
 {
     auto it = m_auxImages.find(sceneName);
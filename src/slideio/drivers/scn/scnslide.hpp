@@ -29,6 +29,7 @@ namespace slideio
         std::string getFilePath() const override;
         std::shared_ptr<slideio::CVScene> getScene(int index) const override;
         std::shared_ptr<CVScene> getAuxImage(const std::string& sceneName) const override;
+        bool releaseFileHandles() override;
     private:
         std::vector<std::shared_ptr<slideio::SCNScene>> m_Scenes;
         std::map<std::string, std::shared_ptr<slideio::CVScene>> m_auxImages;
@@ -36,6 +36,7 @@ SVSScene::~SVSScene() = default;
 
 void SVSScene::makeSureFileIsOpened()
 {
+    std::lock_guard<std::mutex> lock(m_fileMutex);
     if (!m_tiffKeeper.isValid()) {
         m_tiffKeeper.reset(TiffTools::openTiffFile(m_filePath));
         if(!m_tiffKeeper.isValid()) {
@@ -49,3 +50,11 @@ libtiff::TIFF* SVSScene::getFileHandle()
     makeSureFileIsOpened();
     return m_tiffKeeper.getHandle();
 }
+
+bool SVSScene::closeFileHandles()
+{
+    // the file is reopened by the next getFileHandle
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    m_tiffKeeper.reset();
+    return true;
+}
@@ -64,6 +64,8 @@ namespace slideio
             return m_dataType;
         }
         libtiff::TIFF* getFileHandle();
+    protected:
+        bool closeFileHandles() override;
     protected:
         std::string m_filePath;
         std::string m_driverId;
@@ -75,6 +77,7 @@ namespace slideio
         int m_sceneIndex;
     private:
         TIFFKeeper m_tiffKeeper;
+        std::mutex m_fileMutex;
     };
 }
 
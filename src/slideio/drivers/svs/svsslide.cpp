@@ -56,6 +56,16 @@ std::shared_ptr<CVScene> SVSSlide::getScene(int index) const
     return m_Scenes[index];
 }
 
+bool SVSSlide::releaseFileHandles()
+{
+    // every scene and auxiliary image keeps its own tiff handle
+    bool released = CVSlide::releaseFileHandles();
+    for (const auto& auxImage : m_auxImages) {
+        released = auxImage.second->releaseFileHandles() && released;
+    }
+    return released;
+}
+
 void SVSSlide::init(const std::vector<TiffDirectory>& directories, TIFFKeeper& keeper) {
     std::vector<int> image;
     int thumbnail(-1), macro(-1), label(-1);
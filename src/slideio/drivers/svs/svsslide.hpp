@@ -37,6 +37,7 @@ namespace slideio
         static std::shared_ptr<SVSSlide> openFile(const std::string& path, const std::string& id);
         static void closeFile(libtiff::TIFF* hfile);
         std::shared_ptr<CVScene> getAuxImage(const std::string& sceneName) const override;
+        bool releaseFileHandles() override;
         void log();
     protected:
         MetadataBuilder buildMetadataTree() const override;
@@ -6,6 +6,8 @@
 #include "slideio/drivers/svs/svs_api_def.hpp"
 #include "slideio/drivers/svs/svsscene.hpp"
 #include "slideio/imagetools/tifftools.hpp"
+#include "slideio/core/tools/rastercache.hpp"
+#include "slideio/imagetools/tiffhandlepool.hpp"
 
 #if defined(_MSC_VER)
 #pragma warning( push )
@@ -27,8 +29,14 @@ namespace slideio
         int getNumChannels() const override;
         void readResampledBlockChannelsEx(const cv::Rect& blockRect, const cv::Size& blockSize,
             const std::vector<int>& channelIndices, int zSliceIndex, int tFrameIndex, cv::OutputArray output) override;
+    protected:
+        bool closeFileHandles() override;
     private:
         slideio::TiffDirectory m_directory;
+        // whole-directory decode, kept whatever its size
+        RasterCache m_rasterCache;
+        // handles of the threads that decode the strips of a region
+        TIFFHandlePool m_stripHandles;
     };
 }
 
@@ -71,9 +71,9 @@ void vsi::EtsFile::initStruct(TileInfoListPtr& tiles) {
 
 void slideio::vsi::EtsFile::read(std::list<std::shared_ptr<Volume>>& volumes, std::shared_ptr<std::vector<TileInfo>>& tiles) {
     // Open the file
-    m_etsStream = std::make_unique<vsi::VSIStream>(m_filePath);
+    auto etsStream = std::make_unique<vsi::VSIStream>(m_filePath);
     vsi::EtsVolumeHeader header = {0};
-    m_etsStream->read<vsi::EtsVolumeHeader>(header);
+    etsStream->read<vsi::EtsVolumeHeader>(header);
     fromLittleEndianToNative(header);
 
     if (strncmp((char*)header.magic, "SIS", 3) != 0) {
@@ -84,9 +84,9 @@ void slideio::vsi::EtsFile::read(std::list<std::shared_ptr<Volume>>& volumes, st
         RAISE_RUNTIME_ERROR << "VSI driver: invalid file header. Expected header size: 64, got: "
             << header.headerSize;
     }
-    m_etsStream->setPos(header.additionalHeaderPos);
+    etsStream->setPos(header.additionalHeaderPos);
     ETSAdditionalHeader additionalHeader = {0};
-    m_etsStream->read<vsi::ETSAdditionalHeader>(additionalHeader);
+    etsStream->read<vsi::ETSAdditionalHeader>(additionalHeader);
 	fromLittleEndianToNative(additionalHeader);
 
     if (strncmp((char*)additionalHeader.magic, "ETS", 3) != 0) {
@@ -106,23 +106,23 @@ void slideio::vsi::EtsFile::read(std::list<std::shared_ptr<Volume>>& volumes, st
     std::memcpy(m_backgroundColor, additionalHeader.background, sizeof(m_backgroundColor));
     m_usePyramid = additionalHeader.usePyramid != 0;
 
-    m_etsStream->setPos(header.usedChunksPos);
+    etsStream->setPos(header.usedChunksPos);
     tiles->resize(header.numUsedChunks);
     m_maxCoordinates.resize(m_numDimensions);
     for (uint chunk = 0; chunk < header.numUsedChunks; ++chunk) {
         TileInfo& tileInfo = tiles->at(chunk);
-        m_etsStream->skipBytes(4);
+        etsStream->skipBytes(4);
         tileInfo.coordinates.resize(m_numDimensions);
         for (int i = 0; i < m_numDimensions; ++i) {
-            tileInfo.coordinates[i] = m_etsStream->readValue<int32_t>();
+            tileInfo.coordinates[i] = etsStream->readValue<int32_t>();
 			tileInfo.coordinates[i] = Endian::fromLittleEndianToNative(tileInfo.coordinates[i]);
             m_maxCoordinates[i] = std::max(m_maxCoordinates[i], tileInfo.coordinates[i]);
         }
-        tileInfo.offset = m_etsStream->readValue<int64_t>();
+        tileInfo.offset = etsStream->readValue<int64_t>();
 		tileInfo.offset = Endian::fromLittleEndianToNative(tileInfo.offset);
-        tileInfo.size = m_etsStream->readValue<uint32_t>();
+        tileInfo.size = etsStream->readValue<uint32_t>();
 		tileInfo.size = Endian::fromLittleEndianToNative(tileInfo.size);
-        m_etsStream->skipBytes(4);
+        etsStream->skipBytes(4);
     }
 
     const int64_t minWidth = static_cast<int64_t>(m_maxCoordinates[0]) * m_tileSize.width;
@@ -136,25 +136,54 @@ void slideio::vsi::EtsFile::read(std::list<std::shared_ptr<Volume>>& volumes, st
 
     m_sizeWithCompleteTiles = cv::Size(static_cast<int>(maxWidth), static_cast<int>(maxHeight));
 
+    m_etsFile.reset(Tools::openFile(m_filePath, "rb"));
+    if (!m_etsFile) {
+        RAISE_RUNTIME_ERROR << "VSI driver: cannot open file " << m_filePath;
+    }
+
+}
+
+FILE* vsi::EtsFile::getFileHandle() const {
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    if (!m_etsFile) {
+        m_etsFile.reset(Tools::openFile(m_filePath, "rb"));
+        if (!m_etsFile) {
+            RAISE_RUNTIME_ERROR << "VSI driver: cannot open file " << m_filePath;
+        }
+    }
+    return m_etsFile.get();
+}
+
+void vsi::EtsFile::closeFile() {
+    // the file is reopened by the next tile read
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    m_etsFile.reset();
 }
 
-void vsi::EtsFile::readTilePart(const vsi::TileInfo& tileInfo, cv::OutputArray tileRaster) {
+void vsi::EtsFile::readTilePart(const vsi::TileInfo& tileInfo, cv::OutputArray tileRaster) const {
+    FILE* file = getFileHandle();
     const int64_t offset = tileInfo.offset;
     const uint32_t tileCompressedSize = tileInfo.size;
     const int ds = CVTools::cvGetDataTypeSize(m_dataType);
-    m_etsStream->setPos(offset);
-    m_buffer.resize(tileCompressedSize);
-    m_etsStream->readBytes(m_buffer.data(), static_cast<int>(m_buffer.size()));
+    std::vector<uint8_t> buffer(tileCompressedSize);
+    const size_t count = Tools::readFileAt(file, offset, buffer.data(), buffer.size());
+    if (count != buffer.size()) {
+        RAISE_RUNTIME_ERROR << "VSI driver: error by reading tile at offset " << offset
+            << ". Expected: " << buffer.size() << " bytes. Read: " << count;
+    }
     tileRaster.create(m_tileSize, CV_MAKETYPE(CVTools::cvTypeFromDataType(m_dataType), 1));
     if (m_compression == slideio::Compression::Uncompressed) {
-        const int tileSize = m_tileSize.width * m_tileSize.height * ds;
-        std::memcpy(tileRaster.getMat().data, m_buffer.data(), tileSize);
+        const size_t tileSize = static_cast<size_t>(m_tileSize.width) * m_tileSize.height * ds;
+        if (buffer.size() < tileSize) {
+            RAISE_RUNTIME_ERROR << "VSI driver: uncompressed tile at offset " << offset << " is truncated";
+        }
+        std::memcpy(tileRaster.getMat().data, buffer.data(), tileSize);
     }
     else if (m_compression == slideio::Compression::Jpeg) {
-        ImageTools::decodeJpegStream(m_buffer.data(), m_buffer.size(), tileRaster);
+        ImageTools::decodeJpegStream(buffer.data(), buffer.size(), tileRaster);
     }
     else if (m_compression == slideio::Compression::Jpeg2000) {
-        ImageTools::decodeJp2KStream(m_buffer.data(), m_buffer.size(), tileRaster);
+        ImageTools::decodeJp2KStream(buffer.data(), buffer.size(), tileRaster);
     }
     else {
         RAISE_RUNTIME_ERROR << "VSIImageDriver: readTile: Compression " << static_cast<int>(m_compression)
@@ -167,7 +196,7 @@ void vsi::EtsFile::readTile(int levelIndex,
                             const std::vector<int>& channelIndices,
                             int zSlice,
                             int tFrame,
-                            cv::OutputArray output) {
+                            cv::OutputArray output) const {
     if (levelIndex < 0 || levelIndex >= m_pyramid.getNumLevels()) {
         RAISE_RUNTIME_ERROR << "VSIImageDriver: readTile: Pyramid level "
             << levelIndex << " is out of range (0 - " << m_pyramid.getNumLevels() << " )";
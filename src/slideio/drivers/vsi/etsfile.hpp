@@ -5,6 +5,7 @@
 
 #include <string>
 #include <vector>
+#include <mutex>
 
 #include "slideio/drivers/vsi/vsi_api_def.hpp"
 #include "slideio/drivers/vsi/etsfilescene.hpp"
@@ -13,6 +14,7 @@
 #include "slideio/base/slideio_enums.hpp"
 #include "slideio/drivers/vsi/vsistream.hpp"
 #include "slideio/drivers/vsi/pyramid.hpp"
+#include "slideio/core/tools/tools.hpp"
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -46,7 +48,7 @@ namespace slideio
             }
 
             void read(std::list<std::shared_ptr<Volume>>& volumes, TileInfoListPtr& tiles);
-            void readTilePart(const vsi::TileInfo& tileInfo, cv::OutputArray tileRaster);
+            void readTilePart(const vsi::TileInfo& tileInfo, cv::OutputArray tileRaster) const;
             bool assignVolume(std::list<std::shared_ptr<vsi::Volume>>& volumes);
             void initStruct(TileInfoListPtr& tiles);
 
@@ -88,7 +90,11 @@ namespace slideio
             const cv::Size& getSizeWithCompleteTiles() const {
                 return m_sizeWithCompleteTiles;
             }
-            void readTile(int levelIndex, int tileIndex, const std::vector<int>& channelIndices, int zSlice, int tFrame, cv::OutputArray output);
+            void readTile(int levelIndex, int tileIndex, const std::vector<int>& channelIndices, int zSlice, int tFrame, cv::OutputArray output) const;
+            // Closes the file. The next tile read reopens it.
+            void closeFile();
+        private:
+            FILE* getFileHandle() const;
         private:
             std::string m_filePath;
             DataType m_dataType = DataType::DT_Unknown;
@@ -108,8 +114,10 @@ namespace slideio
             int m_numDimensions;
             std::shared_ptr<Volume> m_volume;
             Pyramid m_pyramid;
-            std::unique_ptr<VSIStream> m_etsStream;
-            std::vector<uint8_t> m_buffer;
+            // tile data is read with positional reads, so tiles of one file
+            // may be read and decoded by several threads at once
+            mutable std::unique_ptr<FILE, Tools::FileDeleter> m_etsFile;
+            mutable std::mutex m_fileMutex;
             std::vector<int> m_maxCoordinates;
         };
     }
@@ -248,6 +248,16 @@ std::shared_ptr<vsi::EtsFile> EtsFileScene::getEtsFile() const {
     return m_vsiFile->getEtsFile(m_etsIndex);
 }
 
+bool EtsFileScene::closeFileHandles() {
+    // the auxiliary images read the vsi file through their own handles
+    bool closed = true;
+    for (const auto& auxScene : m_auxScenes) {
+        closed = auxScene.second->releaseFileHandles() && closed;
+    }
+    getEtsFile()->closeFile();
+    return closed;
+}
+
 int EtsFileScene::findZoomLevelIndex(double zoom) const {
     std::shared_ptr<EtsFile> etsFile = getEtsFile();
     const int levelCount = etsFile->getNumPyramidLevels();
@@ -50,6 +50,7 @@ namespace slideio
             void init();
             std::shared_ptr<EtsFile> getEtsFile() const;
             int findZoomLevelIndex(double zoom) const;
+            bool closeFileHandles() override;
         protected:
             int m_etsIndex;
             std::map<std::string, std::shared_ptr<CVScene>> m_auxScenes;
@@ -9,31 +9,54 @@
 using namespace slideio;
 using namespace slideio::vsi;
 
+int PyramidLevel::getTileLookupSlot(int tileIndex, int channelIndex, int zIndex, int tIndex) const {
+    // dimensions absent from the file match any requested index, like the coordinate filter did
+    const int channel = m_channelDimIndex > 0 ? channelIndex : 0;
+    const int z = m_zDimIndex > 0 ? zIndex : 0;
+    const int t = m_tDimIndex > 0 ? tIndex : 0;
+    if (channel < 0 || channel >= m_numChannelIndices || z < 0 || z >= m_numZIndices
+        || t < 0 || t >= m_numTIndices) {
+        return -1;
+    }
+    return ((tileIndex * m_numChannelIndices + channel) * m_numZIndices + z) * m_numTIndices + t;
+}
+
+void PyramidLevel::buildTileLookup(int numChannelIndices, int numZIndices, int numTIndices) {
+    m_numChannelIndices = m_channelDimIndex > 0 ? numChannelIndices : 1;
+    m_numZIndices = m_zDimIndex > 0 ? numZIndices : 1;
+    m_numTIndices = m_tDimIndex > 0 ? numTIndices : 1;
+    const int numTiles = static_cast<int>(m_tileIndices.size());
+    m_tileLookup.assign(static_cast<size_t>(numTiles) * m_numChannelIndices * m_numZIndices * m_numTIndices, -1);
+    for (int tileIndex = 0; tileIndex < numTiles; ++tileIndex) {
+        const int tileStartIndex = m_tileIndices[tileIndex];
+        const int tileEndIndex = (tileIndex < numTiles - 1)
+                                     ? m_tileIndices[tileIndex + 1]
+                                     : static_cast<int>(m_tiles.size());
+        for (int index = tileStartIndex; index < tileEndIndex; ++index) {
+            const auto& coordinates = m_tiles[index].coordinates;
+            const int slot = getTileLookupSlot(tileIndex,
+                m_channelDimIndex > 0 ? coordinates[m_channelDimIndex] : 0,
+                m_zDimIndex > 0 ? coordinates[m_zDimIndex] : 0,
+                m_tDimIndex > 0 ? coordinates[m_tDimIndex] : 0);
+            // the first tile of a (channel, z, t) combination wins, as with the former linear search
+            if (slot >= 0 && m_tileLookup[slot] < 0) {
+                m_tileLookup[slot] = index;
+            }
+        }
+    }
+}
+
 const TileInfo& PyramidLevel::getTile(int tileIndex, int channelIndex, int zIndex, int tIndex) const {
     const int numTiles = static_cast<int>(m_tileIndices.size());
     if (tileIndex < 0 || tileIndex >= numTiles) {
         RAISE_RUNTIME_ERROR << "Tile index " << tileIndex << "is out of range";
     }
-    const int tileStartIndex = m_tileIndices[tileIndex];
-    const int tileEndIndex = (tileIndex < numTiles - 1)
-                                 ? m_tileIndices[tileIndex + 1]
-                                 : static_cast<int>(m_tiles.size());
-
-    for (int index = tileStartIndex; index < tileEndIndex; ++index) {
-        const auto& tile = m_tiles[index];
-        if (m_channelDimIndex>0 && tile.coordinates[m_channelDimIndex] != channelIndex) {
-            continue;
-        }
-        if (m_zDimIndex>0 && tile.coordinates[m_zDimIndex] != zIndex) {
-            continue;
-        }
-        if (m_tDimIndex>0 && tile.coordinates[m_tDimIndex] != tIndex) {
-            continue;
-        }
-        return tile;
+    const int slot = getTileLookupSlot(tileIndex, channelIndex, zIndex, tIndex);
+    if (slot < 0 || m_tileLookup[slot] < 0) {
+        RAISE_RUNTIME_ERROR << "Tile not found: index: " << tileIndex
+            << " channel: " << channelIndex << " z: " << zIndex << " t: " << tIndex;
     }
-    RAISE_RUNTIME_ERROR << "Tile not found: index: " << tileIndex
-        << " channel: " << channelIndex << " z: " << zIndex << " t: " << tIndex;
+    return m_tiles[m_tileLookup[slot]];
 }
 
 void Pyramid::init(const TileInfoListPtr& tiles, const cv::Size& imageSize, const cv::Size& tileSize,
@@ -159,5 +182,6 @@ void Pyramid::init(const TileInfoListPtr& tiles, const cv::Size& imageSize, cons
                 tileIndices.push_back(static_cast<int>(index));
             }
         }
+        pyramidLevel.buildTileLookup(m_numChannelIndices, m_numZIndices, m_numTIndices);
     }
 }
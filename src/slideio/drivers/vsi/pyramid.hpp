@@ -34,11 +34,19 @@ namespace slideio
             cv::Size getSize() const { return m_size; }
             int getNumTiles() const { return static_cast<int>(m_tileIndices.size()); }
             const TileInfo& getTile(int tileIndex, int channelIndex, int zIndex, int tIndex) const;
+        private:
+            void buildTileLookup(int numChannelIndices, int numZIndices, int numTIndices);
+            int getTileLookupSlot(int tileIndex, int channelIndex, int zIndex, int tIndex) const;
         private:
             int m_scaleLevel = 1;
             cv::Size m_size;
             std::vector<TileInfo> m_tiles;
             std::vector<int> m_tileIndices;
+            // dense (tile, channel, z, t) -> position in m_tiles, -1 for missing tiles
+            std::vector<int32_t> m_tileLookup;
+            int m_numChannelIndices = 1;
+            int m_numZIndices = 1;
+            int m_numTIndices = 1;
             int m_channelDimIndex = -1;
             int m_zDimIndex = -1;
             int m_tDimIndex = -1;
@@ -26,10 +26,10 @@ void VsiFileScene::readResampledBlockChannelsEx(const cv::Rect& blockRect, const
     const TiffDirectory& directory = m_vsiFile->getTiffDirectory(m_directoryIndex);
     if(!directory.tiled) {
         cv::Mat directoryRaster;
-        TiffTools::readStripedDir(m_tiff.getHandle(), directory, directoryRaster);
+        TiffTools::readStripedDir(getFileHandle(), directory, directoryRaster);
         cv::Mat blockRaster(directoryRaster, blockRect);
         cv::Mat resizedBlockRaster;
-        cv::resize(blockRaster, resizedBlockRaster, blockSize);
+        Tools::resize(blockRaster, resizedBlockRaster, blockSize);
         Tools::extractChannels(resizedBlockRaster, channelIndices, output);
     } else {
         RAISE_RUNTIME_ERROR << "VSIImageDriver: Tiled images are not implemented";
@@ -52,6 +52,26 @@ bool VsiFileScene::readTile(int tileIndex, const std::vector<int>& channelIndice
     return false;
 }
 
+libtiff::TIFF* VsiFileScene::getFileHandle()
+{
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    if (!m_tiff.isValid()) {
+        m_tiff.reset(TiffTools::openTiffFile(m_filePath));
+        if (!m_tiff.isValid()) {
+            RAISE_RUNTIME_ERROR << "VSIImageDriver: cannot open file " << m_filePath;
+        }
+    }
+    return m_tiff.getHandle();
+}
+
+bool VsiFileScene::closeFileHandles()
+{
+    // the file is reopened by the next getFileHandle
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    m_tiff.reset();
+    return true;
+}
+
 void VsiFileScene::init()
 {
     SLIDEIO_LOG(INFO) << "VSIImageDriver initialization of a vsi scene";
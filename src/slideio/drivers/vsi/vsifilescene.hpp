@@ -6,6 +6,7 @@
 #include "vsiscene.hpp"
 #include "slideio/drivers/vsi/vsi_api_def.hpp"
 #include "slideio/imagetools/tiffkeeper.hpp"
+#include <mutex>
 
 
 #if defined(_MSC_VER)
@@ -30,9 +31,13 @@ namespace slideio
                           void* userData) override;
         protected:
             void init();
+            // Reopens the file if it was closed by closeFileHandles.
+            libtiff::TIFF* getFileHandle();
+            bool closeFileHandles() override;
         protected:
             int m_directoryIndex;
             TIFFKeeper m_tiff;
+            std::mutex m_fileMutex;
         };
     }
 
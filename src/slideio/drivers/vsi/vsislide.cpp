@@ -75,6 +75,16 @@ int VSISlide::getNumScenes() const
     return static_cast<int>(m_Scenes.size());
 }
 
+bool VSISlide::releaseFileHandles()
+{
+    // every scene and auxiliary image keeps its own file handle
+    bool released = CVSlide::releaseFileHandles();
+    for (const auto& auxImage : m_auxImages) {
+        released = auxImage.second->releaseFileHandles() && released;
+    }
+    return released;
+}
+
 std::string VSISlide::getFilePath() const
 {
     return m_filePath;
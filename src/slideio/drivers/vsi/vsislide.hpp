@@ -31,6 +31,7 @@ namespace slideio
             std::shared_ptr<slideio::CVScene> getScene(int index) const override;
             std::shared_ptr<CVScene> getAuxImage(const std::string& sceneName) const override;
             const std::string& getRawMetadata() const override;
+            bool releaseFileHandles() override;
         private:
             void init();
         private:
@@ -8,6 +8,7 @@
 #include "slideio/drivers/zvi/zviimageitem.hpp"
 #include "slideio/imagetools/imagetools.hpp"
 #include "slideio/core/tools/endian.hpp"
+#include "slideio/base/exceptions.hpp"
 
 using namespace slideio;
 
@@ -160,41 +161,41 @@ void ZVIImageItem::readTags(ole::compound_document& doc)
 #pragma clang diagnostic pop
 #endif
 
-void ZVIImageItem::readRaster(ole::compound_document& doc, cv::OutputArray raster) const
+void ZVIImageItem::readRaster(const ZVIStreamIndex& index, cv::OutputArray raster) const
 {
     const DataType dt = getDataType();
     const int ds = CVTools::cvGetDataTypeSize(dt);
     const size_t pixels = getWidth() * getHeight();
     const int channels = getChannelCount();
-    const std::streamoff rasterSize = pixels * ds * channels;
+    const size_t rasterSize = pixels * ds * channels;
     const int validBites = getValidBits();
-    const ZVIPixelFormat pixelFormat = getPixelFormat();
 
-
-    const std::string streamPath = std::string("/Image/Item(") + std::to_string(getItemIndex()) + ")/Contents";
-    ZVIUtils::StreamKeeper stream(doc, streamPath);
-
-    stream->seek(getDataOffset(), std::ios::beg);
+    if (!m_ContentsStream) {
+        RAISE_RUNTIME_ERROR << "ZVIImageDriver: no contents stream for image item " << getItemIndex();
+    }
+    const ZVIStreamIndex::Stream& stream = *m_ContentsStream;
+    if (getDataOffset() < 0 || static_cast<uint64_t>(getDataOffset()) > stream.size) {
+        RAISE_RUNTIME_ERROR << "ZVIImageDriver: invalid data offset of image item " << getItemIndex();
+    }
 
     if (validBites==0 || validBites==1)
     {
-        stream->seek(0, std::ios::end);
-        std::streampos endPos = stream->pos();
-        std::streamsize bytesToRead = endPos - getDataOffset();
-        stream->seek(getDataOffset(), std::ios::beg);
-        std::vector<uint8_t> buff(bytesToRead);
-        stream->read(reinterpret_cast<char*>(buff.data()), bytesToRead);
+        // the encoded tile occupies the rest of the stream
+        const size_t bytesToRead = static_cast<size_t>(stream.size - getDataOffset());
+        thread_local std::vector<uint8_t> buff;
+        buff.resize(bytesToRead);
+        if (index.read(stream, getDataOffset(), buff.data(), bytesToRead) != bytesToRead) {
+            RAISE_RUNTIME_ERROR << "ZVIImageDriver: Unexpected end of stream";
+        }
         ImageTools::decodeJpegStream(buff.data(), buff.size(), raster);
     }
     else
     {
         raster.create(getHeight(), getWidth(), CV_MAKETYPE(CVTools::toOpencvType(dt), channels));
         cv::Mat& mat = raster.getMatRef();
-
-        stream->seek(getDataOffset(), std::ios::beg);
-        const auto readBytes = stream->read(reinterpret_cast<char*>(mat.data), rasterSize);
+        const size_t readBytes = index.read(stream, getDataOffset(), mat.data, rasterSize);
         if (readBytes != rasterSize) {
-            throw std::runtime_error("ZVIImageDriver: Unexpected end of stream");
+            RAISE_RUNTIME_ERROR << "ZVIImageDriver: Unexpected end of stream";
         }
         Endian::fromLittleEndianToNative(dt, mat.data, readBytes);
     }
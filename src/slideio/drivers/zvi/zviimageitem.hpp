@@ -4,6 +4,7 @@
 #pragma once
 #include "slideio/drivers/zvi/pole_lib.hpp"
 #include "slideio/drivers/zvi/zvipixelformat.hpp"
+#include "slideio/drivers/zvi/zvistreamindex.hpp"
 #include "slideio/base/slideio_enums.hpp"
 #include <opencv2/opencv.hpp>
 
@@ -32,7 +33,10 @@ namespace slideio
             void readItemInfo(ole::compound_document& doc);
             int getTileIndexX() const { return m_TileIndexX; }
             int getTileIndexY() const { return m_TileIndexY; }
-            void readRaster(ole::compound_document& doc, cv::OutputArray raster) const;
+            // Stream "/Image/Item(N)/Contents" of the item in the scene stream index.
+            void setContentsStream(const ZVIStreamIndex::Stream* stream) { m_ContentsStream = stream; }
+            // Thread-safe: reads the item data through the stream index.
+            void readRaster(const ZVIStreamIndex& index, cv::OutputArray raster) const;
             int getValidBits() const { return m_ValidBits; }
             void setCIndex(int cIndex) { m_CIndex = cIndex; }
 
@@ -82,6 +86,7 @@ namespace slideio
             double m_EmissionWavelength = 0.0;
             double m_ExcitationWavelength = 0.0;
             std::string m_Reflector;
+            const ZVIStreamIndex::Stream* m_ContentsStream = nullptr;
         };
 
 }
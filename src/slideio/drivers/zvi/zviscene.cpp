@@ -20,11 +20,6 @@ using namespace slideio;
 
 ZVIScene::ZVIScene(const std::string& filePath, const std::string& driverId) :
     m_filePath(filePath),
-#if defined(WIN32)
-    m_Doc(Tools::toWstring(filePath)),
-#else
-    m_Doc(filePath),
-#endif
     m_SceneName("Unknown"),
 	m_driverId(driverId)
 {
@@ -133,7 +128,7 @@ bool ZVIScene::readTile(int tileIndex, const std::vector<int>& channelIndices, c
     TilerData* data = (TilerData*)userData;
     int slice = data->zSliceIndex;
     ZVITile& tile = m_Tiles[tileIndex];
-    return tile.readTile(channelIndices, tileRaster, slice, m_Doc);
+    return tile.readTile(channelIndices, tileRaster, slice, m_StreamIndex);
 }
 
 
@@ -142,6 +137,13 @@ ZVIPixelFormat ZVIScene::getPixelFormat() const
     return (m_PixelFormat == ZVIPixelFormat::PF_UNKNOWN) ? m_ImageItems[0].getPixelFormat() : m_PixelFormat;
 }
 
+bool ZVIScene::closeFileHandles()
+{
+    // the file is reopened by the next tile read
+    m_StreamIndex.close();
+    return true;
+}
+
 void ZVIScene::alignChannelInfoToPixelFormat()
 {
     if (m_ChannelCount == 1 && !m_ImageItems.empty())
@@ -287,17 +289,27 @@ void ZVIScene::readImageItems()
     {
         auto& item = m_ImageItems[itemIndex];
         item.setItemIndex(itemIndex);
-        item.readItemInfo(m_Doc);
+        item.readItemInfo(*m_Doc);
         const int validBits = item.getValidBits();
         if (validBits==0 || validBits==1) {
             m_Compression = Compression::Jpeg;
         }
     }
+    m_StreamIndex.open(m_filePath);
+    for (auto& item : m_ImageItems)
+    {
+        const std::string streamPath = std::string("/Image/Item(") + std::to_string(item.getItemIndex()) + ")/Contents";
+        const ZVIStreamIndex::Stream* stream = m_StreamIndex.findStream(streamPath);
+        if (!stream) {
+            RAISE_RUNTIME_ERROR << "ZVIImageDriver: missing stream " << streamPath << " in " << m_filePath;
+        }
+        item.setContentsStream(stream);
+    }
 }
 
 void ZVIScene::parseImageInfo()
 {
-    ZVIUtils::StreamKeeper stream(m_Doc, "/Image/Contents");
+    ZVIUtils::StreamKeeper stream(*m_Doc, "/Image/Contents");
     ZVIUtils::skipItems(stream, 4);
     m_Width = ZVIUtils::readIntItem(stream);
     m_Height = ZVIUtils::readIntItem(stream);
@@ -347,7 +359,12 @@ void ZVIScene::computeTiles()
 void ZVIScene::init()
 {
     Tools::throwIfPathNotExist(m_filePath, "ZVIScene::init");
-    if (!m_Doc.good())
+#if defined(WIN32)
+    m_Doc = std::make_unique<ole::compound_document>(Tools::toWstring(m_filePath));
+#else
+    m_Doc = std::make_unique<ole::compound_document>(m_filePath);
+#endif
+    if (!m_Doc->good())
     {
         RAISE_RUNTIME_ERROR << "Cannot open compound file " << m_filePath;
     }
@@ -356,6 +373,7 @@ void ZVIScene::init()
     computeSceneDimensions();
     parseImageTags();
     computeTiles();
+    m_Doc.reset();
     m_levels.resize(1);
     LevelInfo& level = m_levels[0];
     level.setLevel(0);
@@ -394,7 +412,7 @@ static double scaleToResolution(double scale, int units)
 
 void ZVIScene::parseImageTags()
 {
-    ZVIUtils::StreamKeeper stream(m_Doc, "/Image/Tags/Contents");
+    ZVIUtils::StreamKeeper stream(*m_Doc, "/Image/Tags/Contents");
     const int version = ZVIUtils::readIntItem(stream);
     const int numTags = ZVIUtils::readIntItem(stream);
     double scaleX(0), scaleY(0), scaleZ(0);
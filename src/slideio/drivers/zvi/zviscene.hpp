@@ -8,6 +8,7 @@
 #include "slideio/drivers/zvi/zviimageitem.hpp"
 #include <pole/storage.hpp>
 #include "slideio/drivers/zvi/zvitile.hpp"
+#include "slideio/drivers/zvi/zvistreamindex.hpp"
 #include "slideio/drivers/zvi/zvi_api_def.hpp"
 
 #if defined(_MSC_VER)
@@ -58,6 +59,8 @@ namespace slideio
         bool readTile(int tileIndex, const std::vector<int>& channelIndices, cv::OutputArray tileRaster,
                       void* userData) override;
         void initializeBlock(const cv::Size& blockSize, const std::vector<int>& channelIndices, cv::OutputArray output) override;
+    protected:
+        bool closeFileHandles() override;
     private:
         ZVIPixelFormat getPixelFormat() const;
         void alignChannelInfoToPixelFormat();
@@ -69,7 +72,10 @@ namespace slideio
         void computeTiles();
     private:
         std::string m_filePath;
-        ole::compound_document m_Doc;
+        // The document is parsed at open and released then: raster reads go through
+        // m_StreamIndex, which is thread-safe and can close its file between reads.
+        std::unique_ptr<ole::compound_document> m_Doc;
+        ZVIStreamIndex m_StreamIndex;
         int m_Width = 0;
         int m_Height = 0;
         int m_RawCount = 0;
@@ -0,0 +1,319 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "slideio/drivers/zvi/zvistreamindex.hpp"
+#include "slideio/base/exceptions.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace slideio;
+
+namespace
+{
+    constexpr uint32_t MAXREGSECT = 0xFFFFFFFA;
+    constexpr uint32_t NOSTREAM = 0xFFFFFFFF;
+    constexpr size_t HEADER_SIZE = 512;
+    constexpr size_t DIRECTORY_ENTRY_SIZE = 128;
+    constexpr int HEADER_DIFAT_ENTRIES = 109;
+    constexpr uint8_t ENTRY_STORAGE = 1;
+    constexpr uint8_t ENTRY_STREAM = 2;
+    constexpr uint8_t ENTRY_ROOT = 5;
+    const uint8_t SIGNATURE[8] = { 0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1 };
+
+    uint16_t readU16(const uint8_t* data) {
+        return static_cast<uint16_t>(data[0] | (data[1] << 8));
+    }
+
+    uint32_t readU32(const uint8_t* data) {
+        return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8)
+            | (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    uint64_t readU64(const uint8_t* data) {
+        return static_cast<uint64_t>(readU32(data)) | (static_cast<uint64_t>(readU32(data + 4)) << 32);
+    }
+
+    // Entry names are UTF-16LE; converted to UTF-8 to match the paths used with pole.
+    std::string entryName(const uint8_t* entry) {
+        const int nameLength = readU16(entry + 0x40);
+        const int numChars = std::max(0, std::min(32, nameLength / 2 - 1));
+        std::string name;
+        for (int index = 0; index < numChars; ++index) {
+            const uint16_t ch = readU16(entry + 2 * index);
+            if (ch < 0x80) {
+                name.push_back(static_cast<char>(ch));
+            }
+            else if (ch < 0x800) {
+                name.push_back(static_cast<char>(0xC0 | (ch >> 6)));
+                name.push_back(static_cast<char>(0x80 | (ch & 0x3F)));
+            }
+            else {
+                name.push_back(static_cast<char>(0xE0 | (ch >> 12)));
+                name.push_back(static_cast<char>(0x80 | ((ch >> 6) & 0x3F)));
+                name.push_back(static_cast<char>(0x80 | (ch & 0x3F)));
+            }
+        }
+        return name;
+    }
+
+    const ZVIStreamIndex::Extent* locateExtent(const ZVIStreamIndex::Stream& stream, uint64_t pos) {
+        auto it = std::upper_bound(stream.extents.begin(), stream.extents.end(), pos,
+            [](uint64_t value, const ZVIStreamIndex::Extent& extent) {
+                return value < extent.streamOffset;
+            });
+        if (it == stream.extents.begin()) {
+            return nullptr;
+        }
+        --it;
+        return pos < it->streamOffset + it->size ? &(*it) : nullptr;
+    }
+
+    // The last sector of a stream is used partially.
+    void truncateStream(ZVIStreamIndex::Stream& stream, uint64_t size) {
+        while (!stream.extents.empty() && stream.extents.back().streamOffset >= size) {
+            stream.extents.pop_back();
+        }
+        if (stream.extents.empty()) {
+            stream.size = 0;
+            return;
+        }
+        ZVIStreamIndex::Extent& last = stream.extents.back();
+        last.size = std::min(last.size, size - last.streamOffset);
+        stream.size = last.streamOffset + last.size;
+    }
+}
+
+void ZVIStreamIndex::open(const std::string& filePath) {
+    m_filePath = filePath;
+    m_streams.clear();
+    m_file.reset(Tools::openFile(filePath, "rb"));
+    if (!m_file) {
+        RAISE_RUNTIME_ERROR << "ZVIImageDriver: cannot open file " << filePath;
+    }
+    uint8_t header[HEADER_SIZE];
+    if (Tools::readFileAt(m_file.get(), 0, header, HEADER_SIZE) != HEADER_SIZE
+        || std::memcmp(header, SIGNATURE, sizeof(SIGNATURE)) != 0) {
+        RAISE_RUNTIME_ERROR << "ZVIImageDriver: " << filePath << " is not a compound document";
+    }
+    const bool version3 = readU16(header + 0x1A) == 3;
+    m_sectorShift = readU16(header + 0x1E);
+    m_miniSectorShift = readU16(header + 0x20);
+    if (m_sectorShift < 7 || m_sectorShift > 16 || m_miniSectorShift >= m_sectorShift) {
+        RAISE_RUNTIME_ERROR << "ZVIImageDriver: unexpected sector size in compound document " << filePath;
+    }
+    const uint32_t sectorSize = 1u << m_sectorShift;
+    const uint32_t numFatSectors = readU32(header + 0x2C);
+    const uint32_t firstDirectorySector = readU32(header + 0x30);
+    const uint32_t miniStreamCutoff = readU32(header + 0x38);
+    const uint32_t firstMiniFatSector = readU32(header + 0x3C);
+    const uint32_t firstDifatSector = readU32(header + 0x44);
+    const uint32_t numDifatSectors = readU32(header + 0x48);
+
+    // FAT sectors are listed by the header and by the chain of DIFAT sectors
+    std::vector<uint32_t> fatSectors;
+    for (int index = 0; index < HEADER_DIFAT_ENTRIES && fatSectors.size() < numFatSectors; ++index) {
+        const uint32_t sector = readU32(header + 0x4C + 4 * index);
+        if (sector > MAXREGSECT) {
+            break;
+        }
+        fatSectors.push_back(sector);
+    }
+    std::vector<uint8_t> sectorData(sectorSize);
+    uint32_t difatSector = firstDifatSector;
+    for (uint32_t index = 0; index < numDifatSectors && difatSector <= MAXREGSECT
+         && fatSectors.size() < numFatSectors; ++index) {
+        if (Tools::readFileAt(m_file.get(), sectorOffset(difatSector), sectorData.data(), sectorSize) != sectorSize) {
+            RAISE_RUNTIME_ERROR << "ZVIImageDriver: cannot read DIFAT sector of " << filePath;
+        }
+        const uint32_t entriesPerSector = sectorSize / 4 - 1;
+        for (uint32_t entry = 0; entry < entriesPerSector && fatSectors.size() < numFatSectors; ++entry) {
+            const uint32_t sector = readU32(sectorData.data() + 4 * entry);
+            if (sector <= MAXREGSECT) {
+                fatSectors.push_back(sector);
+            }
+        }
+        difatSector = readU32(sectorData.data() + 4 * entriesPerSector);
+    }
+    std::vector<uint8_t> tableData;
+    readSectors(fatSectors, tableData);
+    std::vector<uint32_t> fat(tableData.size() / 4);
+    for (size_t index = 0; index < fat.size(); ++index) {
+        fat[index] = readU32(tableData.data() + 4 * index);
+    }
+
+    std::vector<uint8_t> directory;
+    readSectors(readChain(firstDirectorySector, fat), directory);
+    const size_t numEntries = directory.size() / DIRECTORY_ENTRY_SIZE;
+    if (numEntries == 0 || directory[0x42] != ENTRY_ROOT) {
+        RAISE_RUNTIME_ERROR << "ZVIImageDriver: missing root entry in compound document " << filePath;
+    }
+    auto entrySize = [version3](const uint8_t* entry) {
+        // version 3 files may keep garbage in the high half of the size
+        return version3 ? static_cast<uint64_t>(readU32(entry + 0x78)) : readU64(entry + 0x78);
+    };
+
+    // small streams live in the mini stream, which is the data of the root entry
+    const uint8_t* root = directory.data();
+    Stream miniStream;
+    for (const uint32_t sector : readChain(readU32(root + 0x74), fat)) {
+        appendExtent(miniStream, sectorOffset(sector), sectorSize);
+    }
+    truncateStream(miniStream, entrySize(root));
+    tableData.clear();
+    readSectors(readChain(firstMiniFatSector, fat), tableData);
+    std::vector<uint32_t> miniFat(tableData.size() / 4);
+    for (size_t index = 0; index < miniFat.size(); ++index) {
+        miniFat[index] = readU32(tableData.data() + 4 * index);
+    }
+
+    // siblings form a tree of their own; the child of a storage is the root of its tree
+    struct Node {
+        uint32_t id;
+        std::string parentPath;
+    };
+    std::vector<Node> nodes;
+    std::vector<bool> visited(numEntries, false);
+    const uint32_t rootChild = readU32(root + 0x4C);
+    if (rootChild != NOSTREAM) {
+        nodes.push_back({ rootChild, std::string() });
+    }
+    const uint64_t miniSectorSize = 1ull << m_miniSectorShift;
+    while (!nodes.empty()) {
+        const Node node = nodes.back();
+        nodes.pop_back();
+        if (node.id >= numEntries || visited[node.id]) {
+            continue;
+        }
+        visited[node.id] = true;
+        const uint8_t* entry = directory.data() + node.id * DIRECTORY_ENTRY_SIZE;
+        const uint32_t left = readU32(entry + 0x44);
+        const uint32_t right = readU32(entry + 0x48);
+        const uint32_t child = readU32(entry + 0x4C);
+        if (left != NOSTREAM) {
+            nodes.push_back({ left, node.parentPath });
+        }
+        if (right != NOSTREAM) {
+            nodes.push_back({ right, node.parentPath });
+        }
+        const std::string path = node.parentPath + "/" + entryName(entry);
+        const uint8_t type = entry[0x42];
+        if (type == ENTRY_STORAGE) {
+            if (child != NOSTREAM) {
+                nodes.push_back({ child, path });
+            }
+        }
+        else if (type == ENTRY_STREAM) {
+            const uint64_t size = entrySize(entry);
+            const uint32_t start = readU32(entry + 0x74);
+            Stream stream;
+            if (size < miniStreamCutoff) {
+                for (const uint32_t miniSector : readChain(start, miniFat)) {
+                    const uint64_t pos = static_cast<uint64_t>(miniSector) << m_miniSectorShift;
+                    // a mini sector never crosses a sector boundary of the mini stream
+                    const Extent* extent = locateExtent(miniStream, pos);
+                    if (!extent || pos + miniSectorSize > extent->streamOffset + extent->size) {
+                        RAISE_RUNTIME_ERROR << "ZVIImageDriver: stream " << path << " of " << filePath
+                            << " is outside of the mini stream";
+                    }
+                    appendExtent(stream, extent->fileOffset + (pos - extent->streamOffset), miniSectorSize);
+                }
+            }
+            else {
+                for (const uint32_t sector : readChain(start, fat)) {
+                    appendExtent(stream, sectorOffset(sector), sectorSize);
+                }
+            }
+            truncateStream(stream, size);
+            if (stream.size != size) {
+                RAISE_RUNTIME_ERROR << "ZVIImageDriver: stream " << path << " of " << filePath << " is truncated";
+            }
+            m_streams.emplace(path, std::move(stream));
+        }
+    }
+}
+
+const ZVIStreamIndex::Stream* ZVIStreamIndex::findStream(const std::string& path) const {
+    auto it = m_streams.find(path);
+    return it == m_streams.end() ? nullptr : &it->second;
+}
+
+FILE* ZVIStreamIndex::getFileHandle() const {
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    if (!m_file) {
+        m_file.reset(Tools::openFile(m_filePath, "rb"));
+        if (!m_file) {
+            RAISE_RUNTIME_ERROR << "ZVIImageDriver: cannot open file " << m_filePath;
+        }
+    }
+    return m_file.get();
+}
+
+void ZVIStreamIndex::close() {
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    m_file.reset();
+}
+
+size_t ZVIStreamIndex::read(const Stream& stream, uint64_t pos, void* buffer, size_t size) const {
+    if (m_filePath.empty() || pos >= stream.size) {
+        return 0;
+    }
+    FILE* file = getFileHandle();
+    size = static_cast<size_t>(std::min<uint64_t>(size, stream.size - pos));
+    uint8_t* dest = static_cast<uint8_t*>(buffer);
+    auto it = std::upper_bound(stream.extents.begin(), stream.extents.end(), pos,
+        [](uint64_t value, const Extent& extent) {
+            return value < extent.streamOffset;
+        });
+    --it;
+    size_t total = 0;
+    for (; total < size && it != stream.extents.end(); ++it) {
+        const uint64_t offset = pos + total - it->streamOffset;
+        const size_t chunk = static_cast<size_t>(std::min<uint64_t>(size - total, it->size - offset));
+        const size_t bytes = Tools::readFileAt(file, it->fileOffset + offset, dest + total, chunk);
+        total += bytes;
+        if (bytes != chunk) {
+            break;
+        }
+    }
+    return total;
+}
+
+std::vector<uint32_t> ZVIStreamIndex::readChain(uint32_t start, const std::vector<uint32_t>& table) const {
+    std::vector<uint32_t> chain;
+    for (uint32_t sector = start; sector <= MAXREGSECT; sector = table[sector]) {
+        // a chain longer than the table has a loop
+        if (sector >= table.size() || chain.size() >= table.size()) {
+            RAISE_RUNTIME_ERROR << "ZVIImageDriver: corrupted sector chain in " << m_filePath;
+        }
+        chain.push_back(sector);
+    }
+    return chain;
+}
+
+void ZVIStreamIndex::readSectors(const std::vector<uint32_t>& chain, std::vector<uint8_t>& data) const {
+    const size_t sectorSize = static_cast<size_t>(1) << m_sectorShift;
+    data.resize(chain.size() * sectorSize);
+    for (size_t index = 0; index < chain.size(); ++index) {
+        if (Tools::readFileAt(m_file.get(), sectorOffset(chain[index]), data.data() + index * sectorSize, sectorSize)
+            != sectorSize) {
+            RAISE_RUNTIME_ERROR << "ZVIImageDriver: cannot read sector " << chain[index] << " of " << m_filePath;
+        }
+    }
+}
+
+void ZVIStreamIndex::appendExtent(Stream& stream, uint64_t fileOffset, uint64_t size) const {
+    if (!stream.extents.empty()) {
+        Extent& last = stream.extents.back();
+        if (last.fileOffset + last.size == fileOffset) {
+            last.size += size;
+            stream.size += size;
+            return;
+        }
+    }
+    Extent extent;
+    extent.streamOffset = stream.size;
+    extent.fileOffset = fileOffset;
+    extent.size = size;
+    stream.extents.push_back(extent);
+    stream.size += size;
+}
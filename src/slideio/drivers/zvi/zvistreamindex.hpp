@@ -0,0 +1,73 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+#include "slideio/drivers/zvi/zvi_api_def.hpp"
+#include "slideio/core/tools/tools.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#pragma warning( push )
+#pragma warning(disable: 4251)
+#endif
+
+namespace slideio
+{
+    // Locations of all streams of an OLE compound document. The FAT, miniFAT and
+    // directory are walked once when the index is opened; every stream is then a list
+    // of contiguous file extents, and its data is read with positional reads that
+    // need neither the compound document nor a lock.
+    class SLIDEIO_ZVI_EXPORTS ZVIStreamIndex
+    {
+    public:
+        struct Extent {
+            uint64_t streamOffset = 0;  // Position of the extent in the stream
+            uint64_t fileOffset = 0;    // Position of the extent in the file
+            uint64_t size = 0;
+        };
+        struct Stream {
+            uint64_t size = 0;
+            std::vector<Extent> extents;
+        };
+    public:
+        ZVIStreamIndex() = default;
+        ZVIStreamIndex(const ZVIStreamIndex&) = delete;
+        ZVIStreamIndex& operator=(const ZVIStreamIndex&) = delete;
+        void open(const std::string& filePath);
+        // Stream by its path in the document, e.g. "/Image/Item(0)/Contents".
+        // Returns nullptr if there is no such stream.
+        const Stream* findStream(const std::string& path) const;
+        // Reads up to size bytes from position pos of the stream. Thread-safe.
+        // Reopens the file if it was closed. Returns the number of bytes read.
+        size_t read(const Stream& stream, uint64_t pos, void* buffer, size_t size) const;
+        // Closes the file; the index is kept. Must not be called during a read.
+        void close();
+        int getNumStreams() const {
+            return static_cast<int>(m_streams.size());
+        }
+    private:
+        FILE* getFileHandle() const;
+        std::vector<uint32_t> readChain(uint32_t start, const std::vector<uint32_t>& table) const;
+        void readSectors(const std::vector<uint32_t>& chain, std::vector<uint8_t>& data) const;
+        void appendExtent(Stream& stream, uint64_t fileOffset, uint64_t size) const;
+        uint64_t sectorOffset(uint32_t sector) const {
+            return (static_cast<uint64_t>(sector) + 1) << m_sectorShift;
+        }
+    private:
+        std::string m_filePath;
+        mutable std::unique_ptr<FILE, Tools::FileDeleter> m_file;
+        mutable std::mutex m_fileMutex;
+        uint32_t m_sectorShift = 9;
+        uint32_t m_miniSectorShift = 6;
+        std::map<std::string, Stream> m_streams;
+    };
+}
+
+#if defined(_MSC_VER)
+#pragma warning( pop )
+#endif
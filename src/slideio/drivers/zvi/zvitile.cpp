@@ -2,8 +2,11 @@
 // It is subject to the license terms in the LICENSE file found in the top-level directory
 // of this distribution and at http://slideio.com/license.html.
 #include "slideio/base/exceptions.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
 #include "zvitile.hpp"
 #include "zviimageitem.hpp"
+#include "zvistreamindex.hpp"
+#include <opencv2/core/utility.hpp>
 
 using namespace slideio;
 
@@ -64,32 +67,45 @@ const ZVIImageItem* ZVITile::getImageItem(int slice, const int channelIndex) con
 }
 
 bool ZVITile::readTile(const std::vector<int>& componentIndices,
-                       cv::OutputArray tileRaster, int slice, ole::compound_document& doc) const
+                       cv::OutputArray tileRaster, int slice, const ZVIStreamIndex& index) const
 {
     bool ok = false;
 
-    std::vector<cv::Mat> channelRasters;
-
-    for (auto index = 0; index < componentIndices.size(); ++index)
+    std::vector<const ZVIImageItem*> items;
+    for (const int channelIndex : componentIndices)
     {
-        const int channelIndex = componentIndices[index];
         const ZVIImageItem* item = getImageItem(slice, channelIndex);
         if(!item) {
             RAISE_RUNTIME_ERROR << "ZVIImageDriver: Cannot find image item for channel " << channelIndex << " and slice " << slice;
         }
+        items.push_back(item);
+    }
+
+    std::vector<cv::Mat> channelRasters(componentIndices.size());
+    auto readChannel = [&](size_t channel)
+    {
         cv::Mat itemRaster;
-        item->readRaster(doc, itemRaster);
+        items[channel]->readRaster(index, itemRaster);
         if (itemRaster.channels() == 1)
         {
-            channelRasters.push_back(itemRaster);
+            channelRasters[channel] = itemRaster;
         }
         else
         {
-            cv::Mat channelRaster;
-            cv::extractChannel(itemRaster, channelRaster, channelIndex);
-            channelRasters.push_back(channelRaster);
+            cv::extractChannel(itemRaster, channelRasters[channel], componentIndices[channel]);
         }
-    }
+    };
+    // channels are separate streams: they are read and decoded on the OpenCV pool
+    const ReadStatisticsTargets statisticsTargets = ReadStatisticsScope::current();
+    cv::parallel_for_(cv::Range(0, static_cast<int>(items.size())), [&](const cv::Range& range)
+    {
+        ReadStatisticsScope statisticsScope;
+        statisticsScope.activate(statisticsTargets);
+        for (int channel = range.start; channel < range.end; ++channel)
+        {
+            readChannel(channel);
+        }
+    });
 
     ok = true;
     if (channelRasters.size()==1) {
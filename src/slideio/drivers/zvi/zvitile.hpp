@@ -4,13 +4,10 @@
 #pragma once
 #include <opencv2/core.hpp>
 
-namespace ole {
-    class compound_document;
-}
-
 namespace slideio
 {
     class ZVIImageItem;
+    class ZVIStreamIndex;
     class ZVITile
     {
     public:
@@ -23,7 +20,7 @@ namespace slideio
         void finalize();
         void setTilePosition(int x, int y);
         bool readTile(const std::vector<int>& componentIndices,
-            cv::OutputArray tile_raster, int slice, ole::compound_document& doc) const;
+            cv::OutputArray tile_raster, int slice, const ZVIStreamIndex& index) const;
     protected:
         const ZVIImageItem* getImageItem(int slice, int channelIndex) const;
     private:
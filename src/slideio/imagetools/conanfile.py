@@ -6,11 +6,13 @@ class ImageToolsRecipe(ConanFile):
         self.requires("glog/0.7.1")
         self.requires("opencv/4.10.0@slideio/stable")
         self.requires("zlib/1.3.1")
+        self.requires("zstd/1.5.5")
         self.requires("libtiff/4.6.0")
         self.requires("libjpeg/9f", force=True)
         self.requires("libwebp/1.3.2")
         self.requires("libpng/1.6.53")
         self.requires("openjpeg/2.5.2")
+        self.requires("openjph/0.16.0")
         self.requires("jpegxrcodec/1.0.3@slideio/stable")
         self.requires("freeimage/3.18.0")
         self.requires("jxrlib/cci.20260102", force=True) 
\ No newline at end of file
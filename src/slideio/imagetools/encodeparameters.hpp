@@ -42,6 +42,8 @@ namespace slideio {
             m_subSamplingDY = 1;
             m_codecFormat = codec;
             m_compressionRate = rate;
+            m_highThroughput = false;
+            m_quantizationStep = 0.f;
         }
         int getSubSamplingDx() const {
             return m_subSamplingDX;
@@ -67,10 +69,97 @@ namespace slideio {
         void setCompressionRate(float compressionRate) {
             m_compressionRate = compressionRate;
         }
+        // High-throughput (Part 15) block coding. The compression rate is not used
+        // in this mode: the quantization step controls the loss instead.
+        bool getHighThroughput() const {
+            return m_highThroughput;
+        }
+        void setHighThroughput(bool highThroughput) {
+            m_highThroughput = highThroughput;
+        }
+        // Base quantization step for irreversible HTJ2K coding; 0 selects the
+        // reversible (lossless) wavelet.
+        float getQuantizationStep() const {
+            return m_quantizationStep;
+        }
+        void setQuantizationStep(float quantizationStep) {
+            m_quantizationStep = quantizationStep;
+        }
     private:
         int m_subSamplingDX;
         int m_subSamplingDY;
         Codec m_codecFormat;
         float m_compressionRate;
+        bool m_highThroughput;
+        float m_quantizationStep;
+    };
+    // TIFF predictor applied before lossless compression. Auto selects horizontal
+    // differencing for integer data and the floating point predictor for float data.
+    enum class TiffPredictor {
+        Auto = 0,
+        None = 1,
+        Horizontal = 2,
+        FloatingPoint = 3
+    };
+    class LosslessEncodeParameters : public EncodeParameters {
+    protected:
+        LosslessEncodeParameters(Compression compression, int level, TiffPredictor predictor) {
+            m_compression = compression;
+            m_level = level;
+            m_predictor = predictor;
+        }
+    public:
+        int getLevel() const {
+            return m_level;
+        }
+        void setLevel(int level) {
+            m_level = level;
+        }
+        TiffPredictor getPredictor() const {
+            return m_predictor;
+        }
+        void setPredictor(TiffPredictor predictor) {
+            m_predictor = predictor;
+        }
+        TiffPredictor resolvePredictor(DataType dataType) const {
+            if (m_predictor != TiffPredictor::Auto) {
+                return m_predictor;
+            }
+            switch (dataType) {
+            case DataType::DT_Float16:
+            case DataType::DT_Float32:
+            case DataType::DT_Float64:
+                return TiffPredictor::FloatingPoint;
+            default:
+                return TiffPredictor::Horizontal;
+            }
+        }
+        static bool isLosslessCompression(Compression compression) {
+            return compression == Compression::Zstd
+                || compression == Compression::Zlib
+                || compression == Compression::LZW;
+        }
+    private:
+        int m_level;
+        TiffPredictor m_predictor;
+    };
+    class ZstdEncodeParameters : public LosslessEncodeParameters {
+    public:
+        ZstdEncodeParameters(int level = 9, TiffPredictor predictor = TiffPredictor::Auto)
+            : LosslessEncodeParameters(Compression::Zstd, level, predictor) {
+        }
+    };
+    class DeflateEncodeParameters : public LosslessEncodeParameters {
+    public:
+        DeflateEncodeParameters(int level = 6, TiffPredictor predictor = TiffPredictor::Auto)
+            : LosslessEncodeParameters(Compression::Zlib, level, predictor) {
+        }
+    };
+    class LZWEncodeParameters : public LosslessEncodeParameters {
+    public:
+        // LZW has no compression level; the value is kept for a uniform interface.
+        LZWEncodeParameters(TiffPredictor predictor = TiffPredictor::Auto)
+            : LosslessEncodeParameters(Compression::LZW, 0, predictor) {
+        }
     };
 }
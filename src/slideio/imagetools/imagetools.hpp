@@ -31,10 +31,15 @@ namespace slideio
         static void writeSmallImageRaster(const std::string& path, Compression compression, cv::Mat raster);
         static void readJxrImage(const std::string& path, cv::OutputArray output);
         static void decodeJxrBlock(const uint8_t* data, size_t size, cv::OutputArray output);
-        static void decodeJpegStream(const uint8_t* data, size_t size, cv::OutputArray output);
+        // luminance: decodes a color stream into a single channel with the luminance,
+        // skipping the chroma of YCbCr streams.
+        static void decodeJpegStream(const uint8_t* data, size_t size, cv::OutputArray output, bool luminance = false);
         static void encodeJpeg(const cv::Mat& raster, std::vector<uint8_t>& encodedStream, const JpegEncodeParameters& params);
         static void encodeJpegAbbreviated(const cv::Mat& raster, std::vector<uint8_t>& encodedStream, const JpegEncodeParameters& params);
         static void computeJpegTables(int numChannels, int quality, std::vector<uint8_t>& tablesBlob);
+        // Encodes a raster as a TIFF tile body: the TIFF predictor of the parameters is applied
+        // to a copy of the data, which is then compressed with Zstd, Deflate or LZW.
+        static void encodeLossless(const cv::Mat& raster, std::vector<uint8_t>& encodedStream, const LosslessEncodeParameters& params);
         // jpeg 2000 related methods
         static void readJp2KFile(const std::string& path, cv::OutputArray output);
 		static void readBitmap(const std::string& path, cv::OutputArray output);
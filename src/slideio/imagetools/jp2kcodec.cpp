@@ -6,12 +6,19 @@
 #include "slideio/imagetools/memory_stream.hpp"
 #include "slideio/base/exceptions.hpp"
 #include "slideio/base/log.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
 #include "jp2kcodec.hpp"
 
 #include <openjpeg.h>
+#include <openjph/ojph_codestream.h>
+#include <openjph/ojph_file.h>
+#include <openjph/ojph_mem.h>
+#include <openjph/ojph_params.h>
 #include <fstream>
 #include <filesystem>
 #include <iterator>
+#include <algorithm>
+#include <cstring>
 #include "single_tests/jp2k/jp2_memory.hpp"
 
 /* opj_* Helper code from https://groups.google.com/forum/#!topic/openjpeg/8cebr0u7JgY */
@@ -104,6 +111,7 @@ void slideio::ImageTools::decodeJp2KStream(
 
 void slideio::ImageTools::decodeJp2KStream(const uint8_t* data, size_t dataSize, cv::OutputArray output,
     const std::vector<int>& channelIndices, bool forceYUV) {
+    ReadStageTimer timer(ReadStage::Decode);
     opj_codec_t* codec(nullptr);
     opj_image_t* image(nullptr);
     opj_stream_t* stream(nullptr);
@@ -344,9 +352,107 @@ void rasterToOPJImage(const cv::Mat& mat, ImagePtr& image, const slideio::JP2KEn
     }
 }
 
+template <typename T>
+static void copyHTJ2KLine(const cv::Mat& mat, int row, int channel, ojph::line_buf* line)
+{
+    const int numChannels = mat.channels();
+    const T* src = mat.ptr<T>(row) + channel;
+    ojph::si32* dst = line->i32;
+    for (int x = 0; x < mat.cols; ++x, src += numChannels) {
+        dst[x] = static_cast<ojph::si32>(*src);
+    }
+}
+
+// OpenJPEG decodes HTJ2K codestreams but cannot produce them, so the high-throughput
+// encoding goes through OpenJPH.
+static int encodeHTJ2KStream(const cv::Mat& mat, uint8_t* buffer, int bufferSize,
+    const slideio::JP2KEncodeParameters& jp2Params)
+{
+    if (jp2Params.getCodecFormat() != slideio::JP2KEncodeParameters::Codec::J2KStream) {
+        RAISE_RUNTIME_ERROR << "HTJ2K encoding supports only raw codestreams.";
+    }
+    if (jp2Params.getSubSamplingDx() != 1 || jp2Params.getSubSamplingDy() != 1) {
+        RAISE_RUNTIME_ERROR << "HTJ2K encoding does not support component subsampling.";
+    }
+    const int depth = mat.depth();
+    if (depth != CV_8U && depth != CV_8S && depth != CV_16U && depth != CV_16S) {
+        RAISE_RUNTIME_ERROR << "Unsupported type for HTJ2K encoding: " << depth;
+    }
+    const int numChannels = mat.channels();
+    const int width = mat.cols;
+    const int height = mat.rows;
+    const bool isSigned = depth == CV_8S || depth == CV_16S;
+    const int bitDepth = static_cast<int>(8 * mat.elemSize1());
+    const bool reversible = jp2Params.getQuantizationStep() <= 0.f;
+
+    ojph::codestream codestream;
+    ojph::param_siz siz = codestream.access_siz();
+    siz.set_image_extent(ojph::point(width, height));
+    siz.set_num_components(numChannels);
+    for (int channel = 0; channel < numChannels; ++channel) {
+        siz.set_component(channel, ojph::point(1, 1), bitDepth, isSigned);
+    }
+    siz.set_image_offset(ojph::point(0, 0));
+    siz.set_tile_size(ojph::size(width, height));
+    siz.set_tile_offset(ojph::point(0, 0));
+
+    int numDecompositions = 5;
+    while (numDecompositions > 0 && (std::min(width, height) >> numDecompositions) == 0) {
+        --numDecompositions;
+    }
+    ojph::param_cod cod = codestream.access_cod();
+    cod.set_num_decomposition(numDecompositions);
+    cod.set_block_dims(64, 64);
+    cod.set_progression_order("RPCL");
+    cod.set_color_transform(numChannels == 3);
+    cod.set_reversible(reversible);
+    if (!reversible) {
+        codestream.access_qcd().set_irrev_quant(jp2Params.getQuantizationStep());
+    }
+    codestream.set_planar(false);
+
+    ojph::mem_outfile output;
+    output.open();
+    codestream.write_headers(&output);
+    ojph::ui32 channel = 0;
+    ojph::line_buf* line = codestream.exchange(nullptr, channel);
+    for (int row = 0; row < height; ++row) {
+        for (int component = 0; component < numChannels; ++component) {
+            switch (depth) {
+            case CV_8U:
+                copyHTJ2KLine<uint8_t>(mat, row, static_cast<int>(channel), line);
+                break;
+            case CV_8S:
+                copyHTJ2KLine<int8_t>(mat, row, static_cast<int>(channel), line);
+                break;
+            case CV_16U:
+                copyHTJ2KLine<uint16_t>(mat, row, static_cast<int>(channel), line);
+                break;
+            case CV_16S:
+                copyHTJ2KLine<int16_t>(mat, row, static_cast<int>(channel), line);
+                break;
+            }
+            line = codestream.exchange(line, channel);
+        }
+    }
+    codestream.flush();
+    const int64_t encodedSize = output.tell();
+    if (encodedSize > bufferSize) {
+        codestream.close();
+        RAISE_RUNTIME_ERROR << "HTJ2K encoding: output buffer is too small. Required: "
+            << encodedSize << ", available: " << bufferSize;
+    }
+    std::memcpy(buffer, output.get_data(), static_cast<size_t>(encodedSize));
+    codestream.close();
+    return static_cast<int>(encodedSize);
+}
+
 int slideio::ImageTools::encodeJp2KStream(const cv::Mat& mat, uint8_t* buffer, int bufferSize,
     const JP2KEncodeParameters& jp2Params)
 {
+    if (jp2Params.getHighThroughput()) {
+        return encodeHTJ2KStream(mat, buffer, bufferSize, jp2Params);
+    }
     wopj_cparameters parameters;   /* compression parameters */
     ImagePtr image;
 
@@ -5,12 +5,17 @@
 #include "slideio/imagetools/imagetools.hpp"
 #include "slideio/base/exceptions.hpp"
 #include "slideio/imagetools/jpeglib_aux.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
 
 
-void slideio::ImageTools::decodeJpegStream(const uint8_t* jpg_buffer, size_t jpg_size, cv::OutputArray output)
+void slideio::ImageTools::decodeJpegStream(const uint8_t* jpg_buffer, size_t jpg_size, cv::OutputArray output,
+                                           bool luminance)
 {
+    ReadStageTimer timer(ReadStage::Decode);
     try {
-        jpeglibDecode(jpg_buffer, jpg_size, output);
+        JpegDecodeOptions options;
+        options.luminance = luminance;
+        jpeglibDecode(jpg_buffer, jpg_size, output, options);
     }
     catch(std::runtime_error& er) {
         RAISE_RUNTIME_ERROR << "Error decoding jpeg stream: " << er.what();
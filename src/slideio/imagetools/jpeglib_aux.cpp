@@ -1,161 +1,152 @@
 #include "slideio/base/exceptions.hpp"
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <setjmp.h>
 #include <stdio.h>
 #include <jpeglib.h>
 #include <opencv2/core.hpp>
 
-void jpeglibDecode(const uint8_t* jpg_buffer, size_t jpg_size, cv::OutputArray output)
-{
-    // code derived from: https://gist.github.com/PhirePhly/3080633
-    struct jpeg_decompress_struct cinfo {};
-    struct jpeg_error_mgr jerr {};
-
-    cinfo.err = jpeg_std_error(&jerr);
-    // Allocate a new decompress struct, with the default error handler.
-    // The default error handler will exit() on pretty much any issue,
-    // so it's likely you'll want to replace it or supplement it with
-    // your own.
-    jpeg_create_decompress(&cinfo);
-    jpeg_mem_src(&cinfo, jpg_buffer, static_cast<unsigned long>(jpg_size));
-    // Have the decompressor scan the jpeg header. This won't populate
-    // the cinfo struct output fields, but will indicate if the
-    // jpeg is valid.
-    auto rc = jpeg_read_header(&cinfo, TRUE);
-
-    if (rc != 1) {
-        jpeg_destroy_decompress(&cinfo);
-        RAISE_RUNTIME_ERROR << "Invalid jpeg stream. JpegLib returns code: " << rc;
-    }
-
-    // By calling jpeg_start_decompress, you populate cinfo
-    // and can then allocate your output bitmap buffers for
-    // each scanline.
-    jpeg_start_decompress(&cinfo);
-
-    const JDIMENSION width = cinfo.output_width;
-    const JDIMENSION height = cinfo.output_height;
-    const int channels = cinfo.output_components;
+namespace {
+    // Every thread keeps one compressor and one decompressor for its whole lifetime.
+    // Creating and destroying the libjpeg objects, their error managers and output
+    // buffers for every tile is a noticeable part of the per-tile cost, so they are
+    // reset between tiles instead. libjpeg errors return through longjmp: all the
+    // functions that call into libjpeg under setjmp keep trivially destructible locals
+    // only, and the error is raised as an exception after the call returns.
 
-    const size_t bmpSize = width * height * channels;
+    struct JpegErrorManager
+    {
+        jpeg_error_mgr pub;
+        jmp_buf setjmpBuffer;
+        char message[JMSG_LENGTH_MAX];
+    };
 
-    output.create(height, width, CV_MAKETYPE(CV_8U, channels));
-    cv::Mat mat = output.getMat();
+    void jpegErrorExit(j_common_ptr cinfo) {
+        JpegErrorManager* manager = reinterpret_cast<JpegErrorManager*>(cinfo->err);
+        (*cinfo->err->format_message)(cinfo, manager->message);
+        longjmp(manager->setjmpBuffer, 1);
+    }
 
-    // The row_stride is the total number of bytes it takes to store an
-    // entire scanline (row). 
-    const unsigned int rowStride = width * channels;
-
-    // Now that you have the decompressor entirely configured, it's time
-    // to read out all of the scanlines of the jpeg.
-    //
-    // By default, scanlines will come out in RGBRGBRGB...  order, 
-    // but this can be changed by setting cinfo.out_color_space
-    //
-    // jpeg_read_scanlines takes an array of buffers, one for each scanline.
-    // Even if you give it a complete set of buffers for the whole image,
-    // it will only ever decompress a few lines at a time. For best 
-    // performance, you should pass it an array with cinfo.rec_outbuf_height
-    // scanline buffers. rec_outbuf_height is typically 1, 2, or 4, and 
-    // at the default high quality decompression setting is always 1.
-    while (cinfo.output_scanline < cinfo.output_height)
+    // Destination manager that writes into a vector owned by the thread context. The
+    // vector keeps the size reached by previous tiles, so it rarely has to grow.
+    struct JpegVectorDestination
     {
-        unsigned char* bufferArray[1];
-        bufferArray[0] = mat.data +
-            (cinfo.output_scanline) * rowStride;
-
-        jpeg_read_scanlines(&cinfo, bufferArray, 1);
-    }
-    // Once done reading *all* scanlines, release all internal buffers,
-    // etc by calling jpeg_finish_decompress. This lets you go back and
-    // reuse the same cinfo object with the same settings, if you
-    // want to decompress several jpegs in a row.
-    //
-    // If you didn't read all the scanlines, but want to stop early,
-    // you instead need to call jpeg_abort_decompress(&cinfo)
-    jpeg_finish_decompress(&cinfo);
-
-    // At this point, optionally go back and either load a new jpg into
-    // the jpg_buffer, or define a new jpeg_mem_src, and then start 
-    // another decompress operation.
-
-    // Once you're really really done, destroy the object to free everything
-    jpeg_destroy_decompress(&cinfo);
-}
+        jpeg_destination_mgr pub;
+        std::vector<uint8_t>* buffer;
+        size_t length;
+    };
 
-void jpeglibEncode(const cv::Mat& raster, std::vector<uint8_t>& encodedStream, int quality)
-{
-    if (!raster.isContinuous()) {
-        RAISE_RUNTIME_ERROR << "Expected continuous matrix!";
+    const size_t MIN_OUTPUT_BUFFER_SIZE = 64 * 1024;
+
+    void initVectorDestination(j_compress_ptr cinfo) {
+        JpegVectorDestination* dest = reinterpret_cast<JpegVectorDestination*>(cinfo->dest);
+        dest->pub.next_output_byte = dest->buffer->data();
+        dest->pub.free_in_buffer = dest->buffer->size();
+        dest->length = 0;
     }
-    if (raster.dims != 2) {
-        RAISE_RUNTIME_ERROR << "Expected 2D matrix!";
+
+    boolean emptyVectorDestination(j_compress_ptr cinfo) {
+        // libjpeg calls this when the whole buffer is full
+        JpegVectorDestination* dest = reinterpret_cast<JpegVectorDestination*>(cinfo->dest);
+        const size_t used = dest->buffer->size();
+        dest->buffer->resize(used * 2);
+        dest->pub.next_output_byte = dest->buffer->data() + used;
+        dest->pub.free_in_buffer = dest->buffer->size() - used;
+        return TRUE;
     }
-    if (raster.depth() != CV_8U) {
-        RAISE_RUNTIME_ERROR << "Expected 8bit matrix!";
+
+    void termVectorDestination(j_compress_ptr cinfo) {
+        JpegVectorDestination* dest = reinterpret_cast<JpegVectorDestination*>(cinfo->dest);
+        dest->length = dest->buffer->size() - dest->pub.free_in_buffer;
     }
-    const int imageWidth = raster.cols;
-    const int imageHeight = raster.rows;
-    const int numChannels = raster.channels();
-    if (numChannels != 1 && numChannels != 3) {
-        RAISE_RUNTIME_ERROR << "Only 3 or 1 channel images are supported!";
+
+    enum class JpegEncodeMode
+    {
+        None,
+        Full,
+        Abbreviated
+    };
+
+    struct JpegEncoderContext
+    {
+        jpeg_compress_struct cinfo;
+        JpegErrorManager error;
+        JpegVectorDestination destination;
+        std::vector<uint8_t> output;
+        // parameters the quantization and Huffman tables were prepared for
+        JpegEncodeMode mode = JpegEncodeMode::None;
+        int numChannels = 0;
+        int quality = 0;
+
+        JpegEncoderContext() {
+            std::memset(&cinfo, 0, sizeof(cinfo));
+            std::memset(&error, 0, sizeof(error));
+            cinfo.err = jpeg_std_error(&error.pub);
+            jpeg_create_compress(&cinfo);
+            error.pub.error_exit = jpegErrorExit;
+            destination.pub.init_destination = initVectorDestination;
+            destination.pub.empty_output_buffer = emptyVectorDestination;
+            destination.pub.term_destination = termVectorDestination;
+            destination.buffer = &output;
+            destination.length = 0;
+            cinfo.dest = &destination.pub;
+        }
+        ~JpegEncoderContext() {
+            // the destination manager is not allocated by libjpeg
+            cinfo.dest = nullptr;
+            jpeg_destroy_compress(&cinfo);
+        }
+        JpegEncoderContext(const JpegEncoderContext&) = delete;
+        JpegEncoderContext& operator=(const JpegEncoderContext&) = delete;
+    };
+
+    struct JpegDecoderContext
+    {
+        jpeg_decompress_struct cinfo;
+        JpegErrorManager error;
+
+        JpegDecoderContext() {
+            std::memset(&cinfo, 0, sizeof(cinfo));
+            std::memset(&error, 0, sizeof(error));
+            cinfo.err = jpeg_std_error(&error.pub);
+            jpeg_create_decompress(&cinfo);
+            error.pub.error_exit = jpegErrorExit;
+        }
+        ~JpegDecoderContext() {
+            jpeg_destroy_decompress(&cinfo);
+        }
+        JpegDecoderContext(const JpegDecoderContext&) = delete;
+        JpegDecoderContext& operator=(const JpegDecoderContext&) = delete;
+    };
+
+    JpegEncoderContext& threadEncoderContext() {
+        thread_local JpegEncoderContext context;
+        return context;
     }
-    struct jpeg_compress_struct cinfo;
-    struct jpeg_error_mgr jerr;
-    JSAMPROW row_pointer[1];
-    int row_stride = imageWidth * numChannels;
-    cinfo.err = jpeg_std_error(&jerr);
-    jpeg_create_compress(&cinfo);
-    cinfo.image_width = imageWidth;
-    cinfo.image_height = imageHeight;
-    cinfo.input_components = numChannels;
-    cinfo.in_color_space = JCS_RGB;
-    if (numChannels == 1) {
-        cinfo.in_color_space = JCS_GRAYSCALE;
-    }
-    jpeg_set_defaults(&cinfo);
-    jpeg_set_quality(&cinfo, quality, TRUE);
-    size_t length = 0;
-    uint8_t* output = nullptr;
-    jpeg_mem_dest(&cinfo, &output, &length);
-    for(int channel=0; channel<numChannels; ++channel) {
-        cinfo.comp_info[channel].h_samp_factor = 1;
-        cinfo.comp_info[channel].v_samp_factor = 1;
-    }
-    jpeg_start_compress(&cinfo, TRUE);
-    uint8_t* row(raster.data);
-    bool success(true);
-    while (cinfo.next_scanline < cinfo.image_height) {
-        row_pointer[0] = row;
-        if (jpeg_write_scanlines(&cinfo, row_pointer, 1) == 0) {
-            success = false;
-            break;
-        }
-        row += row_stride;
-    }
-    jpeg_finish_compress(&cinfo);
-    jpeg_destroy_compress(&cinfo);
-    if (success) {
-        encodedStream.resize(length);
-        memcpy(encodedStream.data(), output, length);
-    }
-    else {
-        RAISE_RUNTIME_ERROR << "Error during compressing of raster with libjpeg!";
+
+    JpegDecoderContext& threadDecoderContext() {
+        thread_local JpegDecoderContext context;
+        return context;
     }
-}
 
-namespace {
-    // Configures a libjpeg compress struct so that the encoded stream's color
-    // space matches what libtiff expects for COMPRESSION_JPEG with PHOTOMETRIC_RGB
-    // (3-channel) or PHOTOMETRIC_MINISBLACK (1-channel): no YCbCr conversion,
-    // 1:1 sampling. The resulting quantization and Huffman tables are
-    // deterministic for a given (numChannels, quality), so a JPEGTABLES blob
-    // produced with these settings is compatible with abbreviated tile streams
-    // produced with the same settings.
-    void setupAbbreviatedCompressParams(jpeg_compress_struct& cinfo, int numChannels, int quality) {
+    // Configures the compressor for a stream mode. Full streams use the libjpeg defaults
+    // (YCbCr for color input). Abbreviated streams match what libtiff expects for
+    // COMPRESSION_JPEG with PHOTOMETRIC_RGB (3-channel) or PHOTOMETRIC_MINISBLACK
+    // (1-channel): no YCbCr conversion, 1:1 sampling. The resulting quantization and
+    // Huffman tables are deterministic for a given (numChannels, quality), so a
+    // JPEGTABLES blob produced with these settings is compatible with abbreviated tile
+    // streams produced with the same settings. The tables survive between tiles and
+    // are rebuilt only when the mode, channel count or quality changes.
+    void prepareCompressParams(JpegEncoderContext& context, JpegEncodeMode mode, int numChannels, int quality) {
+        if (context.mode == mode && context.numChannels == numChannels && context.quality == quality) {
+            return;
+        }
+        jpeg_compress_struct& cinfo = context.cinfo;
         cinfo.input_components = numChannels;
         cinfo.in_color_space = (numChannels == 1) ? JCS_GRAYSCALE : JCS_RGB;
         jpeg_set_defaults(&cinfo);
-        if (numChannels == 3) {
+        if (mode == JpegEncodeMode::Abbreviated && numChannels == 3) {
             // Default for 3-channel input is JCS_YCbCr; force RGB to match
             // libtiff's PHOTOMETRIC_RGB + COMPRESSION_JPEG color path.
             jpeg_set_colorspace(&cinfo, JCS_RGB);
@@ -165,6 +156,186 @@ namespace {
             cinfo.comp_info[channel].h_samp_factor = 1;
             cinfo.comp_info[channel].v_samp_factor = 1;
         }
+        context.mode = mode;
+        context.numChannels = numChannels;
+        context.quality = quality;
+    }
+
+    void resetEncoderContext(JpegEncoderContext& context) {
+        jpeg_abort_compress(&context.cinfo);
+        context.mode = JpegEncodeMode::None;
+    }
+
+    void prepareOutputBuffer(JpegEncoderContext& context, size_t rasterSize) {
+        const size_t expectedSize = std::max(MIN_OUTPUT_BUFFER_SIZE, rasterSize / 4);
+        if (context.output.size() < expectedSize) {
+            context.output.resize(expectedSize);
+        }
+    }
+
+    // Runs the whole compression; returns false if libjpeg signaled an error.
+    bool compressScanlines(JpegEncoderContext& context, JpegEncodeMode mode, const uint8_t* data,
+                           int width, int height, int numChannels, int quality) {
+        jpeg_compress_struct& cinfo = context.cinfo;
+        if (setjmp(context.error.setjmpBuffer)) {
+            return false;
+        }
+        cinfo.image_width = static_cast<JDIMENSION>(width);
+        cinfo.image_height = static_cast<JDIMENSION>(height);
+        prepareCompressParams(context, mode, numChannels, quality);
+        const bool abbreviated = mode == JpegEncodeMode::Abbreviated;
+        if (abbreviated) {
+            // Suppress per-tile DQT/DHT — tables are carried by TIFF JPEGTABLES tag.
+            jpeg_suppress_tables(&cinfo, TRUE);
+        }
+        jpeg_start_compress(&cinfo, abbreviated ? FALSE : TRUE);
+        const size_t rowStride = static_cast<size_t>(width) * numChannels;
+        JSAMPROW rowPointer[1];
+        while (cinfo.next_scanline < cinfo.image_height) {
+            rowPointer[0] = const_cast<uint8_t*>(data) + cinfo.next_scanline * rowStride;
+            if (jpeg_write_scanlines(&cinfo, rowPointer, 1) == 0) {
+                std::strncpy(context.error.message, "Cannot write scanline", JMSG_LENGTH_MAX - 1);
+                jpeg_abort_compress(&cinfo);
+                return false;
+            }
+        }
+        jpeg_finish_compress(&cinfo);
+        return true;
+    }
+
+    void encodeRaster(const cv::Mat& raster, std::vector<uint8_t>& encodedStream, int quality, JpegEncodeMode mode) {
+        if (!raster.isContinuous()) {
+            RAISE_RUNTIME_ERROR << "Expected continuous matrix!";
+        }
+        if (raster.dims != 2) {
+            RAISE_RUNTIME_ERROR << "Expected 2D matrix!";
+        }
+        if (raster.depth() != CV_8U) {
+            RAISE_RUNTIME_ERROR << "Expected 8bit matrix!";
+        }
+        const int numChannels = raster.channels();
+        if (numChannels != 1 && numChannels != 3) {
+            RAISE_RUNTIME_ERROR << "Only 3 or 1 channel images are supported!";
+        }
+        JpegEncoderContext& context = threadEncoderContext();
+        prepareOutputBuffer(context, raster.total() * raster.elemSize());
+        if (!compressScanlines(context, mode, raster.data, raster.cols, raster.rows, numChannels, quality)) {
+            resetEncoderContext(context);
+            RAISE_RUNTIME_ERROR << "Error during compressing of raster with libjpeg: " << context.error.message;
+        }
+        encodedStream.assign(context.output.begin(),
+            context.output.begin() + static_cast<std::ptrdiff_t>(context.destination.length));
+    }
+
+    J_COLOR_SPACE toLibjpegColorSpace(JpegColorSpace colorSpace) {
+        switch (colorSpace) {
+        case JpegColorSpace::Gray: return JCS_GRAYSCALE;
+        case JpegColorSpace::RGB: return JCS_RGB;
+        case JpegColorSpace::YCbCr: return JCS_YCbCr;
+        default: return JCS_UNKNOWN;
+        }
+    }
+
+    bool startDecompress(JpegDecoderContext& context, const uint8_t* jpgBuffer, size_t jpgSize,
+                         const JpegDecodeOptions& options, int& headerCode) {
+        jpeg_decompress_struct& cinfo = context.cinfo;
+        if (setjmp(context.error.setjmpBuffer)) {
+            return false;
+        }
+        if (options.tables && options.tablesSize > 0) {
+            // the tables stay in the decompressor for the image stream that follows
+            jpeg_mem_src(&cinfo, const_cast<uint8_t*>(options.tables), static_cast<unsigned long>(options.tablesSize));
+            headerCode = jpeg_read_header(&cinfo, FALSE);
+            if (headerCode != JPEG_HEADER_TABLES_ONLY) {
+                return true;
+            }
+        }
+        jpeg_mem_src(&cinfo, const_cast<uint8_t*>(jpgBuffer), static_cast<unsigned long>(jpgSize));
+        // Have the decompressor scan the jpeg header. This won't populate
+        // the cinfo struct output fields, but will indicate if the
+        // jpeg is valid.
+        headerCode = jpeg_read_header(&cinfo, TRUE);
+        if (headerCode != JPEG_HEADER_OK) {
+            return true;
+        }
+        const J_COLOR_SPACE colorSpace = toLibjpegColorSpace(options.colorSpace);
+        if (colorSpace != JCS_UNKNOWN && cinfo.num_components == (colorSpace == JCS_GRAYSCALE ? 1 : 3)) {
+            cinfo.jpeg_color_space = colorSpace;
+            cinfo.out_color_space = (colorSpace == JCS_GRAYSCALE) ? JCS_GRAYSCALE : JCS_RGB;
+        }
+        if (options.luminance && (cinfo.jpeg_color_space == JCS_YCbCr || cinfo.jpeg_color_space == JCS_RGB
+                                  || cinfo.jpeg_color_space == JCS_GRAYSCALE)) {
+            // libjpeg does not decode components the output does not need
+            cinfo.out_color_space = JCS_GRAYSCALE;
+        }
+        // By calling jpeg_start_decompress, you populate cinfo
+        // and can then allocate your output bitmap buffers for
+        // each scanline.
+        jpeg_start_decompress(&cinfo);
+        return true;
+    }
+
+    bool readScanlines(JpegDecoderContext& context, uint8_t* data, size_t rowStride) {
+        jpeg_decompress_struct& cinfo = context.cinfo;
+        if (setjmp(context.error.setjmpBuffer)) {
+            return false;
+        }
+        // jpeg_read_scanlines takes an array of buffers, one for each scanline.
+        // Even if you give it a complete set of buffers for the whole image,
+        // it will only ever decompress a few lines at a time.
+        while (cinfo.output_scanline < cinfo.output_height) {
+            JSAMPROW rowPointer[1];
+            rowPointer[0] = data + cinfo.output_scanline * rowStride;
+            jpeg_read_scanlines(&cinfo, rowPointer, 1);
+        }
+        // Releases the per-image state and leaves the object ready for the next tile.
+        jpeg_finish_decompress(&cinfo);
+        return true;
+    }
+}
+
+void jpeglibDecode(const uint8_t* jpg_buffer, size_t jpg_size, cv::OutputArray output,
+                   const JpegDecodeOptions& options)
+{
+    JpegDecoderContext& context = threadDecoderContext();
+    int rc = JPEG_HEADER_OK;
+    if (!startDecompress(context, jpg_buffer, jpg_size, options, rc)) {
+        jpeg_abort_decompress(&context.cinfo);
+        RAISE_RUNTIME_ERROR << "Invalid jpeg stream: " << context.error.message;
+    }
+    if (rc != JPEG_HEADER_OK) {
+        jpeg_abort_decompress(&context.cinfo);
+        RAISE_RUNTIME_ERROR << "Invalid jpeg stream. JpegLib returns code: " << rc;
+    }
+    const JDIMENSION width = context.cinfo.output_width;
+    const JDIMENSION height = context.cinfo.output_height;
+    const int channels = context.cinfo.output_components;
+
+    output.create(height, width, CV_MAKETYPE(CV_8U, channels));
+    cv::Mat mat = output.getMat();
+    if (!readScanlines(context, mat.data, static_cast<size_t>(width) * channels)) {
+        jpeg_abort_decompress(&context.cinfo);
+        RAISE_RUNTIME_ERROR << "Error during decompressing of jpeg stream: " << context.error.message;
+    }
+}
+
+void jpeglibEncode(const cv::Mat& raster, std::vector<uint8_t>& encodedStream, int quality)
+{
+    encodeRaster(raster, encodedStream, quality, JpegEncodeMode::Full);
+}
+
+namespace {
+    bool writeTables(JpegEncoderContext& context, int numChannels, int quality) {
+        if (setjmp(context.error.setjmpBuffer)) {
+            return false;
+        }
+        // image_width/height are not used by jpeg_write_tables but must be set
+        // to keep cinfo in a consistent state.
+        context.cinfo.image_width = 16;
+        context.cinfo.image_height = 16;
+        prepareCompressParams(context, JpegEncodeMode::Abbreviated, numChannels, quality);
+        jpeg_write_tables(&context.cinfo);
+        return true;
     }
 }
 
@@ -173,76 +344,20 @@ void jpeglibWriteAbbreviatedTables(int numChannels, int quality, std::vector<uin
     if (numChannels != 1 && numChannels != 3) {
         RAISE_RUNTIME_ERROR << "Only 3 or 1 channel images are supported!";
     }
-    struct jpeg_compress_struct cinfo;
-    struct jpeg_error_mgr jerr;
-    cinfo.err = jpeg_std_error(&jerr);
-    jpeg_create_compress(&cinfo);
-    // image_width/height are not used by jpeg_write_tables but must be set
-    // before jpeg_set_defaults to keep cinfo in a consistent state.
-    cinfo.image_width = 16;
-    cinfo.image_height = 16;
-    setupAbbreviatedCompressParams(cinfo, numChannels, quality);
-    size_t length = 0;
-    uint8_t* output = nullptr;
-    jpeg_mem_dest(&cinfo, &output, &length);
-    jpeg_write_tables(&cinfo);
-    jpeg_destroy_compress(&cinfo);
-    if (output == nullptr || length == 0) {
-        if (output) free(output);
+    JpegEncoderContext& context = threadEncoderContext();
+    prepareOutputBuffer(context, 0);
+    if (!writeTables(context, numChannels, quality)) {
+        resetEncoderContext(context);
+        RAISE_RUNTIME_ERROR << "Failed to produce JPEG tables blob: " << context.error.message;
+    }
+    if (context.destination.length == 0) {
         RAISE_RUNTIME_ERROR << "Failed to produce JPEG tables blob.";
     }
-    tablesBlob.assign(output, output + length);
-    free(output);
+    tablesBlob.assign(context.output.begin(),
+        context.output.begin() + static_cast<std::ptrdiff_t>(context.destination.length));
 }
 
 void jpeglibEncodeAbbreviated(const cv::Mat& raster, std::vector<uint8_t>& encodedStream, int quality)
 {
-    if (!raster.isContinuous()) {
-        RAISE_RUNTIME_ERROR << "Expected continuous matrix!";
-    }
-    if (raster.dims != 2) {
-        RAISE_RUNTIME_ERROR << "Expected 2D matrix!";
-    }
-    if (raster.depth() != CV_8U) {
-        RAISE_RUNTIME_ERROR << "Expected 8bit matrix!";
-    }
-    const int imageWidth = raster.cols;
-    const int imageHeight = raster.rows;
-    const int numChannels = raster.channels();
-    if (numChannels != 1 && numChannels != 3) {
-        RAISE_RUNTIME_ERROR << "Only 3 or 1 channel images are supported!";
-    }
-    struct jpeg_compress_struct cinfo;
-    struct jpeg_error_mgr jerr;
-    cinfo.err = jpeg_std_error(&jerr);
-    jpeg_create_compress(&cinfo);
-    cinfo.image_width = imageWidth;
-    cinfo.image_height = imageHeight;
-    setupAbbreviatedCompressParams(cinfo, numChannels, quality);
-    size_t length = 0;
-    uint8_t* output = nullptr;
-    jpeg_mem_dest(&cinfo, &output, &length);
-    // Suppress per-tile DQT/DHT — tables are carried by TIFF JPEGTABLES tag.
-    jpeg_suppress_tables(&cinfo, TRUE);
-    jpeg_start_compress(&cinfo, FALSE);
-    JSAMPROW row_pointer[1];
-    const int row_stride = imageWidth * numChannels;
-    uint8_t* row = raster.data;
-    bool success = true;
-    while (cinfo.next_scanline < cinfo.image_height) {
-        row_pointer[0] = row;
-        if (jpeg_write_scanlines(&cinfo, row_pointer, 1) == 0) {
-            success = false;
-            break;
-        }
-        row += row_stride;
-    }
-    jpeg_finish_compress(&cinfo);
-    jpeg_destroy_compress(&cinfo);
-    if (!success) {
-        if (output) free(output);
-        RAISE_RUNTIME_ERROR << "Error during compressing of raster with libjpeg!";
-    }
-    encodedStream.assign(output, output + length);
-    free(output);
+    encodeRaster(raster, encodedStream, quality, JpegEncodeMode::Abbreviated);
 }
@@ -7,6 +7,27 @@
 #include <stdint.h>
 
 void jpeglibEncode(const cv::Mat& raster, std::vector<uint8_t>& encodedStream, int quality);
-void jpeglibDecode(const uint8_t* jpg_buffer, size_t jpg_size, cv::OutputArray output);
+// Color space of the components of a jpeg stream.
+enum class JpegColorSpace
+{
+    Auto,       // detected by libjpeg from the markers of the stream
+    Gray,
+    RGB,
+    YCbCr
+};
+
+struct JpegDecodeOptions
+{
+    // Abbreviated table-only stream loaded before the image (TIFF JPEGTables), if any.
+    const uint8_t* tables = nullptr;
+    size_t tablesSize = 0;
+    JpegColorSpace colorSpace = JpegColorSpace::Auto;
+    // Decode the luminance into a single channel. The chroma of YCbCr streams is
+    // skipped: no inverse DCT, upsampling or color conversion.
+    bool luminance = false;
+};
+
+void jpeglibDecode(const uint8_t* jpg_buffer, size_t jpg_size, cv::OutputArray output,
+                   const JpegDecodeOptions& options = JpegDecodeOptions());
 void jpeglibWriteAbbreviatedTables(int numChannels, int quality, std::vector<uint8_t>& tablesBlob);
 void jpeglibEncodeAbbreviated(const cv::Mat& raster, std::vector<uint8_t>& encodedStream, int quality);
@@ -10,6 +10,7 @@
 #include <filesystem>
 
 #include "slideio/base/exceptions.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
 
 
 static int getCvType(jpegxr_image_info& info)
@@ -92,6 +93,7 @@ void slideio::ImageTools::readJxrImage(const std::string& path, cv::OutputArray
 
 void slideio::ImageTools::decodeJxrBlock(const uint8_t* data, size_t dataBlockSize, cv::OutputArray output)
 {
+    ReadStageTimer timer(ReadStage::Decode);
     jpegxr_image_info info;
     jpegxr_get_image_info((uint8_t*)data, (uint32_t)dataBlockSize, info);
     int type = getCvType(info);
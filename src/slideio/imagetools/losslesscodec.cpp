@@ -0,0 +1,246 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "slideio/imagetools/imagetools.hpp"
+#include "slideio/base/exceptions.hpp"
+#include <zlib.h>
+#include <zstd.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+using namespace slideio;
+
+namespace
+{
+    // Horizontal differencing (TIFF predictor 2). Works on the unsigned type of the
+    // sample size, which gives the modulo arithmetic TIFF readers expect.
+    template <typename T>
+    void applyHorizontalPredictor(uint8_t* data, int width, int height, int channels) {
+        const size_t rowSamples = static_cast<size_t>(width) * channels;
+        for (int y = 0; y < height; ++y) {
+            T* row = reinterpret_cast<T*>(data) + y * rowSamples;
+            for (size_t sample = rowSamples - 1; sample >= static_cast<size_t>(channels); --sample) {
+                row[sample] = static_cast<T>(row[sample] - row[sample - channels]);
+            }
+        }
+    }
+
+    // Floating point predictor (TIFF predictor 3): bytes of every row are regrouped by
+    // significance, most significant first, and then differenced with the pixel stride.
+    void applyFloatingPointPredictor(uint8_t* data, int width, int height, int channels, int sampleSize) {
+        const size_t rowSamples = static_cast<size_t>(width) * channels;
+        const size_t rowBytes = rowSamples * sampleSize;
+        std::vector<uint8_t> original(rowBytes);
+        const bool littleEndian = []() { const uint16_t one = 1; return *reinterpret_cast<const uint8_t*>(&one) == 1; }();
+        for (int y = 0; y < height; ++y) {
+            uint8_t* row = data + y * rowBytes;
+            std::memcpy(original.data(), row, rowBytes);
+            for (size_t sample = 0; sample < rowSamples; ++sample) {
+                for (int byte = 0; byte < sampleSize; ++byte) {
+                    const int plane = littleEndian ? sampleSize - byte - 1 : byte;
+                    row[plane * rowSamples + sample] = original[sample * sampleSize + byte];
+                }
+            }
+            for (size_t pos = rowBytes - 1; pos >= static_cast<size_t>(channels); --pos) {
+                row[pos] = static_cast<uint8_t>(row[pos] - row[pos - channels]);
+            }
+        }
+    }
+
+    // TIFF flavour of LZW: MSB-first codes of 9 to 12 bits with the code width switched
+    // one code early, matching what libtiff emits and decodes.
+    class LZWEncoder
+    {
+    public:
+        void encode(const uint8_t* data, size_t size, std::vector<uint8_t>& output) {
+            output.clear();
+            output.reserve(size / 2 + 16);
+            m_output = &output;
+            m_bitBuffer = 0;
+            m_bitCount = 0;
+            resetTable();
+            putCode(CODE_CLEAR);
+            if (size > 0) {
+                int prefix = data[0];
+                for (size_t pos = 1; pos < size; ++pos) {
+                    const uint8_t value = data[pos];
+                    const int child = findChild(prefix, value);
+                    if (child >= 0) {
+                        prefix = child;
+                        continue;
+                    }
+                    putCode(prefix);
+                    addEntry(prefix, value);
+                    prefix = value;
+                }
+                putCode(prefix);
+                ++m_nextCode;
+                if (m_nextCode == CODE_MAX - 1) {
+                    putCode(CODE_CLEAR);
+                    m_codeWidth = BITS_MIN;
+                }
+                else if (m_nextCode > maxCode(m_codeWidth)) {
+                    ++m_codeWidth;
+                }
+            }
+            putCode(CODE_EOI);
+            if (m_bitCount > 0) {
+                output.push_back(static_cast<uint8_t>((m_bitBuffer << (8 - m_bitCount)) & 0xff));
+            }
+            m_output = nullptr;
+        }
+    private:
+        static constexpr int BITS_MIN = 9;
+        static constexpr int BITS_MAX = 12;
+        static constexpr int CODE_CLEAR = 256;
+        static constexpr int CODE_EOI = 257;
+        static constexpr int CODE_FIRST = 258;
+        static constexpr int CODE_MAX = (1 << BITS_MAX) - 1;
+
+        static int maxCode(int bits) {
+            return (1 << bits) - 1;
+        }
+        void resetTable() {
+            std::fill(m_firstChild, m_firstChild + CODE_MAX + 1, -1);
+            m_nextCode = CODE_FIRST;
+            m_codeWidth = BITS_MIN;
+        }
+        int findChild(int prefix, uint8_t value) const {
+            for (int code = m_firstChild[prefix]; code >= 0; code = m_nextSibling[code]) {
+                if (m_value[code] == value) {
+                    return code;
+                }
+            }
+            return -1;
+        }
+        void addEntry(int prefix, uint8_t value) {
+            const int code = m_nextCode++;
+            m_value[code] = value;
+            m_firstChild[code] = -1;
+            m_nextSibling[code] = m_firstChild[prefix];
+            m_firstChild[prefix] = code;
+            if (m_nextCode == CODE_MAX - 1) {
+                // table is full: the clear code is still written with the current width
+                putCode(CODE_CLEAR);
+                resetTable();
+            }
+            else if (m_nextCode > maxCode(m_codeWidth)) {
+                ++m_codeWidth;
+            }
+        }
+        void putCode(int code) {
+            m_bitBuffer = (m_bitBuffer << m_codeWidth) | static_cast<uint32_t>(code);
+            m_bitCount += m_codeWidth;
+            while (m_bitCount >= 8) {
+                m_bitCount -= 8;
+                m_output->push_back(static_cast<uint8_t>((m_bitBuffer >> m_bitCount) & 0xff));
+            }
+            m_bitBuffer &= (1u << m_bitCount) - 1;
+        }
+    private:
+        int m_firstChild[CODE_MAX + 1];
+        int m_nextSibling[CODE_MAX + 1];
+        uint8_t m_value[CODE_MAX + 1];
+        int m_nextCode = CODE_FIRST;
+        int m_codeWidth = BITS_MIN;
+        uint32_t m_bitBuffer = 0;
+        int m_bitCount = 0;
+        std::vector<uint8_t>* m_output = nullptr;
+    };
+
+    struct ZstdContextDeleter
+    {
+        void operator()(ZSTD_CCtx* context) const {
+            ZSTD_freeCCtx(context);
+        }
+    };
+
+    void encodeZstd(const uint8_t* data, size_t size, int level, std::vector<uint8_t>& output) {
+        // encoder threads reuse one compression context each
+        thread_local std::unique_ptr<ZSTD_CCtx, ZstdContextDeleter> context(ZSTD_createCCtx());
+        if (!context) {
+            RAISE_RUNTIME_ERROR << "Zstd: cannot create compression context";
+        }
+        output.resize(ZSTD_compressBound(size));
+        const size_t encodedSize = ZSTD_compressCCtx(context.get(), output.data(), output.size(), data, size, level);
+        if (ZSTD_isError(encodedSize)) {
+            RAISE_RUNTIME_ERROR << "Zstd: compression failed: " << ZSTD_getErrorName(encodedSize);
+        }
+        output.resize(encodedSize);
+    }
+
+    void encodeDeflate(const uint8_t* data, size_t size, int level, std::vector<uint8_t>& output) {
+        uLongf encodedSize = compressBound(static_cast<uLong>(size));
+        output.resize(encodedSize);
+        const int result = compress2(output.data(), &encodedSize, data, static_cast<uLong>(size), level);
+        if (result != Z_OK) {
+            RAISE_RUNTIME_ERROR << "Deflate: compression failed with error " << result;
+        }
+        output.resize(encodedSize);
+    }
+}
+
+void slideio::ImageTools::encodeLossless(const cv::Mat& raster, std::vector<uint8_t>& encodedStream,
+                                         const LosslessEncodeParameters& params)
+{
+    const int depth = raster.depth();
+    const bool floatData = depth == CV_32F || depth == CV_64F || depth == CV_16F;
+    const int sampleSize = static_cast<int>(raster.elemSize1());
+    const int channels = raster.channels();
+    TiffPredictor predictor = params.getPredictor();
+    if (predictor == TiffPredictor::Auto) {
+        predictor = floatData ? TiffPredictor::FloatingPoint : TiffPredictor::Horizontal;
+    }
+    if (predictor == TiffPredictor::FloatingPoint && !floatData) {
+        RAISE_RUNTIME_ERROR << "Floating point predictor requires floating point data";
+    }
+    cv::Mat data;
+    if (predictor == TiffPredictor::None && raster.isContinuous()) {
+        data = raster;
+    }
+    else {
+        raster.copyTo(data);
+    }
+    const int width = data.cols;
+    const int height = data.rows;
+    if (width > 0 && height > 0) {
+        if (predictor == TiffPredictor::Horizontal) {
+            switch (sampleSize) {
+            case 1:
+                applyHorizontalPredictor<uint8_t>(data.data, width, height, channels);
+                break;
+            case 2:
+                applyHorizontalPredictor<uint16_t>(data.data, width, height, channels);
+                break;
+            case 4:
+                applyHorizontalPredictor<uint32_t>(data.data, width, height, channels);
+                break;
+            case 8:
+                applyHorizontalPredictor<uint64_t>(data.data, width, height, channels);
+                break;
+            default:
+                RAISE_RUNTIME_ERROR << "Horizontal predictor: unsupported sample size " << sampleSize;
+            }
+        }
+        else if (predictor == TiffPredictor::FloatingPoint) {
+            applyFloatingPointPredictor(data.data, width, height, channels, sampleSize);
+        }
+    }
+    const size_t dataSize = data.total() * data.elemSize();
+    switch (params.getCompression()) {
+    case Compression::Zstd:
+        encodeZstd(data.data, dataSize, params.getLevel(), encodedStream);
+        break;
+    case Compression::Zlib:
+        encodeDeflate(data.data, dataSize, params.getLevel(), encodedStream);
+        break;
+    case Compression::LZW: {
+        thread_local std::unique_ptr<LZWEncoder> encoder(new LZWEncoder);
+        encoder->encode(data.data, dataSize, encodedStream);
+        break;
+    }
+    default:
+        RAISE_RUNTIME_ERROR << "Unsupported lossless compression: " << params.getCompression();
+    }
+}
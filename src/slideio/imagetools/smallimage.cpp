@@ -6,9 +6,22 @@
 #include <opencv2/core.hpp>
 #include "fiwrapper.hpp"
 #include "slideio/base/exceptions.hpp"
+#include "slideio/core/tools/tools.hpp"
 
 using namespace slideio;
 
+void SmallImagePage::readRasterRegion(const cv::Rect& region, const cv::Size& size, cv::OutputArray raster) {
+	cv::Mat pageRaster;
+	readRaster(pageRaster);
+	const cv::Mat regionRaster = pageRaster(region);
+	if (regionRaster.size() != size) {
+		Tools::resize(regionRaster, raster, size);
+	}
+	else {
+		regionRaster.copyTo(raster);
+	}
+}
+
 void SmallImage::readImageStack(cv::OutputArray raster) {
 	int numPages = getNumPages();
 	slideio::Size pageSize = {};
@@ -21,6 +21,19 @@ namespace slideio
 		virtual Compression getCompression() const = 0;
 		virtual const std::string& getMetadata() const = 0;
 		virtual void readRaster(cv::OutputArray raster) = 0;
+		// Returns true if a region of the page can be decoded without decoding the whole page.
+		virtual bool canReadRegion() const {
+			return false;
+		}
+		// Reads a region of the page scaled to the requested size. The default implementation
+		// decodes the whole page and crops it.
+		virtual void readRasterRegion(const cv::Rect& region, const cv::Size& size, cv::OutputArray raster);
+		// Reads a region of the page at the resolution it is decoded with for the requested
+		// size (an overview at least as large, or the page itself), without scaling it.
+		// Only for pages that can read regions.
+		virtual void readRasterRegionUnscaled(const cv::Rect& region, const cv::Size& size, cv::OutputArray raster) {
+			readRasterRegion(region, region.size(), raster);
+		}
 		virtual Resolution getResolution() const {
 			return {};
 		}
@@ -5,6 +5,7 @@
 #include "slideio/imagetools/smalltiffwrapper.hpp"
 #include "slideio/imagetools/tifftools.hpp"
 #include "slideio/imagetools/tiffkeeper.hpp"
+#include "slideio/core/tools/tools.hpp"
 #include <nlohmann/json.hpp>
 
 using namespace slideio;
@@ -48,6 +49,65 @@ void SmallTiffWrapper::SmallTiffPage::readRaster(cv::OutputArray raster) {
 	}
 }
 
+bool SmallTiffWrapper::SmallTiffPage::canReadRegion() const {
+	const TiffDirectory& dir = m_parent->getDirectory(m_pageIndex);
+	return dir.tiled;
+}
+
+const TiffDirectory& SmallTiffWrapper::SmallTiffPage::selectOverview(const cv::Rect& region, const cv::Size& size) const {
+	// Selects the smallest tiled reduced-resolution subdirectory (SubIFD)
+	// that still has at least the requested resolution.
+	const TiffDirectory& dir = m_parent->getDirectory(m_pageIndex);
+	const double scale = std::max(static_cast<double>(size.width) / static_cast<double>(region.width),
+		static_cast<double>(size.height) / static_cast<double>(region.height));
+	const TiffDirectory* selected = &dir;
+	for (const TiffDirectory& subDir : dir.subdirectories) {
+		if (!subDir.tiled || subDir.channels != dir.channels || subDir.dataType != dir.dataType) {
+			continue;
+		}
+		const double subDirScale = static_cast<double>(subDir.width) / static_cast<double>(dir.width);
+		if (subDirScale >= scale && subDir.width < selected->width) {
+			selected = &subDir;
+		}
+	}
+	return *selected;
+}
+
+void SmallTiffWrapper::SmallTiffPage::readRasterRegion(const cv::Rect& region, const cv::Size& size,
+	cv::OutputArray raster) {
+	const TiffDirectory& dir = m_parent->getDirectory(m_pageIndex);
+	if (!dir.tiled) {
+		SmallImagePage::readRasterRegion(region, size, raster);
+		return;
+	}
+	cv::Mat regionRaster;
+	readRasterRegionUnscaled(region, size, regionRaster);
+	if (regionRaster.size() != size) {
+		Tools::resize(regionRaster, raster, size);
+	}
+	else {
+		regionRaster.copyTo(raster);
+	}
+}
+
+void SmallTiffWrapper::SmallTiffPage::readRasterRegionUnscaled(const cv::Rect& region, const cv::Size& size,
+	cv::OutputArray raster) {
+	const TiffDirectory& dir = m_parent->getDirectory(m_pageIndex);
+	if (!dir.tiled) {
+		SmallImagePage::readRasterRegionUnscaled(region, size, raster);
+		return;
+	}
+	const TiffDirectory& source = selectOverview(region, size);
+	cv::Rect sourceRegion = region;
+	if (&source != &dir) {
+		const double scaleX = static_cast<double>(source.width) / static_cast<double>(dir.width);
+		const double scaleY = static_cast<double>(source.height) / static_cast<double>(dir.height);
+		Tools::scaleRect(region, scaleX, scaleY, sourceRegion);
+		sourceRegion &= cv::Rect(0, 0, source.width, source.height);
+	}
+	TiffTools::readTiledDirRegion(m_parent->getHandle(), source, sourceRegion, raster);
+}
+
 Resolution SmallTiffWrapper::SmallTiffPage::getResolution() const {
 	const TiffDirectory& dir = m_parent->getDirectory(m_pageIndex);
 	return dir.res;
@@ -29,9 +29,13 @@ namespace slideio
 			Compression getCompression() const override;
 			const std::string& getMetadata() const override;
 			void readRaster(cv::OutputArray raster) override;
+			bool canReadRegion() const override;
+			void readRasterRegion(const cv::Rect& region, const cv::Size& size, cv::OutputArray raster) override;
+			void readRasterRegionUnscaled(const cv::Rect& region, const cv::Size& size, cv::OutputArray raster) override;
 			Resolution getResolution() const override;
 		private:
 			void extractMetadata();
+			const TiffDirectory& selectOverview(const cv::Rect& region, const cv::Size& size) const;
 		private:
 			SmallTiffWrapper* m_parent;
 			int m_pageIndex;
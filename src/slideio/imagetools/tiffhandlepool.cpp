@@ -0,0 +1,51 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "slideio/imagetools/tiffhandlepool.hpp"
+#include "slideio/imagetools/tifftools.hpp"
+
+using namespace slideio;
+
+TIFFHandlePool::Lease::Lease(TIFFHandlePool& pool) : m_pool(pool), m_handle(pool.acquire()) {
+}
+
+TIFFHandlePool::Lease::~Lease() {
+    m_pool.release(m_handle);
+}
+
+TIFFHandlePool::~TIFFHandlePool() {
+    closeHandles();
+}
+
+libtiff::TIFF* TIFFHandlePool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_idle.empty()) {
+            libtiff::TIFF* handle = m_idle.back();
+            m_idle.pop_back();
+            return handle;
+        }
+    }
+    return TiffTools::openTiffFile(m_filePath);
+}
+
+void TIFFHandlePool::release(libtiff::TIFF* handle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_idle.push_back(handle);
+}
+
+void TIFFHandlePool::closeHandles() {
+    std::vector<libtiff::TIFF*> idle;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        idle.swap(m_idle);
+    }
+    for (libtiff::TIFF* handle : idle) {
+        TiffTools::closeTiffFile(handle);
+    }
+}
+
+int TIFFHandlePool::getNumIdleHandles() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_idle.size());
+}
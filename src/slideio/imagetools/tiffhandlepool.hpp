@@ -0,0 +1,56 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+#include "slideio/imagetools/slideio_imagetools_def.hpp"
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace libtiff
+{
+    struct tiff;
+    typedef tiff TIFF;
+}
+
+namespace slideio
+{
+    // Handles of a file for threads that decode its strips or tiles in parallel: libtiff
+    // handles are not thread-safe. A handle is opened the first time no idle one is left
+    // and is reused by the following reads, so a read opens the file only while the pool
+    // grows to the number of threads that decode at once.
+    class SLIDEIO_IMAGETOOLS_EXPORTS TIFFHandlePool
+    {
+    public:
+        // A handle of the pool, returned to it by the destructor.
+        class SLIDEIO_IMAGETOOLS_EXPORTS Lease
+        {
+        public:
+            explicit Lease(TIFFHandlePool& pool);
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+            ~Lease();
+            libtiff::TIFF* getHandle() const {
+                return m_handle;
+            }
+        private:
+            TIFFHandlePool& m_pool;
+            libtiff::TIFF* m_handle;
+        };
+    public:
+        explicit TIFFHandlePool(const std::string& filePath) : m_filePath(filePath) {}
+        TIFFHandlePool(const TIFFHandlePool&) = delete;
+        TIFFHandlePool& operator=(const TIFFHandlePool&) = delete;
+        ~TIFFHandlePool();
+        // Closes the idle handles; handles leased meanwhile stay open until the next call.
+        void closeHandles();
+        int getNumIdleHandles() const;
+    private:
+        libtiff::TIFF* acquire();
+        void release(libtiff::TIFF* handle);
+    private:
+        std::string m_filePath;
+        std::vector<libtiff::TIFF*> m_idle;
+        mutable std::mutex m_mutex;
+    };
+}
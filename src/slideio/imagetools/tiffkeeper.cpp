@@ -112,3 +112,7 @@ void TIFFKeeper::initSubDirs(int numDirs) {
 void TIFFKeeper::writeRawTile(int x, int y, const uint8_t* data, int size) {
 	TiffTools::writeRawTile(m_hFile, x, y, data, size);
 }
+
+void TIFFKeeper::writeRawTileReference(int x, int y, int sourceX, int sourceY) {
+	TiffTools::writeRawTileReference(m_hFile, x, y, sourceX, sourceY);
+}
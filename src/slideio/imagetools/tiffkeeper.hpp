@@ -71,6 +71,7 @@ namespace slideio
         std::string readStringTag(uint16_t tag);
         void initSubDirs(int numDirs);
         void writeRawTile(int x, int y, const uint8_t* data, int size);
+        void writeRawTileReference(int x, int y, int sourceX, int sourceY);
 
     private:
         // Shared initialiser for m_messageHandler, used by both constructors.
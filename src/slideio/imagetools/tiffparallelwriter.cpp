@@ -0,0 +1,341 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "slideio/imagetools/tiffparallelwriter.hpp"
+#include "slideio/imagetools/imagetools.hpp"
+#include "slideio/imagetools/libtiff.hpp"
+#include "slideio/core/tools/endian.hpp"
+#include "slideio/base/exceptions.hpp"
+#include "slideio/base/log.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace slideio;
+
+namespace
+{
+    constexpr uint64_t BIGTIFF_HEADER_SIZE = 16;
+    constexpr uint64_t BIGTIFF_ENTRY_SIZE = 20;
+
+    enum TagType : uint16_t
+    {
+        TYPE_ASCII = 2,
+        TYPE_SHORT = 3,
+        TYPE_LONG = 4,
+        TYPE_RATIONAL = 5,
+        TYPE_UNDEFINED = 7,
+        TYPE_LONG8 = 16,
+        TYPE_IFD8 = 18
+    };
+
+    struct TagEntry
+    {
+        uint16_t tag;
+        uint16_t type;
+        uint64_t count;
+        std::vector<uint8_t> data;
+    };
+
+    template <typename T>
+    void appendValue(std::vector<uint8_t>& data, T value) {
+        const size_t pos = data.size();
+        data.resize(pos + sizeof(T));
+        std::memcpy(data.data() + pos, &value, sizeof(T));
+    }
+
+    template <typename T>
+    TagEntry makeEntry(uint16_t tag, uint16_t type, const std::vector<T>& values) {
+        TagEntry entry{tag, type, values.size(), {}};
+        entry.data.reserve(values.size() * sizeof(T));
+        for (const T value : values) {
+            appendValue(entry.data, value);
+        }
+        return entry;
+    }
+
+    TagEntry makeAsciiEntry(uint16_t tag, const std::string& value) {
+        TagEntry entry{tag, TYPE_ASCII, value.size() + 1, {}};
+        entry.data.assign(value.begin(), value.end());
+        entry.data.push_back(0);
+        return entry;
+    }
+
+    TagEntry makeRationalEntry(uint16_t tag, double value) {
+        const uint32_t denominator = 1000;
+        const double numerator = std::round(std::max(0., value) * denominator);
+        TagEntry entry{tag, TYPE_RATIONAL, 1, {}};
+        appendValue(entry.data, static_cast<uint32_t>(std::min(numerator, 4294967295.)));
+        appendValue(entry.data, denominator);
+        return entry;
+    }
+
+    uint64_t alignOffset(uint64_t offset) {
+        return (offset + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    // Size of an IFD with its out-of-line values.
+    uint64_t computeIFDSize(const std::vector<TagEntry>& entries) {
+        uint64_t size = 8 + entries.size() * BIGTIFF_ENTRY_SIZE + 8;
+        for (const auto& entry : entries) {
+            if (entry.data.size() > 8) {
+                size = alignOffset(size) + entry.data.size();
+            }
+        }
+        return alignOffset(size);
+    }
+}
+
+TiffParallelWriter::TiffParallelWriter(const std::string& filePath, bool resume) : m_filePath(filePath) {
+    m_file.reset(Tools::openFile(filePath, resume ? "r+b" : "wb"));
+    if (!m_file) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: cannot open file " << filePath << " for writing";
+    }
+}
+
+TiffParallelWriter::~TiffParallelWriter() {
+    if (m_file && m_writing) {
+        SLIDEIO_LOG(WARNING) << "TiffParallelWriter: file " << m_filePath << " is closed without finalization";
+    }
+}
+
+int TiffParallelWriter::addDirectory(const TiffDirectory& dir, int parentIndex) {
+    if (m_writing) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: directories cannot be added after writing has started";
+    }
+    if (dir.tileWidth <= 0 || dir.tileHeight <= 0 || dir.width <= 0 || dir.height <= 0) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: invalid directory geometry " << dir.width << "x" << dir.height
+            << " with tile " << dir.tileWidth << "x" << dir.tileHeight;
+    }
+    const int index = static_cast<int>(m_directories.size());
+    if (parentIndex >= index || (parentIndex >= 0 && m_directories[parentIndex].parentIndex >= 0)) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: invalid parent directory " << parentIndex
+            << " for directory " << index;
+    }
+    Directory& directory = m_directories.emplace_back();
+    directory.dir = dir;
+    directory.parentIndex = parentIndex;
+    directory.tilesAcross = (dir.width + dir.tileWidth - 1) / dir.tileWidth;
+    directory.tilesDown = (dir.height + dir.tileHeight - 1) / dir.tileHeight;
+    const size_t numTiles = static_cast<size_t>(directory.tilesAcross) * directory.tilesDown;
+    directory.tileOffsets.assign(numTiles, 0);
+    directory.tileByteCounts.assign(numTiles, 0);
+    if (dir.slideioCompression == Compression::Jpeg) {
+        ImageTools::computeJpegTables(dir.channels, dir.compressionQuality, directory.jpegTables);
+    }
+    if (parentIndex >= 0) {
+        m_directories[parentIndex].subDirectories.push_back(index);
+    }
+    return index;
+}
+
+void TiffParallelWriter::beginWriting() {
+    if (m_writing) {
+        return;
+    }
+    if (m_directories.empty()) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: no directories declared for " << m_filePath;
+    }
+    // Offset and byte count arrays have their final size already, so the metadata
+    // serialized now occupies exactly the space it will occupy after finalize.
+    std::vector<uint8_t> metadata;
+    serializeMetadata(metadata);
+    m_metadataSize = metadata.size();
+    m_cursor.store(m_metadataSize);
+    m_writing = true;
+}
+
+size_t TiffParallelWriter::getTileIndex(int dirIndex, int x, int y) const {
+    if (!m_writing) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: tiles written outside of beginWriting/finalize";
+    }
+    if (dirIndex < 0 || dirIndex >= static_cast<int>(m_directories.size())) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: invalid directory index " << dirIndex;
+    }
+    const Directory& directory = m_directories[dirIndex];
+    const int col = x / directory.dir.tileWidth;
+    const int row = y / directory.dir.tileHeight;
+    if (x < 0 || y < 0 || col >= directory.tilesAcross || row >= directory.tilesDown) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: tile position (" << x << "," << y
+            << ") is outside of directory " << dirIndex;
+    }
+    return static_cast<size_t>(row) * directory.tilesAcross + col;
+}
+
+uint64_t TiffParallelWriter::writeTile(int dirIndex, int x, int y, const uint8_t* data, size_t size) {
+    const size_t tileIndex = getTileIndex(dirIndex, x, y);
+    Directory& directory = m_directories[dirIndex];
+    const uint64_t offset = m_cursor.fetch_add(size);
+    if (Tools::writeFileAt(m_file.get(), offset, data, size) != size) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: error by writing tile " << tileIndex
+            << " of directory " << dirIndex << " to " << m_filePath;
+    }
+    // every tile has its own slot, so concurrent writers never touch the same element
+    directory.tileOffsets[tileIndex] = offset;
+    directory.tileByteCounts[tileIndex] = size;
+    return offset;
+}
+
+void TiffParallelWriter::writeTileReference(int dirIndex, int x, int y, uint64_t offset, size_t size) {
+    const size_t tileIndex = getTileIndex(dirIndex, x, y);
+    if (offset < m_metadataSize || offset + size > m_cursor.load()) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: tile " << tileIndex << " of directory " << dirIndex
+            << " references data outside of the written tiles";
+    }
+    Directory& directory = m_directories[dirIndex];
+    directory.tileOffsets[tileIndex] = offset;
+    directory.tileByteCounts[tileIndex] = size;
+}
+
+void TiffParallelWriter::restoreTile(int dirIndex, int x, int y, uint64_t offset, size_t size) {
+    const size_t tileIndex = getTileIndex(dirIndex, x, y);
+    if (offset < m_metadataSize) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: restored tile " << tileIndex << " of directory " << dirIndex
+            << " overlaps the directory region";
+    }
+    Directory& directory = m_directories[dirIndex];
+    directory.tileOffsets[tileIndex] = offset;
+    directory.tileByteCounts[tileIndex] = size;
+    if (offset + size > m_cursor.load()) {
+        m_cursor.store(offset + size);
+    }
+}
+
+void TiffParallelWriter::sync() {
+    if (!m_writing) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: sync called before beginWriting";
+    }
+    if (!Tools::syncFile(m_file.get())) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: error by syncing " << m_filePath;
+    }
+}
+
+void TiffParallelWriter::finalize() {
+    if (!m_writing) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: finalize called before beginWriting";
+    }
+    std::vector<uint8_t> metadata;
+    serializeMetadata(metadata);
+    if (metadata.size() != m_metadataSize) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: unexpected metadata size " << metadata.size()
+            << ". Reserved: " << m_metadataSize;
+    }
+    if (Tools::writeFileAt(m_file.get(), 0, metadata.data(), metadata.size()) != metadata.size()) {
+        RAISE_RUNTIME_ERROR << "TiffParallelWriter: error by writing directories to " << m_filePath;
+    }
+    m_writing = false;
+    m_file.reset();
+}
+
+void TiffParallelWriter::serializeMetadata(std::vector<uint8_t>& buffer) const {
+    const size_t numDirectories = m_directories.size();
+    std::vector<uint64_t> ifdOffsets(numDirectories, 0);
+
+    auto buildEntries = [this, &ifdOffsets](const Directory& directory) {
+        const TiffDirectory& dir = directory.dir;
+        const uint16_t numChannels = static_cast<uint16_t>(dir.channels);
+        std::vector<TagEntry> entries;
+        entries.push_back(makeEntry<uint32_t>(TIFFTAG_SUBFILETYPE, TYPE_LONG, {static_cast<uint32_t>(dir.subFileType)}));
+        entries.push_back(makeEntry<uint32_t>(TIFFTAG_IMAGEWIDTH, TYPE_LONG, {static_cast<uint32_t>(dir.width)}));
+        entries.push_back(makeEntry<uint32_t>(TIFFTAG_IMAGELENGTH, TYPE_LONG, {static_cast<uint32_t>(dir.height)}));
+        entries.push_back(makeEntry(TIFFTAG_BITSPERSAMPLE, TYPE_SHORT,
+            std::vector<uint16_t>(numChannels, TiffTools::tiffBitsPerSample(dir.dataType))));
+        entries.push_back(makeEntry<uint16_t>(TIFFTAG_COMPRESSION, TYPE_SHORT,
+            {TiffTools::tiffCompression(dir.slideioCompression)}));
+        entries.push_back(makeEntry<uint16_t>(TIFFTAG_PHOTOMETRIC, TYPE_SHORT, {TiffTools::tiffPhotometric(dir)}));
+        if (!dir.description.empty()) {
+            entries.push_back(makeAsciiEntry(TIFFTAG_IMAGEDESCRIPTION, dir.description));
+        }
+        entries.push_back(makeEntry<uint16_t>(TIFFTAG_SAMPLESPERPIXEL, TYPE_SHORT, {numChannels}));
+        entries.push_back(makeRationalEntry(TIFFTAG_XRESOLUTION, dir.res.x > 0 ? 0.01 / dir.res.x : 0.));
+        entries.push_back(makeRationalEntry(TIFFTAG_YRESOLUTION, dir.res.y > 0 ? 0.01 / dir.res.y : 0.));
+        entries.push_back(makeEntry<uint16_t>(TIFFTAG_PLANARCONFIG, TYPE_SHORT, {PLANARCONFIG_CONTIG}));
+        entries.push_back(makeRationalEntry(TIFFTAG_XPOSITION, 0.));
+        entries.push_back(makeRationalEntry(TIFFTAG_YPOSITION, 0.));
+        entries.push_back(makeEntry<uint16_t>(TIFFTAG_RESOLUTIONUNIT, TYPE_SHORT, {RESUNIT_CENTIMETER}));
+        if (dir.predictor > PREDICTOR_NONE) {
+            entries.push_back(makeEntry<uint16_t>(TIFFTAG_PREDICTOR, TYPE_SHORT, {static_cast<uint16_t>(dir.predictor)}));
+        }
+        if (!dir.software.empty()) {
+            entries.push_back(makeAsciiEntry(TIFFTAG_SOFTWARE, dir.software));
+        }
+        entries.push_back(makeEntry<uint32_t>(TIFFTAG_TILEWIDTH, TYPE_LONG, {static_cast<uint32_t>(dir.tileWidth)}));
+        entries.push_back(makeEntry<uint32_t>(TIFFTAG_TILELENGTH, TYPE_LONG, {static_cast<uint32_t>(dir.tileHeight)}));
+        entries.push_back(makeEntry(TIFFTAG_TILEOFFSETS, TYPE_LONG8, directory.tileOffsets));
+        entries.push_back(makeEntry(TIFFTAG_TILEBYTECOUNTS, TYPE_LONG8, directory.tileByteCounts));
+        if (!directory.subDirectories.empty()) {
+            std::vector<uint64_t> subIFDs;
+            for (const int subDirIndex : directory.subDirectories) {
+                subIFDs.push_back(ifdOffsets[subDirIndex]);
+            }
+            entries.push_back(makeEntry(TIFFTAG_SUBIFD, TYPE_IFD8, subIFDs));
+        }
+        const uint16_t sampleFormat = TiffTools::tiffSampleFormat(dir.dataType);
+        if (sampleFormat != 0) {
+            entries.push_back(makeEntry(TIFFTAG_SAMPLEFORMAT, TYPE_SHORT, std::vector<uint16_t>(numChannels, sampleFormat)));
+        }
+        if (!directory.jpegTables.empty()) {
+            entries.push_back(makeEntry(TIFFTAG_JPEGTABLES, TYPE_UNDEFINED, directory.jpegTables));
+        }
+        return entries;
+    };
+
+    // Pass 1: IFD positions. Directories are laid out in declaration order.
+    uint64_t position = BIGTIFF_HEADER_SIZE;
+    for (size_t index = 0; index < numDirectories; ++index) {
+        ifdOffsets[index] = position;
+        position += computeIFDSize(buildEntries(m_directories[index]));
+    }
+
+    // Pass 2: the same entries, now with the SubIFD offsets known.
+    buffer.assign(position, 0);
+    uint8_t* data = buffer.data();
+    auto put = [data](uint64_t offset, const void* value, size_t size) {
+        std::memcpy(data + offset, value, size);
+    };
+    const char* byteOrder = Endian::isLittleEndian() ? "II" : "MM";
+    put(0, byteOrder, 2);
+    const uint16_t version = 43, offsetSize = 8, reserved = 0;
+    put(2, &version, 2);
+    put(4, &offsetSize, 2);
+    put(6, &reserved, 2);
+    put(8, &ifdOffsets[0], 8);
+
+    for (size_t index = 0; index < numDirectories; ++index) {
+        const Directory& directory = m_directories[index];
+        std::vector<TagEntry> entries = buildEntries(directory);
+        std::sort(entries.begin(), entries.end(),
+            [](const TagEntry& left, const TagEntry& right) { return left.tag < right.tag; });
+        uint64_t entryPos = ifdOffsets[index];
+        const uint64_t numEntries = entries.size();
+        put(entryPos, &numEntries, 8);
+        entryPos += 8;
+        uint64_t valuePos = entryPos + entries.size() * BIGTIFF_ENTRY_SIZE + 8;
+        for (const auto& entry : entries) {
+            put(entryPos, &entry.tag, 2);
+            put(entryPos + 2, &entry.type, 2);
+            put(entryPos + 4, &entry.count, 8);
+            if (entry.data.size() <= 8) {
+                put(entryPos + 12, entry.data.data(), entry.data.size());
+            }
+            else {
+                valuePos = alignOffset(valuePos);
+                put(valuePos, entry.data.data(), entry.data.size());
+                put(entryPos + 12, &valuePos, 8);
+                valuePos += entry.data.size();
+            }
+            entryPos += BIGTIFF_ENTRY_SIZE;
+        }
+        // pages are chained, SubIFDs terminate their own chain
+        uint64_t nextIFD = 0;
+        if (directory.parentIndex < 0) {
+            for (size_t next = index + 1; next < numDirectories; ++next) {
+                if (m_directories[next].parentIndex < 0) {
+                    nextIFD = ifdOffsets[next];
+                    break;
+                }
+            }
+        }
+        put(entryPos, &nextIFD, 8);
+    }
+}
@@ -0,0 +1,88 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "slideio/imagetools/slideio_imagetools_def.hpp"
+#include "slideio/imagetools/tifftools.hpp"
+#include "slideio/core/tools/tools.hpp"
+
+#if defined(_MSC_VER)
+#pragma warning( push )
+#pragma warning(disable: 4251)
+#endif
+
+namespace slideio
+{
+    // Tiled BigTIFF writer that does not go through libtiff. All directories are declared
+    // before writing starts, so the IFDs and their tile offset/byte count arrays get a
+    // reserved region at the beginning of the file. Encoded tiles are appended by any
+    // number of threads: each claims its file range from an atomic cursor and writes it
+    // with a positional write. finalize() fills in the arrays and writes the IFDs.
+    class SLIDEIO_IMAGETOOLS_EXPORTS TiffParallelWriter
+    {
+    public:
+        // With resume set, an existing partially written file is opened for update
+        // instead of being truncated; see restoreTile.
+        explicit TiffParallelWriter(const std::string& filePath, bool resume = false);
+        ~TiffParallelWriter();
+        TiffParallelWriter(const TiffParallelWriter&) = delete;
+        TiffParallelWriter& operator=(const TiffParallelWriter&) = delete;
+        // Declares a tiled directory and returns its index. Directories with a parent
+        // are written as SubIFDs of the parent page, the others form the page chain.
+        int addDirectory(const TiffDirectory& dir, int parentIndex = -1);
+        // Reserves the metadata region. Directories cannot be added afterwards.
+        void beginWriting();
+        // Writes an encoded tile at pixel position (x, y) of the directory and returns
+        // its file offset. Thread-safe.
+        uint64_t writeTile(int dirIndex, int x, int y, const uint8_t* data, size_t size);
+        // Points the tile at pixel position (x, y) to data already written by writeTile,
+        // so identical tiles share one copy in the file. Thread-safe.
+        void writeTileReference(int dirIndex, int x, int y, uint64_t offset, size_t size);
+        // Registers a tile written by an earlier, interrupted session of the same layout.
+        // New tiles are appended after the restored ones. Call before any writeTile.
+        void restoreTile(int dirIndex, int x, int y, uint64_t offset, size_t size);
+        // Makes the tiles written so far durable. Thread-safe.
+        void sync();
+        // Writes the directories with the final tile offsets and closes the file.
+        void finalize();
+        int getNumDirectories() const {
+            return static_cast<int>(m_directories.size());
+        }
+        // Size of the region reserved for the directories; known after beginWriting.
+        uint64_t getMetadataSize() const {
+            return m_metadataSize;
+        }
+    private:
+        struct Directory
+        {
+            TiffDirectory dir;
+            int parentIndex = -1;
+            std::vector<int> subDirectories;
+            int tilesAcross = 0;
+            int tilesDown = 0;
+            std::vector<uint64_t> tileOffsets;
+            std::vector<uint64_t> tileByteCounts;
+            std::vector<uint8_t> jpegTables;
+        };
+        size_t getTileIndex(int dirIndex, int x, int y) const;
+        void serializeMetadata(std::vector<uint8_t>& buffer) const;
+    private:
+        std::string m_filePath;
+        std::unique_ptr<FILE, Tools::FileDeleter> m_file;
+        std::vector<Directory> m_directories;
+        uint64_t m_metadataSize = 0;
+        std::atomic<uint64_t> m_cursor{0};
+        bool m_writing = false;
+    };
+}
+
+#if defined(_MSC_VER)
+#pragma warning( pop )
+#endif
@@ -9,7 +9,13 @@
 #include "slideio/base/log.hpp"
 #include "slideio/core/tools/endian.hpp"
 #include "slideio/core/tools/tools.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
+#include "slideio/core/tools/decodehint.hpp"
+#include "slideio/imagetools/jpeglib_aux.hpp"
+#include "slideio/imagetools/tiffhandlepool.hpp"
 #include <opencv2/core.hpp>
+#include <opencv2/core/utility.hpp>
+#include <algorithm>
 #include <filesystem>
 #include <iomanip>
 
@@ -17,6 +23,44 @@
 
 using namespace slideio;
 
+// Encoded size of a tile or a strip, reported to the read statistics.
+static void countEncodedBytes(libtiff::TIFF* file, uint32_t strile) {
+    if (ReadStatistics::isEnabled()) {
+        ReadStatistics::countBytesRead(libtiff::TIFFGetStrileByteCount(file, strile));
+    }
+}
+
+// Channels of an interleaved tile raster; all of them for an empty channel list.
+static void extractTileChannels(const cv::Mat& tileRaster, const std::vector<int>& channelIndices,
+                                cv::OutputArray output) {
+    if (channelIndices.empty() || (channelIndices.size() == 1 && tileRaster.channels() == 1)) {
+        tileRaster.copyTo(output);
+    }
+    else if (channelIndices.size() == 1) {
+        cv::extractChannel(tileRaster, output, channelIndices[0]);
+    }
+    else {
+        std::vector<cv::Mat> channelRasters;
+        channelRasters.resize(channelIndices.size());
+        for (int i = 0; i < static_cast<int>(channelIndices.size()); ++i) {
+            cv::extractChannel(tileRaster, channelRasters[i], channelIndices[i]);
+        }
+        cv::merge(channelRasters, output);
+    }
+}
+
+// Whether a tile of the directory may be decoded to the luminance for the read
+// running on the calling thread: only the color channels of an 8-bit RGB image are
+// requested under DecodeHint::Luminance.
+static bool isLuminanceRead(const TiffDirectory& dir, const std::vector<int>& channelIndices) {
+    if (DecodeHints::get() != DecodeHint::Luminance || dir.channels != 3 || dir.dataType != DataType::DT_Byte) {
+        return false;
+    }
+    return std::all_of(channelIndices.begin(), channelIndices.end(), [](int channel) {
+        return channel >= 0 && channel < 3;
+    });
+}
+
 static DataType dataTypeFromTIFFDataType(libtiff::TIFFDataType dt) {
     switch (dt) {
     case libtiff::TIFF_NOTYPE:
@@ -147,6 +191,9 @@ static Compression compressTiffToSlideio(int tiffCompression) {
     case 0x879b:
         compression = Compression::JBIG2;
         break;
+    case 0xC350:
+        compression = Compression::Zstd;
+        break;
     default:
         RAISE_RUNTIME_ERROR << "Invalid compression type: " << tiffCompression;
     }
@@ -226,6 +273,9 @@ int compressSlideioToTiff(Compression compression) {
     case Compression::JBIG2:
         tiffCompression = 0x879b;
         break;
+    case Compression::Zstd:
+        tiffCompression = 0xC350;
+        break;
     default:
         RAISE_RUNTIME_ERROR << "Invalid compression type: " << compression;
     }
@@ -716,6 +766,14 @@ void TiffTools::readDirRaster(libtiff::TIFF* tiff, const TiffDirectory& dir, cv:
 
 
 void TiffTools::readStripedDir(libtiff::TIFF* file, const TiffDirectory& dir, cv::OutputArray output) {
+    ReadStageTimer timer(ReadStage::Decode);
+    if (ReadStatistics::isEnabled()) {
+        setCurrentDirectory(file, dir);
+        const uint32_t strips = libtiff::TIFFNumberOfStrips(file);
+        for (uint32_t strip = 0; strip < strips; ++strip) {
+            countEncodedBytes(file, strip);
+        }
+    }
     if (!dir.interleaved) {
         readPlanarStripedDir(file, dir, output);
     }
@@ -733,16 +791,155 @@ void TiffTools::readStripedDir(libtiff::TIFF* file, const TiffDirectory& dir, cv
 }
 
 
+int TiffTools::getRowsPerStrip(const TiffDirectory& dir) {
+    if (dir.rowsPerStrip <= 0 || dir.rowsPerStrip > dir.height) {
+        return dir.height;
+    }
+    return dir.rowsPerStrip;
+}
+
+cv::Range TiffTools::getStripRange(const TiffDirectory& dir, const cv::Rect& region) {
+    const int rowsPerStrip = std::max(1, getRowsPerStrip(dir));
+    const int firstRow = std::max(0, region.y);
+    const int lastRow = std::min(dir.height, region.y + region.height) - 1;
+    if (lastRow < firstRow) {
+        return cv::Range(0, 0);
+    }
+    return cv::Range(firstRow / rowsPerStrip, lastRow / rowsPerStrip + 1);
+}
+
+void TiffTools::readStrip(libtiff::TIFF* file, const TiffDirectory& dir, int strip, cv::OutputArray output) {
+    const int rowsPerStrip = getRowsPerStrip(dir);
+    const int firstRow = strip * rowsPerStrip;
+    const int rows = std::min(rowsPerStrip, dir.height - firstRow);
+    if (strip < 0 || rows <= 0) {
+        RAISE_RUNTIME_ERROR << "TiffTools::readStrip: invalid strip " << strip << " of directory " << dir.dirIndex;
+    }
+    ReadStageTimer timer(ReadStage::Decode);
+    const int cvType = CVTools::toOpencvType(dir.dataType);
+    setCurrentDirectory(file, dir);
+    const bool notRGB = dir.photometric == 6 || dir.photometric == 8 || dir.photometric == 9 || dir.photometric == 10;
+    if (!dir.interleaved) {
+        // planar strips of a channel follow the strips of the previous channel
+        const int stripsPerChannel = (dir.height + rowsPerStrip - 1) / rowsPerStrip;
+        std::vector<cv::Mat> channelRasters(dir.channels);
+        for (int channel = 0; channel < dir.channels; ++channel) {
+            cv::Mat& channelRaster = channelRasters[channel];
+            channelRaster.create(rows, dir.width, CV_MAKETYPE(cvType, 1));
+            const auto size = static_cast<libtiff::tmsize_t>(channelRaster.total() * channelRaster.elemSize());
+            const int stripIndex = channel * stripsPerChannel + strip;
+            countEncodedBytes(file, stripIndex);
+            if (libtiff::TIFFReadEncodedStrip(file, stripIndex, channelRaster.data, size) <= 0) {
+                RAISE_RUNTIME_ERROR << "TiffTools: Error by reading of tif strip " << stripIndex
+                    << " of directory " << dir.dirIndex;
+            }
+        }
+        if (dir.channels == 1) {
+            channelRasters[0].copyTo(output);
+        }
+        else {
+            cv::merge(channelRasters, output);
+        }
+    }
+    else if (notRGB) {
+        countEncodedBytes(file, strip);
+        std::vector<uint8_t> rgbaRaster(4 * rowsPerStrip * dir.width);
+        if (libtiff::TIFFReadRGBAStrip(file, firstRow, (uint32_t*)rgbaRaster.data()) != 1) {
+            RAISE_RUNTIME_ERROR << "TiffTools: Error by reading of tif strip " << strip
+                << " of directory " << dir.dirIndex;
+        }
+        output.create(rows, dir.width, CV_MAKETYPE(cvType, dir.channels));
+        cv::Mat stripRaster = output.getMat();
+        // the same pixel layout as readNotRGBStripedDir produces
+        for (int row = 0; row < rows; ++row) {
+            uint8_t* pixel = stripRaster.ptr<uint8_t>(row);
+            const uint8_t* rgbaPixel = rgbaRaster.data() + 4 * row * dir.width;
+            for (int column = 0; column < dir.width; ++column, pixel += 3, rgbaPixel += 4) {
+                memcpy(pixel, rgbaPixel, 3);
+            }
+        }
+    }
+    else {
+        output.create(rows, dir.width, CV_MAKETYPE(cvType, dir.channels));
+        cv::Mat stripRaster = output.getMat();
+        const auto size = static_cast<libtiff::tmsize_t>(stripRaster.total() * stripRaster.elemSize());
+        countEncodedBytes(file, strip);
+        if (libtiff::TIFFReadEncodedStrip(file, strip, stripRaster.data, size) <= 0) {
+            RAISE_RUNTIME_ERROR << "TiffTools: Error by reading of tif strip " << strip
+                << " of directory " << dir.dirIndex;
+        }
+    }
+}
+
+size_t TiffTools::getDecodedBytes(const TiffDirectory& dir) {
+    const size_t sampleBytes = std::max(1, (dir.bitsPerSample + 7) / 8);
+    return static_cast<size_t>(dir.width) * dir.height * std::max(1, dir.channels) * sampleBytes;
+}
+
+void TiffTools::readStripedDirRegion(libtiff::TIFF* file, const TiffDirectory& dir, const cv::Rect& region,
+                                     cv::OutputArray output, TIFFHandlePool* handles) {
+    if (dir.tiled) {
+        RAISE_RUNTIME_ERROR << "TiffTools::readStripedDirRegion: Expected striped configuration, received tiled";
+    }
+    const cv::Rect dirRect(0, 0, dir.width, dir.height);
+    if ((region & dirRect) != region || region.empty()) {
+        RAISE_RUNTIME_ERROR << "TiffTools::readStripedDirRegion: Region (" << region.x << "," << region.y << ","
+            << region.width << "," << region.height << ") is outside of the directory " << dir.dirIndex;
+    }
+    const int rowsPerStrip = getRowsPerStrip(dir);
+    const cv::Range strips = getStripRange(dir, region);
+    output.create(region.size(), CV_MAKETYPE(CVTools::toOpencvType(dir.dataType), dir.channels));
+    cv::Mat regionRaster = output.getMat();
+
+    // strips are copied into disjoint rows of the region, so ranges need no lock
+    auto decodeStrips = [&](libtiff::TIFF* handle, int begin, int end) {
+        cv::Mat stripRaster;
+        for (int strip = begin; strip < end; ++strip) {
+            readStrip(handle, dir, strip, stripRaster);
+            const cv::Rect stripRect(0, strip * rowsPerStrip, dir.width, stripRaster.rows);
+            const cv::Rect intersection = stripRect & region;
+            const cv::Rect srcRect(intersection.x, intersection.y - stripRect.y, intersection.width, intersection.height);
+            const cv::Rect dstRect(intersection.x - region.x, intersection.y - region.y,
+                intersection.width, intersection.height);
+            stripRaster(srcRect).copyTo(regionRaster(dstRect));
+        }
+    };
+    const int minStripsPerRange = 4;
+    if (handles == nullptr || strips.size() < 2 * minStripsPerRange) {
+        decodeStrips(file, strips.start, strips.end);
+        return;
+    }
+    const ReadStatisticsTargets statisticsTargets = ReadStatisticsScope::current();
+    const double numRanges = static_cast<double>(strips.size() / minStripsPerRange);
+    cv::parallel_for_(cv::Range(strips.start, strips.end), [&](const cv::Range& range) {
+        ReadStatisticsScope statisticsScope;
+        statisticsScope.activate(statisticsTargets);
+        // libtiff handles are not thread-safe
+        TIFFHandlePool::Lease lease(*handles);
+        decodeStrips(lease.getHandle(), range.start, range.end);
+    }, numRanges);
+}
+
 void TiffTools::readTile(libtiff::TIFF* hFile, const TiffDirectory& dir, int tile,
                          const std::vector<int>& channelIndices, cv::OutputArray output) {
     if (!dir.tiled) {
         throw std::runtime_error("TiffTools: Expected tiled configuration, received striped");
     }
+    ReadStageTimer timer(ReadStage::Decode);
     setCurrentDirectory(hFile, dir);
+    if (dir.interleaved) {
+        countEncodedBytes(hFile, tile);
+    }
 
+    const bool jpeg = dir.compression == COMPRESSION_JPEG && dir.dataType == DataType::DT_Byte
+        && dir.channels == 3 && dir.interleaved;
+    const bool luminance = jpeg && isLuminanceRead(dir, channelIndices);
     if (dir.compression == 34712 || dir.compression == 33003 || dir.compression == 33005) {
         readJ2KTile(hFile, dir, tile, channelIndices, output);
     }
+    else if (luminance && (dir.photometric == PHOTOMETRIC_YCBCR || dir.photometric == PHOTOMETRIC_RGB)) {
+        readJpegTile(hFile, dir, tile, channelIndices, luminance, output);
+    }
     else if (dir.photometric == 6 || dir.photometric == 8 || dir.photometric == 9 || dir.photometric == 10) {
         readNotRGBTile(hFile, dir, tile, channelIndices, output);
     }
@@ -766,20 +963,7 @@ void TiffTools::readRegularTile(libtiff::TIFF* hFile, const TiffDirectory& dir,
             RAISE_RUNTIME_ERROR << "TiffTools: Error reading encoded tiff tile "
                 << tile << " of directory " << dir.dirIndex << ". Compression: " << dir.compression;
         }
-        if (channelIndices.empty() || (channelIndices.size() == 1 && dir.channels == 1)) {
-            tileRaster.copyTo(output);
-        }
-        else if (channelIndices.size() == 1) {
-            cv::extractChannel(tileRaster, output, channelIndices[0]);
-        }
-        else {
-            std::vector<cv::Mat> channelRasters;
-            channelRasters.resize(channelIndices.size());
-            for (int i = 0; i < static_cast<int>(channelIndices.size()); ++i) {
-                cv::extractChannel(tileRaster, channelRasters[i], channelIndices[i]);
-            }
-            cv::merge(channelRasters, output);
-        }
+        extractTileChannels(tileRaster, channelIndices, output);
     }
     else {
         std::vector<cv::Mat> channelRasters(channelIndices.size());
@@ -794,6 +978,7 @@ void TiffTools::readRegularTile(libtiff::TIFF* hFile, const TiffDirectory& dir,
             channelRasters[channelIndex].create(tileSize, CV_MAKETYPE(CVTools::toOpencvType(dt), 1));
             uint8_t* channelBegin = channelRasters[channelIndex].data;
             int tileRawNo = TIFFComputeTile(hFile, tileX, tileY, 0, channel);
+            countEncodedBytes(hFile, tileRawNo);
             auto readBytes = TIFFReadEncodedTile(hFile, tileRawNo, channelBegin, channelSize);
             if (readBytes != channelSize) {
                 RAISE_RUNTIME_ERROR << "TiffTools: Error reading encoded tiff tile "
@@ -824,6 +1009,57 @@ void TiffTools::readJ2KTile(libtiff::TIFF* hFile, const TiffDirectory& dir, int
     }
 }
 
+void TiffTools::readJpegTile(libtiff::TIFF* hFile, const TiffDirectory& dir, int tile,
+                             const std::vector<int>& channelIndices, bool luminance, cv::OutputArray output) {
+    const uint64_t rawSize = libtiff::TIFFGetStrileByteCount(hFile, tile);
+    if (rawSize == 0) {
+        RAISE_RUNTIME_ERROR << "TiffTools: Empty jpeg tile " << tile << " of directory " << dir.dirIndex;
+    }
+    std::vector<uint8_t> rawTile(rawSize);
+    const libtiff::tmsize_t readBytes = libtiff::TIFFReadRawTile(hFile, tile, rawTile.data(),
+                                                                 static_cast<libtiff::tmsize_t>(rawTile.size()));
+    if (readBytes <= 0) {
+        RAISE_RUNTIME_ERROR << "TiffTools: Error reading raw jpeg tile " << tile << " of directory " << dir.dirIndex;
+    }
+    JpegDecodeOptions options;
+    uint32_t tablesSize = 0;
+    void* tables = nullptr;
+    if (libtiff::TIFFGetField(hFile, TIFFTAG_JPEGTABLES, &tablesSize, &tables) && tables && tablesSize > 0) {
+        options.tables = static_cast<const uint8_t*>(tables);
+        options.tablesSize = tablesSize;
+    }
+    // libtiff does not convert the components of RGB tiles either
+    options.colorSpace = dir.photometric == PHOTOMETRIC_YCBCR ? JpegColorSpace::YCbCr : JpegColorSpace::RGB;
+    options.luminance = luminance;
+    cv::Mat tileRaster;
+    try {
+        jpeglibDecode(rawTile.data(), static_cast<size_t>(readBytes), tileRaster, options);
+    }
+    catch (std::runtime_error& er) {
+        RAISE_RUNTIME_ERROR << "TiffTools: Error decoding jpeg tile " << tile << " of directory "
+            << dir.dirIndex << ": " << er.what();
+    }
+    if (tileRaster.cols != dir.tileWidth || tileRaster.rows != dir.tileHeight) {
+        RAISE_RUNTIME_ERROR << "TiffTools: Unexpected size of jpeg tile " << tile << " of directory " << dir.dirIndex
+            << ": (" << tileRaster.cols << "," << tileRaster.rows << "). Expected: ("
+            << dir.tileWidth << "," << dir.tileHeight << ")";
+    }
+    if (luminance) {
+        // the luminance stands for every requested color channel
+        const size_t numChannels = channelIndices.empty() ? 3 : channelIndices.size();
+        if (numChannels == 1) {
+            tileRaster.copyTo(output);
+        }
+        else {
+            const std::vector<cv::Mat> channelRasters(numChannels, tileRaster);
+            cv::merge(channelRasters, output);
+        }
+    }
+    else {
+        extractTileChannels(tileRaster, channelIndices, output);
+    }
+}
+
 void TiffTools::readNotRGBTile(libtiff::TIFF* hFile, const TiffDirectory& dir, int tile,
                                const std::vector<int>& channelIndices, cv::OutputArray output) {
     cv::Size tileSize = {dir.tileWidth, dir.tileHeight};
@@ -945,32 +1181,47 @@ void TiffTools::setTags(libtiff::TIFF* tiff, const TiffDirectory& dir) {
     }
     libtiff::TIFFSetField(tiff, TIFFTAG_SOFTWARE, dir.software.c_str());
     libtiff::TIFFSetField(tiff, TIFFTAG_SUBFILETYPE, dir.subFileType);
-	uint16_t sampleFormat = 0;
-    switch (dir.dataType) {
+    const uint16_t sampleFormat = tiffSampleFormat(dir.dataType);
+    if (sampleFormat !=0 ) {
+        libtiff::TIFFSetField(tiff, TIFFTAG_SAMPLEFORMAT, sampleFormat);
+	}
+    if (dir.predictor > PREDICTOR_NONE) {
+        // tiles are written raw with the predictor already applied by the encoder
+        libtiff::TIFFSetField(tiff, TIFFTAG_PREDICTOR, static_cast<uint16_t>(dir.predictor));
+    }
+}
+
+uint16_t TiffTools::tiffCompression(Compression compression) {
+    return static_cast<uint16_t>(compressSlideioToTiff(compression));
+}
+
+uint16_t TiffTools::tiffBitsPerSample(DataType dt) {
+    return bitsPerSampleDataType(dt);
+}
+
+uint16_t TiffTools::tiffPhotometric(const TiffDirectory& dir) {
+    return computeDirectoryPhotometric(dir);
+}
+
+uint16_t TiffTools::tiffSampleFormat(DataType dt) {
+    switch (dt) {
     case DataType::DT_Byte:
     case DataType::DT_UInt16:
     case DataType::DT_UInt32:
     case DataType::DT_UInt64:
-        sampleFormat = SAMPLEFORMAT_UINT;
-        break;
+        return SAMPLEFORMAT_UINT;
     case DataType::DT_Int8:
     case DataType::DT_Int16:
     case DataType::DT_Int32:
     case DataType::DT_Int64:
-        sampleFormat = SAMPLEFORMAT_INT;
-        break;
+        return SAMPLEFORMAT_INT;
     case DataType::DT_Float16:
     case DataType::DT_Float32:
     case DataType::DT_Float64:
-        sampleFormat = SAMPLEFORMAT_IEEEFP;
-        break;
+        return SAMPLEFORMAT_IEEEFP;
     default:
-        break;
+        return 0;
     }
-
-    if (sampleFormat !=0 ) {
-        libtiff::TIFFSetField(tiff, TIFFTAG_SAMPLEFORMAT, sampleFormat);
-	}
 }
 
 void TiffTools::initSubDirs(libtiff::TIFF* tiff, int numDirs) {
@@ -1037,6 +1288,29 @@ void TiffTools::writeRawTile(libtiff::TIFF* tiff, int x, int y, const uint8_t* d
 	}
 }
 
+void TiffTools::writeRawTileReference(libtiff::TIFF* tiff, int x, int y, int sourceX, int sourceY) {
+    const uint32_t tile = libtiff::TIFFComputeTile(tiff, x, y, 0, 0);
+    const uint32_t sourceTile = libtiff::TIFFComputeTile(tiff, sourceX, sourceY, 0, 0);
+    const uint32_t numTiles = libtiff::TIFFNumberOfTiles(tiff);
+    if (tile >= numTiles || sourceTile >= numTiles) {
+        RAISE_RUNTIME_ERROR << "TiffTools: invalid tile reference (" << x << "," << y << ") -> ("
+            << sourceX << "," << sourceY << ")";
+    }
+    // libtiff has no setter for the tile arrays, but returns the arrays of the directory being
+    // written: entries changed before TIFFWriteDirectory are written to the file as they are
+    uint64_t* offsets = nullptr;
+    uint64_t* byteCounts = nullptr;
+    if (!libtiff::TIFFGetField(tiff, TIFFTAG_TILEOFFSETS, &offsets) || offsets == nullptr
+        || !libtiff::TIFFGetField(tiff, TIFFTAG_TILEBYTECOUNTS, &byteCounts) || byteCounts == nullptr) {
+        RAISE_RUNTIME_ERROR << "TiffTools: tile arrays of the current directory are not available";
+    }
+    if (byteCounts[sourceTile] == 0) {
+        RAISE_RUNTIME_ERROR << "TiffTools: referenced tile (" << sourceX << "," << sourceY << ") is not written";
+    }
+    offsets[tile] = offsets[sourceTile];
+    byteCounts[tile] = byteCounts[sourceTile];
+}
+
 void TiffTools::setCurrentDirectory(libtiff::TIFF* hFile, const TiffDirectory& dir) {
     uint64_t offset = libtiff::TIFFCurrentDirOffset(hFile);
     if (offset != dir.byteOffset) {
@@ -1143,3 +1417,46 @@ void TiffTools::readTiledDir(libtiff::TIFF* tiff, const TiffDirectory& dir, cv::
     SLIDEIO_LOG(INFO) << "TiffTools::readTiledDir: Successfully read tiled directory "
         << dir.dirIndex << " (" << tilesAcross << "x" << tilesDown << " tiles)";
 }
+
+void TiffTools::readTiledDirRegion(libtiff::TIFF* tiff, const TiffDirectory& dir, const cv::Rect& region,
+                                   cv::OutputArray output) {
+    if (!dir.tiled) {
+        RAISE_RUNTIME_ERROR << "TiffTools::readTiledDirRegion: Expected tiled configuration, received striped";
+    }
+    const cv::Rect dirRect(0, 0, dir.width, dir.height);
+    if ((region & dirRect) != region || region.empty()) {
+        RAISE_RUNTIME_ERROR << "TiffTools::readTiledDirRegion: Region (" << region.x << "," << region.y << ","
+            << region.width << "," << region.height << ") is outside of the directory " << dir.dirIndex;
+    }
+    setCurrentDirectory(tiff, dir);
+
+    const int tilesAcross = (dir.width + dir.tileWidth - 1) / dir.tileWidth;
+    const int firstCol = region.x / dir.tileWidth;
+    const int lastCol = (region.x + region.width - 1) / dir.tileWidth;
+    const int firstRow = region.y / dir.tileHeight;
+    const int lastRow = (region.y + region.height - 1) / dir.tileHeight;
+
+    const int cvType = CVTools::toOpencvType(dir.dataType);
+    output.create(region.size(), CV_MAKETYPE(cvType, dir.channels));
+    cv::Mat regionMat = output.getMat();
+
+    // only tiles intersecting the region are decoded
+    cv::Mat tileMat;
+    const std::vector<int> channelIndices;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int col = firstCol; col <= lastCol; ++col) {
+            const int tileIndex = row * tilesAcross + col;
+            const cv::Rect tileRect(col * dir.tileWidth, row * dir.tileHeight, dir.tileWidth, dir.tileHeight);
+            const cv::Rect intersection = tileRect & region;
+            readTile(tiff, dir, tileIndex, channelIndices, tileMat);
+            if (tileMat.empty()) {
+                RAISE_RUNTIME_ERROR << "TiffTools::readTiledDirRegion: Empty tile read at index " << tileIndex;
+            }
+            const cv::Rect srcRect(intersection.x - tileRect.x, intersection.y - tileRect.y,
+                intersection.width, intersection.height);
+            const cv::Rect dstRect(intersection.x - region.x, intersection.y - region.y,
+                intersection.width, intersection.height);
+            tileMat(srcRect).copyTo(regionMat(dstRect));
+        }
+    }
+}
@@ -23,6 +23,8 @@ namespace libtiff
 
 namespace slideio
 {
+    class TIFFHandlePool;
+
     struct TiffDirectory
     {
         int width = 0;
@@ -50,6 +52,7 @@ namespace slideio
         int stripSize = 0;
         int compressionQuality = 0;
         uint64_t byteOffset = 0;
+        int predictor = 0;
     };
 
     SLIDEIO_IMAGETOOLS_EXPORTS std::ostream& operator<<(std::ostream& os, const TiffDirectory& dir);
@@ -71,7 +74,20 @@ namespace slideio
         static void readDirRaster(const std::string& filePath, int dir, cv::OutputArray output);
         static void readDirRaster(libtiff::TIFF* tiff, const TiffDirectory& dir, cv::OutputArray output);
         static void readTiledDir(libtiff::TIFF* tiff, const TiffDirectory& dir, cv::OutputArray output);
+        static void readTiledDirRegion(libtiff::TIFF* tiff, const TiffDirectory& dir, const cv::Rect& region,
+            cv::OutputArray output);
         static void readStripedDir(libtiff::TIFF* file, const slideio::TiffDirectory& dir, cv::OutputArray output);
+        // Decodes only the strips covering the region. With a handle pool, groups of strips are
+        // decoded in parallel, each through a handle of the pool.
+        static void readStripedDirRegion(libtiff::TIFF* file, const slideio::TiffDirectory& dir, const cv::Rect& region,
+            cv::OutputArray output, TIFFHandlePool* handles = nullptr);
+        // Bytes of the decoded raster of the directory.
+        static size_t getDecodedBytes(const slideio::TiffDirectory& dir);
+        // Decodes a single strip: rows [strip*rowsPerStrip, (strip+1)*rowsPerStrip) of the directory.
+        static void readStrip(libtiff::TIFF* file, const slideio::TiffDirectory& dir, int strip, cv::OutputArray output);
+        static int getRowsPerStrip(const slideio::TiffDirectory& dir);
+        // Strips covering rows of the region, as a range of strip indices.
+        static cv::Range getStripRange(const slideio::TiffDirectory& dir, const cv::Rect& region);
         static void readTile(libtiff::TIFF* hFile, const slideio::TiffDirectory& dir, int tile,
             const std::vector<int>& channelIndices, cv::OutputArray output);
         static void setCurrentDirectory(libtiff::TIFF* hFile, const slideio::TiffDirectory& dir);
@@ -83,14 +99,26 @@ namespace slideio
             const std::vector<int>& channelIndices, cv::OutputArray output);
         static void readNotRGBTile(libtiff::TIFF* hFile, const slideio::TiffDirectory& dir, int tile,
             const std::vector<int>& channelIndices, cv::OutputArray output);
+        // Decodes a JPEG tile with libjpeg instead of libtiff. readTile uses it under
+        // DecodeHint::Luminance, where color tiles decode the luminance only.
+        static void readJpegTile(libtiff::TIFF* hFile, const slideio::TiffDirectory& dir, int tile,
+            const std::vector<int>& channelIndices, bool luminance, cv::OutputArray output);
         static void writeDirectory(libtiff::TIFF* tiff);
         static void setTags(libtiff::TIFF* tiff, const TiffDirectory& dir);
         static void initSubDirs(libtiff::TIFF* tiff, int numDirs);
+        // Tag values setTags derives from a directory; shared with writers that bypass libtiff.
+        static uint16_t tiffCompression(Compression compression);
+        static uint16_t tiffBitsPerSample(DataType dt);
+        static uint16_t tiffPhotometric(const TiffDirectory& dir);
+        static uint16_t tiffSampleFormat(DataType dt);
         static void writeTile(libtiff::TIFF* tiff, int x, int y, Compression compression,
             const cv::Mat& tileRaster, const EncodeParameters& parameters,
             uint8_t* buffer=nullptr, int bufferSize=0);
         static std::string readStringTag(libtiff::TIFF* tiff, uint16_t tag);
         static int getNumberOfDirectories(libtiff::TIFF* tiff);
         static void writeRawTile(libtiff::TIFF* tiff, int x, int y, const uint8_t* data, int size);
+        // Points the tile at (x, y) to the bytes of the tile at (sourceX, sourceY) already written to
+        // the current directory: no data is written, both tiles share one offset and byte count.
+        static void writeRawTileReference(libtiff::TIFF* tiff, int x, int y, int sourceX, int sourceY);
     };
 }
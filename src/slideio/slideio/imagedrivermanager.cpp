@@ -5,6 +5,7 @@
 
 #include "slideio/base/exceptions.hpp"
 #include "slideio/core/imagedriver.hpp"
+#include "slideio/core/tools/tracing.hpp"
 #include "slideio/drivers/afi/afiimagedriver.hpp"
 #include "slideio/drivers/czi/cziimagedriver.hpp"
 #include "slideio/drivers/dcm/dcmimagedriver.hpp"
@@ -130,6 +131,7 @@ void ImageDriverManager::initialize()
 std::shared_ptr<CVSlide> ImageDriverManager::openSlide(const std::string& filePath, const std::string& driverName)
 {
     static bool initLog = false;
+    TraceScope trace("open slide", "slide");
     initialize();
     std::shared_ptr<slideio::ImageDriver> driver;
     if(driverName.compare("AUTO")==0 || driverName.empty()) {
@@ -165,4 +167,49 @@ void ImageDriverManager::setLogLevel(const std::string &level) {
 std::string ImageDriverManager::getVersion()
 {
 	return SLIDEIO_VERSION;
+}
+
+void ImageDriverManager::setReadStatisticsEnabled(bool enabled)
+{
+    ReadStatistics::setEnabled(enabled);
+}
+
+bool ImageDriverManager::isReadStatisticsEnabled()
+{
+    return ReadStatistics::isEnabled();
+}
+
+const ReadStatistics& ImageDriverManager::getDriverReadStatistics(const std::string& driverId)
+{
+    return ReadStatistics::forDriver(driverId);
+}
+
+const ReadStatistics& ImageDriverManager::getCompressionReadStatistics(Compression compression)
+{
+    return ReadStatistics::forCompression(compression);
+}
+
+std::string ImageDriverManager::getReadStatisticsJson(int indent)
+{
+    return ReadStatistics::aggregatesToJson(indent);
+}
+
+void ImageDriverManager::resetReadStatistics()
+{
+    ReadStatistics::resetAggregates();
+}
+
+void ImageDriverManager::startTracing(const std::string& filePath)
+{
+    Tracer::start(filePath);
+}
+
+void ImageDriverManager::stopTracing()
+{
+    Tracer::stop();
+}
+
+bool ImageDriverManager::isTracingEnabled()
+{
+    return Tracer::isEnabled();
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "slideio/slideio/slideio_def.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
 #include <map>
 #include <vector>
 #include <string>
@@ -48,6 +49,36 @@ namespace slideio
          */
         static void setLogLevel(const std::string& level);
 		static std::string getVersion();
+        /**@brief switches collection of read statistics on or off for all scenes.
+         *
+         * Collection is off by default. While it is off, reads only pay for a check of
+         * the flag.
+         */
+        static void setReadStatisticsEnabled(bool enabled);
+        static bool isReadStatisticsEnabled();
+        /**@brief returns read statistics aggregated over all scenes of a driver. */
+        static const ReadStatistics& getDriverReadStatistics(const std::string& driverId);
+        /**@brief returns read statistics aggregated over all scenes with a compression. */
+        static const ReadStatistics& getCompressionReadStatistics(Compression compression);
+        /**@brief returns the aggregated read statistics of all drivers and compressions
+         * as a json document, for export to a metrics system.
+         */
+        static std::string getReadStatisticsJson(int indent = -1);
+        /**@brief resets the aggregated read statistics. Statistics of scenes are reset
+         * by Scene::resetReadStatistics.
+         */
+        static void resetReadStatistics();
+        /**@brief starts recording a trace of reads and conversions.
+         *
+         * The trace is written by stopTracing in the Chrome trace event format, which
+         * chrome://tracing and the Perfetto UI open. Setting the environment variable
+         * SLIDEIO_TRACE_FILE to a file path traces the whole process instead.
+         * @param filePath : path of the trace file.
+         */
+        static void startTracing(const std::string& filePath);
+        /**@brief stops tracing and writes the trace file.*/
+        static void stopTracing();
+        static bool isTracingEnabled();
     protected:
         static void initialize();
     private:
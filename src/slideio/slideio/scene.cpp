@@ -145,15 +145,16 @@ void Scene::readBlockChannels(const std::tuple<int, int, int, int>& blockRect, c
 }
 
 void Scene::readResampledBlock(const std::tuple<int, int, int, int>& blockRect, const std::tuple<int, int>& blockSize,
-    void* buffer, size_t bufferSize)
+    void* buffer, size_t bufferSize, ResamplingPolicy policy)
 {
     SLIDEIO_LOG(INFO) << "Scene::readResampledBlock ";// << blockRect << "," << blockSize;
     const std::vector<int> channelIndices;
-    return readResampledBlockChannels(blockRect, blockSize, channelIndices, buffer, bufferSize);
+    return readResampledBlockChannels(blockRect, blockSize, channelIndices, buffer, bufferSize, policy);
 }
 
 void Scene::readResampledBlockChannels(const std::tuple<int, int, int, int>& rect,
-                                       const std::tuple<int, int>& size, const std::vector<int>& channelIndices, void* buffer, size_t bufferSize)
+                                       const std::tuple<int, int>& size, const std::vector<int>& channelIndices, void* buffer, size_t bufferSize,
+                                       ResamplingPolicy policy)
 {
     SLIDEIO_LOG(INFO) << "Scene::readResampledBlockChannels ";// << rect << "," << size << "," << channelIndices;
     cv::Rect blockRect = tupleToRect(rect);
@@ -172,7 +173,7 @@ void Scene::readResampledBlockChannels(const std::tuple<int, int, int, int>& rec
     }
     cv::Mat raster(blockSize.height, blockSize.width, CV_MAKETYPE(cvType, numChannels), buffer);
     raster = cv::Scalar(0);
-    m_scene->readResampledBlockChannels(blockRect, blockSize, channelIndices, raster);
+    m_scene->readResampledBlockChannels(blockRect, blockSize, channelIndices, raster, policy);
 
     if(buffer!=raster.data)
     {
@@ -201,17 +202,17 @@ void Scene::read4DBlockChannels(const std::tuple<int, int, int, int>& blockRect,
 
 void Scene::readResampled4DBlock(const std::tuple<int, int, int, int>& blockRect, const std::tuple<int, int>& blockSize,
     const std::tuple<int, int>& zSliceRange, const std::tuple<int, int>& timeFrameRange, void* buffer,
-    size_t bufferSize)
+    size_t bufferSize, ResamplingPolicy policy)
 {
     SLIDEIO_LOG(INFO) << "Scene::readResampled4DBlock ";// << blockRect << "," << zSliceRange << "," << timeFrameRange;
     const std::vector<int> channelIndices;
-    return readResampled4DBlockChannels(blockRect, blockSize, channelIndices, zSliceRange, timeFrameRange, buffer, bufferSize);
+    return readResampled4DBlockChannels(blockRect, blockSize, channelIndices, zSliceRange, timeFrameRange, buffer, bufferSize, policy);
 }
 
 void Scene::readResampled4DBlockChannels(const std::tuple<int, int, int, int>& rect,
     const std::tuple<int, int>& size, const std::vector<int>& channelIndices,
     const std::tuple<int, int>& zSliceRange, const std::tuple<int, int>& timeFrameRange, void* buffer,
-    size_t bufferSize)
+    size_t bufferSize, ResamplingPolicy policy)
 {
     SLIDEIO_LOG(INFO) << "Scene::readResampled4DBlockChannels ";// << rect << "," << size << "," << channelIndices << "," << zSliceRange << "," << timeFrameRange;
     cv::Rect blockRect = tupleToRect(rect);
@@ -234,7 +235,7 @@ void Scene::readResampled4DBlockChannels(const std::tuple<int, int, int, int>& r
 
     cv::Mat raster(blockSize.height, blockSize.width, CV_MAKETYPE(static_cast<int>(cvType), numPlanes), buffer);
     if (numSlices==1 && numFrames==1) {
-        m_scene->readResampled4DBlockChannels(blockRect, blockSize, channelIndices, sliceRange, frameRange, raster);
+        m_scene->readResampled4DBlockChannels(blockRect, blockSize, channelIndices, sliceRange, frameRange, raster, policy);
         if (buffer != raster.data) {
             RAISE_RUNTIME_ERROR << "Unexpected memory reallocation";
         }
@@ -254,7 +255,7 @@ void Scene::readResampled4DBlockChannels(const std::tuple<int, int, int, int>& r
         }
         int planeNum(0);
         uint8_t* planeBegin = static_cast<uint8_t*>(buffer);
-        m_scene->readResampled4DBlockChannels(blockRect, blockSize, channelIndices, sliceRange, frameRange, mdRaster);
+        m_scene->readResampled4DBlockChannels(blockRect, blockSize, channelIndices, sliceRange, frameRange, mdRaster, policy);
         for (int tfIndex = frameRange.start; tfIndex < frameRange.end; ++tfIndex)
         {
             if(frameIndex>=0) {
@@ -385,7 +386,7 @@ int Scene::getNumAuxImages() const
     return m_scene->getNumAuxImages();
 }
 
-std::string Scene::getRawMetadata() const
+const std::string& Scene::getRawMetadata() const
 {
     SLIDEIO_LOG(INFO) << "Scene::getRawMetadata "; 
     return m_scene->getRawMetadata();
@@ -402,6 +403,16 @@ const slideio::Metadata& slideio::Scene::getMetadata() const
     return m_scene->getMetadata();
 }
 
+const ReadStatistics& Scene::getReadStatistics() const
+{
+    return m_scene->getReadStatistics();
+}
+
+void Scene::resetReadStatistics()
+{
+    m_scene->resetReadStatistics();
+}
+
 std::shared_ptr<Scene> Scene::getAuxImage(const std::string& sceneName) const
 {
     SLIDEIO_LOG(INFO) << "Scene::getAuxImage " << sceneName; 
@@ -6,6 +6,7 @@
 #include "slideio/slideio/slideio_def.hpp"
 #include "slideio/base/slideio_enums.hpp"
 #include "slideio/core/metadata.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
 #include <string>
 #include <vector>
 #include <memory>
@@ -144,8 +145,11 @@ namespace slideio
          *
          * All channels have to be of the same type. The method will throw an error by attempt to put read several channels of different types in one block.
          * The raster will be placed in the memory buffer. Memory layout of the buffer is described in the #readBlock method.
+         * @param policy : trade-off between speed and quality of the resampling. It selects
+         * the zoom level the block is read from and the interpolation, see ResamplingPolicy.
          */
-        void readResampledBlock(const std::tuple<int,int,int,int>& blockRect, const std::tuple<int,int>& blockSize, void* buffer, size_t bufferSize);
+        void readResampledBlock(const std::tuple<int,int,int,int>& blockRect, const std::tuple<int,int>& blockSize, void* buffer, size_t bufferSize,
+            ResamplingPolicy policy = ResamplingPolicy::Balanced);
         /**@brief reads raster rectangle plane image combined from selected channels and resizes it to the size specified in the parameters.
          *
          * @param blockRect : rectangle of the block to be read. The rectangle is represented by @b std::tuple<x,y,with,height>. Here:
@@ -161,8 +165,11 @@ namespace slideio
          *
          * All channels have to be of the same type. The method will throw an error by attempt to put read several channels of different types in one block.
          * The raster will be placed in the memory buffer. Memory layout of the buffer is described in the #readBlock method.
+         * @param policy : trade-off between speed and quality of the resampling. It selects
+         * the zoom level the block is read from and the interpolation, see ResamplingPolicy.
          */
-        void readResampledBlockChannels(const std::tuple<int,int,int,int>& blockRect, const std::tuple<int,int>& blockSize, const std::vector<int>& channelIndices, void* buffer, size_t bufferSize);
+        void readResampledBlockChannels(const std::tuple<int,int,int,int>& blockRect, const std::tuple<int,int>& blockSize, const std::vector<int>& channelIndices, void* buffer, size_t bufferSize,
+            ResamplingPolicy policy = ResamplingPolicy::Balanced);
         /**@brief reads multi-dimensional raster block to a memory buffer.
          *
          * @param blockRect : rectangle of the block to be read. The rectangle is represented by std::tuple(x,y,with,height). Here:
@@ -237,8 +244,11 @@ namespace slideio
          * All channels have to be of the same type. The method will throw an error by attempt to put read several channels of different types in one block.
          * The raster will be placed in the memory buffer. The raster is organized as a continuous multi-dimensional array.
          * Memory layout is the same as in #read4DBlock method.
+         * @param policy : trade-off between speed and quality of the resampling. It selects
+         * the zoom level the block is read from and the interpolation, see ResamplingPolicy.
          */
-        void readResampled4DBlock(const std::tuple<int,int,int,int>& blockRect, const std::tuple<int,int>& blockSize, const std::tuple<int,int>& zSliceRange, const std::tuple<int,int>& timeFrameRange, void* buffer, size_t bufferSize);
+        void readResampled4DBlock(const std::tuple<int,int,int,int>& blockRect, const std::tuple<int,int>& blockSize, const std::tuple<int,int>& zSliceRange, const std::tuple<int,int>& timeFrameRange, void* buffer, size_t bufferSize,
+            ResamplingPolicy policy = ResamplingPolicy::Balanced);
         /**@brief reads selected channels of multi-dimensional raster block to a memory buffer with resizing to the specified size.
          *
          * @param blockRect : rectangle of the block to be read. The rectangle is represented by std::tuple(x,y,with,height). Here:
@@ -256,8 +266,11 @@ namespace slideio
          * All channels have to be of the same type. The method will throw an error by attempt to put read several channels of different types in one block.
          * The raster will be placed in the memory buffer. The raster is organized as a continuous multi-dimensional array.
          * Memory layout is the same as in #read4DBlock method.
+         * @param policy : trade-off between speed and quality of the resampling. It selects
+         * the zoom level the block is read from and the interpolation, see ResamplingPolicy.
          */
-        void readResampled4DBlockChannels(const std::tuple<int,int,int,int>& blockRect, const std::tuple<int,int>& blockSize, const std::vector<int>& channelIndices, const std::tuple<int,int>& zSliceRange, const std::tuple<int,int>& timeFrameRange, void* buffer, size_t bufferSize);
+        void readResampled4DBlockChannels(const std::tuple<int,int,int,int>& blockRect, const std::tuple<int,int>& blockSize, const std::vector<int>& channelIndices, const std::tuple<int,int>& zSliceRange, const std::tuple<int,int>& timeFrameRange, void* buffer, size_t bufferSize,
+            ResamplingPolicy policy = ResamplingPolicy::Balanced);
         /**@brief reads a raster rectangle from an explicitly selected zoom level into a memory buffer.
          *
          * Unlike the readBlock family, this method reads from the level named by @p level
@@ -296,12 +309,22 @@ namespace slideio
         virtual const std::list<std::string>& getAuxImageNames() const;
         /**@brief returns number of auxiliary images available for the scene.*/
         virtual int getNumAuxImages() const;
-        /**@brief returns string of serialized metadata. Content of the string depends on image format.*/
-        std::string getRawMetadata() const;
+        /**@brief returns string of serialized metadata. Content of the string depends on image format.
+         * The reference stays valid while the scene exists.*/
+        const std::string& getRawMetadata() const;
 		/**@brief returns metadata format of the scene. */
 		MetadataFormat getMetadataFormat() const;
         /**@brief returns metadata as a navigable tree. Built lazily on first call. */
         const Metadata& getMetadata() const;
+        /**@brief returns counters (tiles decoded, bytes read, cache hits) and per stage
+         * latency histograms of the reads of the scene.
+         *
+         * Statistics are collected only while collection is switched on with
+         * slideio::setReadStatisticsEnabled. Use ReadStatistics::toJson for export.
+         */
+        const ReadStatistics& getReadStatistics() const;
+        /**@brief resets the read statistics of the scene. */
+        void resetReadStatistics();
         /**@brief returns a slideio::Scene object that represents an auxiliary image.
          * @param imageName : name of the auxiliary image.
          */
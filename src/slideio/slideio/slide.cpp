@@ -3,6 +3,7 @@
 // of this distribution and at http://slideio.com/license.html.
 #include "slideio/slideio/slide.hpp"
 #include "slideio/core/cvslide.hpp"
+#include "slideio/core/cvscene.hpp"
 #include "slideio/base/log.hpp"
 
 using namespace slideio;
@@ -92,3 +93,23 @@ void Slide::setDriverId(const std::string& driverId) {
 const std::string& Slide::getDriverId() const {
 	return m_slide->getDriverId();
 }
+
+bool Slide::releaseFileHandles()
+{
+    if (m_reopenListener.expired()) {
+        return m_slide->releaseFileHandles();
+    }
+    // scenes are marked before the close too: a read between the close and the marks
+    // reopens the files as well
+    auto markScenes = [this]() {
+        for (int index = 0; index < m_slide->getNumScenes(); ++index) {
+            m_slide->getScene(index)->notifyNextReopen(m_reopenListener);
+        }
+    };
+    markScenes();
+    const bool released = m_slide->releaseFileHandles();
+    if (released) {
+        markScenes();
+    }
+    return released;
+}
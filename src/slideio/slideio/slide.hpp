@@ -19,6 +19,7 @@
 namespace slideio
 {
     class CVSlide;
+    class FileReopenListener;
     /** @brief Slide class is an interface for accessing the information on a medical slide. 
 
     Slide class is an interface for accessing the information on a medical  Slide class represents a medical slide. 
@@ -29,6 +30,7 @@ namespace slideio
     class SLIDEIO_EXPORTS Slide
     {
         friend SLIDEIO_EXPORTS std::shared_ptr<Slide> openSlide(const std::string& path, const std::string& driver);
+        friend class SlidePool;
     private:
         /** Constructor of the class. 
         @param slide : object of a CVSlide class created by a corresponding ImageDriver object. */
@@ -72,8 +74,16 @@ namespace slideio
         void setDriverId(const std::string& driverId);
         /**@brief The method returns the id of the image driver that opened the slide.*/
         const std::string& getDriverId() const;
+        /**@brief Closes the files kept open by the slide. The parsed structure is kept and
+         * the next read reopens the files transparently.
+         *
+         *Returns false if a read is running; the files it uses stay open then.*/
+        bool releaseFileHandles();
     private:
         std::shared_ptr<CVSlide> m_slide;
+        // notified by the first read of a scene after releaseFileHandles; set by the pool
+        // before the slide is shared
+        std::weak_ptr<FileReopenListener> m_reopenListener;
     };
 }
 
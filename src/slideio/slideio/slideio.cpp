@@ -3,6 +3,7 @@
 // of this distribution and at http://slideio.org/license.html.
 #include "slideio/slideio/slideio.hpp"
 #include "slideio/slideio/imagedrivermanager.hpp"
+#include "slideio/slideio/slidepool.hpp"
 
 using namespace slideio;
 
@@ -14,6 +15,11 @@ std::shared_ptr<slideio::Slide> slideio::openSlide(const std::string& path, cons
     return slide;
 }
 
+std::shared_ptr<slideio::Slide> slideio::openPooledSlide(const std::string& path, const std::string& driver)
+{
+    return SlidePool::getDefault().getSlide(path, driver);
+}
+
 std::vector<std::string> slideio::getDriverIDs()
 {
     return ImageDriverManager::getDriverIDs();
@@ -27,4 +33,19 @@ void slideio::setLogLevel(const std::string& level)
 std::string slideio::getVersion()
 {
     return ImageDriverManager::getVersion();
+}
+
+void slideio::setReadStatisticsEnabled(bool enabled)
+{
+    ImageDriverManager::setReadStatisticsEnabled(enabled);
+}
+
+void slideio::startTracing(const std::string& filePath)
+{
+    ImageDriverManager::startTracing(filePath);
+}
+
+void slideio::stopTracing()
+{
+    ImageDriverManager::stopTracing();
 }
\ No newline at end of file
@@ -100,11 +100,22 @@ namespace  slideio
     if the id is unknown or if no driver accepts the file.
     */
     SLIDEIO_EXPORTS std::shared_ptr<Slide> openSlide(const std::string& path, const std::string& driver= "");
+    /**@brief Returns a slide from the library slide pool (SlidePool::getDefault), opening it on
+    the first request. Parameters are as for openSlide. */
+    SLIDEIO_EXPORTS std::shared_ptr<Slide> openPooledSlide(const std::string& path, const std::string& driver = "");
     /**@brief Returns a list of available driver ids. */
     SLIDEIO_EXPORTS std::vector<std::string> getDriverIDs();
     /**@brief Sets the log level for the library.*/
     SLIDEIO_EXPORTS void setLogLevel(const std::string& level);
     /**@brief returns version of the library.*/
     SLIDEIO_EXPORTS std::string getVersion();
+    /**@brief Switches collection of read statistics on or off. See Scene::getReadStatistics
+    and ImageDriverManager::getReadStatisticsJson. */
+    SLIDEIO_EXPORTS void setReadStatisticsEnabled(bool enabled);
+    /**@brief Starts recording a Chrome trace of reads and conversions into a file.
+    See ImageDriverManager::startTracing. */
+    SLIDEIO_EXPORTS void startTracing(const std::string& filePath);
+    /**@brief Stops tracing and writes the trace file.*/
+    SLIDEIO_EXPORTS void stopTracing();
 
 }
\ No newline at end of file
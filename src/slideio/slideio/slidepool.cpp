@@ -0,0 +1,310 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "slideio/slideio/slidepool.hpp"
+#include "slideio/slideio/slide.hpp"
+#include "slideio/slideio/imagedrivermanager.hpp"
+#include "slideio/core/cvslide.hpp"
+#include "slideio/core/cvscene.hpp"
+#include "slideio/base/exceptions.hpp"
+#include "slideio/base/log.hpp"
+#include <chrono>
+#include <vector>
+
+using namespace slideio;
+
+namespace
+{
+    // The slide of a finished open, nullptr if the open is running or failed.
+    std::shared_ptr<Slide> getOpenedSlide(const std::shared_future<std::shared_ptr<Slide>>& future) {
+        if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return nullptr;
+        }
+        try {
+            return future.get();
+        }
+        catch (...) {
+            return nullptr;
+        }
+    }
+}
+
+// Reports the reads that reopen the files of a pooled slide. Detached when the slide
+// leaves the pool; a notification running meanwhile finishes first.
+class SlidePool::ReopenListener : public FileReopenListener
+{
+public:
+    ReopenListener(SlidePool* pool, const Key& key) : m_pool(pool), m_key(key) {}
+    void onFilesReopened() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pool == nullptr) {
+            return;
+        }
+        try {
+            m_pool->onSlideReopened(m_key);
+        }
+        catch (const std::exception& ex) {
+            SLIDEIO_LOG(WARNING) << "SlidePool: cannot apply the open file budget: " << ex.what();
+        }
+    }
+    void detach() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pool = nullptr;
+    }
+private:
+    std::mutex m_mutex;
+    SlidePool* m_pool;
+    const Key m_key;
+};
+
+SlidePool::SlidePool(size_t maxSlides, size_t maxOpenSlides) :
+    m_maxSlides(maxSlides),
+    m_maxOpenSlides(maxOpenSlides)
+{
+    if (maxSlides == 0) {
+        RAISE_RUNTIME_ERROR << "SlidePool: the maximal number of slides must be positive";
+    }
+}
+
+SlidePool::~SlidePool()
+{
+    for (auto& item : m_entries) {
+        item.second.listener->detach();
+    }
+}
+
+SlidePool& SlidePool::getDefault()
+{
+    static SlidePool pool;
+    return pool;
+}
+
+SlidePool::Key SlidePool::makeKey(const std::string& filePath, const std::string& driver)
+{
+    return Key(filePath, driver.empty() ? std::string("AUTO") : driver);
+}
+
+std::shared_ptr<Slide> SlidePool::getSlide(const std::string& filePath, const std::string& driver)
+{
+    const Key key = makeKey(filePath, driver);
+    std::promise<std::shared_ptr<Slide>> promise;
+    SlideFuture future;
+    std::shared_ptr<ReopenListener> listener;
+    bool opener = false;
+    std::list<std::pair<Key, std::shared_ptr<Slide>>> coldSlides;
+    std::vector<Entry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            Entry& entry = it->second;
+            m_order.splice(m_order.begin(), m_order, entry.position);
+            if (!entry.open) {
+                // the files are reopened by the next read of the caller
+                entry.open = true;
+                ++m_numOpenSlides;
+            }
+            future = entry.slide;
+        }
+        else {
+            opener = true;
+            m_order.push_front(key);
+            Entry entry;
+            entry.slide = promise.get_future().share();
+            entry.listener = std::make_shared<ReopenListener>(this, key);
+            entry.position = m_order.begin();
+            entry.open = true;
+            future = entry.slide;
+            listener = entry.listener;
+            m_entries.emplace(key, std::move(entry));
+            ++m_numOpenSlides;
+        }
+        coldSlides = enforceLimits(evicted);
+    }
+    detachEntries(evicted);
+    closeSlides(coldSlides);
+    if (opener) {
+        // the slide is opened without the lock: requests of other slides do not wait for it
+        try {
+            std::shared_ptr<CVSlide> cvSlide = ImageDriverManager::openSlide(filePath, key.second);
+            std::shared_ptr<Slide> slide(new Slide(cvSlide));
+            slide->m_reopenListener = listener;
+            promise.set_value(slide);
+        }
+        catch (...) {
+            promise.set_exception(std::current_exception());
+            // a failed open is not kept: the next request tries again
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(key);
+            // unless the slide was evicted and is being opened again by another request
+            if (it != m_entries.end()
+                && it->second.slide.wait_for(std::chrono::seconds(0)) == std::future_status::ready
+                && getOpenedSlide(it->second.slide) == nullptr) {
+                if (it->second.open) {
+                    --m_numOpenSlides;
+                }
+                m_order.erase(it->second.position);
+                m_entries.erase(it);
+            }
+        }
+    }
+    return future.get();
+}
+
+std::list<std::pair<SlidePool::Key, std::shared_ptr<Slide>>> SlidePool::enforceLimits(std::vector<Entry>& evicted)
+{
+    while (m_entries.size() > m_maxSlides) {
+        auto it = m_entries.find(m_order.back());
+        if (it->second.open) {
+            --m_numOpenSlides;
+        }
+        // detached and destroyed by the caller after the lock is released
+        evicted.push_back(std::move(it->second));
+        m_entries.erase(it);
+        m_order.pop_back();
+    }
+    std::list<std::pair<Key, std::shared_ptr<Slide>>> coldSlides;
+    for (auto position = m_order.rbegin(); m_numOpenSlides > m_maxOpenSlides && position != m_order.rend();
+         ++position) {
+        Entry& entry = m_entries.at(*position);
+        if (!entry.open) {
+            continue;
+        }
+        std::shared_ptr<Slide> slide = getOpenedSlide(entry.slide);
+        if (!slide) {
+            continue;
+        }
+        entry.open = false;
+        --m_numOpenSlides;
+        coldSlides.emplace_back(*position, slide);
+    }
+    return coldSlides;
+}
+
+void SlidePool::detachEntries(std::vector<Entry>& entries)
+{
+    for (Entry& entry : entries) {
+        entry.listener->detach();
+    }
+    entries.clear();
+}
+
+void SlidePool::onSlideReopened(const Key& key)
+{
+    std::list<std::pair<Key, std::shared_ptr<Slide>>> coldSlides;
+    std::vector<Entry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) {
+            return;
+        }
+        Entry& entry = it->second;
+        m_order.splice(m_order.begin(), m_order, entry.position);
+        if (!entry.open) {
+            entry.open = true;
+            ++m_numOpenSlides;
+        }
+        coldSlides = enforceLimits(evicted);
+    }
+    detachEntries(evicted);
+    closeSlides(coldSlides);
+}
+
+void SlidePool::closeSlides(const std::list<std::pair<Key, std::shared_ptr<Slide>>>& slides)
+{
+    for (const auto& item : slides) {
+        bool released = false;
+        try {
+            released = item.second->releaseFileHandles();
+        }
+        catch (const std::exception& ex) {
+            SLIDEIO_LOG(WARNING) << "SlidePool: cannot close files of slide " << item.first.first << ": " << ex.what();
+        }
+        if (!released) {
+            // a read is running: the slide keeps its files and stays counted as open
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(item.first);
+            if (it != m_entries.end() && !it->second.open) {
+                it->second.open = true;
+                ++m_numOpenSlides;
+            }
+        }
+    }
+}
+
+void SlidePool::setLimits(size_t maxSlides, size_t maxOpenSlides)
+{
+    if (maxSlides == 0) {
+        RAISE_RUNTIME_ERROR << "SlidePool: the maximal number of slides must be positive";
+    }
+    std::list<std::pair<Key, std::shared_ptr<Slide>>> coldSlides;
+    std::vector<Entry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxSlides = maxSlides;
+        m_maxOpenSlides = maxOpenSlides;
+        coldSlides = enforceLimits(evicted);
+    }
+    detachEntries(evicted);
+    closeSlides(coldSlides);
+}
+
+size_t SlidePool::getMaxSlides() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxSlides;
+}
+
+size_t SlidePool::getMaxOpenSlides() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxOpenSlides;
+}
+
+size_t SlidePool::getNumSlides() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+size_t SlidePool::getNumOpenSlides() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_numOpenSlides;
+}
+
+void SlidePool::remove(const std::string& filePath, const std::string& driver)
+{
+    std::vector<Entry> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(makeKey(filePath, driver));
+        if (it == m_entries.end()) {
+            return;
+        }
+        if (it->second.open) {
+            --m_numOpenSlides;
+        }
+        m_order.erase(it->second.position);
+        removed.push_back(std::move(it->second));
+        m_entries.erase(it);
+    }
+    // the slide is detached and destroyed after the lock is released
+    detachEntries(removed);
+}
+
+void SlidePool::clear()
+{
+    std::map<Key, Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        entries.swap(m_entries);
+        m_order.clear();
+        m_numOpenSlides = 0;
+    }
+    // the slides are detached and destroyed after the lock is released
+    for (auto& item : entries) {
+        item.second.listener->detach();
+    }
+}
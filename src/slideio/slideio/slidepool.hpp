@@ -0,0 +1,99 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+
+#include "slideio/slideio/slideio_def.hpp"
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#pragma warning( push )
+#pragma warning(disable: 4251)
+#endif
+
+namespace slideio
+{
+    class Slide;
+    /**@brief SlidePool keeps opened slides for reuse, keyed by file path and driver id.
+     *
+     * Opening a slide parses its structure. The pool keeps up to maxSlides parsed slides
+     * and evicts the least recently requested one beyond that. To bound the number of open
+     * files, only the maxOpenSlides most recently requested slides keep their files open:
+     * colder slides close them (Slide::releaseFileHandles) but keep their parsed structure,
+     * and the next read reopens them transparently. A read that reopens the files of a
+     * cold slide makes it the most recently used one and closes the files of the slides
+     * beyond the limit at once. Slides of drivers that cannot close their files, and slides
+     * being read, stay counted as open. A slide held by a caller stays valid after eviction;
+     * its reads are no longer counted then. The methods of the class are thread-safe.
+     */
+    class SLIDEIO_EXPORTS SlidePool
+    {
+    public:
+        static constexpr size_t DEFAULT_MAX_SLIDES = 1024;
+        static constexpr size_t DEFAULT_MAX_OPEN_SLIDES = 128;
+    public:
+        explicit SlidePool(size_t maxSlides = DEFAULT_MAX_SLIDES, size_t maxOpenSlides = DEFAULT_MAX_OPEN_SLIDES);
+        SlidePool(const SlidePool&) = delete;
+        SlidePool& operator=(const SlidePool&) = delete;
+        ~SlidePool();
+        /**@brief returns the pooled slide, opening it on the first request.
+         *
+         * Concurrent first requests of a slide open it once.
+         * @param filePath : path of the slide file/folder.
+         * @param driver : driver id as for slideio::openSlide; empty or "AUTO" selects the
+         * driver by the file.
+         */
+        std::shared_ptr<Slide> getSlide(const std::string& filePath, const std::string& driver = "");
+        /**@brief changes the limits; slides beyond them are evicted or closed at once. */
+        void setLimits(size_t maxSlides, size_t maxOpenSlides);
+        size_t getMaxSlides() const;
+        size_t getMaxOpenSlides() const;
+        /**@brief returns the number of slides kept by the pool. */
+        size_t getNumSlides() const;
+        /**@brief returns the number of pooled slides that keep their files open. */
+        size_t getNumOpenSlides() const;
+        /**@brief removes a slide from the pool. */
+        void remove(const std::string& filePath, const std::string& driver = "");
+        void clear();
+        /**@brief returns the pool shared by the users of the library. */
+        static SlidePool& getDefault();
+    private:
+        using Key = std::pair<std::string, std::string>;
+        using SlideFuture = std::shared_future<std::shared_ptr<Slide>>;
+        class ReopenListener;
+        struct Entry
+        {
+            SlideFuture slide;
+            std::shared_ptr<ReopenListener> listener;
+            std::list<Key>::iterator position;
+            bool open = false;
+        };
+        static Key makeKey(const std::string& filePath, const std::string& driver);
+        // Drops the least recently requested slides beyond the limits into evicted. Slides
+        // that must close their files are returned, to be closed without holding the lock.
+        std::list<std::pair<Key, std::shared_ptr<Slide>>> enforceLimits(std::vector<Entry>& evicted);
+        void closeSlides(const std::list<std::pair<Key, std::shared_ptr<Slide>>>& slides);
+        // Detaches the listeners of dropped entries; called without holding the lock.
+        static void detachEntries(std::vector<Entry>& entries);
+        void onSlideReopened(const Key& key);
+    private:
+        mutable std::mutex m_mutex;
+        size_t m_maxSlides;
+        size_t m_maxOpenSlides;
+        size_t m_numOpenSlides = 0;
+        // Most recently requested first
+        std::list<Key> m_order;
+        std::map<Key, Entry> m_entries;
+    };
+}
+
+#if defined(_MSC_VER)
+#pragma warning( pop )
+#endif
@@ -20,5 +20,10 @@ std::vector<DataType> BilateralFilter::computeChannelDataTypes(const std::vector
 int BilateralFilter::getInflationValue() const
 {
     const int d = getDiameter();
-    return d > 0 ? ((d + 1) / 2) : 7;
+    if (d > 0) {
+        return (d + 1) / 2;
+    }
+    // radius cv::bilateralFilter derives from sigmaSpace when the diameter is not set
+    const double sigmaSpace = getSigmaSpace() > 0 ? getSigmaSpace() : 1.;
+    return std::max(1, cvRound(sigmaSpace * 1.5));
 }
@@ -0,0 +1,144 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#include "slideio/transformer/chainexecutor.hpp"
+#include "slideio/transformer/transformationex.hpp"
+#include "slideio/transformer/transformationtype.hpp"
+#include "slideio/base/exceptions.hpp"
+#include <algorithm>
+#include <climits>
+
+using namespace slideio;
+
+namespace
+{
+    // Header of rows of a raster without the surrounding rows: filters extrapolate
+    // the border at the edges of the rows instead of reading the rest of the raster.
+    cv::Mat isolatedRows(const cv::Mat& raster, int first, int count) {
+        return cv::Mat(count, raster.cols, raster.type(), const_cast<uchar*>(raster.ptr(first)), raster.step);
+    }
+}
+
+ChainExecutor::ChainExecutor(const std::list<std::shared_ptr<Transformation>>& transformations, size_t bandBytes) :
+    m_bandBytes(bandBytes), m_local(isLocal(transformations))
+{
+    for (const auto& transformation : transformations) {
+        const TransformationEx* transformationEx = dynamic_cast<const TransformationEx*>(transformation.get());
+        if (!transformationEx) {
+            RAISE_RUNTIME_ERROR << "ChainExecutor: invalid Transformation";
+        }
+        Stage stage;
+        stage.transformation = transformationEx;
+        stage.halo = transformationEx->getInflationValue();
+        m_stages.push_back(stage);
+    }
+    int remainingHalo = 0;
+    for (auto stage = m_stages.rbegin(); stage != m_stages.rend(); ++stage) {
+        stage->remainingHalo = remainingHalo;
+        remainingHalo += stage->halo;
+    }
+}
+
+bool ChainExecutor::isLocal(const std::list<std::shared_ptr<Transformation>>& transformations)
+{
+    for (const auto& transformation : transformations) {
+        if (transformation->getType() == TransformationType::CannyFilter) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int ChainExecutor::getBandRows(const cv::Mat& block) const
+{
+    const size_t rowBytes = std::max<size_t>(1, static_cast<size_t>(block.cols) * block.channels() * sizeof(float));
+    return std::max(MIN_BAND_ROWS, static_cast<int>(std::min<size_t>(m_bandBytes / rowBytes, INT_MAX)));
+}
+
+void ChainExecutor::run(const cv::Mat& block, cv::OutputArray output)
+{
+    const int bandRows = getBandRows(block);
+    if (m_stages.empty() || !m_local || block.rows <= bandRows) {
+        runWhole(block, output);
+        return;
+    }
+    const int height = block.rows;
+    for (auto& stage : m_stages) {
+        stage.first = 0;
+        stage.count = 0;
+    }
+    const size_t lastStage = m_stages.size() - 1;
+    cv::Mat target;
+    for (int bandEnd = bandRows; ; bandEnd = std::min(height, bandEnd + bandRows)) {
+        // input of the current stage: the block, then the rows kept by the previous stage
+        const cv::Mat* input = &block;
+        int inputFirst = 0;
+        for (size_t index = 0; index < m_stages.size(); ++index) {
+            Stage& stage = m_stages[index];
+            const int done = stage.first + stage.count;
+            const int needed = std::min(height, bandEnd + stage.remainingHalo);
+            if (needed > done) {
+                const int inputBegin = std::max(0, done - stage.halo);
+                const int inputEnd = std::min(height, needed + stage.halo);
+                stage.transformation->applyTransformation(
+                    isolatedRows(*input, inputBegin - inputFirst, inputEnd - inputBegin), stage.result);
+                const cv::Mat computed = stage.result.rowRange(done - inputBegin, needed - inputBegin);
+                if (index == lastStage) {
+                    if (target.empty()) {
+                        output.create(block.size(), computed.type());
+                        target = output.getMat();
+                    }
+                    computed.copyTo(target.rowRange(done, needed));
+                    stage.count = needed;
+                }
+                else {
+                    // the next stage starts its next input at keepFrom
+                    const Stage& next = m_stages[index + 1];
+                    const int keepFrom = std::max(0, next.first + next.count - next.halo);
+                    appendRows(stage, computed, keepFrom, bandRows + 2 * stage.remainingHalo);
+                }
+            }
+            input = &stage.rows;
+            inputFirst = stage.first;
+        }
+        if (bandEnd == height) {
+            break;
+        }
+    }
+}
+
+void ChainExecutor::appendRows(Stage& stage, const cv::Mat& computed, int keepFrom, int capacity)
+{
+    const int shift = keepFrom - stage.first;
+    const int kept = stage.count - shift;
+    if (shift > 0) {
+        // rows move up: a row is read before it is overwritten
+        for (int row = 0; row < kept; ++row) {
+            stage.rows.row(shift + row).copyTo(stage.rows.row(row));
+        }
+    }
+    const int required = kept + computed.rows;
+    if (stage.rows.rows < required || stage.rows.cols != computed.cols || stage.rows.type() != computed.type()) {
+        cv::Mat rows(std::max(required, capacity), computed.cols, computed.type());
+        if (kept > 0) {
+            stage.rows.rowRange(0, kept).copyTo(rows.rowRange(0, kept));
+        }
+        stage.rows = rows;
+    }
+    computed.copyTo(stage.rows.rowRange(kept, required));
+    stage.first = keepFrom;
+    stage.count = required;
+}
+
+void ChainExecutor::runWhole(const cv::Mat& block, cv::OutputArray output)
+{
+    // the stages write to the buffers in turn
+    const cv::Mat* source = &block;
+    int target = 0;
+    for (const auto& stage : m_stages) {
+        stage.transformation->applyTransformation(*source, m_buffers[target]);
+        source = &m_buffers[target];
+        target = 1 - target;
+    }
+    source->copyTo(output);
+}
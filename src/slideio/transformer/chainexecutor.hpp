@@ -0,0 +1,72 @@
+// This file is part of slideio project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://slideio.com/license.html.
+#pragma once
+#include "slideio/transformer/transformer_def.hpp"
+#include <opencv2/core.hpp>
+#include <list>
+#include <memory>
+#include <vector>
+
+#if defined(_MSC_VER)
+#pragma warning( push )
+#pragma warning(disable: 4251)
+#endif
+
+namespace slideio
+{
+    class Transformation;
+    class TransformationEx;
+
+    // Runs a chain of transformations over a block in bands of rows. Every stage keeps
+    // the rows of its output the next stage still needs (the inflation value of the next
+    // stage above the next band), so a band is transformed by all stages while it stays
+    // in the cache and no full-size intermediate is allocated. The band buffers are
+    // reused by the following blocks. Blocks not taller than a band, and chains with
+    // a non-local transformation, are transformed as a whole, stage by stage.
+    // An executor must not be used by several threads at once.
+    class SLIDEIO_TRANSFORMER_EXPORTS ChainExecutor
+    {
+    public:
+        // Bytes of a band of one stage: a band, the output of the stage for it and the
+        // rows kept by the stage fit an L2 cache.
+        static constexpr size_t DEFAULT_BAND_BYTES = 256 * 1024;
+        static constexpr int MIN_BAND_ROWS = 8;
+    public:
+        explicit ChainExecutor(const std::list<std::shared_ptr<Transformation>>& transformations,
+            size_t bandBytes = DEFAULT_BAND_BYTES);
+        void run(const cv::Mat& block, cv::OutputArray output);
+        // Rows of a band for the block; 32 bits per channel are assumed for the outputs
+        // of the stages.
+        int getBandRows(const cv::Mat& block) const;
+        // False if a transformation needs more than its inflation value around a pixel
+        // (Canny edge tracking): the chain can be split neither in bands nor in tiles.
+        static bool isLocal(const std::list<std::shared_ptr<Transformation>>& transformations);
+    private:
+        struct Stage
+        {
+            const TransformationEx* transformation = nullptr;
+            // Inflation value of the stage and of the following stages
+            int halo = 0;
+            int remainingHalo = 0;
+            // Rows [first, first + count) of the output of the stage
+            cv::Mat rows;
+            int first = 0;
+            int count = 0;
+            // Output of the stage for its input rows
+            cv::Mat result;
+        };
+        void runWhole(const cv::Mat& block, cv::OutputArray output);
+        // Replaces the rows before keepFrom with the computed rows.
+        static void appendRows(Stage& stage, const cv::Mat& computed, int keepFrom, int capacity);
+    private:
+        std::vector<Stage> m_stages;
+        size_t m_bandBytes;
+        bool m_local;
+        cv::Mat m_buffers[2];
+    };
+}
+
+#if defined(_MSC_VER)
+#pragma warning( pop )
+#endif
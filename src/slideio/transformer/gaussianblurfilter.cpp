@@ -6,6 +6,17 @@
 
 using namespace slideio;
 
+namespace
+{
+    // Size of the kernel cv::GaussianBlur derives from sigma when the size is not set:
+    // a radius of 3 sigma for 8-bit images and 4 sigma for other depths. The depth is
+    // not known here, so the larger radius is taken.
+    int kernelSizeFromSigma(double sigma)
+    {
+        return cvRound(sigma * 4 * 2 + 1) | 1;
+    }
+}
+
 void GaussianBlurFilter::applyTransformation(const cv::Mat& block, cv::OutputArray transformedBlock) const
 {
     cv::GaussianBlur(block, transformedBlock, cv::Size(getKernelSizeX(), getKernelSizeY()), getSigmaX(), getSigmaY());
@@ -13,11 +24,17 @@ void GaussianBlurFilter::applyTransformation(const cv::Mat& block, cv::OutputArr
 
 int GaussianBlurFilter::getInflationValue() const
 {
-    int kernel = std::max(getKernelSizeX(), getKernelSizeY());
-    if (kernel == 0) {
-        kernel = (int)ceil(2 *
-            ceil(2 * std::max(getSigmaX(), getSigmaY())) + 1);
+    const double sigmaX = getSigmaX();
+    const double sigmaY = getSigmaY() > 0 ? getSigmaY() : sigmaX;
+    int kernelX = getKernelSizeX();
+    int kernelY = getKernelSizeY();
+    if (kernelX <= 0 && sigmaX > 0) {
+        kernelX = kernelSizeFromSigma(sigmaX);
+    }
+    if (kernelY <= 0 && sigmaY > 0) {
+        kernelY = kernelSizeFromSigma(sigmaY);
     }
+    const int kernel = std::max(kernelX, kernelY);
     const int extension = (kernel + 1) / 2;
     return extension;
 }
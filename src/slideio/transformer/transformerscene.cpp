@@ -4,17 +4,34 @@
 #include "transformerscene.hpp"
 
 #include "transformationex.hpp"
+#include "chainexecutor.hpp"
+#include "colortransformation.hpp"
 #include "transformertools.hpp"
+#include "transformations.hpp"
 #include "slideio/base/exceptions.hpp"
+#include "slideio/core/tools/readstatistics.hpp"
+#include "slideio/core/tools/tools.hpp"
+#include <opencv2/core/utility.hpp>
+#include <mutex>
+#include <string>
 
 using namespace slideio;
 
 TransformerScene::TransformerScene(std::shared_ptr<CVScene> originScene,
                                    const std::list<std::shared_ptr<Transformation>>& list) :
-    m_originScene(originScene), m_transformations(list), m_inflationValue(0)
+    m_originScene(originScene), m_inflationValue(0)
 {
+    // the scene keeps copies: the cached tiles stay valid if the caller changes
+    // the parameters of its transformations
+    for (const auto& transformation : list) {
+        if (!transformation) {
+            RAISE_RUNTIME_ERROR << "TransformScene: invalid Transformation";
+        }
+        m_transformations.push_back(makeTransformationCopy(*transformation));
+    }
     initChannels();
     computeInflationValue();
+    computeDecodeHint();
 }
 
 std::string TransformerScene::getFilePath() const
@@ -90,13 +107,43 @@ double TransformerScene::getTFrameResolution() const
     return m_originScene->getTFrameResolution();
 }
 
-std::string TransformerScene::getRawMetadata() const
+const std::string& TransformerScene::getRawMetadata() const
 {
     return m_originScene->getRawMetadata();
 }
 
 void TransformerScene::readResampledBlockChannelsEx(const cv::Rect& blockRect, const cv::Size& blockSize,
     const std::vector<int>& componentIndices, int zSliceIndex, int tFrameIndex, cv::OutputArray output)
+{
+    const cv::Rect sceneRect(cv::Point(0, 0), getRect().size());
+    const bool cached = m_tileable && blockRect.size() == blockSize && (blockRect & sceneRect) == blockRect;
+    auto readBlock = [&](cv::OutputArray target) {
+        if (cached) {
+            readCachedBlock(blockRect, zSliceIndex, tFrameIndex, target);
+        }
+        else {
+            readTransformedBlock(blockRect, blockSize, zSliceIndex, tFrameIndex, target);
+        }
+    };
+    if (componentIndices.empty()) {
+        // the tiles are written straight into the output
+        readBlock(output);
+        return;
+    }
+    cv::Mat block;
+    readBlock(block);
+    Tools::extractChannels(block, componentIndices, output);
+}
+
+void TransformerScene::readSourceBlock(const cv::Rect& blockRect, const cv::Size& blockSize, int zSliceIndex,
+    int tFrameIndex, cv::OutputArray output)
+{
+    DecodeHintScope decodeHint(m_decodeHint);
+    getOriginScene()->readResampledBlockChannelsEx(blockRect, blockSize, {}, zSliceIndex, tFrameIndex, output);
+}
+
+void TransformerScene::readTransformedBlock(const cv::Rect& blockRect, const cv::Size& blockSize,
+    int zSliceIndex, int tFrameIndex, cv::OutputArray output)
 {
     cv::Rect extendedBlockRect;
     cv::Size extendedBlockSize;
@@ -106,34 +153,117 @@ void TransformerScene::readResampledBlockChannelsEx(const cv::Rect& blockRect, c
     TransformerTools::computeInflatedRectParams(sceneSize, blockRect, m_inflationValue, blockSize, extendedBlockRect,
         extendedBlockSize, blockPosition);
     cv::Mat sourceBlock;
-    getOriginScene()->readResampledBlockChannelsEx(extendedBlockRect, extendedBlockSize, {}, zSliceIndex,
-        tFrameIndex, sourceBlock);
+    readSourceBlock(extendedBlockRect, extendedBlockSize, zSliceIndex, tFrameIndex, sourceBlock);
 
-    for (const auto& transformation : m_transformations) {
-        cv::Mat targetBlock;
-        TransformationEx * transformationEx = dynamic_cast<TransformationEx*>(transformation.get());
-        if(!transformationEx) {
-            RAISE_RUNTIME_ERROR << "TransformScene: invalid Transformation";
+    const cv::Rect rectInInflatedRect(blockPosition, blockSize);
+    if (!m_tileable) {
+        ChainExecutor executor(m_transformations);
+        cv::Mat transformed;
+        executor.run(sourceBlock, transformed);
+        transformed(rectInInflatedRect).copyTo(output);
+        return;
+    }
+    std::vector<cv::Rect> tileRects;
+    for (int y = 0; y < blockSize.height; y += TILE_SIZE) {
+        for (int x = 0; x < blockSize.width; x += TILE_SIZE) {
+            const cv::Rect tileRect(blockPosition.x + x, blockPosition.y + y,
+                std::min(TILE_SIZE, blockSize.width - x), std::min(TILE_SIZE, blockSize.height - y));
+            tileRects.push_back(tileRect);
         }
-        transformationEx->applyTransformation(sourceBlock,targetBlock);
-        targetBlock.copyTo(sourceBlock);
     }
+    // the output is created with the type of the first transformed tile
+    std::once_flag created;
+    cv::Mat block;
+    transformTiles(sourceBlock, tileRects, [&](int index, const cv::Mat& tile) {
+        std::call_once(created, [&]() {
+            output.create(blockSize, tile.type());
+            block = output.getMat();
+        });
+        tile.copyTo(block(tileRects[index] - blockPosition));
+    });
+}
 
-    cv::Rect rectInInflatedRect = cv::Rect(blockPosition.x, blockPosition.y, blockSize.width, blockSize.height);
-    cv::Mat block = sourceBlock(rectInInflatedRect);
-    if(componentIndices.empty()) {
-        block.copyTo(output);
+void TransformerScene::readCachedBlock(const cv::Rect& blockRect, int zSliceIndex, int tFrameIndex,
+    cv::OutputArray output)
+{
+    const cv::Rect sceneRect(cv::Point(0, 0), getRect().size());
+    const std::string prefix = std::to_string(zSliceIndex) + ":" + std::to_string(tFrameIndex) + ":";
+    std::vector<cv::Rect> tileRects;
+    std::vector<std::string> tileKeys;
+    const int firstRow = blockRect.y / TILE_SIZE;
+    const int lastRow = (blockRect.y + blockRect.height - 1) / TILE_SIZE;
+    const int firstColumn = blockRect.x / TILE_SIZE;
+    const int lastColumn = (blockRect.x + blockRect.width - 1) / TILE_SIZE;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            tileRects.push_back(cv::Rect(column * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE) & sceneRect);
+            tileKeys.push_back(prefix + std::to_string(column) + ":" + std::to_string(row));
+        }
     }
-    else {
-        std::vector<cv::Mat> channels;
-        cv::split(block, channels);
-        std::vector<cv::Mat> selectedChannels;
-        selectedChannels.reserve(componentIndices.size());
-        for (const auto index : componentIndices) {
-            selectedChannels.push_back(channels[index]);
+    // the output is created with the type of the first tile, cached or transformed
+    std::once_flag created;
+    cv::Mat block;
+    auto copyTile = [&](size_t index, const cv::Mat& tile) {
+        std::call_once(created, [&]() {
+            output.create(blockRect.size(), tile.type());
+            block = output.getMat();
+        });
+        const cv::Rect intersection = tileRects[index] & blockRect;
+        tile(intersection - tileRects[index].tl()).copyTo(block(intersection - blockRect.tl()));
+    };
+    std::vector<size_t> missingTiles;
+    cv::Rect missingRect;
+    for (size_t index = 0; index < tileRects.size(); ++index) {
+        cv::Mat tile;
+        if (m_tileCache.find(tileKeys[index], tile)) {
+            copyTile(index, tile);
+        }
+        else {
+            missingTiles.push_back(index);
+            missingRect |= tileRects[index];
         }
-        cv::merge(selectedChannels, output);
     }
+    if (missingTiles.empty()) {
+        return;
+    }
+    // the missing tiles are transformed from a single read of the origin scene
+    cv::Rect sourceRect(missingRect.x - m_inflationValue, missingRect.y - m_inflationValue,
+        missingRect.width + 2 * m_inflationValue, missingRect.height + 2 * m_inflationValue);
+    sourceRect &= sceneRect;
+    cv::Mat sourceBlock;
+    readSourceBlock(sourceRect, sourceRect.size(), zSliceIndex, tFrameIndex, sourceBlock);
+    std::vector<cv::Rect> rectsInSource;
+    rectsInSource.reserve(missingTiles.size());
+    for (const size_t index : missingTiles) {
+        rectsInSource.push_back(tileRects[index] - sourceRect.tl());
+    }
+    transformTiles(sourceBlock, rectsInSource, [&](int missing, const cv::Mat& tile) {
+        // the cache keeps its own copy of the tile; the output gets the part of the block
+        const size_t index = missingTiles[missing];
+        copyTile(index, m_tileCache.put(tileKeys[index], tile.clone()));
+    });
+}
+
+void TransformerScene::transformTiles(const cv::Mat& sourceBlock, const std::vector<cv::Rect>& tileRects,
+    const std::function<void(int, const cv::Mat&)>& store) const
+{
+    const cv::Rect sourceRect(cv::Point(0, 0), sourceBlock.size());
+    const ReadStatisticsTargets statisticsTargets = ReadStatisticsScope::current();
+    cv::parallel_for_(cv::Range(0, static_cast<int>(tileRects.size())), [&](const cv::Range& range) {
+        ReadStatisticsScope statisticsScope;
+        statisticsScope.activate(statisticsTargets);
+        // the band buffers are reused by the tiles of the range
+        ChainExecutor executor(m_transformations);
+        cv::Mat transformed;
+        for (int index = range.start; index < range.end; ++index) {
+            const cv::Rect& tileRect = tileRects[index];
+            cv::Rect haloRect(tileRect.x - m_inflationValue, tileRect.y - m_inflationValue,
+                tileRect.width + 2 * m_inflationValue, tileRect.height + 2 * m_inflationValue);
+            haloRect &= sourceRect;
+            executor.run(sourceBlock(haloRect), transformed);
+            store(index, transformed(tileRect - haloRect.tl()));
+        }
+    });
 }
 
 void TransformerScene::initChannels()
@@ -164,4 +294,23 @@ void TransformerScene::computeInflationValue()
         }
         m_inflationValue += transformationEx->getInflationValue();
     }
+    m_tileable = !m_transformations.empty() && ChainExecutor::isLocal(m_transformations);
+}
+
+void TransformerScene::computeDecodeHint()
+{
+    m_decodeHint = DecodeHint::None;
+    if (m_transformations.empty() || m_originScene->getNumChannels() != 3) {
+        return;
+    }
+    for (int channel = 0; channel < 3; ++channel) {
+        if (m_originScene->getChannelDataType(channel) != DataType::DT_Byte) {
+            return;
+        }
+    }
+    const ColorTransformation* colorTransformation =
+        dynamic_cast<const ColorTransformation*>(m_transformations.front().get());
+    if (colorTransformation && colorTransformation->getColorSpace() == ColorSpace::GRAY) {
+        m_decodeHint = DecodeHint::Luminance;
+    }
 }
@@ -3,7 +3,10 @@
 // of this distribution and at http://slideio.com/license.html.
 #pragma once
 #include "slideio/core/cvscene.hpp"
+#include "slideio/core/tools/decodehint.hpp"
+#include "slideio/core/tools/rastercache.hpp"
 #include "transformer_def.hpp"
+#include <functional>
 
 #if defined(_MSC_VER)
 #pragma warning( push )
@@ -14,9 +17,18 @@ namespace slideio
 {
     class Transformation;
 
+    // Scene that applies a chain of transformations to the blocks of the origin scene.
+    // Blocks are transformed in tiles of TILE_SIZE pixels in parallel; each tile is
+    // extended by the inflation value of the chain, so the tiles give the pixels of the
+    // whole block. A ChainExecutor runs the chain over the rows of a tile in bands.
+    // Tiles of blocks read at full resolution are kept in a cache for overlapping
+    // requests.
     class SLIDEIO_TRANSFORMER_EXPORTS TransformerScene : public CVScene
     {
     public:
+        static constexpr int TILE_SIZE = 256;
+    public:
+        // The scene transforms with copies of the transformations of the list.
         TransformerScene(std::shared_ptr<CVScene> originScene, const std::list<std::shared_ptr<Transformation>>& list);
     public:
         std::string getFilePath() const override;
@@ -34,21 +46,43 @@ namespace slideio
         std::string getChannelName(int channel) const override;
         double getZSliceResolution() const override;
         double getTFrameResolution() const override;
-        std::string getRawMetadata() const override;
+        const std::string& getRawMetadata() const override;
         void readResampledBlockChannelsEx(const cv::Rect& blockRect, const cv::Size& blockSize,
             const std::vector<int>& componentIndices, int zSliceIndex, int tFrameIndex,
             cv::OutputArray output) override;
         std::shared_ptr<CVScene> getOriginScene() const {
             return m_originScene;
         }
+        const RasterCache& getTileCache() const {
+            return m_tileCache;
+        }
     private:
         void initChannels();
         void computeInflationValue();
+        void computeDecodeHint();
+        void readSourceBlock(const cv::Rect& blockRect, const cv::Size& blockSize, int zSliceIndex,
+            int tFrameIndex, cv::OutputArray output);
+        // Transforms blockRect of the scene at the size blockSize.
+        void readTransformedBlock(const cv::Rect& blockRect, const cv::Size& blockSize, int zSliceIndex,
+            int tFrameIndex, cv::OutputArray output);
+        // Transforms blockRect of the scene at full resolution from the cached tiles.
+        void readCachedBlock(const cv::Rect& blockRect, int zSliceIndex, int tFrameIndex, cv::OutputArray output);
+        // Transforms the tiles (rectangles of sourceBlock) in parallel. store receives the
+        // index and the pixels of each tile on the thread that transformed it.
+        void transformTiles(const cv::Mat& sourceBlock, const std::vector<cv::Rect>& tileRects,
+            const std::function<void(int, const cv::Mat&)>& store) const;
     private:
         std::shared_ptr<CVScene> m_originScene;
         std::list<std::shared_ptr<Transformation>> m_transformations;
         std::vector<DataType> m_channelDataTypes;
         int m_inflationValue;
+        // Hint for the reads of the origin scene: the luminance suffices if the chain
+        // starts with a conversion of an 8-bit RGB image to grayscale.
+        DecodeHint m_decodeHint = DecodeHint::None;
+        // False if a transformation is not local (Canny edge tracking): the block is then
+        // transformed as a whole.
+        bool m_tileable = false;
+        RasterCache m_tileCache;
     };
 }
 
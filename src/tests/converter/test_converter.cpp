@@ -52,6 +52,49 @@ TEST(Converter, convertGDALJpeg) {
 	EXPECT_LE(0.99, sim);
 }
 
+TEST(Converter, convertGDALJpegParallelWriting) {
+	std::string path = TestTools::getTestImagePath("gdal", "Airbus_Pleiades_50cm_8bit_RGB_Yogyakarta.jpg");
+	SlidePtr slide = slideio::openSlide(path, "GDAL");
+	ScenePtr scene = slide->getScene(0);
+	ASSERT_TRUE(scene.get() != nullptr);
+	auto sceneRect = scene->getRect();
+	int sceneWidth = std::get<2>(sceneRect);
+	int sceneHeight = std::get<3>(sceneRect);
+
+	slideio::TempFile tmp("svs");
+	std::string outputPath = tmp.getPath().string();
+	if (std::filesystem::exists(outputPath)) {
+		std::filesystem::remove(outputPath);
+	}
+	slideio::converter::SVSJpegConverterParameters parameters;
+	parameters.setQuality(99);
+	parameters.setTileWidth(128);
+	parameters.setTileHeight(128);
+	parameters.setNumEncodingThreads(4);
+	parameters.setParallelWriting(true);
+	slideio::converter::convertScene(scene, parameters, outputPath, 1);
+
+	std::vector<slideio::TiffDirectory> dirs;
+	slideio::TiffTools::scanFile(outputPath, dirs);
+	ASSERT_GT(dirs.size(), 1);
+	EXPECT_EQ(sceneWidth, dirs[0].width);
+	EXPECT_EQ(sceneHeight, dirs[0].height);
+	EXPECT_EQ(128, dirs[0].tileWidth);
+	EXPECT_EQ(slideio::Compression::Jpeg, dirs[0].slideioCompression);
+
+	SlidePtr svsSlide = slideio::openSlide(outputPath, "SVS");
+	ScenePtr svsScene = svsSlide->getScene(0);
+	int dataSize = sceneHeight * sceneWidth * scene->getNumChannels();
+	std::vector<uint8_t> svsBuffer(dataSize);
+	svsScene->readBlock(sceneRect, svsBuffer.data(), svsBuffer.size());
+	std::vector<uint8_t> gdalBuffer(dataSize);
+	scene->readBlock(sceneRect, gdalBuffer.data(), gdalBuffer.size());
+	cv::Mat svsImage(sceneHeight, sceneWidth, CV_8UC3, svsBuffer.data());
+	cv::Mat gdalImage(sceneHeight, sceneWidth, CV_8UC3, gdalBuffer.data());
+	double sim = slideio::ImageTools::computeSimilarity(svsImage, gdalImage);
+	EXPECT_LE(0.99, sim);
+}
+
 TEST(Converter, convertGDALJp2K)
 {
 	std::string path = TestTools::getTestImagePath("gdal", "Airbus_Pleiades_50cm_8bit_RGB_Yogyakarta.jpg");
@@ -527,6 +527,8 @@ TEST(ConverterParametersTests, CopyConstructor_JP2KParameters) {
     jp2kParams->setSubSamplingDx(2);
     jp2kParams->setSubSamplingDy(2);
     jp2kParams->setCodecFormat(JP2KEncodeParameters::Codec::J2KFile);
+    jp2kParams->setHighThroughput(true);
+    jp2kParams->setQuantizationStep(0.005f);
     
     ConverterParameters copy(original);
     
@@ -537,6 +539,8 @@ TEST(ConverterParametersTests, CopyConstructor_JP2KParameters) {
     EXPECT_EQ(2, copiedParams->getSubSamplingDx());
     EXPECT_EQ(2, copiedParams->getSubSamplingDy());
     EXPECT_EQ(JP2KEncodeParameters::Codec::J2KFile, copiedParams->getCodecFormat());
+    EXPECT_TRUE(copiedParams->getHighThroughput());
+    EXPECT_FLOAT_EQ(0.005f, copiedParams->getQuantizationStep());
     
     // Verify it's a deep copy
     jp2kParams->setCompressionRate(0.75f);
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 //#include <opencv2/highgui.hpp>
+#include <opencv2/imgproc.hpp>
 
 #include "tests/testlib/testtools.hpp"
 #include "slideio/converter/convertertools.hpp"
@@ -233,3 +234,28 @@ TEST(ConverterTools, computeZoomLevelRect)
 	}
 }
 
+
+TEST(ConverterTools, isBackgroundTile)
+{
+    cv::Scalar value;
+    cv::Mat uniform(256, 256, CV_8UC3, cv::Scalar(240, 238, 242));
+    EXPECT_TRUE(ConverterTools::isBackgroundTile(uniform, 0, value));
+    EXPECT_EQ(cv::Scalar(240, 238, 242), value);
+
+    cv::Mat noisy(256, 256, CV_8UC3);
+    cv::randu(noisy, cv::Scalar(239, 237, 241), cv::Scalar(242, 240, 244));
+    EXPECT_FALSE(ConverterTools::isBackgroundTile(noisy, 0, value));
+    EXPECT_TRUE(ConverterTools::isBackgroundTile(noisy, 2, value));
+    EXPECT_NEAR(240., value[0], 1.);
+    EXPECT_NEAR(238., value[1], 1.);
+    EXPECT_NEAR(242., value[2], 1.);
+
+    // an object too small for the probe is still found by the full check
+    cv::Mat spot = uniform.clone();
+    cv::rectangle(spot, cv::Rect(101, 101, 3, 3), cv::Scalar(60, 20, 90), cv::FILLED);
+    EXPECT_FALSE(ConverterTools::isBackgroundTile(spot, 2, value));
+
+    cv::Mat tissue(256, 256, CV_16UC1);
+    cv::randu(tissue, cv::Scalar(0), cv::Scalar(4000));
+    EXPECT_FALSE(ConverterTools::isBackgroundTile(tissue, 2, value));
+}
@@ -83,3 +83,80 @@ TEST(Converter, convertGdalToOmetiffJp2K)
 	double sim = slideio::ImageTools::computeSimilarity(ometiffImage, gdalImage);
 	EXPECT_LE(0.99, sim);
 }
+
+TEST(Converter, convertGdalToOmetiffHTJ2K)
+{
+	std::string path = TestTools::getTestImagePath("gdal", "Airbus_Pleiades_50cm_8bit_RGB_Yogyakarta.jpg");
+	SlidePtr slide = slideio::openSlide(path, "GDAL");
+	ScenePtr scene = slide->getScene(0);
+	auto sceneRect = scene->getRect();
+	int sceneWidth = std::get<2>(sceneRect);
+	int sceneHeight = std::get<3>(sceneRect);
+	ASSERT_TRUE(scene.get() != nullptr);
+
+	slideio::TempFile tmp("ome.tiff");
+	std::string outputPath = tmp.getPath().string();
+	if (std::filesystem::exists(outputPath)) {
+		std::filesystem::remove(outputPath);
+	}
+	OMETIFFJp2KConverterParameters parameters;
+	parameters.setHighThroughput(true);
+	convertScene(scene, parameters, outputPath, 1);
+	SlidePtr omeSlide = openSlide(outputPath, "OMETIFF");
+	ScenePtr omeScene = omeSlide->getScene(0);
+	auto omeRect = omeScene->getRect();
+	EXPECT_EQ(sceneWidth, std::get<2>(omeRect));
+	EXPECT_EQ(sceneHeight, std::get<3>(omeRect));
+	EXPECT_EQ(Compression::Jpeg2000, omeScene->getCompression());
+	int dataSize = sceneHeight * sceneWidth * scene->getNumChannels();
+	std::vector<uint8_t> omeBuffer(dataSize);
+	omeScene->readBlock(sceneRect, omeBuffer.data(), omeBuffer.size());
+	std::vector<uint8_t> gdalBuffer(dataSize);
+	scene->readBlock(sceneRect, gdalBuffer.data(), gdalBuffer.size());
+	cv::Mat ometiffImage(sceneHeight, sceneWidth, CV_8UC3, omeBuffer.data());
+	cv::Mat gdalImage(sceneHeight, sceneWidth, CV_8UC3, gdalBuffer.data());
+	// reversible HT coding is lossless
+	EXPECT_EQ(0., cv::norm(ometiffImage, gdalImage, cv::NORM_INF));
+}
+
+TEST(Converter, convertToOmetiffLossless)
+{
+	std::string path = TestTools::getTestImagePath("zvi", "Zeiss-1-Merged.zvi");
+	SlidePtr slide = openSlide(path);
+	ScenePtr scene = slide->getScene(0);
+	ASSERT_TRUE(scene.get() != nullptr);
+
+	const int x = 100;
+	const int y = 100;
+	const int width = 300;
+	const int height = 300;
+	const int numChannels = scene->getNumChannels();
+	const int dataTypeSize = Tools::dataTypeSize(scene->getChannelDataType(0));
+	const int rasterSize = width * height * numChannels * dataTypeSize;
+	const std::tuple<int, int, int, int> block = { x, y, width, height };
+	std::vector<uint8_t> buffer(rasterSize);
+	scene->readBlock(block, buffer.data(), buffer.size());
+	const cv::Mat inputImage(height, width, CV_16SC3, buffer.data());
+
+	for (Compression compression : { Compression::Zstd, Compression::Zlib, Compression::LZW }) {
+		SCOPED_TRACE(compressionToString(compression));
+		OMETIFFLosslessConverterParameters parameters(compression);
+		parameters.setRect(Rect(x, y, width, height));
+		parameters.setTileWidth(128);
+		parameters.setTileHeight(128);
+		const TempFile tmp("ome.tiff");
+		const std::string outputPath = tmp.getPath().string();
+		if (std::filesystem::exists(outputPath)) {
+			std::filesystem::remove(outputPath);
+		}
+		convertScene(scene, parameters, outputPath, 1);
+		SlidePtr omeSlide = openSlide(outputPath, "OMETIFF");
+		ScenePtr omeScene = omeSlide->getScene(0);
+		EXPECT_EQ(compression, omeScene->getCompression());
+		EXPECT_EQ(scene->getChannelDataType(0), omeScene->getChannelDataType(0));
+		std::vector<uint8_t> outputBuffer(rasterSize);
+		omeScene->readBlock(omeScene->getRect(), outputBuffer.data(), outputBuffer.size());
+		const cv::Mat outputImage(height, width, CV_16SC3, outputBuffer.data());
+		EXPECT_EQ(0., cv::norm(inputImage, outputImage, cv::NORM_INF));
+	}
+}
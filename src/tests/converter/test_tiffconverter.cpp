@@ -1,9 +1,11 @@
 #include <gtest/gtest.h>
+#include <atomic>
 #include <chrono>
 #include <queue>
 #include "tests/testlib/testtools.hpp"
 #include "tests/testlib/testscene.hpp"
 #include "slideio/converter/tiffconverter.hpp"
+#include "slideio/converter/conversionjournal.hpp"
 #include "slideio/converter/converterparameters.hpp"
 #include "slideio/core/tools/tempfile.hpp"
 #include "slideio/base/exceptions.hpp"
@@ -1435,3 +1437,164 @@ TEST(TiffConverterTests, CreateTileQueue_SequenceIdsMonotonic) {
 		prevSeqId = block.firstTileSequenceId;
 	}
 }
+
+TEST(TiffConverterTests, OMETIFFBackgroundTiles) {
+    constexpr int numChannels = 3;
+    // configureCommonRanges converts a 512x512 rect with 128x128 tiles
+    const cv::Rect sceneRect(0, 0, 512, 512);
+    std::vector<uintmax_t> fileSizes;
+    for (bool backgroundDetection : { false, true }) {
+        for (bool parallelWriting : { false, true }) {
+            SCOPED_TRACE(std::string("background detection: ") + (backgroundDetection ? "yes" : "no")
+                + ", parallel writing: " + (parallelWriting ? "yes" : "no"));
+            slideio::TempFile tmp("ome.tiff");
+            std::string outputPath = tmp.getPath().string();
+            if (std::filesystem::exists(outputPath)) {
+                std::filesystem::remove(outputPath);
+            }
+            auto scene = makeScene(numChannels, sceneRect.width, sceneRect.height);
+            OMETIFFLosslessConverterParameters params(Compression::Zstd);
+            configureCommonRanges(params, numChannels, 1);
+            params.setParallelWriting(parallelWriting);
+            params.setBackgroundDetection(backgroundDetection);
+            // the test scene is uniform: every tile is background even without tolerance
+            params.setBackgroundTolerance(0);
+            TestTiffConverter converter;
+            converter.createFileLayout(scene, params);
+            converter.createTiff(outputPath, nullptr, 1);
+            EXPECT_EQ(backgroundDetection ? converter.getTotalTiles() : 0, converter.getNumBackgroundTiles());
+            fileSizes.push_back(std::filesystem::file_size(outputPath));
+
+            auto slide = openSlide(outputPath, "OMETIFF");
+            auto cvScene = slide->getScene(0)->getCVScene();
+            ASSERT_EQ(numChannels, cvScene->getNumChannels());
+            for (int channel = 0; channel < numChannels; ++channel) {
+                cv::Mat raster;
+                cvScene->readBlockChannels(sceneRect, { channel }, raster);
+                double minVal, maxVal;
+                cv::minMaxLoc(raster, &minVal, &maxVal);
+                const uint8_t expectedValue = getChannelColor(0, 0, channel);
+                EXPECT_EQ(expectedValue, static_cast<uint8_t>(minVal));
+                EXPECT_EQ(expectedValue, static_cast<uint8_t>(maxVal));
+            }
+        }
+    }
+    // with either writer all background tiles share one copy in the file
+    EXPECT_LT(fileSizes[2], fileSizes[0]);
+    EXPECT_LT(fileSizes[3], fileSizes[1]);
+}
+
+namespace
+{
+    // Fails every read once the shared budget of reads is used up, like a preempted process.
+    class InterruptedScene : public DummyScene
+    {
+    public:
+        explicit InterruptedScene(std::shared_ptr<std::atomic<int>> budget) : m_budget(std::move(budget)) {
+        }
+        void readResampledBlockChannelsEx(const cv::Rect& blockRect, const cv::Size& blockSize,
+            const std::vector<int>& componentIndices, int zSliceIndex, int tFrameIndex, cv::OutputArray output) override {
+            if (--(*m_budget) < 0) {
+                RAISE_RUNTIME_ERROR << "Conversion interrupted";
+            }
+            DummyScene::readResampledBlockChannelsEx(blockRect, blockSize, componentIndices, zSliceIndex, tFrameIndex, output);
+        }
+    private:
+        std::shared_ptr<std::atomic<int>> m_budget;
+    };
+
+    class InterruptedTiffConverter : public TiffConverter
+    {
+    public:
+        explicit InterruptedTiffConverter(int numReads) : m_budget(std::make_shared<std::atomic<int>>(numReads)) {
+        }
+        std::pair<std::shared_ptr<Slide>, std::shared_ptr<Scene>> cloneScene() const override {
+            auto rect = getScene()->getRect();
+            auto cvScene = std::make_shared<InterruptedScene>(m_budget);
+            cvScene->setNumChannels(getScene()->getNumChannels());
+            cvScene->setChannelDataType(DataType::DT_Byte);
+            cvScene->setRect(rect);
+            cvScene->setResolution(Resolution(1e-3, 2e-3));
+            std::shared_ptr<Scene> scene(new Scene(std::static_pointer_cast<CVScene>(cvScene)));
+            return { nullptr, scene };
+        }
+    private:
+        std::shared_ptr<std::atomic<int>> m_budget;
+    };
+}
+
+TEST(TiffConverterTests, OMETIFFResumeConversion) {
+    constexpr int numChannels = 3;
+    const cv::Rect sceneRect(0, 0, 512, 512);
+    slideio::TempFile tmp("ome.tiff");
+    const std::string outputPath = tmp.getPath().string();
+    const std::string journalPath = ConversionJournal::getJournalPath(outputPath);
+    if (std::filesystem::exists(outputPath)) {
+        std::filesystem::remove(outputPath);
+    }
+    auto scene = makeScene(numChannels, sceneRect.width, sceneRect.height);
+    OMETIFFLosslessConverterParameters params(Compression::Zstd);
+    configureCommonRanges(params, numChannels, 2);
+    params.setResumable(true);
+    params.setNumReadingThreads(1);
+    params.setNumEncodingThreads(1);
+    {
+        InterruptedTiffConverter converter(8);
+        converter.createFileLayout(scene, params);
+        EXPECT_THROW(converter.createTiff(outputPath, nullptr, 1), RuntimeError);
+    }
+    ASSERT_TRUE(std::filesystem::exists(outputPath));
+    ASSERT_TRUE(std::filesystem::exists(journalPath));
+
+    TestTiffConverter converter;
+    converter.createFileLayout(scene, params);
+    int lastProgress = 0;
+    converter.createTiff(outputPath, [&lastProgress](int progress) { lastProgress = progress; }, 1);
+    EXPECT_GT(converter.getNumResumedTiles(), 0);
+    EXPECT_LT(converter.getNumResumedTiles(), converter.getTotalTiles());
+    EXPECT_EQ(100, lastProgress);
+    EXPECT_FALSE(std::filesystem::exists(journalPath));
+
+    auto slide = openSlide(outputPath, "OMETIFF");
+    auto cvScene = slide->getScene(0)->getCVScene();
+    ASSERT_EQ(numChannels, cvScene->getNumChannels());
+    for (int channel = 0; channel < numChannels; ++channel) {
+        cv::Mat raster;
+        cvScene->readBlockChannels(sceneRect, { channel }, raster);
+        double minVal, maxVal;
+        cv::minMaxLoc(raster, &minVal, &maxVal);
+        const uint8_t expectedValue = getChannelColor(0, 0, channel);
+        EXPECT_EQ(expectedValue, static_cast<uint8_t>(minVal));
+        EXPECT_EQ(expectedValue, static_cast<uint8_t>(maxVal));
+    }
+}
+
+TEST(ConversionJournal, recordsFollowDataSync) {
+    slideio::TempFile tmp("journal");
+    const std::string journalPath = tmp.getPath().string();
+    int numSyncs = 0;
+    {
+        ConversionJournal journal(journalPath);
+        journal.setDataSync([&numSyncs]() { ++numSyncs; });
+        journal.start("layout", 1024);
+        ConversionJournal::Record record;
+        record.offset = 1024;
+        record.size = 16;
+        for (size_t index = 0; index < ConversionJournal::RECORDS_PER_SYNC + 1; ++index) {
+            record.x = static_cast<int>(index);
+            journal.append(record);
+        }
+        // one full batch: the data is synced before its records are written
+        EXPECT_EQ(1, numSyncs);
+        ConversionJournal reader(journalPath);
+        ASSERT_TRUE(reader.load("layout"));
+        EXPECT_EQ(ConversionJournal::RECORDS_PER_SYNC, reader.getRecords().size());
+        journal.flush();
+        EXPECT_EQ(2, numSyncs);
+    }
+    ConversionJournal reader(journalPath);
+    ASSERT_TRUE(reader.load("layout"));
+    ASSERT_EQ(ConversionJournal::RECORDS_PER_SYNC + 1, reader.getRecords().size());
+    EXPECT_EQ(static_cast<int>(ConversionJournal::RECORDS_PER_SYNC), reader.getRecords().back().x);
+    EXPECT_EQ(1024u, reader.getMetadataSize());
+}
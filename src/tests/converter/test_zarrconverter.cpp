@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "tests/testlib/testtools.hpp"
+#include "slideio/converter/converter.hpp"
+#include "slideio/converter/converterparameters.hpp"
+#include "slideio/converter/zarrconverter.hpp"
+#include "slideio/slideio/slideio.hpp"
+#include "slideio/slideio/scene.hpp"
+#include "slideio/base/exceptions.hpp"
+#include "slideio/core/tools/tempfile.hpp"
+#include "slideio/core/tools/tools.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <zlib.h>
+
+using namespace slideio;
+using namespace slideio::converter;
+
+namespace
+{
+    std::string readTextFile(const std::filesystem::path& path) {
+        std::ifstream stream(path);
+        std::stringstream content;
+        content << stream.rdbuf();
+        return content.str();
+    }
+
+    std::vector<uint8_t> readBinaryFile(const std::filesystem::path& path) {
+        std::ifstream stream(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    class ZarrDirectory
+    {
+    public:
+        ZarrDirectory() : m_path(TempFile("zarr").getPath()) {
+        }
+        ~ZarrDirectory() {
+            std::error_code ec;
+            std::filesystem::remove_all(m_path, ec);
+        }
+        const std::filesystem::path& getPath() const {
+            return m_path;
+        }
+    private:
+        std::filesystem::path m_path;
+    };
+}
+
+TEST(ZarrConverter, chunkPath)
+{
+    EXPECT_EQ(std::string("2/0/1/3/5/4"), ZarrConverter::chunkPath(2, 0, 1, 3, 4, 5));
+    EXPECT_EQ(std::string("|u1"), ZarrConverter::zarrDataType(DataType::DT_Byte));
+    EXPECT_EQ(std::string("<u2"), ZarrConverter::zarrDataType(DataType::DT_UInt16));
+    EXPECT_EQ(std::string("<f4"), ZarrConverter::zarrDataType(DataType::DT_Float32));
+}
+
+TEST(ZarrConverter, rejectsLossyCompression)
+{
+    std::string path = TestTools::getTestImagePath("gdal", "Airbus_Pleiades_50cm_8bit_RGB_Yogyakarta.jpg");
+    SlidePtr slide = openSlide(path, "GDAL");
+    ScenePtr scene = slide->getScene(0);
+    OMEZarrConverterParameters parameters(Compression::Jpeg);
+    ZarrDirectory dir;
+    EXPECT_THROW(convertScene(scene, parameters, dir.getPath().string(), 1), RuntimeError);
+    EXPECT_FALSE(std::filesystem::exists(dir.getPath()));
+}
+
+TEST(ZarrConverter, convertGdalToOMEZarr)
+{
+    std::string path = TestTools::getTestImagePath("gdal", "Airbus_Pleiades_50cm_8bit_RGB_Yogyakarta.jpg");
+    SlidePtr slide = openSlide(path, "GDAL");
+    ScenePtr scene = slide->getScene(0);
+    ASSERT_TRUE(scene.get() != nullptr);
+    const int x = 100;
+    const int y = 200;
+    const int width = 700;
+    const int height = 500;
+    const int numChannels = scene->getNumChannels();
+    std::vector<uint8_t> buffer(width * height * numChannels);
+    scene->readBlock({ x, y, width, height }, buffer.data(), buffer.size());
+    const cv::Mat inputImage(height, width, CV_8UC(numChannels), buffer.data());
+    std::vector<cv::Mat> inputChannels;
+    cv::split(inputImage, inputChannels);
+
+    OMEZarrConverterParameters parameters(Compression::Zlib);
+    parameters.setRect(Rect(x, y, width, height));
+    parameters.setChunkWidth(256);
+    parameters.setChunkHeight(256);
+    parameters.setNumZoomLevels(2);
+    ZarrDirectory dir;
+    int lastProgress = -1;
+    convertScene(scene, parameters, dir.getPath().string(), 1, [&lastProgress](int progress) {
+        lastProgress = progress;
+    });
+    EXPECT_EQ(100, lastProgress);
+    const std::filesystem::path root = dir.getPath();
+    ASSERT_TRUE(std::filesystem::exists(root / ".zgroup"));
+    EXPECT_NE(std::string::npos, readTextFile(root / ".zattrs").find("\"multiscales\""));
+    const std::string zarray = readTextFile(root / "0" / ".zarray");
+    EXPECT_NE(std::string::npos, zarray.find("\"zlib\""));
+    EXPECT_NE(std::string::npos, zarray.find("\"|u1\""));
+    ASSERT_TRUE(std::filesystem::exists(root / "1" / ".zarray"));
+    EXPECT_FALSE(std::filesystem::exists(root / "2"));
+
+    const int chunkSize = 256;
+    const int columns = (width + chunkSize - 1) / chunkSize;
+    const int rows = (height + chunkSize - 1) / chunkSize;
+    std::vector<uint8_t> chunkData(chunkSize * chunkSize);
+    for (int channel = 0; channel < numChannels; ++channel) {
+        cv::Mat outputChannel(rows * chunkSize, columns * chunkSize, CV_8UC1);
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                const std::filesystem::path chunkPath = root / ZarrConverter::chunkPath(0, 0, channel, 0, column, row);
+                ASSERT_TRUE(std::filesystem::exists(chunkPath)) << chunkPath.string();
+                const std::vector<uint8_t> encoded = readBinaryFile(chunkPath);
+                uLongf decodedSize = static_cast<uLongf>(chunkData.size());
+                ASSERT_EQ(Z_OK, uncompress(chunkData.data(), &decodedSize, encoded.data(), static_cast<uLong>(encoded.size())));
+                ASSERT_EQ(chunkData.size(), decodedSize);
+                const cv::Mat chunk(chunkSize, chunkSize, CV_8UC1, chunkData.data());
+                chunk.copyTo(outputChannel(cv::Rect(column * chunkSize, row * chunkSize, chunkSize, chunkSize)));
+            }
+        }
+        const cv::Mat outputImage = outputChannel(cv::Rect(0, 0, width, height));
+        EXPECT_EQ(0., cv::norm(inputChannels[channel], outputImage, cv::NORM_INF));
+    }
+}
@@ -10,6 +10,11 @@
 #include <nlohmann/json.hpp>
 
 #include "slideio/imagetools/imagetools.hpp"
+#include "slideio/imagetools/smallimage.hpp"
+#include "slideio/drivers/gdal/gdalscene.hpp"
+#include "slideio/base/slideio_enums.hpp"
+#include <atomic>
+#include <thread>
 
 using namespace tinyxml2;
 using json = nlohmann::json;
@@ -379,3 +384,55 @@ TEST(GDALDriver, getSceneIndex)
 		EXPECT_EQ("GDAL", scene->getDriverId());
     }
 }
+
+namespace
+{
+    // Page that can only be decoded as a whole; counts the decodes.
+    class WholePage : public slideio::SmallImagePage
+    {
+    public:
+        explicit WholePage(const slideio::Size& size) : m_size(size) {}
+        slideio::Size getSize() const override { return m_size; }
+        slideio::DataType getDataType() const override { return slideio::DataType::DT_Byte; }
+        int getNumChannels() const override { return 3; }
+        slideio::Compression getCompression() const override { return slideio::Compression::Png; }
+        const std::string& getMetadata() const override { return m_metadata; }
+        void readRaster(cv::OutputArray raster) override {
+            ++decodes;
+            raster.create(m_size.height, m_size.width, CV_8UC3);
+            raster.getMat().setTo(cv::Scalar(10, 20, 30));
+        }
+        std::atomic<int> decodes{ 0 };
+    private:
+        slideio::Size m_size;
+        std::string m_metadata;
+    };
+}
+
+// A page larger than the default page cache budget is decoded once for all its blocks,
+// also by concurrent readers.
+TEST(GDALDriver, largePageDecodedOnce)
+{
+    WholePage page({ 5000, 5000 });
+    ASSERT_GT(5000u * 5000u * 3u, slideio::RasterCache::DEFAULT_MAX_BYTES);
+    slideio::GDALScene scene(&page, "large.png", "GDAL");
+    cv::Mat first, second;
+    scene.readBlock({ 0, 0, 256, 256 }, first);
+    scene.readBlock({ 4000, 4000, 256, 256 }, second);
+    EXPECT_EQ(1, page.decodes.load());
+    EXPECT_EQ(cv::Vec3b(10, 20, 30), second.at<cv::Vec3b>(100, 100));
+
+    WholePage concurrentPage({ 5000, 5000 });
+    slideio::GDALScene concurrentScene(&concurrentPage, "large.png", "GDAL");
+    std::vector<std::thread> threads;
+    for (int index = 0; index < 4; ++index) {
+        threads.emplace_back([&concurrentScene, index]() {
+            cv::Mat block;
+            concurrentScene.readBlock({ index * 1000, index * 1000, 256, 256 }, block);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(1, concurrentPage.decodes.load());
+}
@@ -340,6 +340,61 @@ TEST(ImageTools, encodeJpegGray)
     EXPECT_GE(similarity, 0.99);
 }
 
+TEST(ImageTools, encodeDecodeJpegReusedContext)
+{
+    std::string pathPng = TestTools::getTestImagePath("jpeg", "lena_256.png");
+    cv::Mat color;
+    slideio::ImageTools::readSmallImageRaster(pathPng, color);
+    cv::Mat gray;
+    cv::cvtColor(color, gray, cv::COLOR_RGB2GRAY);
+    // the same thread context is reused across rasters of different
+    // size, channel count and quality
+    const std::vector<cv::Mat> sources = { color, gray, color(cv::Rect(0, 0, 100, 60)).clone(), gray, color };
+    const std::vector<int> qualities = { 95, 95, 80, 99, 95 };
+    for (size_t index = 0; index < sources.size(); ++index) {
+        SCOPED_TRACE(index);
+        std::vector<uint8_t> output;
+        slideio::JpegEncodeParameters params(qualities[index]);
+        slideio::ImageTools::encodeJpeg(sources[index], output, params);
+        cv::Mat target;
+        slideio::ImageTools::decodeJpegStream(output.data(), output.size(), target);
+        ASSERT_EQ(sources[index].size(), target.size());
+        ASSERT_EQ(sources[index].channels(), target.channels());
+        EXPECT_GE(slideio::ImageTools::computeSimilarity(sources[index], target), 0.98);
+    }
+    // a corrupted stream must not spoil the context for the next one
+    std::vector<uint8_t> valid;
+    slideio::ImageTools::encodeJpeg(color, valid, slideio::JpegEncodeParameters(95));
+    std::vector<uint8_t> corrupted(valid.begin(), valid.begin() + 20);
+    cv::Mat target;
+    EXPECT_THROW(slideio::ImageTools::decodeJpegStream(corrupted.data(), corrupted.size(), target),
+        slideio::RuntimeError);
+    slideio::ImageTools::decodeJpegStream(valid.data(), valid.size(), target);
+    EXPECT_GE(slideio::ImageTools::computeSimilarity(color, target), 0.98);
+}
+
+TEST(ImageTools, decodeJpegStreamLuminance)
+{
+    std::string pathPng = TestTools::getTestImagePath("jpeg", "lena_256.png");
+    cv::Mat color;
+    slideio::ImageTools::readSmallImageRaster(pathPng, color);
+    std::vector<uint8_t> stream;
+    slideio::ImageTools::encodeJpeg(color, stream, slideio::JpegEncodeParameters(95));
+    cv::Mat decoded;
+    slideio::ImageTools::decodeJpegStream(stream.data(), stream.size(), decoded);
+    cv::Mat luminance;
+    slideio::ImageTools::decodeJpegStream(stream.data(), stream.size(), luminance, true);
+    ASSERT_EQ(luminance.size(), color.size());
+    ASSERT_EQ(luminance.type(), CV_8UC1);
+    cv::Mat gray;
+    cv::cvtColor(decoded, gray, cv::COLOR_RGB2GRAY);
+    EXPECT_LT(cv::norm(luminance, gray, cv::NORM_L1) / static_cast<double>(gray.total()), 1.);
+    // the context decodes colors again after a luminance stream
+    cv::Mat again;
+    slideio::ImageTools::decodeJpegStream(stream.data(), stream.size(), again);
+    EXPECT_EQ(cv::norm(again, decoded, cv::NORM_INF), 0.);
+}
+
 TEST(ConverterTools, ConvertTo32BitChannelsTest) {
     const int width = 3;
     const int height = 2;
@@ -167,6 +167,54 @@ TEST(MetadataXml, EndToEndViaMetadata)
     EXPECT_EQ(m["Image"]["Pixels"]["@SizeY"].asInt(), 256);
 }
 
+TEST(MetadataXml, LazyTreeMatchesConversion)
+{
+    const std::string xml =
+        R"(<Image Name="a&amp;b"><Pixels SizeX="512" SizeY="256"/><Channel>1</Channel>)"
+        R"(<Channel Id="c2">2</Channel><Note>text<B/></Note><Empty/></Image>)";
+    std::string error;
+    auto root = detail::xmlStringToLazyNode(xml, error);
+    ASSERT_TRUE(root);
+    const Metadata lazy = detail::makeLazyMetadata(root);
+    const Metadata full = detail::makeMetadataFromJson(detail::xmlStringToJson(xml));
+    EXPECT_EQ(full.toJson(), lazy.toJson());
+    EXPECT_EQ(full["Image"].keys(), lazy["Image"].keys());
+    EXPECT_EQ(full["Image"].size(), lazy["Image"].size());
+    EXPECT_EQ("a&b", lazy["Image"]["@Name"].asString());
+    EXPECT_EQ(512, lazy.find("/Image/Pixels/@SizeX").asInt());
+    ASSERT_TRUE(lazy["Image"]["Channel"].isArray());
+    EXPECT_EQ(2u, lazy["Image"]["Channel"].size());
+    EXPECT_EQ("1", lazy["Image"]["Channel"][0].asString());
+    EXPECT_EQ("c2", lazy.find("/Image/Channel/1/@Id").asString());
+    EXPECT_EQ("2", lazy.find("/Image/Channel/1/#text").asString());
+    EXPECT_EQ("text", lazy["Image"]["Note"]["#text"].asString());
+    EXPECT_TRUE(lazy["Image"]["Empty"].isObject());
+    EXPECT_EQ(0u, lazy["Image"]["Empty"].size());
+    EXPECT_TRUE(lazy["Image"]["Missing"].isNull());
+    EXPECT_TRUE(lazy.find("/Image/Channel/2").isNull());
+    EXPECT_TRUE(lazy.find("Image").isNull());
+    EXPECT_FALSE(lazy["Image"].contains("Missing"));
+    EXPECT_TRUE(lazy["Image"].contains("@Name"));
+
+    EXPECT_FALSE(detail::xmlStringToLazyNode("<not <valid xml", error));
+    EXPECT_FALSE(error.empty());
+}
+
+TEST(MetadataXml, LazyBuilderMaterialisesOnModification)
+{
+    MetadataBuilder b = detail::makeDefaultMetadataBuilder(
+        R"(<R a="1"><Item>x</Item></R>)", MetadataFormat::XML);
+    EXPECT_TRUE(b.isObject());
+    EXPECT_EQ(1u, b.size());
+    const Metadata before = b.freeze();
+    b["R"]["added"].set("y");
+    const Metadata after = b.freeze();
+    EXPECT_FALSE(before["R"].contains("added"));
+    EXPECT_EQ("y", after["R"]["added"].asString());
+    EXPECT_EQ("1", after["R"]["@a"].asString());
+    EXPECT_EQ("x", after["R"]["Item"].asString());
+}
+
 namespace
 {
     class TestScene : public slideio::CVScene
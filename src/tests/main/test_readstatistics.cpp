@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "slideio/core/tools/readstatistics.hpp"
+#include "slideio/slideio/imagedrivermanager.hpp"
+#include "slideio/slideio/slideio.hpp"
+#include "slideio/slideio/scene.hpp"
+#include "tests/testlib/testtools.hpp"
+#include <nlohmann/json.hpp>
+#include <thread>
+
+using namespace slideio;
+
+namespace
+{
+    class ReadStatisticsGuard
+    {
+    public:
+        ReadStatisticsGuard() {
+            ImageDriverManager::resetReadStatistics();
+        }
+        ~ReadStatisticsGuard() {
+            ImageDriverManager::setReadStatisticsEnabled(false);
+            ImageDriverManager::resetReadStatistics();
+        }
+    };
+}
+
+TEST(LatencyHistogram, bucketsAndPercentiles)
+{
+    for (uint64_t value : {0ull, 7ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull}) {
+        const int index = LatencyHistogram::bucketIndex(value);
+        EXPECT_GE(LatencyHistogram::bucketUpperBound(index), value);
+        if (index > 0) {
+            EXPECT_LT(LatencyHistogram::bucketUpperBound(index - 1), value);
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::BUCKET_COUNT - 1, LatencyHistogram::bucketIndex(UINT64_MAX));
+
+    LatencyHistogram histogram;
+    EXPECT_EQ(0u, histogram.getPercentile(50.));
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value * 1000);
+    }
+    EXPECT_EQ(1000u, histogram.getCount());
+    EXPECT_EQ(1000u, histogram.getMin());
+    EXPECT_EQ(1000000u, histogram.getMax());
+    EXPECT_DOUBLE_EQ(500500., histogram.getMean());
+    const double p50 = static_cast<double>(histogram.getPercentile(50.));
+    EXPECT_NEAR(500000., p50, 500000. / 16.);
+    const double p99 = static_cast<double>(histogram.getPercentile(99.));
+    EXPECT_NEAR(990000., p99, 990000. / 16.);
+    EXPECT_EQ(histogram.getMax(), histogram.getPercentile(100.));
+
+    LatencyHistogram copy(histogram);
+    copy.add(histogram);
+    EXPECT_EQ(2000u, copy.getCount());
+    EXPECT_EQ(histogram.getPercentile(50.), copy.getPercentile(50.));
+}
+
+TEST(ReadStatistics, collectedOnlyWhenEnabled)
+{
+    ReadStatisticsGuard guard;
+    std::string path = TestTools::getTestImagePath("svs", "CMU-1-Small-Region.svs");
+    auto slide = openSlide(path, "SVS");
+    auto scene = slide->getScene(0);
+    const int width = 1000;
+    const int height = 800;
+    std::vector<uint8_t> buffer(width / 2 * height / 2 * scene->getNumChannels());
+
+    scene->readResampledBlock({ 100, 100, width, height }, { width / 2, height / 2 }, buffer.data(), buffer.size());
+    EXPECT_EQ(0u, scene->getReadStatistics().getTilesDecoded());
+    EXPECT_EQ(0u, scene->getReadStatistics().getLatency(ReadStage::Total).getCount());
+
+    ImageDriverManager::setReadStatisticsEnabled(true);
+    EXPECT_TRUE(ImageDriverManager::isReadStatisticsEnabled());
+    scene->readResampledBlock({ 100, 100, width, height }, { width / 2, height / 2 }, buffer.data(), buffer.size());
+
+    const ReadStatistics& statistics = scene->getReadStatistics();
+    EXPECT_GT(statistics.getTilesDecoded(), 1u);
+    EXPECT_GT(statistics.getBytesRead(), 0u);
+    EXPECT_EQ(1u, statistics.getLatency(ReadStage::Total).getCount());
+    EXPECT_EQ(statistics.getTilesDecoded(), statistics.getLatency(ReadStage::Decode).getCount());
+    EXPECT_GT(statistics.getLatency(ReadStage::Resize).getCount(), 0u);
+    EXPECT_GT(statistics.getLatency(ReadStage::Copy).getCount(), 0u);
+    // stage times are exclusive parts of the request
+    EXPECT_LE(statistics.getLatency(ReadStage::Decode).getTotal(),
+              statistics.getLatency(ReadStage::Total).getTotal());
+
+    const ReadStatistics& driver = ImageDriverManager::getDriverReadStatistics("SVS");
+    EXPECT_EQ(statistics.getTilesDecoded(), driver.getTilesDecoded());
+    EXPECT_EQ(statistics.getBytesRead(), driver.getBytesRead());
+    const ReadStatistics& compression = ImageDriverManager::getCompressionReadStatistics(scene->getCompression());
+    EXPECT_EQ(1u, compression.getLatency(ReadStage::Total).getCount());
+
+    auto exported = nlohmann::json::parse(ImageDriverManager::getReadStatisticsJson());
+    EXPECT_EQ(statistics.getTilesDecoded(), exported["drivers"]["SVS"]["tilesDecoded"].get<uint64_t>());
+    EXPECT_EQ(1u, exported["drivers"]["SVS"]["latency"]["total"]["count"].get<uint64_t>());
+
+    scene->resetReadStatistics();
+    EXPECT_EQ(0u, scene->getReadStatistics().getTilesDecoded());
+    EXPECT_EQ(0u, scene->getReadStatistics().getLatency(ReadStage::Total).getCount());
+}
+
+TEST(ReadStatistics, workerThreadsCountIntoTheCallingRead)
+{
+    ReadStatisticsGuard guard;
+    ImageDriverManager::setReadStatisticsEnabled(true);
+    ReadStatistics statistics;
+    ReadStatisticsScope scope;
+    scope.activate(statistics, "SVS", Compression::Jpeg);
+    const ReadStatisticsTargets targets = ReadStatisticsScope::current();
+    ASSERT_FALSE(targets.empty());
+
+    std::thread unattributed([]() {
+        ReadStatistics::countTiles(1);
+    });
+    unattributed.join();
+    EXPECT_EQ(0u, statistics.getTilesDecoded());
+
+    std::thread worker([&targets]() {
+        ReadStatisticsScope workerScope;
+        workerScope.activate(targets);
+        ReadStatistics::countTiles(2);
+        ReadStatistics::countBytesRead(100);
+    });
+    worker.join();
+    EXPECT_EQ(2u, statistics.getTilesDecoded());
+    EXPECT_EQ(100u, statistics.getBytesRead());
+    EXPECT_EQ(2u, ImageDriverManager::getDriverReadStatistics("SVS").getTilesDecoded());
+
+    // a worker body run by the calling thread keeps the scope of the read
+    {
+        ReadStatisticsScope nested;
+        nested.activate(targets);
+        ReadStatistics::countTiles(1);
+    }
+    ReadStatistics::countTiles(1);
+    EXPECT_EQ(4u, statistics.getTilesDecoded());
+}
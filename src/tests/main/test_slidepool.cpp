@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "slideio/slideio/slidepool.hpp"
+#include "slideio/slideio/slideio.hpp"
+#include "slideio/slideio/slide.hpp"
+#include "slideio/slideio/scene.hpp"
+#include "slideio/core/tools/tools.hpp"
+#include "tests/testlib/testtools.hpp"
+#include <filesystem>
+
+using namespace slideio;
+
+namespace
+{
+    // Descriptors of the process open on the file; -1 where /proc/self/fd is missing.
+    int countOpenDescriptors(const std::string& filePath) {
+        namespace fs = std::filesystem;
+        const fs::path descriptors("/proc/self/fd");
+        std::error_code error;
+        if (!fs::is_directory(descriptors, error)) {
+            return -1;
+        }
+        const fs::path target = fs::canonical(filePath);
+        int count = 0;
+        for (const auto& entry : fs::directory_iterator(descriptors, error)) {
+            const fs::path link = fs::read_symlink(entry.path(), error);
+            if (!error && link == target) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    std::vector<uint8_t> readBlock(const std::shared_ptr<Slide>& slide) {
+        auto scene = slide->getScene(0);
+        const int width = 400;
+        const int height = 300;
+        size_t pixelSize = 0;
+        for (int channel = 0; channel < scene->getNumChannels(); ++channel) {
+            pixelSize += slideio::Tools::dataTypeSize(scene->getChannelDataType(channel));
+        }
+        std::vector<uint8_t> buffer(width * height * pixelSize);
+        scene->readBlock({ 200, 100, width, height }, buffer.data(), buffer.size());
+        return buffer;
+    }
+}
+
+TEST(SlidePool, reusesOpenedSlides)
+{
+    SlidePool pool(4, 4);
+    std::string path = TestTools::getTestImagePath("svs", "CMU-1-Small-Region.svs");
+    auto slide = pool.getSlide(path, "SVS");
+    EXPECT_EQ(slide, pool.getSlide(path, "SVS"));
+    // the driver is part of the key
+    EXPECT_NE(slide, pool.getSlide(path));
+    EXPECT_EQ(2u, pool.getNumSlides());
+    pool.remove(path, "SVS");
+    EXPECT_EQ(1u, pool.getNumSlides());
+    EXPECT_NE(slide, pool.getSlide(path, "SVS"));
+    pool.clear();
+    EXPECT_EQ(0u, pool.getNumSlides());
+    EXPECT_EQ(0u, pool.getNumOpenSlides());
+}
+
+TEST(SlidePool, coldSlidesCloseAndReopenFiles)
+{
+    SlidePool pool(4, 1);
+    std::string path1 = TestTools::getTestImagePath("svs", "CMU-1-Small-Region.svs");
+    std::string path2 = TestTools::getTestImagePath("svs", "JP2K-33003-1.svs");
+    auto slide1 = pool.getSlide(path1, "SVS");
+    const std::vector<uint8_t> expected = readBlock(slide1);
+    auto slide2 = pool.getSlide(path2, "SVS");
+    readBlock(slide2);
+    EXPECT_EQ(2u, pool.getNumSlides());
+    EXPECT_EQ(1u, pool.getNumOpenSlides());
+    // the closed slide reads from a reopened file
+    EXPECT_EQ(expected, readBlock(slide1));
+    EXPECT_EQ(slide1, pool.getSlide(path1, "SVS"));
+    EXPECT_EQ(1u, pool.getNumOpenSlides());
+    EXPECT_EQ(expected, readBlock(slide1));
+}
+
+TEST(SlidePool, readOfColdSlideClosesOthers)
+{
+    std::string path1 = TestTools::getTestImagePath("svs", "CMU-1-Small-Region.svs");
+    std::string path2 = TestTools::getTestImagePath("svs", "JP2K-33003-1.svs");
+    if (countOpenDescriptors(path1) < 0) {
+        GTEST_SKIP() << "Skip the test because open files cannot be listed";
+    }
+    SlidePool pool(4, 1);
+    auto slide1 = pool.getSlide(path1, "SVS");
+    const std::vector<uint8_t> expected = readBlock(slide1);
+    auto slide2 = pool.getSlide(path2, "SVS");
+    readBlock(slide2);
+    EXPECT_EQ(0, countOpenDescriptors(path1));
+    EXPECT_GT(countOpenDescriptors(path2), 0);
+    // a read through a held slide reopens its files without asking the pool: the pool
+    // is notified and closes the files of the other slide
+    EXPECT_EQ(expected, readBlock(slide1));
+    EXPECT_GT(countOpenDescriptors(path1), 0);
+    EXPECT_EQ(0, countOpenDescriptors(path2));
+    EXPECT_EQ(1u, pool.getNumOpenSlides());
+    // slides that left the pool are no longer tracked
+    pool.clear();
+    readBlock(slide2);
+    EXPECT_GT(countOpenDescriptors(path1), 0);
+    EXPECT_GT(countOpenDescriptors(path2), 0);
+}
+
+TEST(SlidePool, coldSlidesOfOtherDriversCloseAndReopenFiles)
+{
+    SlidePool pool(4, 1);
+    std::string zviPath = TestTools::getTestImagePath("zvi", "Zeiss-1-Merged.zvi");
+    std::string scnPath = TestTools::getTestImagePath("scn", "Leica-Fluorescence-1.scn");
+    auto zviSlide = pool.getSlide(zviPath, "ZVI");
+    const std::vector<uint8_t> expected = readBlock(zviSlide);
+    auto scnSlide = pool.getSlide(scnPath, "SCN");
+    const std::vector<uint8_t> scnExpected = readBlock(scnSlide);
+    EXPECT_EQ(2u, pool.getNumSlides());
+    EXPECT_EQ(1u, pool.getNumOpenSlides());
+    EXPECT_EQ(expected, readBlock(zviSlide));
+    EXPECT_EQ(zviSlide, pool.getSlide(zviPath, "ZVI"));
+    EXPECT_EQ(1u, pool.getNumOpenSlides());
+    EXPECT_EQ(scnExpected, readBlock(scnSlide));
+}
+
+TEST(SlidePool, slidesThatCannotCloseFilesStayOpen)
+{
+    SlidePool pool(4, 1);
+    std::string path1 = TestTools::getTestImagePath("gdal", "img_2448x2448_3x8bit_SRC_RGB_ducks.png");
+    std::string path2 = TestTools::getTestImagePath("gdal", "img_1024x600_3x8bit_RGB_color_bars_CMYKWRGB.png");
+    auto slide1 = pool.getSlide(path1, "GDAL");
+    auto slide2 = pool.getSlide(path2, "GDAL");
+    // the GDAL driver keeps its datasets open: both slides are counted as open
+    EXPECT_EQ(2u, pool.getNumSlides());
+    EXPECT_EQ(2u, pool.getNumOpenSlides());
+    EXPECT_FALSE(slide1->releaseFileHandles());
+}
+
+TEST(SlidePool, evictsLeastRecentlyUsed)
+{
+    SlidePool pool(1, 1);
+    std::string path1 = TestTools::getTestImagePath("svs", "CMU-1-Small-Region.svs");
+    std::string path2 = TestTools::getTestImagePath("svs", "JP2K-33003-1.svs");
+    auto slide1 = pool.getSlide(path1, "SVS");
+    const std::vector<uint8_t> expected = readBlock(slide1);
+    pool.getSlide(path2, "SVS");
+    EXPECT_EQ(1u, pool.getNumSlides());
+    // an evicted slide stays valid for its holders
+    EXPECT_EQ(expected, readBlock(slide1));
+    EXPECT_NE(slide1, pool.getSlide(path1, "SVS"));
+}
+
+TEST(SlidePool, failedOpenIsNotKept)
+{
+    SlidePool pool;
+    std::string path = TestTools::getTestImagePath("svs", "missing-file.svs");
+    EXPECT_THROW(pool.getSlide(path, "SVS"), std::exception);
+    EXPECT_EQ(0u, pool.getNumSlides());
+    EXPECT_EQ(0u, pool.getNumOpenSlides());
+}
+
+TEST(SlidePool, releaseFileHandles)
+{
+    std::string path = TestTools::getTestImagePath("svs", "CMU-1-Small-Region.svs");
+    auto slide = openSlide(path, "SVS");
+    const std::vector<uint8_t> expected = readBlock(slide);
+    EXPECT_TRUE(slide->releaseFileHandles());
+    EXPECT_EQ(expected, readBlock(slide));
+}
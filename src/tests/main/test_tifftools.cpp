@@ -5,8 +5,12 @@
 #include "tests/testlib/testtools.hpp"
 #include "slideio/imagetools/imagetools.hpp"
 #include "opencv2/imgproc.hpp"
+#include <opencv2/core/utility.hpp>
 #include "slideio/imagetools/tiffkeeper.hpp"
+#include "slideio/imagetools/tiffhandlepool.hpp"
+#include "slideio/base/exceptions.hpp"
 #include "slideio/slideio/imagedrivermanager.hpp"
+#include "slideio/core/tools/decodehint.hpp"
 
 class TiffToolsTests : public ::testing::Test {
 protected:
@@ -122,6 +126,53 @@ TEST_F(TiffToolsTests, readStripedDir16bit3Channels)
     ASSERT_LT(0.99, sim);
 }
 
+TEST_F(TiffToolsTests, readStripedDirRegion)
+{
+    const std::vector<std::pair<std::string, int>> images = {
+        { TestTools::getTestImagePath("gdal", "img_2448x2448_3x16bit_SRC_RGB_ducks.tif"), 0 },
+        { TestTools::getTestImagePath("svs", "CMU-1-Small-Region.svs"), 2 },
+    };
+    for (const auto& [filePath, dirIndex] : images) {
+        slideio::TIFFKeeper tiff(filePath);
+        ASSERT_TRUE(tiff.isValid());
+        std::vector<slideio::TiffDirectory> dirs;
+        slideio::TiffTools::scanFile(tiff.getHandle(), dirs);
+        slideio::TiffDirectory& dir = dirs[dirIndex];
+        if (dir.dataType == slideio::DataType::DT_Unknown || dir.dataType == slideio::DataType::DT_None) {
+            dir.dataType = slideio::DataType::DT_Byte;
+        }
+        ASSERT_FALSE(dir.tiled);
+        cv::Mat dirRaster;
+        slideio::TiffTools::readStripedDir(tiff.getHandle(), dir, dirRaster);
+        const cv::Rect regions[] = {
+            { 0, 0, dir.width, dir.height },
+            { dir.width / 4, dir.height / 3, dir.width / 2, dir.height / 3 },
+            { dir.width - 10, dir.height - 7, 10, 7 },
+        };
+        slideio::TIFFHandlePool handles(filePath);
+        for (const cv::Rect& region : regions) {
+            cv::Mat regionRaster;
+            slideio::TiffTools::readStripedDirRegion(tiff.getHandle(), dir, region, regionRaster);
+            EXPECT_EQ(0, cv::norm(dirRaster(region), regionRaster, cv::NORM_INF));
+            // strips decoded in parallel through the handles of the pool
+            cv::Mat parallelRaster;
+            slideio::TiffTools::readStripedDirRegion(tiff.getHandle(), dir, region, parallelRaster, &handles);
+            EXPECT_EQ(0, cv::norm(dirRaster(region), parallelRaster, cv::NORM_INF));
+        }
+        // the handles are kept for the next reads: no more than the threads of the pool
+        for (int read = 0; read < 4; ++read) {
+            cv::Mat again;
+            slideio::TiffTools::readStripedDirRegion(tiff.getHandle(), dir, regions[0], again, &handles);
+        }
+        EXPECT_LE(handles.getNumIdleHandles(), std::max(1, cv::getNumThreads()));
+        handles.closeHandles();
+        EXPECT_EQ(0, handles.getNumIdleHandles());
+        cv::Mat outside;
+        EXPECT_THROW(slideio::TiffTools::readStripedDirRegion(tiff.getHandle(), dir,
+            cv::Rect(dir.width - 5, 0, 10, 10), outside), slideio::RuntimeError);
+    }
+}
+
 TEST_F(TiffToolsTests, readTile_jpeg)
 {
     const std::string filePath = 
@@ -216,6 +267,40 @@ TEST_F(TiffToolsTests, readTile_jpeg_swapChannles)
     }
 }
 
+TEST_F(TiffToolsTests, readTile_jpegLuminance)
+{
+    const std::string filePath =
+        TestTools::getTestImagePath("svs", "CMU-1-Small-Region.svs");
+    slideio::TIFFKeeper tiff(slideio::TiffTools::openTiffFile(filePath));
+    slideio::TiffDirectory dir;
+    slideio::TiffTools::scanTiffDir(tiff.getHandle(), 0, 0, dir);
+    dir.dataType = slideio::DataType::DT_Byte;
+    const int tile = 5 * ((dir.width - 1) / dir.tileWidth + 1) + 5;
+    cv::Mat colorTile;
+    slideio::TiffTools::readTile(tiff.getHandle(), dir, tile, {}, colorTile);
+    cv::Mat expected;
+    cv::cvtColor(colorTile, expected, cv::COLOR_RGB2GRAY);
+    cv::Mat luminanceTile;
+    {
+        slideio::DecodeHintScope hint(slideio::DecodeHint::Luminance);
+        slideio::TiffTools::readTile(tiff.getHandle(), dir, tile, {}, luminanceTile);
+    }
+    ASSERT_EQ(luminanceTile.size(), colorTile.size());
+    ASSERT_EQ(luminanceTile.type(), CV_8UC3);
+    std::vector<cv::Mat> channels;
+    cv::split(luminanceTile, channels);
+    EXPECT_EQ(cv::norm(channels[0], channels[1], cv::NORM_INF), 0.);
+    EXPECT_EQ(cv::norm(channels[0], channels[2], cv::NORM_INF), 0.);
+    // libjpeg and OpenCV round the weighted sums differently
+    cv::Mat gray;
+    cv::cvtColor(luminanceTile, gray, cv::COLOR_RGB2GRAY);
+    EXPECT_LE(cv::norm(gray, expected, cv::NORM_INF), 1.);
+    // the hint does not outlive its scope
+    cv::Mat colorAgain;
+    slideio::TiffTools::readTile(tiff.getHandle(), dir, tile, {}, colorAgain);
+    EXPECT_EQ(cv::norm(colorAgain, colorTile, cv::NORM_INF), 0.);
+}
+
 TEST_F(TiffToolsTests, readPhotometricYCbCr)
 {
     std::string filePath = TestTools::getTestImagePath("scn", "Leica-Fluorescence-1.scn");
@@ -233,6 +318,39 @@ TEST_F(TiffToolsTests, readPhotometricYCbCr)
     EXPECT_EQ(dir2.YCbCrSubsampling[1], 2);
 }
 
+TEST_F(TiffToolsTests, readJpegTileYCbCr)
+{
+    std::string filePath = TestTools::getTestImagePath("scn", "Leica-Fluorescence-1.scn");
+    std::vector<slideio::TiffDirectory> dirs;
+    slideio::TiffTools::scanFile(filePath, dirs);
+    ASSERT_EQ(dirs.size(), 18);
+    const slideio::TiffDirectory& dir = dirs[0];
+    ASSERT_EQ(dir.compression, 7);
+    slideio::TIFFKeeper tiff(slideio::TiffTools::openTiffFile(filePath));
+    std::string tilePath = TestTools::getTestImagePath("scn", "Leica-Fluorescence-1/tile.png");
+    cv::Mat tile;
+    slideio::ImageTools::readSmallImageRaster(tilePath, tile);
+
+    cv::Mat raster;
+    slideio::TiffTools::readJpegTile(tiff.getHandle(), dir, 24, {}, false, raster);
+    ASSERT_EQ(raster.size(), cv::Size(512, 512));
+    ASSERT_EQ(raster.channels(), 3);
+    EXPECT_GT(slideio::ImageTools::computeSimilarity2(raster, tile), 0.99);
+
+    cv::Mat channel;
+    slideio::TiffTools::readJpegTile(tiff.getHandle(), dir, 24, {1}, false, channel);
+    cv::Mat expectedChannel;
+    cv::extractChannel(raster, expectedChannel, 1);
+    EXPECT_EQ(cv::norm(channel, expectedChannel, cv::NORM_INF), 0.);
+
+    cv::Mat luminance;
+    slideio::TiffTools::readJpegTile(tiff.getHandle(), dir, 24, {0}, true, luminance);
+    ASSERT_EQ(luminance.type(), CV_8UC1);
+    cv::Mat gray;
+    cv::cvtColor(raster, gray, cv::COLOR_RGB2GRAY);
+    EXPECT_GT(slideio::ImageTools::computeSimilarity2(luminance, gray), 0.99);
+}
+
 TEST_F(TiffToolsTests, readNotRGBTile)
 {
     std::string filePath = TestTools::getTestImagePath("scn", "Leica-Fluorescence-1.scn");
@@ -293,3 +411,21 @@ TEST_F(TiffToolsTests, openFileUtf8)
     ASSERT_EQ(dirCount, 1);
 }
 
+
+TEST_F(TiffToolsTests, readTiledDirRegion)
+{
+    const std::string filePath = TestTools::getTestImagePath("svs", "CMU-1-Small-Region.svs");
+    slideio::TIFFKeeper tiff(filePath, true);
+    slideio::TiffDirectory dir;
+    slideio::TiffTools::scanTiffDir(tiff.getHandle(), 0, 0, dir);
+    ASSERT_TRUE(dir.tiled);
+    cv::Mat dirRaster;
+    slideio::TiffTools::readTiledDir(tiff.getHandle(), dir, dirRaster);
+    const cv::Rect region(dir.tileWidth / 2, dir.tileHeight - 10, dir.tileWidth + 20, dir.tileHeight / 2);
+    cv::Mat regionRaster;
+    slideio::TiffTools::readTiledDirRegion(tiff.getHandle(), dir, region, regionRaster);
+    ASSERT_EQ(regionRaster.size(), region.size());
+    ASSERT_EQ(regionRaster.type(), dirRaster.type());
+    const cv::Mat expected = dirRaster(region);
+    EXPECT_EQ(0, cv::norm(expected, regionRaster, cv::NORM_INF));
+}
@@ -6,8 +6,13 @@
 #include "slideio/base/exceptions.hpp"
 #include "slideio/core/tools/tempfile.hpp"
 #include "slideio/core/tools/endian.hpp"
+#include "slideio/core/tools/rastercache.hpp"
+#include "slideio/core/tools/downsampler.hpp"
+#include "slideio/core/tools/resampling.hpp"
+#include <atomic>
 #include <filesystem>
 #include <numeric>
+#include <thread>
 #include <gtest/gtest.h>
 #include <opencv2/imgproc.hpp>
 
@@ -60,6 +65,73 @@ TEST(Tools, findZoomLevel) {
     EXPECT_EQ(Tools::findZoomLevel(0.1, numLevels, zoomFunct), 3);
 }
 
+TEST(Tools, findZoomLevelPolicy) {
+    std::vector<double> levels(10);
+    double zoom = 1.;
+    for (auto& level : levels) {
+        level = zoom;
+        zoom /= 2.;
+    }
+    const double lastZoom = levels.back();
+    auto zoomFunct = [&levels](int level) {
+        return levels[level];
+    };
+    const int numLevels = static_cast<int>(levels.size());
+    {
+        ResamplingScope scope(ResamplingPolicy::Fast);
+        EXPECT_EQ(Resampling::getPolicy(), ResamplingPolicy::Fast);
+        EXPECT_EQ(Tools::findZoomLevel(2., numLevels, zoomFunct), 0);
+        EXPECT_EQ(Tools::findZoomLevel(0.9, numLevels, zoomFunct), 0);
+        EXPECT_EQ(Tools::findZoomLevel(0.55, numLevels, zoomFunct), 1);
+        EXPECT_EQ(Tools::findZoomLevel(0.5, numLevels, zoomFunct), 1);
+        EXPECT_EQ(Tools::findZoomLevel(0.1, numLevels, zoomFunct), 3);
+        EXPECT_EQ(Tools::findZoomLevel(0.07, numLevels, zoomFunct), 4);
+        EXPECT_EQ(Tools::findZoomLevel(lastZoom / 2, numLevels, zoomFunct), 9);
+        {
+            ResamplingScope nested(ResamplingPolicy::Exact);
+            EXPECT_EQ(Resampling::getPolicy(), ResamplingPolicy::Exact);
+            EXPECT_EQ(Tools::findZoomLevel(2., numLevels, zoomFunct), 0);
+            EXPECT_EQ(Tools::findZoomLevel(0.55, numLevels, zoomFunct), 0);
+            EXPECT_EQ(Tools::findZoomLevel(0.45, numLevels, zoomFunct), 0);
+            EXPECT_EQ(Tools::findZoomLevel(0.25, numLevels, zoomFunct), 2);
+            EXPECT_EQ(Tools::findZoomLevel(0.2, numLevels, zoomFunct), 1);
+            EXPECT_EQ(Tools::findZoomLevel(0.1, numLevels, zoomFunct), 2);
+            EXPECT_EQ(Tools::findZoomLevel(lastZoom / 2, numLevels, zoomFunct), 9);
+        }
+        EXPECT_EQ(Resampling::getPolicy(), ResamplingPolicy::Fast);
+    }
+    EXPECT_EQ(Resampling::getPolicy(), ResamplingPolicy::Balanced);
+    EXPECT_EQ(Tools::findZoomLevel(0.55, numLevels, zoomFunct), 0);
+    EXPECT_EQ(Tools::findZoomLevel(0.2, numLevels, zoomFunct), 2);
+}
+
+TEST(Tools, resamplingInterpolation) {
+    const cv::Size large(100, 100), small(50, 50), mixed(120, 50);
+    EXPECT_EQ(Resampling::getInterpolation(ResamplingPolicy::Fast, large, small), cv::INTER_NEAREST);
+    EXPECT_EQ(Resampling::getInterpolation(ResamplingPolicy::Balanced, large, small), cv::INTER_LINEAR);
+    EXPECT_EQ(Resampling::getInterpolation(ResamplingPolicy::Exact, large, small), cv::INTER_AREA);
+    EXPECT_EQ(Resampling::getInterpolation(ResamplingPolicy::Exact, small, large), cv::INTER_LANCZOS4);
+    EXPECT_EQ(Resampling::getInterpolation(ResamplingPolicy::Exact, large, mixed), cv::INTER_LANCZOS4);
+    EXPECT_EQ(Resampling::getInterpolation(large, small), cv::INTER_LINEAR);
+
+    // Tools::resize follows the policy of the thread unless an interpolation is given
+    cv::Mat src(4, 4, CV_8UC1, cv::Scalar(0));
+    src.at<uint8_t>(1, 1) = 200;
+    cv::Mat nearest, area;
+    {
+        ResamplingScope scope(ResamplingPolicy::Fast);
+        Tools::resize(src, nearest, cv::Size(2, 2));
+    }
+    {
+        ResamplingScope scope(ResamplingPolicy::Exact);
+        Tools::resize(src, area, cv::Size(2, 2));
+    }
+    cv::Mat expected;
+    cv::resize(src, expected, cv::Size(2, 2), 0, 0, cv::INTER_NEAREST);
+    EXPECT_EQ(cv::norm(nearest, expected, cv::NORM_INF), 0.);
+    EXPECT_EQ(area.at<uint8_t>(0, 0), 50);
+}
+
 
 TEST(Tools, convert12BitsTo16Bits) {
     const uint8_t src[] = {
@@ -481,6 +553,93 @@ TEST(Tools, resize_32S_multichannelPreservesChannels) {
     EXPECT_EQ(px[2], 90000);
 }
 
+TEST(Downsampler, getFactor) {
+    EXPECT_EQ(Downsampler::getFactor(cv::Size(200, 100), cv::Size(100, 50)), 2);
+    EXPECT_EQ(Downsampler::getFactor(cv::Size(200, 100), cv::Size(50, 25)), 4);
+    EXPECT_EQ(Downsampler::getFactor(cv::Size(200, 104), cv::Size(25, 13)), 8);
+    EXPECT_EQ(Downsampler::getFactor(cv::Size(200, 100), cv::Size(100, 51)), 0);
+    EXPECT_EQ(Downsampler::getFactor(cv::Size(300, 300), cv::Size(100, 100)), 0);
+    EXPECT_EQ(Downsampler::getFactor(cv::Size(200, 100), cv::Size(0, 0)), 0);
+}
+
+TEST(Downsampler, selectFactor) {
+    const cv::Size src(256, 256);
+    EXPECT_EQ(Downsampler::selectFactor(src, cv::Size(128, 128), CV_8UC3, cv::INTER_LINEAR), 2);
+    EXPECT_EQ(Downsampler::selectFactor(src, cv::Size(64, 64), CV_8UC3, cv::INTER_LINEAR), 0);
+    EXPECT_EQ(Downsampler::selectFactor(src, cv::Size(64, 64), CV_16UC1, cv::INTER_AREA), 4);
+    EXPECT_EQ(Downsampler::selectFactor(src, cv::Size(32, 32), CV_32FC1, cv::INTER_AREA), 8);
+    EXPECT_EQ(Downsampler::selectFactor(src, cv::Size(128, 128), CV_8UC1, cv::INTER_NEAREST), 0);
+    EXPECT_EQ(Downsampler::selectFactor(src, cv::Size(128, 128), CV_8UC1, cv::INTER_CUBIC), 0);
+    EXPECT_EQ(Downsampler::selectFactor(src, cv::Size(128, 128), CV_64FC1, cv::INTER_AREA), 0);
+}
+
+TEST(Downsampler, matchesOpenCV8UC3) {
+    // ROIs of larger rasters: rows are not contiguous on either side
+    cv::Mat source(530, 1100, CV_8UC3);
+    cv::randu(source, cv::Scalar::all(0), cv::Scalar::all(256));
+    const cv::Mat src(source, cv::Rect(7, 9, 1024, 512));
+    for (int factor : {2, 4, 8}) {
+        const cv::Size size(src.cols / factor, src.rows / factor);
+        cv::Mat target(size.height + 10, size.width + 10, CV_8UC3, cv::Scalar::all(0));
+        cv::Mat dst(target, cv::Rect(cv::Point(5, 5), size));
+        const uchar* data = dst.data;
+        Downsampler::downsample(src, dst, factor);
+        EXPECT_EQ(data, dst.data);
+        cv::Mat expected;
+        cv::resize(src, expected, size, 0, 0, cv::INTER_AREA);
+        // OpenCV rounds the larger averages half to even, the downsampler half up
+        EXPECT_LE(cv::norm(dst, expected, cv::NORM_INF), factor == 2 ? 0. : 1.) << "factor " << factor;
+    }
+    cv::Mat linear, expected;
+    Tools::resize(src, linear, cv::Size(src.cols / 2, src.rows / 2));
+    cv::resize(src, expected, linear.size(), 0, 0, cv::INTER_LINEAR);
+    EXPECT_EQ(cv::norm(linear, expected, cv::NORM_INF), 0.);
+}
+
+TEST(Downsampler, matchesOpenCV16UC1) {
+    cv::Mat src(512, 768, CV_16UC1);
+    cv::randu(src, cv::Scalar(0), cv::Scalar(65536));
+    for (int factor : {2, 4, 8}) {
+        cv::Mat dst;
+        Tools::resize(src, dst, cv::Size(src.cols / factor, src.rows / factor), cv::INTER_AREA);
+        ASSERT_EQ(dst.type(), CV_16UC1);
+        cv::Mat expected;
+        cv::resize(src, expected, dst.size(), 0, 0, cv::INTER_AREA);
+        EXPECT_LE(cv::norm(dst, expected, cv::NORM_INF), 1.) << "factor " << factor;
+    }
+}
+
+TEST(Downsampler, signedAndFloatRasters) {
+    cv::Mat src8S(8, 8, CV_8SC1, cv::Scalar(-100));
+    src8S.at<signed char>(0, 0) = -128;
+    src8S.at<signed char>(0, 1) = 127;
+    cv::Mat dst8S;
+    Downsampler::downsample(src8S, dst8S, 2);
+    ASSERT_EQ(dst8S.type(), CV_8SC1);
+    // (-128 + 127 - 100 - 100 + 2) >> 2
+    EXPECT_EQ(dst8S.at<signed char>(0, 0), -50);
+    EXPECT_EQ(dst8S.at<signed char>(3, 3), -100);
+
+    cv::Mat src32F(16, 16, CV_32FC4, cv::Scalar(0.25, -1.5, 1000., 3.));
+    cv::Mat dst32F;
+    Downsampler::downsample(src32F, dst32F, 8);
+    ASSERT_EQ(dst32F.size(), cv::Size(2, 2));
+    const cv::Vec4f px = dst32F.at<cv::Vec4f>(1, 1);
+    EXPECT_FLOAT_EQ(px[0], 0.25f);
+    EXPECT_FLOAT_EQ(px[1], -1.5f);
+    EXPECT_FLOAT_EQ(px[2], 1000.f);
+    EXPECT_FLOAT_EQ(px[3], 3.f);
+}
+
+TEST(Downsampler, invalidInput) {
+    cv::Mat src(10, 10, CV_8UC1, cv::Scalar(0));
+    cv::Mat dst;
+    EXPECT_THROW(Downsampler::downsample(src, dst, 3), slideio::RuntimeError);
+    EXPECT_THROW(Downsampler::downsample(src, dst, 4), slideio::RuntimeError);
+    cv::Mat src64F(8, 8, CV_64FC1, cv::Scalar(0));
+    EXPECT_THROW(Downsampler::downsample(src64F, dst, 2), slideio::RuntimeError);
+}
+
 TEST(TestTools, writeReadRawImage_8UC1) {
     // Create a test image with CV_8UC1 (8-bit unsigned, 1 channel)
     cv::Mat original(100, 100, CV_8UC1);
@@ -670,3 +829,71 @@ TEST(TestTools, writeReadRawImage_MultiChannel) {
     TestTools::compareRasters(original, loaded);
 }
 
+TEST(RasterCache, keepsRecentRasters) {
+    const size_t rasterBytes = 100 * 100;
+    RasterCache cache(2 * rasterBytes);
+    int loads = 0;
+    auto loader = [&loads](uint8_t value) {
+        return [&loads, value](cv::OutputArray output) {
+            ++loads;
+            output.create(100, 100, CV_8UC1);
+            output.getMat().setTo(value);
+        };
+    };
+    cv::Mat first = cache.get("first", loader(1));
+    cv::Mat again = cache.get("first", loader(2));
+    EXPECT_EQ(1, loads);
+    EXPECT_EQ(first.data, again.data);
+    EXPECT_EQ(1, again.at<uint8_t>(0, 0));
+    cache.get("second", loader(2));
+    // "first" is used more recently than "second", so "second" is evicted
+    cache.get("first", loader(1));
+    cache.get("third", loader(3));
+    EXPECT_EQ(3, loads);
+    EXPECT_EQ(2, cache.getCount());
+    EXPECT_EQ(2 * rasterBytes, cache.getSize());
+    cache.get("first", loader(1));
+    EXPECT_EQ(3, loads);
+    cache.get("second", loader(2));
+    EXPECT_EQ(4, loads);
+    // a raster larger than the budget is returned but not kept
+    cv::Mat large = cache.get("large", [](cv::OutputArray output) {
+        output.create(1000, 1000, CV_8UC1);
+    });
+    EXPECT_EQ(1000, large.rows);
+    EXPECT_EQ(2, cache.getCount());
+    cache.clear();
+    EXPECT_EQ(0, cache.getCount());
+    EXPECT_EQ(0u, cache.getSize());
+}
+
+TEST(RasterCache, concurrentMissesShareOneLoad) {
+    RasterCache cache;
+    std::atomic<int> loads{ 0 };
+    auto loader = [&loads](cv::OutputArray output) {
+        ++loads;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        output.create(100, 100, CV_8UC1);
+        output.getMat().setTo(7);
+    };
+    std::vector<cv::Mat> rasters(4);
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < rasters.size(); ++index) {
+        threads.emplace_back([&, index]() {
+            rasters[index] = cache.get("shared", loader);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(1, loads.load());
+    for (const cv::Mat& raster : rasters) {
+        EXPECT_EQ(rasters[0].data, raster.data);
+    }
+    // a failed load is not kept: the next reader loads again
+    EXPECT_THROW(cache.get("failing", [](cv::OutputArray) {
+        throw std::runtime_error("decode error");
+    }), std::runtime_error);
+    cv::Mat raster = cache.get("failing", loader);
+    EXPECT_EQ(7, raster.at<uint8_t>(0, 0));
+}
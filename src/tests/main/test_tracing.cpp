@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include "slideio/core/tools/tempfile.hpp"
+#include "slideio/slideio/imagedrivermanager.hpp"
+#include "slideio/slideio/slideio.hpp"
+#include "slideio/slideio/scene.hpp"
+#include "tests/testlib/testtools.hpp"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <set>
+
+using namespace slideio;
+
+TEST(Tracing, writesChromeTrace)
+{
+    TempFile traceFile("json");
+    std::string path = TestTools::getTestImagePath("svs", "CMU-1-Small-Region.svs");
+    const int width = 1000;
+    const int height = 800;
+
+    startTracing(traceFile.getPath().string());
+    EXPECT_TRUE(ImageDriverManager::isTracingEnabled());
+    {
+        auto slide = openSlide(path, "SVS");
+        auto scene = slide->getScene(0);
+        std::vector<uint8_t> buffer(width / 2 * height / 2 * scene->getNumChannels());
+        scene->readResampledBlock({ 100, 100, width, height }, { width / 2, height / 2 }, buffer.data(), buffer.size());
+    }
+    stopTracing();
+    EXPECT_FALSE(ImageDriverManager::isTracingEnabled());
+    ASSERT_TRUE(std::filesystem::exists(traceFile.getPath()));
+
+    std::ifstream stream(traceFile.getPath());
+    auto trace = nlohmann::json::parse(stream);
+    std::multiset<std::string> names;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "X") {
+            EXPECT_GE(event["dur"].get<double>(), 0.);
+            EXPECT_GE(event["ts"].get<double>(), 0.);
+            names.insert(event["name"].get<std::string>());
+        }
+    }
+    EXPECT_EQ(1u, names.count("open slide"));
+    EXPECT_EQ(1u, names.count("read block"));
+    EXPECT_GT(names.count("tile read"), 1u);
+    EXPECT_EQ(names.count("tile read"), names.count("decode"));
+    EXPECT_GT(names.count("resize"), 0u);
+    EXPECT_EQ(0u, trace["otherData"]["droppedEvents"].get<uint64_t>());
+}
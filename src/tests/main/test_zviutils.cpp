@@ -6,7 +6,9 @@
 #include "tests/testlib/testtools.hpp"
 #include "slideio/drivers/zvi/zviutils.hpp"
 #include "slideio/drivers/zvi/pole_lib.hpp"
+#include "slideio/drivers/zvi/zvistreamindex.hpp"
 #include "slideio/base/exceptions.hpp"
+#include <algorithm>
 #include <stdexcept>
 
 using namespace slideio;
@@ -164,3 +166,34 @@ TEST(ZVIUtils, readAllTags_imageTagsContents)
     }
     EXPECT_TRUE(hasFilename);
 }
+
+TEST(ZVIStreamIndex, readMatchesCompoundDocument)
+{
+    std::string file_path = TestTools::getTestImagePath("zvi","Zeiss-1-Merged.zvi");
+    ole::compound_document doc(file_path);
+    ASSERT_TRUE(doc.good());
+    ZVIStreamIndex index;
+    index.open(file_path);
+    EXPECT_GT(index.getNumStreams(), 0);
+    EXPECT_EQ(nullptr, index.findStream("/Image/Item(100000)/Contents"));
+    for (const std::string path : { "/Image/Contents", "/Image/Tags/Contents", "/Image/Item(0)/Contents" }) {
+        ZVIUtils::StreamKeeper stream(doc, path);
+        stream->seek(0, std::ios::end);
+        const std::streamsize size = stream->pos();
+        stream->seek(0, std::ios::beg);
+        std::vector<char> expected(size);
+        stream->read(expected.data(), size);
+
+        const ZVIStreamIndex::Stream* indexed = index.findStream(path);
+        ASSERT_NE(nullptr, indexed) << path;
+        ASSERT_EQ(static_cast<uint64_t>(size), indexed->size) << path;
+        std::vector<char> data(size);
+        ASSERT_EQ(static_cast<size_t>(size), index.read(*indexed, 0, data.data(), data.size())) << path;
+        EXPECT_EQ(expected, data) << path;
+        // reads from the middle cross extent boundaries
+        const uint64_t pos = size / 3;
+        std::vector<char> tail(size - pos);
+        ASSERT_EQ(tail.size(), index.read(*indexed, pos, tail.data(), tail.size() + 100)) << path;
+        EXPECT_TRUE(std::equal(tail.begin(), tail.end(), expected.begin() + pos)) << path;
+    }
+}
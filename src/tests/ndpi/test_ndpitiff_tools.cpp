@@ -297,7 +297,9 @@ TEST_F(NDPITiffToolsTests, readScanlinesDNLMarker)
     const std::vector<int> channelIndices = { 0,1,2 };
     cv::Mat stripRaster;
     cv::Rect roi = { dir.width / 2, dir.height / 2, 400, 300 };
-    slideio::NDPITiffTools::readJpegDirectoryRegion(tiff, filePath, roi, dir, channelIndices, stripRaster);
+    std::unique_ptr<FILE, slideio::Tools::FileDeleter> file(slideio::Tools::openFile(filePath, "rb"));
+    ASSERT_TRUE(file != nullptr);
+    slideio::NDPITiffTools::readJpegDirectoryRegion(tiff, file.get(), roi, dir, channelIndices, stripRaster);
     EXPECT_EQ(roi.height, stripRaster.rows);
     EXPECT_EQ(roi.width, stripRaster.cols);
     //slideio::NDPITestTools::writePNG(stripRaster, testFilePath);
@@ -320,7 +322,9 @@ TEST_F(NDPITiffToolsTests, readScanlinesDNLMarkerSingleChannel)
     const std::vector<int> channelIndices = { 1 };
     cv::Mat stripRaster;
     cv::Rect roi = { dir.width / 3, dir.height / 3, 400, 300 };
-    slideio::NDPITiffTools::readJpegDirectoryRegion(tiff, filePath, roi, dir, channelIndices, stripRaster);
+    std::unique_ptr<FILE, slideio::Tools::FileDeleter> file(slideio::Tools::openFile(filePath, "rb"));
+    ASSERT_TRUE(file != nullptr);
+    slideio::NDPITiffTools::readJpegDirectoryRegion(tiff, file.get(), roi, dir, channelIndices, stripRaster);
     EXPECT_EQ(roi.height, stripRaster.rows);
     EXPECT_EQ(roi.width, stripRaster.cols);
     EXPECT_EQ(1, stripRaster.channels());
@@ -344,7 +348,9 @@ TEST_F(NDPITiffToolsTests, readScanlinesDNLMarkerInversedChannels)
     const std::vector<int> channelIndices = { 2,0,1};
     cv::Mat stripRaster;
     cv::Rect roi = { dir.width / 2, dir.height / 2, 400, 300 };
-    slideio::NDPITiffTools::readJpegDirectoryRegion(tiff, filePath, roi, dir, channelIndices, stripRaster);
+    std::unique_ptr<FILE, slideio::Tools::FileDeleter> file(slideio::Tools::openFile(filePath, "rb"));
+    ASSERT_TRUE(file != nullptr);
+    slideio::NDPITiffTools::readJpegDirectoryRegion(tiff, file.get(), roi, dir, channelIndices, stripRaster);
     EXPECT_EQ(roi.height, stripRaster.rows);
     EXPECT_EQ(roi.width, stripRaster.cols);
     //slideio::NDPITestTools::writePNG(stripRaster, testFilePath);
@@ -376,6 +382,44 @@ TEST_F(NDPITiffToolsTests, readMCUTile)
     TestTools::compareRasters(tileRaster, testRaster);
 }
 
+TEST_F(NDPITiffToolsTests, scanRestartMarkers)
+{
+    std::string filePath = TestTools::getFullTestImagePath("hamamatsu", "openslide/CMU-1.ndpi");
+    slideio::NDPIFile ndpi;
+    ndpi.init(filePath);
+    const slideio::NDPITiffDirectory& dir = ndpi.directories()[0];
+    ASSERT_FALSE(dir.mcuStarts.empty());
+    std::unique_ptr<FILE, slideio::Tools::FileDeleter> sfile(slideio::Tools::openFile(ndpi.getFilePath(), "rb"));
+    std::vector<uint64_t> starts;
+    slideio::NDPITiffTools::scanRestartMarkers(sfile.get(), dir.jpegHeaderOffset + dir.jpegHeaderSize,
+        dir.jpegHeaderOffset + dir.rawStripSize, starts);
+    EXPECT_EQ(starts, dir.mcuStarts);
+}
+
+TEST_F(NDPITiffToolsTests, readMCURegion)
+{
+    std::string filePath = TestTools::getFullTestImagePath("hamamatsu", "openslide/CMU-1.ndpi");
+    slideio::NDPIFile ndpi;
+    ndpi.init(filePath);
+    const slideio::NDPITiffDirectory& dir = ndpi.directories()[0];
+    ASSERT_EQ(dir.getType(), slideio::NDPITiffDirectory::Type::SingleStripeMCU);
+    const int tilesX = (dir.width - 1) / dir.tileWidth + 1;
+    const int tilesY = (dir.height - 1) / dir.tileHeight + 1;
+    const int tile = (tilesY / 2) * tilesX + tilesX / 2;
+    const cv::Rect tileRect((tilesX / 2) * dir.tileWidth, (tilesY / 2) * dir.tileHeight,
+        dir.tileWidth, dir.tileHeight);
+    // the region spans the tile and its neighbours in both directions
+    const cv::Rect region(tileRect.x - dir.tileWidth / 2, tileRect.y - dir.tileHeight / 2,
+        dir.tileWidth * 2, dir.tileHeight * 2);
+    cv::Mat regionRaster;
+    slideio::NDPITiffTools::readMCURegion(ndpi.getFileHandle(), dir, region, {}, regionRaster);
+    ASSERT_EQ(regionRaster.size(), region.size());
+    cv::Mat tileRaster;
+    std::unique_ptr<FILE, slideio::Tools::FileDeleter> sfile(slideio::Tools::openFile(ndpi.getFilePath(), "rb"));
+    slideio::NDPITiffTools::readMCUTile(sfile.get(), dir, tile, tileRaster);
+    cv::Mat regionTile(regionRaster, tileRect - region.tl());
+    TestTools::compareRasters(tileRaster, regionTile);
+}
 
 TEST_F(NDPITiffToolsTests, getDirectoryType) {
 
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <opencv2/imgproc.hpp>
+
+#include "tests/testlib/testtools.hpp"
+#include "slideio/base/slideio_enums.hpp"
+#include "slideio/transformer/cannyfilter.hpp"
+#include "slideio/transformer/chainexecutor.hpp"
+#include "slideio/transformer/colortransformation.hpp"
+#include "slideio/transformer/gaussianblurfilter.hpp"
+#include "slideio/transformer/medianblurfilter.hpp"
+#include "slideio/transformer/sobelfilter.hpp"
+
+using namespace slideio;
+
+static std::list<std::shared_ptr<Transformation>> grayBlurSobelChain()
+{
+    std::shared_ptr<ColorTransformation> gray(new ColorTransformation);
+    gray->setColorSpace(ColorSpace::GRAY);
+    std::shared_ptr<GaussianBlurFilter> blur(new GaussianBlurFilter);
+    blur->setKernelSizeX(9);
+    blur->setKernelSizeY(7);
+    std::shared_ptr<SobelFilter> sobel(new SobelFilter);
+    sobel->setDepth(DataType::DT_Float32);
+    sobel->setKernelSize(3);
+    sobel->setDx(1);
+    sobel->setDy(1);
+    return { gray, blur, sobel };
+}
+
+static cv::Mat applyStages(const std::list<std::shared_ptr<Transformation>>& chain, const cv::Mat& block)
+{
+    cv::Mat result = block.clone();
+    for (const auto& transformation : chain) {
+        cv::Mat transformed;
+        dynamic_cast<TransformationEx*>(transformation.get())->applyTransformation(result, transformed);
+        result = transformed;
+    }
+    return result;
+}
+
+TEST(ChainExecutor, bandsMatchWholeBlock)
+{
+    cv::Mat block(301, 123, CV_8UC3);
+    cv::randu(block, cv::Scalar::all(0), cv::Scalar::all(255));
+    const auto chain = grayBlurSobelChain();
+    cv::Mat expected = applyStages(chain, block);
+
+    // a tiny budget gives bands of MIN_BAND_ROWS rows, thinner than the halo of the chain
+    ChainExecutor executor(chain, 1);
+    EXPECT_EQ(ChainExecutor::MIN_BAND_ROWS, executor.getBandRows(block));
+    cv::Mat transformed;
+    executor.run(block, transformed);
+    ASSERT_EQ(expected.type(), transformed.type());
+    ASSERT_EQ(expected.size(), transformed.size());
+    TestTools::compareRasters(expected, transformed);
+
+    // the band buffers are reused by a block of another size
+    cv::Mat roi = block(cv::Rect(10, 20, 100, 250));
+    cv::Mat expectedRoi = applyStages(chain, roi.clone());
+    executor.run(roi.clone(), transformed);
+    TestTools::compareRasters(expectedRoi, transformed);
+}
+
+TEST(ChainExecutor, bandsOfSeveralRows)
+{
+    cv::Mat block(517, 200, CV_8UC3);
+    cv::randu(block, cv::Scalar::all(0), cv::Scalar::all(255));
+    std::shared_ptr<MedianBlurFilter> median(new MedianBlurFilter);
+    median->setKernelSize(5);
+    std::shared_ptr<GaussianBlurFilter> blur(new GaussianBlurFilter);
+    blur->setKernelSizeX(5);
+    blur->setKernelSizeY(5);
+    std::list<std::shared_ptr<Transformation>> chain = { median, blur };
+    cv::Mat expected = applyStages(chain, block);
+
+    ChainExecutor executor(chain, 40 * block.cols * block.channels() * sizeof(float));
+    EXPECT_EQ(40, executor.getBandRows(block));
+    cv::Mat transformed;
+    executor.run(block, transformed);
+    TestTools::compareRasters(expected, transformed);
+}
+
+TEST(ChainExecutor, nonLocalChain)
+{
+    cv::Mat block(300, 200, CV_8UC1);
+    cv::randu(block, cv::Scalar::all(0), cv::Scalar::all(255));
+    std::shared_ptr<CannyFilter> canny(new CannyFilter);
+    canny->setThreshold1(50);
+    canny->setThreshold2(150);
+    std::list<std::shared_ptr<Transformation>> chain = { canny };
+    EXPECT_FALSE(ChainExecutor::isLocal(chain));
+    EXPECT_TRUE(ChainExecutor::isLocal(grayBlurSobelChain()));
+    // the Canny filter is applied to the whole block
+    cv::Mat expected = applyStages(chain, block);
+    ChainExecutor executor(chain, 1);
+    cv::Mat transformed;
+    executor.run(block, transformed);
+    TestTools::compareRasters(expected, transformed);
+}
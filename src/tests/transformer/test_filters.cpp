@@ -201,6 +201,75 @@ TEST(Filters, readBlockPartialScharr)
     //TestTools::showRaster(transformedImage);
 }
 
+TEST(Filters, readBlockTiledChain)
+{
+    std::string path = TestTools::getTestImagePath("gdal", "Airbus_Pleiades_50cm_8bit_RGB_Yogyakarta.jpg");
+    std::shared_ptr<Slide> slide = openSlide(path, "AUTO");
+    std::shared_ptr<Scene> originScene = slide->getScene(0);
+    std::shared_ptr<CVScene> originCVScene = originScene->getCVScene();
+    const cv::Rect sceneRect(cv::Point(0, 0), originCVScene->getRect().size());
+    cv::Mat originImage;
+    originCVScene->readBlock(sceneRect, originImage);
+
+    constexpr int kernelSize = 7;
+    std::shared_ptr<GaussianBlurFilter> blur(new GaussianBlurFilter);
+    blur->setKernelSizeX(kernelSize);
+    blur->setKernelSizeY(kernelSize);
+    std::shared_ptr<SobelFilter> sobel(new SobelFilter);
+    sobel->setDepth(DataType::DT_Int16);
+    sobel->setKernelSize(5);
+    sobel->setDx(0);
+    sobel->setDy(1);
+    std::list<std::shared_ptr<Transformation>> transformations = { blur, sobel };
+    std::shared_ptr<Scene> transformedScene = transformSceneEx(originScene, transformations);
+    auto transformerScene = std::dynamic_pointer_cast<TransformerScene>(transformedScene->getCVScene());
+    ASSERT_TRUE(transformerScene != nullptr);
+
+    cv::Mat blurred, reference;
+    cv::GaussianBlur(originImage, blurred, cv::Size(kernelSize, kernelSize), 0);
+    cv::Sobel(blurred, reference, CV_16S, 0, 1, 5);
+
+    // the block spans several tiles: the tiles must give the pixels of the whole image
+    const cv::Rect blockRect(sceneRect.width / 8, sceneRect.height / 8, sceneRect.width / 2, sceneRect.height / 2);
+    cv::Mat block;
+    transformerScene->readBlock(blockRect, block);
+    ASSERT_EQ(block.type(), CV_16SC3);
+    cv::Mat referenceBlock = reference(blockRect);
+    TestTools::compareRasters(referenceBlock, block);
+    const int cachedTiles = transformerScene->getTileCache().getCount();
+    EXPECT_GT(cachedTiles, 1);
+
+    // an overlapping block is composed from the cached tiles
+    const cv::Rect innerRect(blockRect.x + 50, blockRect.y + 70, blockRect.width / 2, blockRect.height / 2);
+    cv::Mat innerBlock;
+    transformerScene->readBlockChannels(innerRect, { 2 }, innerBlock);
+    EXPECT_EQ(cachedTiles, transformerScene->getTileCache().getCount());
+    cv::Mat referenceChannel;
+    cv::extractChannel(reference(innerRect), referenceChannel, 2);
+    TestTools::compareRasters(referenceChannel, innerBlock);
+    // the scene keeps its own copies of the transformations
+    blur->setKernelSizeX(3);
+    blur->setKernelSizeY(3);
+    transformerScene->readBlockChannels(innerRect, { 2 }, innerBlock);
+    TestTools::compareRasters(referenceChannel, innerBlock);
+
+    // a kernel given by sigma only: the tiles must cover the kernel OpenCV derives from it
+    constexpr double sigma = 3.;
+    std::shared_ptr<GaussianBlurFilter> sigmaBlur(new GaussianBlurFilter);
+    sigmaBlur->setKernelSizeX(0);
+    sigmaBlur->setKernelSizeY(0);
+    sigmaBlur->setSigmaX(sigma);
+    sigmaBlur->setSigmaY(sigma);
+    std::list<std::shared_ptr<Transformation>> sigmaTransformations = { sigmaBlur };
+    std::shared_ptr<Scene> sigmaScene = transformSceneEx(originScene, sigmaTransformations);
+    cv::Mat sigmaReference;
+    cv::GaussianBlur(originImage, sigmaReference, cv::Size(0, 0), sigma);
+    cv::Mat sigmaBlock;
+    sigmaScene->getCVScene()->readBlock(blockRect, sigmaBlock);
+    cv::Mat sigmaReferenceBlock = sigmaReference(blockRect);
+    TestTools::compareRasters(sigmaReferenceBlock, sigmaBlock);
+}
+
 TEST(Filters, readScaledBlockMedian)
 {
     // scale the image to 50% and apply median filter
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include "slideio/transformer/bilateralfilter.hpp"
 #include "slideio/transformer/gaussianblurfilter.hpp"
 #include "slideio/transformer/transformertools.hpp"
 
@@ -185,13 +186,28 @@ TEST(TransformerTools, getBlockExtensionForGaussianBlur)
     filter.setSigmaX(1.0);
     filter.setSigmaY(1.0);
     extension = filter.getInflationValue();
-    EXPECT_EQ(3, extension);
+    EXPECT_EQ(5, extension);
     filter.setSigmaX(2.0);
     filter.setSigmaY(1.0);
     extension = filter.getInflationValue();
-    EXPECT_EQ(5, extension);
+    EXPECT_EQ(9, extension);
     filter.setSigmaX(1.5);
     filter.setSigmaY(1.0);
     extension = filter.getInflationValue();
-    EXPECT_EQ(4, extension);
+    EXPECT_EQ(7, extension);
+    // sigmaY defaults to sigmaX
+    filter.setSigmaX(2.0);
+    filter.setSigmaY(0.);
+    extension = filter.getInflationValue();
+    EXPECT_EQ(9, extension);
+}
+
+TEST(TransformerTools, getBlockExtensionForBilateral)
+{
+    BilateralFilter filter;
+    filter.setDiameter(5);
+    EXPECT_EQ(3, filter.getInflationValue());
+    filter.setDiameter(0);
+    filter.setSigmaSpace(10.);
+    EXPECT_EQ(15, filter.getInflationValue());
 }
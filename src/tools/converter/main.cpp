@@ -112,13 +112,13 @@ int main(int argc, char* argv[]) {
     app.add_option("-d,--driver", inputDriver, "Input driver name (AUTO for auto-detection)")
        ->default_val("AUTO");
 
-    app.add_option("-f,--format", targetFormat, "Target format (SVS or OMETIFF)")
+    app.add_option("-f,--format", targetFormat, "Target format (SVS, OMETIFF or OMEZARR)")
        ->default_val("OMETIFF")
-       ->check(CLI::IsMember({"SVS", "OMETIFF"}));
+       ->check(CLI::IsMember({"SVS", "OMETIFF", "OMEZARR"}));
 
-    app.add_option("-m,--compression-method", targetCompression, "Compression method (Jpeg or Jpeg2000)")
+    app.add_option("-m,--compression-method", targetCompression, "Compression method (Jpeg, Jpeg2000, HTJ2K, Zstd, Deflate or LZW)")
        ->default_val("Jpeg2000")
-       ->check(CLI::IsMember({"Jpeg", "Jpeg2000"}));
+       ->check(CLI::IsMember({"Jpeg", "Jpeg2000", "HTJ2K", "Zstd", "Deflate", "LZW"}));
 
     app.add_option("-q,--quality", compressionQuality, "Compression quality for Jpeg compression (0-100)")
        ->default_val(95)
@@ -164,6 +164,22 @@ int main(int argc, char* argv[]) {
        ->default_val(0)
        ->check(CLI::NonNegativeNumber);
 
+    bool parallelWriting = false;
+    app.add_flag("--parallel-writing", parallelWriting, "Encoding threads write tiles directly into a BigTIFF file");
+
+    bool backgroundDetection = false;
+    double backgroundTolerance = 2.0;
+    app.add_flag("--detect-background", backgroundDetection,
+                 "Near-uniform background tiles are encoded once and shared");
+    app.add_option("--background-tolerance", backgroundTolerance,
+                   "Maximal standard deviation of a background tile (0 = exactly uniform tiles only)")
+       ->default_val(2.0)
+       ->check(CLI::NonNegativeNumber);
+
+    bool resume = false;
+    app.add_flag("--resume", resume,
+                 "Journal written tiles and continue an interrupted conversion of the same output file");
+
     CLI11_PARSE(app, argc, argv);
 
     try {
@@ -215,7 +231,11 @@ int main(int argc, char* argv[]) {
                     deleteIfExists,
                     tileBatchSize,
                     numReadingThreads,
-                    numEncodingThreads);
+                    numEncodingThreads,
+                    parallelWriting,
+                    backgroundDetection,
+                    backgroundTolerance,
+                    resume);
     }
     catch (const std::exception& e) {
         std::cerr << "Error during processing: " << e.what() << std::endl;
@@ -4,6 +4,8 @@
 
 #include "slideio/converter/converterparameters.hpp"
 #include "slideio/converter/tiffconverter.hpp"
+#include "slideio/converter/zarrconverter.hpp"
+#include "slideio/converter/conversionjournal.hpp"
 #include "slideio/slideio/slide.hpp"
 #include "slideio/base/rect.hpp"
 #include "slideio/base/range.hpp"
@@ -167,9 +169,18 @@ void printInfo(const TiffConverter& converter) {
 		std::cout << " (Compression quality: " << quality << ")";
 	}
 	else if (compression == Compression::Jpeg2000) {
-		const float rate =
-			std::static_pointer_cast<const JP2KEncodeParameters>(params.getEncodeParameters())->getCompressionRate();
-		std::cout << " (Compression rate: " << rate << ")";
+		auto jp2kParams = std::static_pointer_cast<const JP2KEncodeParameters>(params.getEncodeParameters());
+		if (jp2kParams->getHighThroughput()) {
+			std::cout << " (High throughput, quantization step: " << jp2kParams->getQuantizationStep() << ")";
+		}
+		else {
+			std::cout << " (Compression rate: " << jp2kParams->getCompressionRate() << ")";
+		}
+	}
+	else if (LosslessEncodeParameters::isLosslessCompression(compression)) {
+		const int level =
+			std::static_pointer_cast<const LosslessEncodeParameters>(params.getEncodeParameters())->getLevel();
+		std::cout << " (Compression level: " << level << ")";
 	}
 	std::cout << std::endl;
 	const int numZoomLevels = tiffParams->getNumZoomLevels();
@@ -185,9 +196,32 @@ void printInfo(const TiffConverter& converter) {
 	const int numEncodingThreads = tiffParams->getNumEncodingThreads();
 	std::cout << "Reading threads: " << numReadingThreads << (numReadingThreads == 0 ? " (auto: half of CPU cores)" : "") << std::endl;
 	std::cout << "Encoding threads: " << numEncodingThreads << (numEncodingThreads == 0 ? " (auto: half of CPU cores)" : "") << std::endl;
+	std::cout << "Parallel writing: " << (tiffParams->getParallelWriting() || tiffParams->getResumable() ? "yes" : "no") << std::endl;
+	std::cout << "Resumable: " << (tiffParams->getResumable() ? "yes" : "no") << std::endl;
+	std::cout << "Background detection: ";
+	if (tiffParams->getBackgroundDetection()) {
+		std::cout << "yes (tolerance: " << tiffParams->getBackgroundTolerance() << ")" << std::endl;
+	}
+	else {
+		std::cout << "no" << std::endl;
+	}
 
 }
 
+void printInfo(const ZarrConverter& converter) {
+	const ConverterParameters& params = converter.getParameters();
+	std::cout << "Target format: OMEZARR" << std::endl;
+	const int level =
+		std::static_pointer_cast<const LosslessEncodeParameters>(params.getEncodeParameters())->getLevel();
+	std::cout << "Target compression: " << params.getEncoding() << " (Compression level: " << level << ")" << std::endl;
+	std::cout << "Number of zoom levels: " << converter.getNumZoomLevels() << std::endl;
+	std::cout << "Chunk size: " << converter.getChunkSize().width << " x " << converter.getChunkSize().height << std::endl;
+	std::cout << "Number of chunks: " << converter.getTotalChunks() << std::endl;
+	std::cout << "Channel range: " << params.getChannelRange() << std::endl;
+	std::cout << "Slice range: " << params.getSliceRange() << std::endl;
+	std::cout << "Time frame range: " << params.getTFrameRange() << std::endl;
+	std::cout << "Target image rectangle: " << params.getRect() << std::endl;
+}
 
 void convertFile(
 	const std::string& inputPath,
@@ -209,13 +243,19 @@ void convertFile(
 	bool deleteIfExists,
 	int tileBatchSize,
 	int numReadingThreads,
-	int numEncodingThreads) {
+	int numEncodingThreads,
+	bool parallelWriting,
+	bool backgroundDetection,
+	double backgroundTolerance,
+	bool resume) {
 	if (!std::filesystem::exists(inputPath)) {
 		throw std::runtime_error("Input file does not exist: " + inputPath);
 	}
-	if (!infoOnly && std::filesystem::exists(outputPath)) {
+	const bool resumeOutput = resume
+		&& std::filesystem::exists(ConversionJournal::getJournalPath(outputPath));
+	if (!infoOnly && !resumeOutput && std::filesystem::exists(outputPath)) {
 		if (deleteIfExists) {
-			std::filesystem::remove(outputPath);
+			std::filesystem::remove_all(outputPath);
 		} else {
 			throw std::runtime_error("Output file already exists: " + outputPath);
 		}
@@ -223,9 +263,27 @@ void convertFile(
 	auto slide = openSlide(inputPath, inputDriver);
 	auto scene = slide->getScene(sceneIndex);
 
-	Compression compression = (targetCompression == "Jpeg") ? Compression::Jpeg : Compression::Jpeg2000;
-	ImageFormat format = (targetFormat == "SVS") ? SVS : OME_TIFF;
-	ConverterParameters params(format, TIFF_CONTAINER, compression);
+	Compression compression = Compression::Jpeg2000;
+	if (targetCompression == "Jpeg") {
+		compression = Compression::Jpeg;
+	}
+	else if (targetCompression == "Zstd") {
+		compression = Compression::Zstd;
+	}
+	else if (targetCompression == "Deflate") {
+		compression = Compression::Zlib;
+	}
+	else if (targetCompression == "LZW") {
+		compression = Compression::LZW;
+	}
+	ImageFormat format = OME_TIFF;
+	if (targetFormat == "SVS") {
+		format = SVS;
+	}
+	else if (targetFormat == "OMEZARR") {
+		format = OME_ZARR;
+	}
+	ConverterParameters params(format, format == OME_ZARR ? ZARR_CONTAINER : TIFF_CONTAINER, compression);
 	params.setTileBatchSize(tileBatchSize);
 	if (!rect.empty()) {
 		const Rect& sceneRect = scene->getCVScene()->getRect();
@@ -264,17 +322,60 @@ void convertFile(
 		auto jp2kParams 
 	        = std::static_pointer_cast<JP2KEncodeParameters>(params.getEncodeParameters());
 		jp2kParams->setCompressionRate(static_cast<float>(compressionRate));
+		if (targetCompression == "HTJ2K") {
+			// the compression rate does not apply to HT coding, which is written losslessly
+			jp2kParams->setHighThroughput(true);
+		}
 	} else if (compression==Compression::Jpeg) {
 		auto jpegParams 
 			= std::static_pointer_cast<JpegEncodeParameters>(params.getEncodeParameters());
 		jpegParams->setQuality(compressionQuality);
 	}
+	if (format == OME_ZARR) {
+		auto zarrParams = std::static_pointer_cast<ZarrContainerParameters>(params.getContainerParameters());
+		zarrParams->setChunkWidth(tileSize);
+		zarrParams->setChunkHeight(tileSize);
+		zarrParams->setNumReadingThreads(numReadingThreads);
+		zarrParams->setNumEncodingThreads(numEncodingThreads);
+		if (numZoomLevels > 0) {
+			zarrParams->setNumZoomLevels(numZoomLevels);
+		}
+		ZarrConverter converter;
+		converter.createLayout(scene->getCVScene(), params);
+		if (infoOnly || !silent) {
+			printInfo(converter);
+		}
+		if (infoOnly) {
+			std::cout << "Info-only mode: Conversion skipped." << std::endl;
+			return;
+		}
+		auto startTime = std::chrono::high_resolution_clock::now();
+		if (!silent) {
+			std::cout << "Converting..." << std::endl;
+			CursorGuard cursorGuard;
+			converter.createZarr(outputPath, showProgress);
+		}
+		else {
+			converter.createZarr(outputPath, nullptr);
+		}
+		auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::high_resolution_clock::now() - startTime);
+		if (!silent) {
+			std::cout << "Conversion completed successfully." << std::endl;
+			std::cout << "Conversion time: " << formatDuration(duration) << std::endl;
+		}
+		return;
+	}
 	auto containerParams 
         = std::static_pointer_cast<TIFFContainerParameters>(params.getContainerParameters());
 	containerParams->setTileWidth(tileSize);
 	containerParams->setTileHeight(tileSize);
 	containerParams->setNumReadingThreads(numReadingThreads);
 	containerParams->setNumEncodingThreads(numEncodingThreads);
+	containerParams->setParallelWriting(parallelWriting);
+	containerParams->setBackgroundDetection(backgroundDetection);
+	containerParams->setBackgroundTolerance(backgroundTolerance);
+	containerParams->setResumable(resume);
 	if (numZoomLevels > 0) {
 		containerParams->setNumZoomLevels(numZoomLevels);
 	}
@@ -306,6 +407,9 @@ void convertFile(
 	if (!silent) {
 		std::cout << "Conversion completed successfully." << std::endl;
 		std::cout << "Conversion time: " << formatDuration(duration) << std::endl;
+		if (converter.getNumResumedTiles() > 0) {
+			std::cout << "Tiles resumed from the journal: " << converter.getNumResumedTiles() << std::endl;
+		}
 		auto readersIdle = std::chrono::duration_cast<std::chrono::milliseconds>(converter.getReadersIdleTime());
 		auto encodersIdle = std::chrono::duration_cast<std::chrono::milliseconds>(converter.getEncodersIdleTime());
 		auto writerIdle = std::chrono::duration_cast<std::chrono::milliseconds>(converter.getWriterIdleTime());
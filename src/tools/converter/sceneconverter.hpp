@@ -26,4 +26,8 @@ void convertFile(
 	bool deleteIfExists,
 	int tileBatchSize,
 	int numReadingThreads,
-	int numEncodingThreads);
+	int numEncodingThreads,
+	bool parallelWriting,
+	bool backgroundDetection,
+	double backgroundTolerance,
+	bool resume);